@@ -221,6 +221,8 @@ Bool do_hint, do_save, full_interleave, do_frag, hint_interleave, dump_rtp, regu
 Bool print_sdp, open_edit, dump_cr, force_ocr, encode, do_scene_log, dump_srt, dump_ttxt, do_saf, dump_m2ts, dump_cart, dump_chunk, dump_check_xml, fuzz_chk;
 Bool do_hash, verbose, force_cat, pack_wgt, single_group, clean_groups, dash_live, no_fragments_defaults, single_traf_per_moof, tfdt_per_traf;
 Bool hls_clock, do_mpd_rip, merge_vtt_cues, get_nb_tracks, no_inplace, merge_last_seg, freeze_box_order, no_odf_conf;
+u32 do_sic;
+char *sic_dir;
 Bool insert_utc, chunk_mode, HintCopy, hint_no_offset, do_bin_xml, frag_real_time, force_co64, live_scene, use_mfra, dump_iod, samplegroups_in_traf;
 Bool mvex_after_traks, daisy_chain_sidx, use_ssix, single_segment, single_file, segment_timeline, has_add_image;
 Bool strict_cues, use_url_template, seg_at_rap, frag_at_rap, memory_frags, keep_utc, has_next_arg, no_cache, no_loop;
@@ -281,6 +283,8 @@ static void init_global_vars()
 	dump_cr = force_ocr = encode = do_scene_log = dump_srt = dump_ttxt = do_saf = dump_m2ts = dump_cart = dump_chunk = GF_FALSE;
 	dump_check_xml = do_hash = verbose = force_cat = pack_wgt = single_group = clean_groups = dash_live = no_fragments_defaults = fuzz_chk = GF_FALSE;
 	single_traf_per_moof = tfdt_per_traf = hls_clock = do_mpd_rip = merge_vtt_cues = get_nb_tracks = GF_FALSE;
+	do_sic = 0;
+	sic_dir = NULL;
 	no_inplace = merge_last_seg = freeze_box_order = no_odf_conf = GF_FALSE;
 	insert_utc = chunk_mode = HintCopy = hint_no_offset = do_bin_xml = frag_real_time = force_co64 = live_scene = GF_FALSE;
 	use_mfra = dump_iod = samplegroups_in_traf = mvex_after_traks = daisy_chain_sidx = use_ssix = single_segment = single_file = GF_FALSE;
@@ -1314,6 +1318,9 @@ MP4BoxArg m4b_dump_args[] =
  	MP4BOX_ARG("nstats", "generate node/field statistics per Access Unit", GF_ARG_BOOL, 0, &stat_level, 2, 0),
  	MP4BOX_ARG("nstatx", "generate node/field statistics for scene after each AU", GF_ARG_BOOL, 0, &stat_level, 3, 0),
  	MP4BOX_ARG("hash", "generate SHA-1 Hash of the input file", GF_ARG_BOOL, 0, &do_hash, 0, 0),
+ 	MP4BOX_ARG("sic-build", "build sample index cache of the input file, used by mp4dmx [-sicache]()", GF_ARG_BOOL, GF_FS_ARG_HINT_EXPERT, &do_sic, 1, 0),
+ 	MP4BOX_ARG("sic-check", "check sample index cache of the input file against its sample tables", GF_ARG_BOOL, GF_FS_ARG_HINT_EXPERT, &do_sic, 2, 0),
+ 	MP4BOX_ARG("sic-dir", "directory of sample index cache for [-sic-build]() and [-sic-check]() (default is next to input file)", GF_ARG_STRING, GF_FS_ARG_HINT_EXPERT, &sic_dir, 0, 0),
  	MP4BOX_ARG("comp", "replace with compressed version all top level box types given as parameter, formatted as `orig_4cc_1=comp_4cc_1[,orig_4cc_2=comp_4cc_2]`", GF_ARG_STRING, 0, parse_comp_box, 0, ARG_IS_FUN),
  	MP4BOX_ARG("topcount", "print to stdout the number of top-level boxes matching box types given as parameter, formatted as `4cc_1,4cc_2N`", GF_ARG_STRING, 0, parse_comp_box, 2, ARG_IS_FUN),
  	MP4BOX_ARG("topsize", "print to stdout the number of bytes of top-level boxes matching types given as parameter, formatted as `4cc_1,4cc_2N` or `all` for all boxes", GF_ARG_STRING, 0, parse_comp_box, 1, ARG_IS_FUN),
@@ -4213,6 +4220,41 @@ static GF_Err hash_file(char *name, u32 dump_std)
 	return GF_OK;
 }
 
+static GF_Err do_sample_index(char *name)
+{
+	GF_Err e;
+	char *idx_name = gf_isom_sample_index_get_name(name, sic_dir);
+	if (!idx_name) return GF_OUT_OF_MEM;
+
+	if (do_sic==1) {
+		GF_ISOFile *mov = gf_isom_open(name, GF_ISOM_OPEN_READ, NULL);
+		if (!mov) {
+			e = gf_isom_last_error(NULL);
+		} else {
+			e = gf_isom_sample_index_build(mov, idx_name);
+			gf_isom_close(mov);
+		}
+		if (e) {
+			M4_LOG(GF_LOG_ERROR, ("Failed to build sample index cache %s: %s\n", idx_name, gf_error_to_string(e)));
+		} else {
+			M4_LOG(GF_LOG_INFO, ("Sample index cache %s created\n", idx_name));
+		}
+	} else {
+		e = gf_isom_sample_index_check(name, idx_name, GF_TRUE);
+		if (e==GF_NOT_FOUND) {
+			M4_LOG(GF_LOG_ERROR, ("Sample index cache %s not found\n", idx_name));
+		} else if (e==GF_CORRUPTED_DATA) {
+			M4_LOG(GF_LOG_ERROR, ("Sample index cache %s is not valid for %s\n", idx_name, name));
+		} else if (e) {
+			M4_LOG(GF_LOG_ERROR, ("Failed to check sample index cache %s: %s\n", idx_name, gf_error_to_string(e)));
+		} else {
+			M4_LOG(GF_LOG_INFO, ("Sample index cache %s is valid\n", idx_name));
+		}
+	}
+	gf_free(idx_name);
+	return e;
+}
+
 static u32 do_raw_cat()
 {
 	char chunk[4096];
@@ -6551,6 +6593,10 @@ int mp4box_main(int argc, char **argv)
 		e = hash_file(inName, dump_std);
 		if (e) goto err_exit;
 	}
+	if (do_sic) {
+		e = do_sample_index(inName);
+		if (e) goto err_exit;
+	}
 	if (do_bin_xml) {
 		e = xml_bs_to_bin(inName, outName, dump_std);
 		if (e) goto err_exit;
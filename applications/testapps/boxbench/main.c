@@ -0,0 +1,124 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - ISOBMFF box parsing benchmark
+ *
+ */
+
+#include <gpac/isomedia.h>
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: boxbench [options] FILE\n"
+	        "Measures the time needed to open and parse an ISOBMFF file, typically a fragmented file with many fragments\n"
+	        "Options:\n"
+	        "-rounds R     number of times the file is opened (default 10)\n"
+	        "-gen N        first write FILE as a fragmented file with N single-sample fragments\n"
+	        "\n"
+	       );
+}
+
+static GF_Err write_fragmented(const char *dst, u32 nb_frags)
+{
+	u32 i, track, track_id, di;
+	u8 data[16];
+	GF_Err e;
+	GF_ISOSample samp;
+	GF_GenericSampleDescription udesc;
+	GF_ISOFile *file = gf_isom_open(dst, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return GF_IO_ERR;
+
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_TEXT, 1000);
+	if (!track) {
+		gf_isom_delete(file);
+		return gf_isom_last_error(NULL);
+	}
+	track_id = gf_isom_get_track_id(file, track);
+	memset(&udesc, 0, sizeof(udesc));
+	udesc.codec_tag = GF_4CC('t','e','s','t');
+	e = gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di);
+	if (!e) e = gf_isom_setup_track_fragment(file, track_id, di, 10, 0, 1, 0, 0, GF_FALSE);
+	if (!e) e = gf_isom_finalize_for_fragment(file, 0, GF_TRUE);
+
+	memset(data, 0, sizeof(data));
+	memset(&samp, 0, sizeof(samp));
+	samp.data = data;
+	samp.dataLength = sizeof(data);
+	samp.IsRAP = RAP;
+	//each fragment is moof/mfhd/traf/tfhd/tfdt/trun/mdat
+	for (i=0; i<nb_frags && !e; i++) {
+		samp.DTS = i*10;
+		e = gf_isom_start_fragment(file, GF_ISOM_FRAG_MOOF_FIRST);
+		if (!e) e = gf_isom_fragment_add_sample(file, track_id, &samp, di, 10, 0, 0, GF_FALSE);
+	}
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	u32 r, nb_rounds = 10, nb_gen = 0, nb_samples = 0;
+	u64 start, t_open = 0, t_min = 0;
+	const char *src = NULL;
+
+	for (i=1; i<argc; i++) {
+		if (!strcmp(argv[i], "-rounds") && (i+1<argc)) {
+			nb_rounds = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-gen") && (i+1<argc)) {
+			nb_gen = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-h")) {
+			print_usage();
+			return 0;
+		} else {
+			src = argv[i];
+		}
+	}
+	if (!src) {
+		print_usage();
+		return 1;
+	}
+	if (!nb_rounds) nb_rounds = 1;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_sys_set_args(argc, (const char **) argv);
+
+	if (nb_gen) {
+		GF_Err e = write_fragmented(src, nb_gen);
+		if (e) {
+			fprintf(stderr, "Failed to write %s: %s\n", src, gf_error_to_string(e));
+			gf_sys_close();
+			return 1;
+		}
+	}
+
+	for (r=0; r<nb_rounds; r++) {
+		u32 t;
+		GF_ISOFile *file;
+		start = gf_sys_clock_high_res();
+		file = gf_isom_open(src, GF_ISOM_OPEN_READ, NULL);
+		start = gf_sys_clock_high_res() - start;
+		if (!file) {
+			fprintf(stderr, "Failed to open %s: %s\n", src, gf_error_to_string(gf_isom_last_error(NULL)));
+			gf_sys_close();
+			return 1;
+		}
+		nb_samples = 0;
+		for (t=0; t<gf_isom_get_track_count(file); t++)
+			nb_samples += gf_isom_get_sample_count(file, t+1);
+		gf_isom_close(file);
+		t_open += start;
+		if (!r || (start < t_min)) t_min = start;
+	}
+	fprintf(stdout, "%s: %u samples - open %.2f ms average - %.2f ms best\n", src, nb_samples,
+		(Double) t_open / nb_rounds / 1000, (Double) t_min / 1000);
+
+	gf_sys_close();
+	return 0;
+}
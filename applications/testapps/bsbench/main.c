@@ -0,0 +1,267 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - bitstream reader benchmark
+ *
+ */
+
+#include <gpac/internal/media_dev.h>
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: bsbench [options] FILE\n"
+	        "Measures bitstream reader speed on the slice NAL units of an AVC, HEVC or VVC Annex B file\n"
+	        "Slice headers are parsed with the media parsers, and slice payloads are read as Exp-Golomb codes and fixed-size fields\n"
+	        "using the bitstream reader and using a bit-by-bit reference reader\n"
+	        "Options:\n"
+	        "-codec C      force codec type, one of avc, hevc or vvc (default from file extension)\n"
+	        "-rounds R     number of passes over the slices (default 100)\n"
+	        "\n"
+	       );
+}
+
+enum
+{
+	BENCH_AVC=0,
+	BENCH_HEVC,
+	BENCH_VVC,
+};
+
+typedef struct
+{
+	u8 *data;
+	u32 size;
+	Bool is_slice;
+} BenchNAL;
+
+typedef struct
+{
+	u32 codec;
+	AVCState *avc;
+	HEVCState *hevc;
+	VVCState *vvc;
+} BenchParser;
+
+static Bool nal_is_slice(u32 codec, const u8 *data, u32 size)
+{
+	if (!size) return GF_FALSE;
+	switch (codec) {
+	case BENCH_AVC:
+	{
+		u8 type = data[0] & 0x1F;
+		return ((type>=GF_AVC_NALU_NON_IDR_SLICE) && (type<=GF_AVC_NALU_IDR_SLICE)) ? GF_TRUE : GF_FALSE;
+	}
+	case BENCH_HEVC:
+		return (((data[0] >> 1) & 0x3F) < 32) ? GF_TRUE : GF_FALSE;
+	case BENCH_VVC:
+		return ((size>1) && ((data[1] >> 3) < 12)) ? GF_TRUE : GF_FALSE;
+	}
+	return GF_FALSE;
+}
+
+static s32 parse_nal(BenchParser *p, BenchNAL *nal)
+{
+	s32 ret;
+	u8 type, tid, lid;
+	GF_BitStream *bs;
+	switch (p->codec) {
+	case BENCH_AVC:
+		bs = gf_bs_new(nal->data, nal->size, GF_BITSTREAM_READ);
+		ret = gf_avc_parse_nalu(bs, p->avc);
+		gf_bs_del(bs);
+		return ret;
+	case BENCH_HEVC:
+		return gf_hevc_parse_nalu(nal->data, nal->size, p->hevc, &type, &tid, &lid);
+	case BENCH_VVC:
+		return gf_vvc_parse_nalu(nal->data, nal->size, p->vvc, &type, &tid, &lid);
+	}
+	return -1;
+}
+
+//Exp-Golomb code read as done by the media parsers
+static GFINLINE u32 read_ue(GF_BitStream *bs)
+{
+	u32 nb_lead = gf_bs_read_leading_zeros(bs, 31);
+	if (!nb_lead) return 0;
+	return (1 << nb_lead) - 1 + gf_bs_read_int(bs, nb_lead);
+}
+
+//reference bit-by-bit reads
+static GFINLINE u32 read_bits_ref(GF_BitStream *bs, u32 nb_bits)
+{
+	u32 ret = 0;
+	while (nb_bits--) ret = (ret << 1) | gf_bs_read_int(bs, 1);
+	return ret;
+}
+
+static GFINLINE u32 read_ue_ref(GF_BitStream *bs)
+{
+	u32 nb_lead = 0;
+	while ((nb_lead < 31) && !gf_bs_read_int(bs, 1)) nb_lead++;
+	if (!nb_lead) return 0;
+	return (1 << nb_lead) - 1 + read_bits_ref(bs, nb_lead);
+}
+
+//read slice payloads (after the NAL header) until less than 8 bytes are left, returns the number of bits read
+static u64 read_payloads(BenchNAL *nals, u32 nb_nals, Bool golomb, Bool ref, u32 *crc)
+{
+	u32 i;
+	u64 nb_bits = 0;
+	for (i=0; i<nb_nals; i++) {
+		u32 width = 1;
+		GF_BitStream *bs;
+		if (!nals[i].is_slice) continue;
+		bs = gf_bs_new(nals[i].data, nals[i].size, GF_BITSTREAM_READ);
+		gf_bs_enable_emulation_byte_removal(bs, GF_TRUE);
+		gf_bs_skip_bytes(bs, 2);
+		while (gf_bs_available(bs) >= 8) {
+			u32 val;
+			if (golomb) {
+				val = ref ? read_ue_ref(bs) : read_ue(bs);
+			} else {
+				val = ref ? read_bits_ref(bs, width) : gf_bs_read_int(bs, width);
+				width = (width % 24) + 1;
+			}
+			*crc = *crc * 31 + val;
+		}
+		nb_bits += gf_bs_get_bit_offset(bs);
+		gf_bs_del(bs);
+	}
+	return nb_bits;
+}
+
+static void bench_payloads(BenchNAL *nals, u32 nb_nals, u32 nb_rounds, Bool golomb)
+{
+	u32 k, r;
+	u32 crc[2];
+	for (k=0; k<2; k++) {
+		u64 nb_bits = 0;
+		u64 start = gf_sys_clock_high_res();
+		crc[k] = 0;
+		for (r=0; r<nb_rounds; r++)
+			nb_bits += read_payloads(nals, nb_nals, golomb, k ? GF_TRUE : GF_FALSE, &crc[k]);
+		start = gf_sys_clock_high_res() - start;
+		fprintf(stdout, "%s %s: %.1f Mbits/s\n", golomb ? "Exp-Golomb codes" : "fixed-size fields 1 to 24 bits",
+			k ? "bit-by-bit reference" : "bitstream reader", start ? (Double) nb_bits / start : 0);
+	}
+	if (crc[0] != crc[1])
+		fprintf(stderr, "Error: bitstream reader and bit-by-bit reference values differ\n");
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	u32 codec = 0xFFFFFFFF, nb_rounds = 100;
+	u32 size, pos, nb_nals = 0, nb_slices = 0, nb_alloc = 0, nb_err = 0;
+	u64 start;
+	u8 *data;
+	const char *src = NULL;
+	BenchNAL *nals = NULL;
+	BenchParser p;
+
+	for (i=1; i<argc; i++) {
+		if (!strcmp(argv[i], "-codec") && (i+1<argc)) {
+			if (!strcmp(argv[i+1], "avc")) codec = BENCH_AVC;
+			else if (!strcmp(argv[i+1], "hevc")) codec = BENCH_HEVC;
+			else if (!strcmp(argv[i+1], "vvc")) codec = BENCH_VVC;
+			i++;
+		} else if (!strcmp(argv[i], "-rounds") && (i+1<argc)) {
+			nb_rounds = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-h")) {
+			print_usage();
+			return 0;
+		} else {
+			src = argv[i];
+		}
+	}
+	if (!src) {
+		print_usage();
+		return 1;
+	}
+	if (codec == 0xFFFFFFFF) {
+		const char *ext = gf_file_ext_start(src);
+		if (ext && (!stricmp(ext, ".hevc") || !stricmp(ext, ".265") || !stricmp(ext, ".h265") || !stricmp(ext, ".hvc"))) codec = BENCH_HEVC;
+		else if (ext && (!stricmp(ext, ".vvc") || !stricmp(ext, ".266") || !stricmp(ext, ".h266"))) codec = BENCH_VVC;
+		else codec = BENCH_AVC;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_sys_set_args(argc, (const char **) argv);
+
+	if (gf_file_load_data(src, &data, &size) != GF_OK) {
+		fprintf(stderr, "Failed to load %s\n", src);
+		gf_sys_close();
+		return 1;
+	}
+
+	//split Annex B stream
+	pos = 0;
+	while (pos < size) {
+		u32 sc_size = 0;
+		u32 sc_pos = gf_media_nalu_next_start_code(data+pos, size-pos, &sc_size);
+		u32 nal_start, nal_end;
+		if (sc_pos == size-pos) break;
+		nal_start = pos + sc_pos + sc_size;
+		nal_end = nal_start + gf_media_nalu_next_start_code(data+nal_start, size-nal_start, &sc_size);
+		if (nal_end > nal_start) {
+			if (nb_nals == nb_alloc) {
+				nb_alloc = nb_alloc ? 2*nb_alloc : 256;
+				nals = gf_realloc(nals, sizeof(BenchNAL) * nb_alloc);
+			}
+			nals[nb_nals].data = data + nal_start;
+			nals[nb_nals].size = nal_end - nal_start;
+			nals[nb_nals].is_slice = nal_is_slice(codec, nals[nb_nals].data, nals[nb_nals].size);
+			if (nals[nb_nals].is_slice) nb_slices++;
+			nb_nals++;
+		}
+		pos = nal_end;
+	}
+	if (!nb_slices) {
+		fprintf(stderr, "No slice found in %s\n", src);
+		gf_free(nals);
+		gf_free(data);
+		gf_sys_close();
+		return 1;
+	}
+
+	memset(&p, 0, sizeof(BenchParser));
+	p.codec = codec;
+	GF_SAFEALLOC(p.avc, AVCState);
+	GF_SAFEALLOC(p.hevc, HEVCState);
+	GF_SAFEALLOC(p.vvc, VVCState);
+	if (!p.avc || !p.hevc || !p.vvc) {
+		fprintf(stderr, "Out of memory\n");
+		nb_rounds = 0;
+	}
+
+	//load parameter sets
+	for (i=0; i<(int) nb_nals && nb_rounds; i++) {
+		if (parse_nal(&p, &nals[i]) < 0) nb_err++;
+	}
+	fprintf(stdout, "%s: %u NAL units - %u slices - %u parse errors\n", src, nb_nals, nb_slices, nb_err);
+
+	if (nb_rounds) {
+		u32 r;
+		start = gf_sys_clock_high_res();
+		for (r=0; r<nb_rounds; r++) {
+			for (i=0; i<(int) nb_nals; i++) {
+				if (nals[i].is_slice) parse_nal(&p, &nals[i]);
+			}
+		}
+		start = gf_sys_clock_high_res() - start;
+		fprintf(stdout, "slice headers: %.1f ns per slice\n", (Double) start * 1000 / nb_rounds / nb_slices);
+
+		bench_payloads(nals, nb_nals, nb_rounds, GF_TRUE);
+		bench_payloads(nals, nb_nals, nb_rounds, GF_FALSE);
+	}
+
+	if (p.avc) gf_free(p.avc);
+	if (p.hevc) gf_free(p.hevc);
+	if (p.vvc) gf_free(p.vvc);
+	gf_free(nals);
+	gf_free(data);
+	gf_sys_close();
+	return 0;
+}
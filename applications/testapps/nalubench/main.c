@@ -0,0 +1,152 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - NAL unit scanning benchmark
+ *
+ */
+
+#include <gpac/internal/media_dev.h>
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: nalubench [options] FILE\n"
+	        "Measures start code scanning and emulation prevention byte removal speed on an Annex B file (AVC, HEVC or VVC)\n"
+	        "using the media tools and using a byte-by-byte reference implementation\n"
+	        "Options:\n"
+	        "-rounds R     number of passes over the file (default 20)\n"
+	        "\n"
+	       );
+}
+
+//byte-by-byte start code scan
+static u32 next_start_code_ref(const u8 *data, u32 data_len, u32 *sc_size)
+{
+	u32 i, v = 0xffffffff;
+	for (i=0; i<data_len; i++) {
+		v = (v<<8) | data[i];
+		if ((v & 0x00FFFFFF) == 0x00000001) {
+			*sc_size = ((v == 0x00000001) && (i>=3)) ? 4 : 3;
+			return i + 1 - *sc_size;
+		}
+	}
+	return data_len;
+}
+
+//byte-by-byte emulation prevention byte removal
+static u32 remove_emulation_bytes_ref(const u8 *src, u8 *dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+	while (i < nal_size) {
+		if ((num_zero == 2) && (src[i] == 0x03) && (i + 1 < nal_size) && (src[i + 1] < 0x04)) {
+			num_zero = 0;
+			emulation_bytes_count++;
+			i++;
+		}
+		dst[i - emulation_bytes_count] = src[i];
+		if (!src[i]) num_zero++;
+		else num_zero = 0;
+		i++;
+	}
+	return nal_size - emulation_bytes_count;
+}
+
+typedef u32 (*next_sc_fn)(const u8 *data, u32 data_len, u32 *sc_size);
+typedef u32 (*remove_epb_fn)(const u8 *src, u8 *dst, u32 nal_size);
+
+//splits the stream in NAL units, removes emulation prevention bytes in each of them, returns a checksum of the payloads
+static u32 scan_file(const u8 *data, u32 size, u8 *dst, next_sc_fn next_sc, remove_epb_fn remove_epb, u32 *nb_nals, u64 *t_scan, u64 *t_epb)
+{
+	u32 pos = 0, crc = 0;
+	u64 start;
+	while (pos < size) {
+		u32 j, sc_size = 0, sc_pos, nal_start, nal_end, nal_size;
+		start = gf_sys_clock_high_res();
+		sc_pos = next_sc(data+pos, size-pos, &sc_size);
+		if (sc_pos == size-pos) {
+			*t_scan += gf_sys_clock_high_res() - start;
+			break;
+		}
+		nal_start = pos + sc_pos + sc_size;
+		nal_end = nal_start + next_sc(data+nal_start, size-nal_start, &sc_size);
+		*t_scan += gf_sys_clock_high_res() - start;
+		pos = nal_end;
+		if (nal_end == nal_start) continue;
+
+		start = gf_sys_clock_high_res();
+		nal_size = remove_epb(data+nal_start, dst, nal_end - nal_start);
+		*t_epb += gf_sys_clock_high_res() - start;
+		(*nb_nals)++;
+		crc = crc * 31 + nal_size;
+		for (j=0; j<nal_size; j+=64) crc = crc * 31 + dst[j];
+	}
+	return crc;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	u32 r, k, size, nb_rounds = 20;
+	u32 crc[2];
+	u8 *data, *dst;
+	const char *src = NULL;
+
+	for (i=1; i<argc; i++) {
+		if (!strcmp(argv[i], "-rounds") && (i+1<argc)) {
+			nb_rounds = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-h")) {
+			print_usage();
+			return 0;
+		} else {
+			src = argv[i];
+		}
+	}
+	if (!src) {
+		print_usage();
+		return 1;
+	}
+	if (!nb_rounds) nb_rounds = 1;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_sys_set_args(argc, (const char **) argv);
+
+	if (gf_file_load_data(src, &data, &size) != GF_OK) {
+		fprintf(stderr, "Failed to load %s\n", src);
+		gf_sys_close();
+		return 1;
+	}
+	dst = gf_malloc(size ? size : 1);
+	if (!dst) {
+		fprintf(stderr, "Out of memory\n");
+		gf_free(data);
+		gf_sys_close();
+		return 1;
+	}
+
+	for (k=0; k<2; k++) {
+		u32 nb_nals = 0;
+		u64 t_scan = 0, t_epb = 0;
+		crc[k] = 0;
+		for (r=0; r<nb_rounds; r++) {
+			nb_nals = 0;
+			crc[k] = scan_file(data, size, dst,
+				k ? next_start_code_ref : gf_media_nalu_next_start_code,
+				k ? remove_emulation_bytes_ref : gf_media_nalu_remove_emulation_bytes,
+				&nb_nals, &t_scan, &t_epb);
+		}
+		if (!k) fprintf(stdout, "%s: %u bytes - %u NAL units\n", src, size, nb_nals);
+		fprintf(stdout, "%s: start codes %.1f MB/s - emulation prevention bytes %.1f MB/s\n",
+			k ? "byte-by-byte reference" : "media tools",
+			t_scan ? (Double) size * nb_rounds / t_scan : 0,
+			t_epb ? (Double) size * nb_rounds / t_epb : 0);
+	}
+	if (crc[0] != crc[1])
+		fprintf(stderr, "Error: media tools and byte-by-byte reference results differ\n");
+
+	gf_free(dst);
+	gf_free(data);
+	gf_sys_close();
+	return (crc[0] != crc[1]) ? 1 : 0;
+}
@@ -0,0 +1,414 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - socket group benchmark
+ *
+ */
+
+#include <gpac/network.h>
+
+#if !defined(WIN32)
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: netbench [options]\n"
+	        "Measures socket group wake-up cost with many idle UDP sockets or TCP connections on the loopback, a few of them receiving data at each round\n"
+	        "With -mcast, measures reception of bursts of datagrams on a loopback multicast socket, one datagram per call or batched\n"
+	        "Options:\n"
+	        "-n N          number of sockets in the group (default 1000)\n"
+	        "-active K     number of sockets receiving a datagram at each round (default 16)\n"
+	        "-rounds R     number of rounds (default 2000)\n"
+	        "-port P       first UDP port to use (default 20000)\n"
+	        "-tcp          use TCP connections instead of UDP sockets\n"
+	        "-mcast IP     run the multicast benchmark on group IP (e.g. 234.1.1.1)\n"
+	        "-burst B      number of datagrams sent per round in multicast mode (default 64)\n"
+	        "-no-epoll     use poll instead of epoll for socket groups\n"
+	        "-no-poll      use select instead of poll/epoll for socket groups (limited to FD_SETSIZE sockets)\n"
+	        "\n"
+	       );
+}
+
+#if !defined(WIN32)
+
+static u32 rand_state = 1;
+static u32 bench_rand(u32 max)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+	return (rand_state >> 8) % max;
+}
+
+static int group_bench(u32 nb_socks, u32 nb_active, u32 nb_rounds, u16 port)
+{
+	u32 i, r, nb_recv = 0, nb_select = 0;
+	u64 start, select_time = 0, scan_time = 0;
+	u8 buf[1500];
+	GF_Socket **socks, *sock;
+	u16 *ports;
+	struct sockaddr_in dst;
+	GF_SockGroup *sg;
+	int sender;
+	struct rlimit rl;
+
+	//we need one descriptor per socket
+	if (!getrlimit(RLIMIT_NOFILE, &rl) && (rl.rlim_cur < nb_socks + 64)) {
+		rl.rlim_cur = (rl.rlim_max < nb_socks + 64) ? rl.rlim_max : nb_socks + 64;
+		setrlimit(RLIMIT_NOFILE, &rl);
+	}
+
+	socks = gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	ports = gf_malloc(sizeof(u16) * nb_socks);
+	sg = gf_sk_group_new();
+	for (i=0; i<nb_socks; i++) {
+		GF_Err e = GF_OUT_OF_MEM;
+		//skip ports already in use
+		while (port < 0xFFFF) {
+			socks[i] = gf_sk_new(GF_SOCK_TYPE_UDP);
+			if (!socks[i]) break;
+			e = gf_sk_bind(socks[i], "127.0.0.1", port, NULL, 0, 0);
+			ports[i] = port++;
+			if (!e) break;
+			gf_sk_del(socks[i]);
+			socks[i] = NULL;
+		}
+		if (!socks[i]) {
+			fprintf(stderr, "Failed to create socket %u: %s\n", i+1, gf_error_to_string(e));
+			nb_socks = i;
+			break;
+		}
+		gf_sk_set_block_mode(socks[i], GF_TRUE);
+		gf_sk_group_register(sg, socks[i]);
+	}
+	if (!nb_socks) {
+		gf_sk_group_del(sg);
+		gf_free(socks);
+		gf_free(ports);
+		return 1;
+	}
+	if (nb_active > nb_socks) nb_active = nb_socks;
+
+	sender = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&dst, 0, sizeof(dst));
+	dst.sin_family = AF_INET;
+	dst.sin_addr.s_addr = inet_addr("127.0.0.1");
+	memset(buf, 0, sizeof(buf));
+
+	for (r=0; r<nb_rounds; r++) {
+		u32 nb_pending = nb_active;
+		for (i=0; i<nb_active; i++) {
+			dst.sin_port = htons(ports[bench_rand(nb_socks)]);
+			sendto(sender, buf, 188, 0, (struct sockaddr *) &dst, sizeof(dst));
+		}
+		//a socket may be picked several times, count datagrams not wake-ups
+		while (nb_pending) {
+			GF_Err e;
+			start = gf_sys_clock_high_res();
+			e = gf_sk_group_select(sg, 10000, GF_SK_SELECT_READ);
+			select_time += gf_sys_clock_high_res() - start;
+			nb_select++;
+			if (e) {
+				if (e==GF_IP_NETWORK_EMPTY) continue;
+				fprintf(stderr, "Select failed: %s\n", gf_error_to_string(e));
+				nb_pending = 0;
+				break;
+			}
+			start = gf_sys_clock_high_res();
+			i=0;
+			while ((sock = gf_sk_group_get_ready(sg, &i, GF_SK_SELECT_READ))) {
+				u32 read;
+				while (gf_sk_receive_no_select(sock, buf, sizeof(buf), &read) == GF_OK) {
+					nb_recv++;
+					if (nb_pending) nb_pending--;
+				}
+			}
+			scan_time += gf_sys_clock_high_res() - start;
+		}
+	}
+	close(sender);
+
+	fprintf(stdout, "%u sockets - %u active per round - %u rounds - %u datagrams received\n", nb_socks, nb_active, nb_rounds, nb_recv);
+	fprintf(stdout, "select: %u calls - %.2f us per call\n", nb_select, nb_select ? (Double) select_time / nb_select : 0);
+	fprintf(stdout, "scan and read: %.2f us per select\n", nb_select ? (Double) scan_time / nb_select : 0);
+	fprintf(stdout, "total: %.2f us per round\n", nb_rounds ? (Double) (select_time + scan_time) / nb_rounds : 0);
+
+	for (i=0; i<nb_socks; i++) {
+		gf_sk_group_unregister(sg, socks[i]);
+		gf_sk_del(socks[i]);
+	}
+	gf_sk_group_del(sg);
+	gf_free(socks);
+	gf_free(ports);
+	return 0;
+}
+
+#define TCP_MAX_SEND	6000
+
+//same as group_bench with TCP connections: each active connection receives a random amount of data, read until a short read or would block
+static int tcp_bench(u32 nb_socks, u32 nb_active, u32 nb_rounds, u16 port)
+{
+	u32 i, r, nb_select = 0, nb_reads = 0;
+	u64 start, select_time = 0, scan_time = 0, nb_sent = 0, nb_recv = 0;
+	u8 buf[1500], data[TCP_MAX_SEND];
+	int *clients;
+	GF_Socket **socks, *sock, *listener;
+	struct sockaddr_in dst;
+	GF_SockGroup *sg;
+	GF_Err e;
+	struct rlimit rl;
+	int ret = 0;
+
+	//we need two descriptors per connection
+	if (!getrlimit(RLIMIT_NOFILE, &rl) && (rl.rlim_cur < 2*nb_socks + 64)) {
+		rl.rlim_cur = (rl.rlim_max < 2*nb_socks + 64) ? rl.rlim_max : 2*nb_socks + 64;
+		setrlimit(RLIMIT_NOFILE, &rl);
+	}
+
+	listener = gf_sk_new(GF_SOCK_TYPE_TCP);
+	if (!listener) return 1;
+	e = gf_sk_bind(listener, "127.0.0.1", port, NULL, 0, GF_SOCK_REUSE_PORT);
+	if (!e) e = gf_sk_listen(listener, 0);
+	if (e) {
+		fprintf(stderr, "Failed to listen on port %d: %s\n", port, gf_error_to_string(e));
+		gf_sk_del(listener);
+		return 1;
+	}
+
+	clients = gf_malloc(sizeof(int) * nb_socks);
+	socks = gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	sg = gf_sk_group_new();
+	memset(&dst, 0, sizeof(dst));
+	dst.sin_family = AF_INET;
+	dst.sin_addr.s_addr = inet_addr("127.0.0.1");
+	dst.sin_port = htons(port);
+	for (i=0; i<nb_socks; i++) {
+		socks[i] = NULL;
+		clients[i] = socket(AF_INET, SOCK_STREAM, 0);
+		if ((clients[i]<0) || connect(clients[i], (struct sockaddr *) &dst, sizeof(dst))) {
+			e = GF_IP_CONNECTION_FAILURE;
+		} else {
+			e = gf_sk_accept(listener, &socks[i]);
+			if (!e && !socks[i]) e = GF_IP_NETWORK_EMPTY;
+		}
+		if (e) {
+			fprintf(stderr, "Failed to create connection %u: %s\n", i+1, gf_error_to_string(e));
+			if (clients[i]>=0) close(clients[i]);
+			nb_socks = i;
+			break;
+		}
+		gf_sk_set_block_mode(socks[i], GF_TRUE);
+		gf_sk_group_register(sg, socks[i]);
+	}
+	if (nb_active > nb_socks) nb_active = nb_socks;
+	memset(data, 0, sizeof(data));
+
+	for (r=0; (r<nb_rounds) && nb_socks; r++) {
+		u64 pending = 0, last_recv = gf_sys_clock_high_res();
+		for (i=0; i<nb_active; i++) {
+			//multiples of the read size exercise the would block path, others the short read path
+			u32 size = (bench_rand(2) ? sizeof(buf) : 1) * (1 + bench_rand(TCP_MAX_SEND / sizeof(buf)));
+			s32 res = (s32) send(clients[bench_rand(nb_socks)], data, size, 0);
+			if (res>0) pending += res;
+		}
+		nb_sent += pending;
+		while (pending) {
+			start = gf_sys_clock_high_res();
+			e = gf_sk_group_select(sg, 10000, GF_SK_SELECT_READ);
+			select_time += gf_sys_clock_high_res() - start;
+			nb_select++;
+			if (e) {
+				//data is pending but no socket reported ready
+				if ((e==GF_IP_NETWORK_EMPTY) && (gf_sys_clock_high_res() - last_recv < 1000000)) continue;
+				fprintf(stderr, "Select failed with "LLU" bytes pending: %s\n", pending, gf_error_to_string(e));
+				ret = 1;
+				break;
+			}
+			start = gf_sys_clock_high_res();
+			i=0;
+			while ((sock = gf_sk_group_get_ready(sg, &i, GF_SK_SELECT_READ))) {
+				u32 read;
+				while (gf_sk_receive_no_select(sock, buf, sizeof(buf), &read) == GF_OK) {
+					nb_reads++;
+					nb_recv += read;
+					pending = (pending>read) ? pending-read : 0;
+					if (read < sizeof(buf)) break;
+				}
+			}
+			scan_time += gf_sys_clock_high_res() - start;
+			last_recv = gf_sys_clock_high_res();
+		}
+		if (ret) break;
+	}
+
+	fprintf(stdout, "%u connections - %u active per round - %u rounds - "LLU" bytes sent - "LLU" bytes received in %u reads\n", nb_socks, nb_active, r, nb_sent, nb_recv, nb_reads);
+	fprintf(stdout, "select: %u calls - %.2f us per call\n", nb_select, nb_select ? (Double) select_time / nb_select : 0);
+	fprintf(stdout, "scan and read: %.2f us per select\n", nb_select ? (Double) scan_time / nb_select : 0);
+	fprintf(stdout, "total: %.2f us per round\n", r ? (Double) (select_time + scan_time) / r : 0);
+	if (nb_recv != nb_sent) ret = 1;
+
+	for (i=0; i<nb_socks; i++) {
+		gf_sk_group_unregister(sg, socks[i]);
+		gf_sk_del(socks[i]);
+		close(clients[i]);
+	}
+	gf_sk_group_del(sg);
+	gf_sk_del(listener);
+	gf_free(socks);
+	gf_free(clients);
+	return ret;
+}
+
+#define MCAST_BATCH	32
+#define MCAST_SIZE	1316
+
+//receive all pending datagrams, one per call or in batches, returns number of datagrams read
+static u32 mcast_drain(GF_Socket *sock, Bool batch, GF_SockDatagram *slots, u32 *nb_calls)
+{
+	u32 nb_recv = 0;
+	while (1) {
+		u32 read;
+		GF_Err e;
+		(*nb_calls)++;
+		if (batch) {
+			e = gf_sk_receive_batch(sock, slots, MCAST_BATCH, &read);
+			if (e) break;
+			nb_recv += read;
+		} else {
+			e = gf_sk_receive_no_select(sock, slots[0].buffer, slots[0].size, &read);
+			if (e) break;
+			nb_recv++;
+		}
+	}
+	return nb_recv;
+}
+
+static int mcast_bench(const char *mcast_ip, u32 nb_rounds, u32 burst, u16 port)
+{
+	u32 i, r, k;
+	GF_Err e;
+	u8 buf[MCAST_SIZE];
+	GF_SockDatagram slots[MCAST_BATCH];
+	struct sockaddr_in dst;
+	struct in_addr ifce;
+	GF_Socket *sock;
+	int sender, rcvbuf = 4*1024*1024;
+	u8 loop = 1;
+
+	sock = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (!sock) return 1;
+	e = gf_sk_setup_multicast(sock, mcast_ip, port, 0, GF_FALSE, "127.0.0.1");
+	if (e) {
+		fprintf(stderr, "Failed to join multicast group %s:%d: %s\n", mcast_ip, port, gf_error_to_string(e));
+		gf_sk_del(sock);
+		return 1;
+	}
+	gf_sk_set_buffer_size(sock, GF_FALSE, rcvbuf);
+	gf_sk_set_block_mode(sock, GF_TRUE);
+
+	sender = socket(AF_INET, SOCK_DGRAM, 0);
+	ifce.s_addr = inet_addr("127.0.0.1");
+	setsockopt(sender, IPPROTO_IP, IP_MULTICAST_IF, &ifce, sizeof(ifce));
+	setsockopt(sender, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+	memset(&dst, 0, sizeof(dst));
+	dst.sin_family = AF_INET;
+	dst.sin_addr.s_addr = inet_addr(mcast_ip);
+	dst.sin_port = htons(port);
+	memset(buf, 0, sizeof(buf));
+
+	for (i=0; i<MCAST_BATCH; i++) {
+		slots[i].buffer = gf_malloc(MCAST_SIZE);
+		slots[i].size = MCAST_SIZE;
+	}
+
+	//alternate single and batched rounds so that both modes see the same conditions
+	for (k=0; k<2; k++) {
+		u32 nb_recv = 0, nb_calls = 0;
+		u64 start, recv_time = 0;
+		for (r=0; r<nb_rounds; r++) {
+			u32 nb_sent = 0, nb_got = 0;
+			for (i=0; i<burst; i++) {
+				if (sendto(sender, buf, MCAST_SIZE, 0, (struct sockaddr *) &dst, sizeof(dst)) == MCAST_SIZE)
+					nb_sent++;
+			}
+			//loopback delivery is synchronous with sendto, but allow late datagrams
+			start = gf_sys_clock_high_res();
+			while (nb_got < nb_sent) {
+				u32 got = mcast_drain(sock, k ? GF_TRUE : GF_FALSE, slots, &nb_calls);
+				if (!got && (gf_sys_clock_high_res() - start > 100000)) break;
+				nb_got += got;
+			}
+			recv_time += gf_sys_clock_high_res() - start;
+			nb_recv += nb_got;
+		}
+		fprintf(stdout, "%s: %u datagrams of %d bytes in %u calls - %.3f us per datagram - %.1f kdatagrams/s\n",
+			k ? "recvmmsg batch" : "single receive", nb_recv, MCAST_SIZE, nb_calls,
+			nb_recv ? (Double) recv_time / nb_recv : 0, recv_time ? (Double) nb_recv * 1000 / recv_time : 0);
+	}
+	close(sender);
+	for (i=0; i<MCAST_BATCH; i++)
+		gf_free(slots[i].buffer);
+	gf_sk_del(sock);
+	return 0;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+	int i, ret;
+	u32 nb_socks = 1000, nb_active = 16, nb_rounds = 2000;
+	u32 burst = 64;
+	u16 port = 20000;
+	const char *mcast_ip = NULL;
+	Bool use_tcp = GF_FALSE;
+
+	for (i=1; i<argc; i++) {
+		if (!strcmp(argv[i], "-n") && (i+1<argc)) {
+			nb_socks = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-active") && (i+1<argc)) {
+			nb_active = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-rounds") && (i+1<argc)) {
+			nb_rounds = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-port") && (i+1<argc)) {
+			port = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-mcast") && (i+1<argc)) {
+			mcast_ip = argv[i+1];
+			i++;
+		} else if (!strcmp(argv[i], "-burst") && (i+1<argc)) {
+			burst = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-tcp")) {
+			use_tcp = GF_TRUE;
+		} else if (!strcmp(argv[i], "-h")) {
+			print_usage();
+			return 0;
+		}
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	//-no-epoll and -no-poll are handled by libgpac
+	gf_sys_set_args(argc, (const char **) argv);
+
+#if defined(WIN32)
+	fprintf(stderr, "netbench is not supported on this platform\n");
+	ret = 1;
+#else
+	if (mcast_ip)
+		ret = mcast_bench(mcast_ip, nb_rounds, burst, port);
+	else if (use_tcp)
+		ret = tcp_bench(nb_socks, nb_active, nb_rounds, port);
+	else
+		ret = group_bench(nb_socks, nb_active, nb_rounds, port);
+#endif
+
+	gf_sys_close();
+	return ret;
+}
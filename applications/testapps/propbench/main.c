@@ -0,0 +1,206 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - packet property benchmark
+ *
+ */
+
+#include <gpac/filters.h>
+#include <gpac/list.h>
+#include <gpac/thread.h>
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: propbench [options]\n"
+	        "Measures packet property lookup and merge speed, compared with a list of properties as used before property arrays\n"
+	        "Options:\n"
+	        "-props N      number of built-in properties per packet (default 12)\n"
+	        "-names N      number of named properties per packet (default 4, max 16)\n"
+	        "-lookups N    number of lookups (default 2000000)\n"
+	        "-merges N     number of packet merges (default 200000)\n"
+	        "\n"
+	       );
+}
+
+//names are not copied by gf_filter_pck_set_property_str
+static const char *prop_names[16] = {
+	"bench_prop_0", "bench_prop_1", "bench_prop_2", "bench_prop_3", "bench_prop_4", "bench_prop_5", "bench_prop_6", "bench_prop_7",
+	"bench_prop_8", "bench_prop_9", "bench_prop_10", "bench_prop_11", "bench_prop_12", "bench_prop_13", "bench_prop_14", "bench_prop_15"
+};
+
+//list entry as used before property arrays
+typedef struct
+{
+	u32 p4cc;
+	const char *pname;
+	GF_PropertyValue prop;
+	u32 reference_count;
+} ListProp;
+
+static const ListProp *list_find(GF_List *list, u32 p4cc, const char *name)
+{
+	u32 i, count = gf_list_count(list);
+	for (i=0; i<count; i++) {
+		const ListProp *p = gf_list_get(list, i);
+		if (p4cc) {
+			if (p->p4cc==p4cc) return p;
+		} else if (p->pname && !strcmp(p->pname, name)) {
+			return p;
+		}
+	}
+	return NULL;
+}
+
+static void list_merge(GF_List *dst, GF_List *src)
+{
+	u32 i, count = gf_list_count(src);
+	for (i=0; i<count; i++) {
+		ListProp *p = gf_list_get(src, i);
+		safe_int_inc(&p->reference_count);
+		gf_list_add(dst, p);
+	}
+}
+
+static void list_reset(GF_List *list)
+{
+	while (gf_list_count(list)) {
+		ListProp *p = gf_list_pop_back(list);
+		safe_int_dec(&p->reference_count);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	GF_Err e;
+	u32 j, idx, nb_4cc = 12, nb_names = 4, nb_props, nb_lookups = 2000000, nb_merges = 200000, nb_miss = 0;
+	u64 start, t_list, t_pck;
+	u8 *data;
+	GF_PropertyValue val;
+	GF_List *list, *dst_list;
+	ListProp *lprops;
+	GF_FilterSession *fs;
+	GF_Filter *f;
+	GF_FilterPid *pid;
+	GF_FilterPacket *pck, *dst;
+
+	for (i=1; i<argc; i++) {
+		if (!strcmp(argv[i], "-props") && (i+1<argc)) {
+			nb_4cc = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-names") && (i+1<argc)) {
+			nb_names = atoi(argv[i+1]);
+			if (nb_names>16) nb_names = 16;
+			i++;
+		} else if (!strcmp(argv[i], "-lookups") && (i+1<argc)) {
+			nb_lookups = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(argv[i], "-merges") && (i+1<argc)) {
+			nb_merges = atoi(argv[i+1]);
+			i++;
+		} else {
+			print_usage();
+			return !strcmp(argv[i], "-h") ? 0 : 1;
+		}
+	}
+	nb_props = nb_4cc + nb_names;
+	if (!nb_props) {
+		print_usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_sys_set_args(argc, (const char **) argv);
+
+	fs = gf_fs_new_defaults(0);
+	f = fs ? gf_fs_new_filter(fs, "propbench", 0, &e) : NULL;
+	pid = f ? gf_filter_pid_new(f) : NULL;
+	pck = pid ? gf_filter_pck_new_alloc(pid, 1, &data) : NULL;
+	lprops = gf_malloc(sizeof(ListProp) * nb_props);
+	if (!pck || !lprops) {
+		fprintf(stderr, "Failed to setup filter session\n");
+		if (fs) gf_fs_del(fs);
+		if (lprops) gf_free(lprops);
+		gf_sys_close();
+		return 1;
+	}
+
+	list = gf_list_new();
+	memset(&val, 0, sizeof(val));
+	memset(lprops, 0, sizeof(ListProp) * nb_props);
+	val.type = GF_PROP_UINT;
+	for (j=0; j<nb_props; j++) {
+		val.value.uint = j;
+		if (j<nb_4cc) {
+			lprops[j].p4cc = GF_4CC('b', 'p', 'a' + (j/26)%26, 'a' + (j%26));
+			gf_filter_pck_set_property(pck, lprops[j].p4cc, &val);
+		} else {
+			lprops[j].pname = prop_names[j-nb_4cc];
+			gf_filter_pck_set_property_str(pck, lprops[j].pname, &val);
+		}
+		lprops[j].prop = val;
+		lprops[j].reference_count = 1;
+		gf_list_add(list, &lprops[j]);
+	}
+
+	//lookups cycle through all properties and a missing one
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_lookups; j++) {
+		idx = j % (nb_props+1);
+		if (idx==nb_props) {
+			if (!list_find(list, GF_4CC('b','p','z','z'), NULL)) nb_miss++;
+		} else if (!list_find(list, lprops[idx].p4cc, lprops[idx].pname)) {
+			nb_miss++;
+		}
+	}
+	t_list = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_lookups; j++) {
+		const GF_PropertyValue *p;
+		idx = j % (nb_props+1);
+		if (idx==nb_props) p = gf_filter_pck_get_property(pck, GF_4CC('b','p','z','z'));
+		else if (lprops[idx].p4cc) p = gf_filter_pck_get_property(pck, lprops[idx].p4cc);
+		else p = gf_filter_pck_get_property_str(pck, lprops[idx].pname);
+		if (!p) nb_miss++;
+	}
+	t_pck = gf_sys_clock_high_res() - start;
+	if (nb_miss != 2 * (nb_lookups / (nb_props+1)))
+		fprintf(stderr, "Error: unexpected lookup misses %u\n", nb_miss);
+
+	fprintf(stdout, "%u properties - lookups per second: list %.1f M - packet %.1f M\n", nb_props,
+		t_list ? (Double) nb_lookups / t_list : 0,
+		t_pck ? (Double) nb_lookups / t_pck : 0);
+
+	//merge into new packets, as done by filters forwarding packet properties
+	dst_list = gf_list_new();
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_merges; j++) {
+		dst = gf_filter_pck_new_alloc(pid, 1, &data);
+		list_merge(dst_list, list);
+		list_reset(dst_list);
+		gf_filter_pck_discard(dst);
+	}
+	t_list = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (j=0; j<nb_merges; j++) {
+		dst = gf_filter_pck_new_alloc(pid, 1, &data);
+		gf_filter_pck_merge_properties(pck, dst);
+		gf_filter_pck_discard(dst);
+	}
+	t_pck = gf_sys_clock_high_res() - start;
+
+	fprintf(stdout, "%u properties - merges per second, including packet allocation: list %.1f k - packet %.1f k\n", nb_props,
+		t_list ? (Double) nb_merges * 1000 / t_list : 0,
+		t_pck ? (Double) nb_merges * 1000 / t_pck : 0);
+
+	gf_list_del(dst_list);
+	gf_list_del(list);
+	gf_free(lprops);
+	gf_filter_pck_discard(pck);
+	gf_fs_del(fs);
+	gf_sys_close();
+	return 0;
+}
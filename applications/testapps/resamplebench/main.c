@@ -0,0 +1,148 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC - audio resampler benchmark
+ *
+ */
+
+#include <gpac/filters.h>
+#include <math.h>
+
+//GF_PI is single precision
+#define BENCH_PI	3.14159265358979323846
+
+static void print_usage()
+{
+	fprintf(stdout,
+	        "Usage: resamplebench [options]\n"
+	        "Measures speed and quality of the resample filter on a mono float sine, in linear (audio mixer) and sinc modes\n"
+	        "SNR is measured against the ideal output sine, after least-square fit of amplitude and phase\n"
+	        "Options:\n"
+	        "-sr N         input sample rate (default 48000)\n"
+	        "-osr N        output sample rate (default 44100)\n"
+	        "-freq N       sine frequency in Hz (default 1000)\n"
+	        "-dur N        duration in seconds (default 10)\n"
+	        "-taps N       taps per phase in sinc mode (default filter value)\n"
+	        "\n"
+	       );
+}
+
+static GF_Err make_input(const char *name, u32 sr, u32 freq, u32 nb_samples)
+{
+	u32 i;
+	FILE *f = gf_fopen(name, "wb");
+	if (!f) return GF_IO_ERR;
+	for (i=0; i<nb_samples; i++) {
+		Float v = (Float) (0.5 * sin(2 * BENCH_PI * freq * i / sr));
+		gf_fwrite(&v, sizeof(Float), f);
+	}
+	gf_fclose(f);
+	return GF_OK;
+}
+
+//runs a resampling session, returns run time in us or 0 if failure
+static u64 run_session(const char *in, const char *out, u32 sr, u32 osr, const char *mode, u32 taps)
+{
+	GF_Err e;
+	u64 start;
+	char args[GF_MAX_PATH];
+	GF_FilterSession *fs = gf_fs_new_defaults(0);
+	if (!fs) return 0;
+
+	snprintf(args, GF_MAX_PATH, "%s:sr=%u:safmt=flt:ch=1", in, sr);
+	gf_fs_load_source(fs, args, NULL, NULL, &e);
+	if (!e) {
+		if (taps) snprintf(args, GF_MAX_PATH, "resample:osr=%u:osfmt=flt:mode=%s:taps=%u", osr, mode, taps);
+		else snprintf(args, GF_MAX_PATH, "resample:osr=%u:osfmt=flt:mode=%s", osr, mode);
+		gf_fs_load_filter(fs, args, &e);
+	}
+	if (!e) gf_fs_load_destination(fs, out, NULL, NULL, &e);
+	if (e) {
+		gf_fs_del(fs);
+		return 0;
+	}
+	start = gf_sys_clock_high_res();
+	e = gf_fs_run(fs);
+	start = gf_sys_clock_high_res() - start;
+	gf_fs_del(fs);
+	if (e && (e != GF_EOS)) return 0;
+	return start ? start : 1;
+}
+
+static Double get_snr(const Float *out, u32 nb_out, u32 osr, u32 freq)
+{
+	u32 i, skip = 256;
+	Double ss=0, cc=0, sc=0, sy=0, cy=0, a, b, sig=0, err=0;
+	for (i=skip; i+skip<nb_out; i++) {
+		Double s = sin(2 * BENCH_PI * freq * i / osr);
+		Double c = cos(2 * BENCH_PI * freq * i / osr);
+		ss += s*s;
+		cc += c*c;
+		sc += s*c;
+		sy += s*out[i];
+		cy += c*out[i];
+	}
+	if (ss*cc == sc*sc) return 0;
+	a = (sy*cc - cy*sc) / (ss*cc - sc*sc);
+	b = (cy*ss - sy*sc) / (ss*cc - sc*sc);
+	for (i=skip; i+skip<nb_out; i++) {
+		Double fit = a * sin(2 * BENCH_PI * freq * i / osr) + b * cos(2 * BENCH_PI * freq * i / osr);
+		sig += fit*fit;
+		err += (out[i]-fit) * (out[i]-fit);
+	}
+	return err ? 10 * log10(sig / err) : 1000;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	u32 k, sr = 48000, osr = 44100, freq = 1000, dur = 10, taps = 0, nb_in;
+	int ret = 0;
+	const char *modes[2] = {"lin", "sinc"};
+	const char *in_name = "resamplebench_in.pcm";
+	const char *out_name = "resamplebench_out.flt";
+
+	for (i=1; i<argc; i++) {
+		if ((i+1<argc) && !strcmp(argv[i], "-sr")) sr = atoi(argv[++i]);
+		else if ((i+1<argc) && !strcmp(argv[i], "-osr")) osr = atoi(argv[++i]);
+		else if ((i+1<argc) && !strcmp(argv[i], "-freq")) freq = atoi(argv[++i]);
+		else if ((i+1<argc) && !strcmp(argv[i], "-dur")) dur = atoi(argv[++i]);
+		else if ((i+1<argc) && !strcmp(argv[i], "-taps")) taps = atoi(argv[++i]);
+		else {
+			print_usage();
+			return !strcmp(argv[i], "-h") ? 0 : 1;
+		}
+	}
+	if (!sr || !osr || !dur) {
+		print_usage();
+		return 1;
+	}
+	nb_in = sr * dur;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_sys_set_args(argc, (const char **) argv);
+
+	if (make_input(in_name, sr, freq, nb_in) != GF_OK) {
+		fprintf(stderr, "Failed to write %s\n", in_name);
+		gf_sys_close();
+		return 1;
+	}
+	fprintf(stdout, "%u -> %u Hz, %u Hz sine, %u s\n", sr, osr, freq, dur);
+	for (k=0; k<2; k++) {
+		u8 *data;
+		u32 size;
+		u64 t = run_session(in_name, out_name, sr, osr, modes[k], taps);
+		if (!t || (gf_file_load_data(out_name, &data, &size) != GF_OK)) {
+			fprintf(stderr, "Failed to resample in %s mode\n", modes[k]);
+			ret = 1;
+			break;
+		}
+		fprintf(stdout, "%s: %.1f dB - %.1f Msamples/s (full session)\n", modes[k],
+			get_snr((Float *) data, size / sizeof(Float), osr, freq), (Double) nb_in / t);
+		gf_free(data);
+	}
+	gf_file_delete(in_name);
+	gf_file_delete(out_name);
+	gf_sys_close();
+	return ret;
+}
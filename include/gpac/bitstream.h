@@ -161,6 +161,15 @@ Reads a large integer coded on a number of bit bigger than 32.
  */
 u64 gf_bs_read_long_int(GF_BitStream *bs, u32 nBits);
 /*!
+\brief leading zero bits reading
+
+Reads zero bits until a bit set to 1 is found, typically used for Exp-Golomb codes. The bit set to 1 is read but not counted.
+\param bs the target bitstream
+\param max_bits the maximum number of zero bits to read. If reached, the next bit is not read
+\return the number of zero bits read
+ */
+u32 gf_bs_read_leading_zeros(GF_BitStream *bs, u32 max_bits);
+/*!
 \brief float reading
 
 Reads a float coded as IEEE 32 bit format.
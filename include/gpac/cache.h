@@ -219,6 +219,14 @@ Delete all cached files in given directory starting with startpattern
  */
 GF_Err gf_cache_delete_all_cached_files(const char * directory);
 
+/*!
+Delete least recently modified cached files in given directory until the cache size is below the given size
+\param directory to clean up
+\param max_size maximum size in bytes of the cache files in directory
+\return GF_OK if everything went fine
+ */
+GF_Err gf_cache_trim_cached_files(const char * directory, u64 max_size);
+
 
 /*!
 
@@ -505,6 +505,35 @@ Gets the cumultated bitrate in of all active sessions.
  */
 u32 gf_dm_get_global_rate(GF_DownloadManager *dm);
 
+/*! HTTP cache statistics*/
+typedef struct
+{
+	/*! number of resources served from cache, either without request or after revalidation*/
+	u32 hits;
+	/*! number of resources downloaded to the cache*/
+	u32 misses;
+	/*! number of cache entries evicted to enforce cache size*/
+	u32 evictions;
+	/*! number of cache entries*/
+	u32 nb_entries;
+	/*! number of cache entries stored in memory*/
+	u32 nb_mem_entries;
+	/*! size in bytes of all cache entries*/
+	u64 size;
+	/*! size in bytes of cache entries stored in memory*/
+	u64 mem_size;
+} GF_DMCacheStats;
+
+/*!
+\brief gets HTTP cache statistics
+
+Gets statistics of the HTTP cache of the download manager
+\param dm the download manager object
+\param stats filled with the cache statistics
+\return error code if any
+ */
+GF_Err gf_dm_get_cache_stats(GF_DownloadManager *dm, GF_DMCacheStats *stats);
+
 
 /*!
 \brief Get header sizes and times stats for the session
@@ -200,7 +200,9 @@ typedef enum
 	/*! In this mode, the scheduler uses locks for packet and property queues even if single-threaded (test mode) */
 	GF_FS_SCHEDULER_LOCK_FORCE,
 	/*! In this mode, the scheduler uses direct dispatch and no threads, trying to nest task calls within task calls */
-	GF_FS_SCHEDULER_DIRECT
+	GF_FS_SCHEDULER_DIRECT,
+	/*! In this mode, the scheduler uses one task list per thread in addition to the main task lists. Filter tasks are posted to the task list of the thread which last processed the filter, and idle threads steal tasks from other threads */
+	GF_FS_SCHEDULER_WORK_STEAL
 } GF_FilterSchedulerType;
 
 /*! Filter session flags */
@@ -2252,6 +2254,12 @@ void gf_filter_abort(GF_Filter *filter);
 */
 void gf_filter_lock(GF_Filter *filter, Bool do_lock);
 
+/*! Starts or ends a batch dispatch on a filter. While a batch is active, packets sent on the output PIDs of the filter are dispatched immediately, but the destination filters are only scheduled for processing once, when the batch ends. Batches can be nested, destination filters are scheduled when the outermost batch ends. A batch left open at the end of the process callback is closed by the session.
+\param filter the target filter
+\param start if GF_TRUE, starts a batch, otherwise ends it
+*/
+void gf_filter_batch_dispatch(GF_Filter *filter, Bool start);
+
 
 
 /*! Lock global filter session. This is needed when assigning source IDs after a connect source or destination to the loaded source to connect in an async way
@@ -2624,6 +2632,34 @@ void gf_filter_make_sticky(GF_Filter *filter);
 */
 u32 gf_filter_get_num_events_queued(GF_Filter *filter);
 
+/*! Callback function for parallel jobs
+\param udta opaque data passed to \ref gf_filter_parallel_for
+\param first index of the first item to process
+\param last index after the last item to process
+\param thread_idx index of the calling thread, strictly less than \ref gf_filter_parallel_max_threads. Two concurrent calls never share the same index, so it can be used to select per-thread scratch buffers
+*/
+typedef void (*gf_filter_parallel_job)(void *udta, u32 first, u32 last, u32 thread_idx);
+
+/*! Gets the maximum number of threads that may run a parallel job for this filter
+\param filter target filter
+\return number of threads, 1 if the session is single-threaded
+*/
+u32 gf_filter_parallel_max_threads(GF_Filter *filter);
+
+/*! Runs a job over a range of items, splitting it in tasks run by the calling thread and by idle threads of the session.
+The items are split in tasks of at least min_items items, and each thread is assigned at most a few tasks. The function returns once all items are processed.
+
+The job runs inline on the calling thread if the session is single-threaded, if there are less than twice min_items items, or if another parallel job is pending.
+Job callbacks must not call filter or PID functions.
+\param filter target filter
+\param nb_items number of items to process
+\param min_items minimum number of items per task, 0 means 1
+\param job callback function processing a range of items
+\param udta opaque data passed to the callback
+\return error if any
+*/
+GF_Err gf_filter_parallel_for(GF_Filter *filter, u32 nb_items, u32 min_items, gf_filter_parallel_job job, void *udta);
+
 /*! Returns the single instance of GPAC download manager. DO NOT DESTROY IT!!
 \param filter target filter
 \return the GPAC download manager
@@ -2875,6 +2911,16 @@ By default, all filters are created as non-blocking.
 */
 void gf_filter_set_blocking(GF_Filter *filter, Bool is_blocking);
 
+/*! Pins a filter to one of the session threads, using the thread with the least number of pinned filters. The filter tasks will only be executed by this thread.
+Filters loaded later on to connect a PID to this filter (for example a muxer inserted before a file sink) are pinned to the same thread, so that a complete chain can be run concurrently with other pinned chains.
+
+This has no effect if the session has no additional threads.
+
+\param filter the target filter
+\return GF_TRUE if the filter is pinned, GF_FALSE otherwise
+*/
+Bool gf_filter_pin_thread(GF_Filter *filter);
+
 /*! Overrides the filter caps with new caps for this instance. Typically used when an option of the filter changes the capabilities
 
 The new caps are only taken into account for future graph resolutions, any current link from/to the target filter will not be re-solved when calling this function.
@@ -4014,6 +4060,23 @@ Bool gf_filter_pid_get_first_packet_cts(GF_FilterPid *PID, u64 *cts);
 */
 void gf_filter_pid_drop_packet(GF_FilterPid *PID);
 
+/*! Fetches up to max_pcks packets from the input PID buffer without removing them. The first packet is fetched as with \ref gf_filter_pid_get_packet. Fetching stops before any packet carrying PID property or info changes, or before any internal command packet, so that these are processed at the next call.
+
+Packets are valid until dropped by \ref gf_filter_pid_drop_packet or \ref gf_filter_pid_drop_packets.
+\param PID the target filter PID
+\param pcks array of packets to fill
+\param max_pcks number of entries in the packet array
+\return number of packets fetched
+*/
+u32 gf_filter_pid_get_packets(GF_FilterPid *PID, GF_FilterPacket **pcks, u32 max_pcks);
+
+/*! Drops the first packets in the input PID buffer. Buffer occupancy and unblocking of the source PID are only evaluated once, after the last packet is dropped.
+\param PID the target filter PID
+\param nb_pcks number of packets to drop
+\return number of packets dropped
+*/
+u32 gf_filter_pid_drop_packets(GF_FilterPid *PID, u32 nb_pcks);
+
 /*! Gets the number of packets in input PID buffer.
 \param PID the target filter PID
 \return the number of packets
@@ -4433,6 +4496,13 @@ However, packets don't have to be sent in their allocation order.
 */
 GF_Err gf_filter_pck_send(GF_FilterPacket *pck);
 
+/*! Sends a set of packets in order, scheduling each destination filter only once - see \ref gf_filter_batch_dispatch. All packets must belong to output PIDs of the same filter.
+\param pcks array of output packets to send
+\param nb_pcks number of packets in array
+\return error if any
+*/
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks);
+
 /*! Destructs a packet allocated but that cannot be sent. Shall not be used on packet references.
 \param pck the target output packet to send
 */
@@ -592,6 +592,8 @@ enum
 #define GF_ISOM_BS_COOKIE_QT_CONV		(1<<2)
 #define GF_ISOM_BS_COOKIE_CLONE_TRACK	(1<<3)
 #define GF_ISOM_BS_COOKIE_IN_UDTA		(1<<4)
+//sample sizes and chunk offsets are not loaded, the sample index cache of the file is used instead
+#define GF_ISOM_BS_COOKIE_SKIP_SAMPLE_TABLES	(1<<5)
 
 
 #ifndef GPAC_DISABLE_ISOM
@@ -970,6 +972,8 @@ typedef struct
 
 	u8 *(*sample_alloc_cbk)(u32 size, void *cbk);
 	void *sample_alloc_udta;
+	u8 *(*sample_mmap_cbk)(u8 *data, u32 size, void *cbk);
+	void *sample_mmap_udta;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	u64 first_dts_chunk;
@@ -1164,6 +1168,13 @@ typedef struct
 	u32 sampleDelta;
 } GF_SttsEntry;
 
+/*lookup index entry for stts: first sample number and DTS of an entry*/
+typedef struct
+{
+	u32 first_sample;
+	u64 dts;
+} GF_SttsIndexEntry;
+
 typedef struct
 {
 	GF_ISOM_FULL_BOX
@@ -1179,6 +1190,9 @@ typedef struct
 	u32 r_FirstSampleInEntry;
 	u32 r_currentEntryIndex;
 	u64 r_CurrentDTS;
+	/*lookup index for READ, built on first random access - reset r_index_count when modifying entries other than the last one*/
+	GF_SttsIndexEntry *r_index;
+	u32 r_index_count, r_index_alloc;
 	//when removing samples, this is the DTS of first sample after all removed samples
 	u64 cumulated_start_dts;
 
@@ -1916,6 +1930,8 @@ typedef struct
 	u32 max_size;
 	u64 total_size;
 	u32 total_samples;
+	//sizes point to the sample index cache and are not owned by the box
+	Bool sizes_mapped;
 } GF_SampleSizeBox;
 
 typedef struct
@@ -1955,6 +1971,9 @@ typedef struct
 	u32 firstSampleInCurrentChunk;
 	u32 currentChunk;
 	u32 ghostNumber;
+	/*lookup index for READ (first sample number of each entry), built on first random access - reset r_index_count when modifying entries other than the last one*/
+	u32 *r_index;
+	u32 r_index_count, r_index_alloc;
 
 	u32 w_lastSampleNumber;
 	u32 w_lastChunkNumber;
@@ -2103,6 +2122,20 @@ typedef struct
 	u32 r_cur_sample, r_cur_idx;
 } GF_TrafToSampleMap;
 
+/*per-track tables of a sample index cache, pointing to the loaded or mapped cache file*/
+typedef struct
+{
+	u32 nb_samples;
+	const u64 *offsets;
+	const u64 *dts;
+	const u32 *sizes;
+	const s32 *cts_offsets;
+	const u32 *durations;
+	const u32 *chunks;
+	//sample description index in the lower 16 bits, SAP type in bits 16 to 23
+	const u32 *infos;
+} GF_SampleTableIndex;
+
 typedef struct
 {
 	GF_ISOM_BOX
@@ -2142,6 +2175,9 @@ typedef struct
 
 	u32 r_last_chunk_num, r_last_sample_num, r_last_offset_in_chunk;
 	u8 patch_piff_psec;
+
+	//sample index cache for this track, if any
+	GF_SampleTableIndex *sample_index;
 } GF_SampleTableBox;
 
 GF_Err stbl_AppendTrafMap(GF_ISOFile *mov, GF_SampleTableBox *stbl, Bool is_seg_start, u64 seg_start_offset, u64 frag_start_offset, u64 tfdt, u8 *moof_template, u32 moof_template_size, u64 sidx_start, u64 sidx_end, u32 nb_pack_samples);
@@ -4007,6 +4043,8 @@ typedef struct
 
 /*regular file IO*/
 #define GF_ISOM_DATA_FILE         0x01
+/*File Mapping object, read-only mode on complete files (no download)*/
+#define GF_ISOM_DATA_FILE_MAPPING 0x02
 /*External file object. Needs implementation*/
 #define GF_ISOM_DATA_FILE_EXTERN  0x03
 /*regular memory IO*/
@@ -4066,6 +4104,11 @@ typedef struct
 	u64 file_size;
 	u8 *byte_map;
 	u64 byte_pos;
+	//mapping is shared between the file and the users of zero-copy sample data
+	u32 nb_refs;
+	//access pattern tracking for paging hints
+	u32 nb_seq, nb_rand;
+	Bool random_access;
 } GF_FileMappingDataMap;
 
 GF_Err gf_isom_datamap_new(const char *location, const char *parentPath, u8 mode, GF_DataMap **outDataMap);
@@ -4083,6 +4126,14 @@ u32 gf_isom_fdm_get_data(GF_FileDataMap *ptr, u8 *buffer, u32 bufferLength, u64
 GF_DataMap *gf_isom_fdm_new_temp(const char *sTempPath);
 #endif
 
+/*File-mapping data map, only available on linux - gf_isom_fmo_new returns NULL otherwise*/
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode);
+/*releases a reference on the mapping, the mapping is destroyed once no more references are held*/
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr);
+u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset, GF_BlobRangeStatus *range_status);
+/*gets pointer to mapped data, NULL if range is not in mapping*/
+u8 *gf_isom_fmo_get_ptr(GF_FileMappingDataMap *ptr, u64 fileOffset, u32 size);
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 u64 gf_isom_datamap_get_offset(GF_DataMap *map);
 GF_Err gf_isom_datamap_add_data(GF_DataMap *ptr, u8 *data, u32 dataSize);
@@ -4130,6 +4181,12 @@ struct __tag_isom {
 	to make easily parsable files (note there could be some data (mdat) before
 	the moov*/
 	GF_DataMap *movieFileMap;
+	/*optional read-only mapping of the movie file, used to fetch sample data of complete local files*/
+	GF_FileMappingDataMap *mmap_map;
+	/*sample index cache used when opening the file, either mapped or loaded in sample_index_data*/
+	GF_FileMappingDataMap *sample_index_map;
+	u8 *sample_index_data;
+	GF_SampleTableIndex *sample_index_tracks;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	/*the final file name*/
@@ -4328,6 +4385,8 @@ GF_Err stbl_GetSampleSize(GF_SampleSizeBox *stsz, u32 SampleNumber, u32 *Size);
 GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *CTSoffset);
 GF_Err stbl_GetSampleDTS(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 *DTS);
 GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 *DTS, u32 *duration);
+/*discard the stts and stsc lookup indexes*/
+void stbl_reset_lookup_index(GF_SampleTableBox *stbl);
 
 /*find a RAP or set the prev / next RAPs if vars are passed*/
 GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, GF_ISOSAPType *IsRAP, u32 *prevRAP, u32 *nextRAP);
@@ -0,0 +1,40 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC / common tools sub-project
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#ifndef _GF_LOG_DEV_H_
+#define _GF_LOG_DEV_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <gpac/tools.h>
+
+#ifndef GPAC_DISABLE_LOG
+/*releases the async log queue of the calling thread, called when a thread created by gf_th_run exits*/
+void gf_log_thread_done(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/*_GF_LOG_DEV_H_*/
@@ -0,0 +1,42 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *  This file is part of GPAC / common tools sub-project
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#ifndef _GF_SIMD_H_
+#define _GF_SIMD_H_
+
+#include <gpac/setup.h>
+
+/*compile-time SIMD detection for internal vectorized code paths
+	- GPAC_HAS_SSE2 is defined if SSE2 intrinsics are available
+	- GPAC_HAS_NEON is defined if 64-bit ARM NEON intrinsics are available
+*/
+#if defined(GPAC_64_BITS) && defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+# define GPAC_HAS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# include <arm_neon.h>
+# define GPAC_HAS_NEON
+#endif
+
+#endif	/*_GF_SIMD_H_*/
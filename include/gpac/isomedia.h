@@ -796,6 +796,42 @@ If the movie is successfully loaded (isom_file non-NULL), BytesMissing is zero
 */
 GF_Err gf_isom_open_progressive_ex(const char *fileName, u64 start_range, u64 end_range, Bool enable_frag_templates, GF_ISOFile **isom_file, u64 *BytesMissing, u32 *topBoxType);
 
+/*! gets the name of the sample index cache of a file
+
+A sample index cache is a sidecar file storing the sample tables of a non-fragmented file in a binary form which can be memory-mapped, and identified by the size, modification time and movie box of the source file.
+\param fileName the name of the local source file
+\param cache_dir the directory where caches are stored, or NULL to store the cache next to the source file
+\return the name of the cache file (to free by the caller), or NULL if error
+*/
+char *gf_isom_sample_index_get_name(const char *fileName, const char *cache_dir);
+
+/*! builds the sample index cache of a file
+\param isom_file the target ISO file, opened in read mode from a local file
+\param idx_file the name of the cache file to create
+\return error if any, GF_NOT_SUPPORTED if the file cannot be indexed (fragmented file, compressed movie box, ...)
+*/
+GF_Err gf_isom_sample_index_build(GF_ISOFile *isom_file, const char *idx_file);
+
+/*! checks if a sample index cache is valid for a file
+\param fileName the name of the local source file
+\param idx_file the name of the cache file
+\param full_check if GF_FALSE, only checks file size, modification time and movie box position. Otherwise, also checks the movie box hash and compares all cached samples with the source file
+\return GF_OK if valid, GF_NOT_FOUND if cache is missing, GF_CORRUPTED_DATA if the cache does not match the source file or error if any
+*/
+GF_Err gf_isom_sample_index_check(const char *fileName, const char *idx_file, Bool full_check);
+
+/*! opens a local file in read mode using its sample index cache
+
+Sample sizes and chunk offsets are not loaded from the movie box but fetched from the cache, and sample properties are directly read from the cache. The cache is checked as in \ref gf_isom_sample_index_check without full check.
+
+Chunk offset tables are not loaded: dumping the file reports no chunk offsets, and cloning the movie box or writing the sample tables fails with GF_NOT_SUPPORTED. Such files shall be opened without cache.
+\param fileName the name of the local file to open
+\param idx_file the name of the cache file
+\param isom_file set to the opened file if success
+\return error if any, in which case the file shall be opened without cache
+*/
+GF_Err gf_isom_open_indexed(const char *fileName, const char *idx_file, GF_ISOFile **isom_file);
+
 /*! retrieves number of bytes missing.
 if requesting a sample fails with error GF_ISOM_INCOMPLETE_FILE, use this function
 to get the number of bytes missing to retrieve the sample
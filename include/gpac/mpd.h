@@ -142,11 +142,16 @@ typedef struct
 	u32 repeat_count;
 } GF_MPD_SegmentTimelineEntry;
 
+/*! Serialization cache of manifest fragments, internal to the MPD and M3U8 writers*/
+typedef struct _gf_mpd_frag_cache GF_MPD_FragmentCache;
+
 /*! Segment Timeline*/
 typedef struct
 {
 	/*! list of entries*/
 	GF_List *entries;
+	/*! serialization cache of stable entries, only used when the timeline is written more than once*/
+	GF_MPD_FragmentCache *print_cache;
 } GF_MPD_SegmentTimeline;
 
 /*! Byte range info*/
@@ -654,6 +659,8 @@ typedef struct {
 	char *m3u8_var_name;
 	/*! temp file for m3u8 generation*/
 	FILE *m3u8_var_file;
+	/*! serialization cache of stable segments in m3u8 playlist*/
+	GF_MPD_FragmentCache *m3u8_cache;
 
 	/*! for m3u8: 0: not encrypted, 1: full segment, 2: CENC*/
 	u8 crypto_type;
@@ -878,6 +885,8 @@ typedef struct {
 	GF_List *base_URLs;
 	/*! list of strings */
 	GF_List *locations;
+	/*! URL of MPD patch document, may be NULL*/
+	char *patch_location;
 	/*! list of Metrics */
 	GF_List *metrics;
 	/*! list of GF_MPD_Period */
@@ -997,6 +1006,15 @@ void gf_mpd_period_free(void *_item);
 \return error if any
 */
 GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact);
+
+/*! writes an MPD patch document updating publish time, maximum segment duration and all segment timelines of a dynamic MPD
+\param mpd the target MPD to write
+\param out the target file object
+\param original_publish_time publish time in milliseconds of the MPD the patch applies to
+\param compact if set, removes all new line and indentation in the output
+\return error if any
+*/
+GF_Err gf_mpd_write_patch(GF_MPD const * const mpd, FILE *out, u64 original_publish_time, Bool compact);
 /*! writes an MPD to a local file
 \param mpd the target MPD to write
 \param file_name the target file name
@@ -1971,6 +1971,14 @@ typedef enum
 \return packet produced or NULL if error or idle
 */
 const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next);
+/*! produces one packet of the multiplex, writing it in the given buffer
+\param muxer the target MPEG-2 TS multiplexer
+\param status set to the current state of the multiplexer
+\param usec_till_next the target MPEG-2 TS multiplexer
+\param dst_pck buffer of at least 188 bytes in which the packet is written, typically inside an output packet. If NULL, the internal packet buffer of the multiplexer is used
+\return packet produced (dst_pck if set) or NULL if error or idle
+*/
+const u8 *gf_m2ts_mux_process_ex(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next, u8 *dst_pck);
 /*! gets the system clock of the multiplexer (time elapsed since start)
 \param muxer the target MPEG-2 TS multiplexer
 \return system clock of the multiplexer in milliseconds
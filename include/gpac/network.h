@@ -503,6 +503,33 @@ Sends a buffer on the socket. The socket must be in a bound or connected mode. T
  */
 GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written);
 
+/*!
+\brief gathered data emission
+
+Sends several buffers on the socket in a single call (writev). The socket must be in a connected mode
+\param sock the socket object
+\param buffers the data buffers to send
+\param sizes the size of each data buffer
+\param nb_buffers the number of buffers, at most 8
+\param more if GF_TRUE, hints that more data is coming and the last packet can be delayed (MSG_MORE)
+\param written set to number of written bytes - may be NULL
+\return error if any, GF_IP_NETWORK_EMPTY if the socket would block (written may be non 0), GF_NOT_SUPPORTED if not supported on this socket
+ */
+GF_Err gf_sk_sendv(GF_Socket *sock, const u8 **buffers, const u32 *sizes, u32 nb_buffers, Bool more, u32 *written);
+
+/*!
+\brief file data emission
+
+Sends a range of a file on a TCP socket without copying it to user memory (sendfile)
+\param sock the socket object
+\param fd file descriptor of the file to send
+\param offset offset of the range in the file
+\param length length of the range
+\param written set to number of written bytes - may be NULL
+\return error if any, GF_IP_NETWORK_EMPTY if the socket would block (written may be non 0), GF_NOT_SUPPORTED if zero-copy is not available for this socket or file
+ */
+GF_Err gf_sk_send_file(GF_Socket *sock, s32 fd, u64 offset, u32 length, u32 *written);
+
 
 /*!
 \brief data reception
@@ -663,6 +690,29 @@ Fetches data on a socket without performing any select (wait), to be used with s
  */
 GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *read);
 
+/*! datagram slot for batched reception*/
+typedef struct
+{
+	/*! reception buffer, allocated by caller*/
+	u8 *buffer;
+	/*! allocated size of the reception buffer*/
+	u32 size;
+	/*! number of bytes received in this slot*/
+	u32 read;
+} GF_SockDatagram;
+
+/*!
+Fetches several datagrams on a UDP socket without performing any select (wait), to be used with socket group on sockets that are set in the selected socket group.
+
+On Linux, all datagrams are fetched using a single system call (recvmmsg). On other platforms, or when the socket is used with network capture, datagrams are fetched one at a time until no more data is available or all slots are filled.
+\param sock the socket object
+\param slots the datagram slots to fill
+\param nb_slots the number of datagram slots
+\param nb_read set to the number of filled slots
+\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *slots, u32 nb_slots, u32 *nb_read);
+
 /*!
 Checks if connection has been closed by remote peer
 \param sock the socket object
@@ -690,6 +740,19 @@ Checks if socket can is ready for read or write
  */
 GF_Err gf_sk_select(GF_Socket *sock, GF_SockSelectMode mode);
 
+/*!
+Sets the user data of a socket, typically used to retrieve the owner of a socket returned by \ref gf_sk_group_get_ready
+\param sock socket object
+\param udta user data
+ */
+void gf_sk_set_usr_data(GF_Socket *sock, void *udta);
+/*!
+Gets the user data of a socket
+\param sock socket object
+\return user data of the socket
+ */
+void *gf_sk_get_usr_data(GF_Socket *sock);
+
 /*! @} */
 
 /*!
@@ -739,6 +802,22 @@ Checks if given socket is selected and can be read. This shall be called after g
  */
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode mode);
 
+/*!
+Enumerates sockets ready after a call to \ref gf_sk_group_select. Only ready sockets are visited, unlike checking each registered socket with \ref gf_sk_group_sock_is_set. Sockets drained or unregistered since the select are skipped
+\param sg socket group object
+\param idx index of the enumeration, must be set to 0 before the first call
+\param mode the operation mode desired
+\return the next ready socket, or NULL if no more ready sockets
+ */
+GF_Socket *gf_sk_group_get_ready(GF_SockGroup *sg, u32 *idx, GF_SockSelectMode mode);
+
+/*!
+Signals that an operation on the socket would block. Socket groups using edge-triggered polling (epoll) keep sockets ready until an operation on them would block. This must be called when reading or writing the socket handle directly (e.g. TLS) rather than through \ref gf_sk_receive or \ref gf_sk_send, otherwise the socket is reported ready until the next gf_sk_receive or gf_sk_send call would block
+\param sock socket object
+\param mode the operation which would block
+ */
+void gf_sk_set_would_block(GF_Socket *sock, GF_SockSelectMode mode);
+
 /*! @} */
 #endif //GPAC_DISABLE_NETWORK
 
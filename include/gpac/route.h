@@ -103,6 +103,12 @@ enum
 	GF_LCT_EXT_TOL48 = 67,
 };
 
+/*! FEC Encoding ID for Reed-Solomon codes over GF(2^8) under small block mode (RFC 5510)
+
+Packets using this scheme carry a 32-bit FEC payload ID made of a 24-bit source block number followed by an 8-bit encoding symbol ID. Repair packets (PSI b00 in ROUTE) carry an FTI extension header (HEL 3) with 48 bits of transfer length, 16 bits of encoding symbol length, 8 bits of maximum source block length and 8 bits of maximum number of encoding symbols.
+*/
+#define GF_FEC_ENCODING_RS	5
+
 /*! LCT fragment information*/
 typedef struct
 {
@@ -352,6 +358,37 @@ GF_Err gf_routedmx_patch_frag_info(GF_ROUTEDmx *routedmx, u32 service_id, GF_ROU
  */
 GF_Err gf_routedmx_mark_active_quality(GF_ROUTEDmx *routedmx, u32 service_id, const char *period_id, s32 as_id, const char *rep_id, Bool is_selected);
 
+/*! Gets source block partitioning of an object for AL-FEC, following the blocking algorithm of RFC 5052
+\param transfer_length size in bytes of the object
+\param symbol_size size in bytes of an encoding symbol
+\param max_sbl maximum number of source symbols in a source block
+\param sbn source block number to query
+\param block_offset set to the byte offset of the source block in the object - may be NULL
+\param block_k set to the number of source symbols in the source block - may be NULL
+\return number of source blocks in the object, 0 if invalid parameters
+ */
+u32 gf_route_fec_source_block(u32 transfer_length, u32 symbol_size, u32 max_sbl, u32 sbn, u32 *block_offset, u32 *block_k);
+
+/*! Computes Reed-Solomon repair symbols of a source block (FEC Encoding ID 5)
+\param src the k source symbols of the block, each of symbol_size bytes
+\param k number of source symbols in the block
+\param symbol_size size in bytes of an encoding symbol
+\param repair buffers receiving the repair symbols, of encoding symbol ID k to k+nb_repair-1
+\param nb_repair number of repair symbols to compute, k+nb_repair shall be at most 255
+\return error if any
+ */
+GF_Err gf_route_fec_rs_encode(u8 **src, u32 k, u32 symbol_size, u8 **repair, u32 nb_repair);
+
+/*! Recovers missing source symbols of a Reed-Solomon source block (FEC Encoding ID 5)
+\param symbols k received encoding symbols of the block, each of symbol_size bytes
+\param esis encoding symbol IDs of the received symbols, all different
+\param k number of source symbols in the block
+\param symbol_size size in bytes of an encoding symbol
+\param sources k entries indexed by source symbol ID - entries not NULL are filled with the recovered source symbol
+\return error if any
+ */
+GF_Err gf_route_fec_rs_decode(u8 **symbols, const u32 *esis, u32 k, u32 symbol_size, u8 **sources);
+
 
 /*! @} */
 #ifdef __cplusplus
@@ -851,6 +851,24 @@ Assigns a user-defined callback for printing log messages. By default all logs a
 */
 gf_log_cbk gf_log_set_callback(void *usr_cbk, gf_log_cbk cbk);
 
+/*!
+\brief Asynchronous logging
+
+Enables or disables asynchronous logging. When enabled, log messages are formatted on the calling thread without any lock and pushed to a per-thread lock-free queue; a dedicated logger thread dequeues them and calls the log callback. Messages for \ref GF_LOG_APP and errors in strict mode are still written synchronously, after all pending messages are written. Messages are dropped when the calling thread queue is full.
+
+Disabling asynchronous logging flushes all pending messages and shall only be done when no other thread is logging.
+\param enable if GF_TRUE, enables asynchronous logging, otherwise disables it
+\return error if any, GF_NOT_SUPPORTED if threads are not available
+*/
+GF_Err gf_log_set_async(Bool enable);
+
+/*!
+\brief Asynchronous logging drops
+
+Gets the number of log messages dropped by the asynchronous logger since it was enabled
+\return number of dropped messages
+*/
+u32 gf_log_get_async_drops();
 
 /*!
  \cond DUMMY_DOXY_SECTION
@@ -1932,6 +1950,29 @@ const char * gf_fileio_url(GF_FileIO *fileio);
 */
 GF_FileIO *gf_fileio_from_mem(const char *URL, const u8 *data, u32 size);
 
+/*! Memory reallocation callback for memory writer fileIO
+\param udta opaque data passed to \ref gf_fileio_mem_writer
+\param data current memory block, NULL at first call
+\param size new size of memory block
+\return reallocated memory block, or NULL if error
+*/
+typedef u8 *(*gfio_mem_realloc_proc)(void *udta, u8 *data, u32 size);
+
+/*! Creates a write-only fileIO object storing written data in memory. Seeking in the object truncates the written data to the new position.
+\param realloc_proc callback used to reallocate memory, may be NULL to use gf_realloc. If set, memory is owned by the caller and is not freed when closing the object
+\param udta opaque data passed to realloc_proc
+\param size_hint initial allocation size, may be 0
+\return new fileIO as a FILE object, or NULL if error - use gf_fclose() on this object to destroy it
+*/
+FILE *gf_fileio_mem_writer(gfio_mem_realloc_proc realloc_proc, void *udta, u32 size_hint);
+
+/*! Gets data written in a memory writer fileIO
+\param fp memory writer fileIO created by \ref gf_fileio_mem_writer
+\param size set to the number of bytes written
+\return written data, or NULL if not a memory writer fileIO
+*/
+u8 *gf_fileio_mem_writer_data(FILE *fp, u32 *size);
+
 /*! Cache state for file IO object*/
 typedef enum
 {
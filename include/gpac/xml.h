@@ -101,6 +101,8 @@ typedef struct _xml_node
 	u16 orig_pos;
 	/*! set to 1 if content comes from an existing XML and character checking should be skipped*/
 	u16 valid_content;
+	/*! set if node, attributes and strings are owned by the DOM parser arena (see \ref gf_xml_dom_enable_arena): strings and attributes shall not be freed or modified*/
+	Bool in_arena;
 } GF_XMLNode;
 
 /*! @} */
@@ -291,6 +293,14 @@ u32 gf_xml_dom_get_line(GF_DOMParser *parser);
  */
 GF_Err gf_xml_dom_enable_passthrough(GF_DOMParser *dom);
 
+/*! Enables arena allocation of parsed documents. Nodes, attributes and strings are allocated in large blocks owned by the parser, and element and attribute names are shared. All memory is released at once at the next parse or when destroying the parser.
+
+Nodes of such documents can be inspected and moved around but their strings and attributes shall not be modified or freed. Use \ref gf_xml_dom_node_clone to keep a node after the parser is destroyed; \ref gf_xml_dom_detach_root returns such a clone.
+\param dom the dom parser
+\return error if any
+ */
+GF_Err gf_xml_dom_enable_arena(GF_DOMParser *dom);
+
 /*! Gets the number of root nodes in the document (not XML compliant, but used in DASH for remote periods)
 \param parser the DOM parser to use
 \return the number of root elements in the document
@@ -32,3 +32,11 @@ static Bool fatal_ut = GF_TRUE;
 #define assert_less(a, b)                 assert_true((a) < (b))
 #define assert_less_equal(a, b)           assert_true((a) <= (b))
 #define assert_not_null(ptr)              assert_true((ptr) != NULL)
+
+//deterministic pseudo-random numbers for test data, 24 bits
+static u32 ut_rand_state = 1;
+static GFINLINE u32 ut_rand(void)
+{
+    ut_rand_state = ut_rand_state * 1103515245 + 12345;
+    return ut_rand_state >> 8;
+}
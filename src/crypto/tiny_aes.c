@@ -471,6 +471,269 @@ static void InvCipher(state_t* state,u8* RoundKey)
 }
 
 
+/*****************************************************************************/
+/* AES-NI:                                                                   */
+/*****************************************************************************/
+// When built with gcc/clang for x86, the ECB, CBC and CTR entry points switch at run time to the
+// AES-NI instructions if the CPU supports them. The key schedule is the one computed by
+// KeyExpansion above, so both paths share the same context and produce identical output.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(GPAC_DISABLE_AESNI) && (AES_KEYLEN == 16)
+#define TINYAES_AESNI
+
+#include <wmmintrin.h>
+
+#define AESNI_FUNC static __attribute__((target("aes,sse2")))
+
+static int aesni_state = -1;
+
+static int aesni_available(void)
+{
+  if (aesni_state < 0)
+  {
+    __builtin_cpu_init();
+    aesni_state = __builtin_cpu_supports("aes") ? 1 : 0;
+  }
+  return aesni_state;
+}
+
+AESNI_FUNC void aesni_load_keys(__m128i rk[Nr+1], const u8* RoundKey)
+{
+  u8 i;
+  for (i = 0; i <= Nr; ++i)
+  {
+    rk[i] = _mm_loadu_si128((const __m128i *) (RoundKey + i*AES_BLOCKLEN));
+  }
+}
+
+AESNI_FUNC void aesni_load_dec_keys(__m128i rk[Nr+1], const u8* RoundKey)
+{
+  u8 i;
+  //equivalent inverse cipher: reversed schedule, InvMixColumns applied to inner round keys
+  rk[0] = _mm_loadu_si128((const __m128i *) (RoundKey + Nr*AES_BLOCKLEN));
+  for (i = 1; i < Nr; ++i)
+  {
+    rk[i] = _mm_aesimc_si128(_mm_loadu_si128((const __m128i *) (RoundKey + (Nr-i)*AES_BLOCKLEN)));
+  }
+  rk[Nr] = _mm_loadu_si128((const __m128i *) RoundKey);
+}
+
+AESNI_FUNC __m128i aesni_encrypt_block(__m128i b, const __m128i rk[Nr+1])
+{
+  u8 i;
+  b = _mm_xor_si128(b, rk[0]);
+  for (i = 1; i < Nr; ++i)
+  {
+    b = _mm_aesenc_si128(b, rk[i]);
+  }
+  return _mm_aesenclast_si128(b, rk[Nr]);
+}
+
+AESNI_FUNC __m128i aesni_decrypt_block(__m128i b, const __m128i rk[Nr+1])
+{
+  u8 i;
+  b = _mm_xor_si128(b, rk[0]);
+  for (i = 1; i < Nr; ++i)
+  {
+    b = _mm_aesdec_si128(b, rk[i]);
+  }
+  return _mm_aesdeclast_si128(b, rk[Nr]);
+}
+
+AESNI_FUNC void aesni_ecb(struct AES_ctx* ctx, u8* buf, int decrypt)
+{
+  __m128i rk[Nr+1];
+  __m128i b = _mm_loadu_si128((const __m128i *) buf);
+  if (decrypt)
+  {
+    aesni_load_dec_keys(rk, ctx->RoundKey);
+    b = aesni_decrypt_block(b, rk);
+  }
+  else
+  {
+    aesni_load_keys(rk, ctx->RoundKey);
+    b = aesni_encrypt_block(b, rk);
+  }
+  _mm_storeu_si128((__m128i *) buf, b);
+}
+
+AESNI_FUNC void aesni_cbc_encrypt(struct AES_ctx* ctx, u8* buf, u32 length)
+{
+  uintptr_t i;
+  __m128i rk[Nr+1];
+  __m128i iv = _mm_loadu_si128((const __m128i *) ctx->Iv);
+  aesni_load_keys(rk, ctx->RoundKey);
+  //CBC encryption is a serial chain, only the block cipher itself is accelerated
+  for (i = 0; i < length; i += AES_BLOCKLEN)
+  {
+    iv = aesni_encrypt_block(_mm_xor_si128(_mm_loadu_si128((const __m128i *) buf), iv), rk);
+    _mm_storeu_si128((__m128i *) buf, iv);
+    buf += AES_BLOCKLEN;
+  }
+  _mm_storeu_si128((__m128i *) ctx->Iv, iv);
+}
+
+AESNI_FUNC void aesni_cbc_decrypt(struct AES_ctx* ctx, u8* buf, u32 length)
+{
+  u8 r;
+  __m128i rk[Nr+1];
+  __m128i iv = _mm_loadu_si128((const __m128i *) ctx->Iv);
+  aesni_load_dec_keys(rk, ctx->RoundKey);
+
+  //CBC decryption blocks are independent, run 4 of them in the pipeline
+  while (length >= 4*AES_BLOCKLEN)
+  {
+    __m128i c0 = _mm_loadu_si128((const __m128i *) buf);
+    __m128i c1 = _mm_loadu_si128((const __m128i *) (buf + 16));
+    __m128i c2 = _mm_loadu_si128((const __m128i *) (buf + 32));
+    __m128i c3 = _mm_loadu_si128((const __m128i *) (buf + 48));
+    __m128i b0 = _mm_xor_si128(c0, rk[0]);
+    __m128i b1 = _mm_xor_si128(c1, rk[0]);
+    __m128i b2 = _mm_xor_si128(c2, rk[0]);
+    __m128i b3 = _mm_xor_si128(c3, rk[0]);
+    for (r = 1; r < Nr; ++r)
+    {
+      b0 = _mm_aesdec_si128(b0, rk[r]);
+      b1 = _mm_aesdec_si128(b1, rk[r]);
+      b2 = _mm_aesdec_si128(b2, rk[r]);
+      b3 = _mm_aesdec_si128(b3, rk[r]);
+    }
+    b0 = _mm_xor_si128(_mm_aesdeclast_si128(b0, rk[Nr]), iv);
+    b1 = _mm_xor_si128(_mm_aesdeclast_si128(b1, rk[Nr]), c0);
+    b2 = _mm_xor_si128(_mm_aesdeclast_si128(b2, rk[Nr]), c1);
+    b3 = _mm_xor_si128(_mm_aesdeclast_si128(b3, rk[Nr]), c2);
+    _mm_storeu_si128((__m128i *) buf, b0);
+    _mm_storeu_si128((__m128i *) (buf + 16), b1);
+    _mm_storeu_si128((__m128i *) (buf + 32), b2);
+    _mm_storeu_si128((__m128i *) (buf + 48), b3);
+    iv = c3;
+    buf += 4*AES_BLOCKLEN;
+    length -= 4*AES_BLOCKLEN;
+  }
+  while (length >= AES_BLOCKLEN)
+  {
+    __m128i c = _mm_loadu_si128((const __m128i *) buf);
+    _mm_storeu_si128((__m128i *) buf, _mm_xor_si128(aesni_decrypt_block(c, rk), iv));
+    iv = c;
+    buf += AES_BLOCKLEN;
+    length -= AES_BLOCKLEN;
+  }
+  _mm_storeu_si128((__m128i *) ctx->Iv, iv);
+}
+
+static GFINLINE u64 aesni_load_be64(const u8* p)
+{
+  return ((u64)p[0]<<56) | ((u64)p[1]<<48) | ((u64)p[2]<<40) | ((u64)p[3]<<32) | ((u64)p[4]<<24) | ((u64)p[5]<<16) | ((u64)p[6]<<8) | (u64)p[7];
+}
+
+static GFINLINE void aesni_store_be64(u8* p, u64 v)
+{
+  u8 i;
+  for (i = 0; i < 8; ++i)
+  {
+    p[i] = (u8) (v >> (56 - 8*i));
+  }
+}
+
+//counter block from the 128-bit big-endian counter value hi:lo
+#define AESNI_CTR_BLOCK(_hi, _lo) _mm_set_epi64x((long long) __builtin_bswap64(_lo), (long long) __builtin_bswap64(_hi))
+#define AESNI_CTR_INC(_hi, _lo) { (_lo)++; if (!(_lo)) (_hi)++; }
+
+AESNI_FUNC void aesni_ctr_xcrypt(struct AES_ctx* ctx, u8* buf, u32 length)
+{
+  u8 r;
+  u64 hi, lo;
+  __m128i rk[Nr+1];
+  int bi = (AES_BLOCKLEN - ctx->counter_pos);
+
+  //consume what is left of the current keystream block
+  while (length && (bi < AES_BLOCKLEN))
+  {
+    *buf = (*buf ^ ctx->buffer[bi]);
+    buf++;
+    bi++;
+    length--;
+  }
+  if (!length)
+  {
+    ctx->counter_pos = (AES_BLOCKLEN - bi);
+    return;
+  }
+
+  aesni_load_keys(rk, ctx->RoundKey);
+  hi = aesni_load_be64(ctx->Iv);
+  lo = aesni_load_be64(ctx->Iv + 8);
+
+  while (length >= 4*AES_BLOCKLEN)
+  {
+    __m128i b0, b1, b2, b3;
+    b0 = AESNI_CTR_BLOCK(hi, lo);
+    AESNI_CTR_INC(hi, lo);
+    b1 = AESNI_CTR_BLOCK(hi, lo);
+    AESNI_CTR_INC(hi, lo);
+    b2 = AESNI_CTR_BLOCK(hi, lo);
+    AESNI_CTR_INC(hi, lo);
+    b3 = AESNI_CTR_BLOCK(hi, lo);
+    AESNI_CTR_INC(hi, lo);
+
+    b0 = _mm_xor_si128(b0, rk[0]);
+    b1 = _mm_xor_si128(b1, rk[0]);
+    b2 = _mm_xor_si128(b2, rk[0]);
+    b3 = _mm_xor_si128(b3, rk[0]);
+    for (r = 1; r < Nr; ++r)
+    {
+      b0 = _mm_aesenc_si128(b0, rk[r]);
+      b1 = _mm_aesenc_si128(b1, rk[r]);
+      b2 = _mm_aesenc_si128(b2, rk[r]);
+      b3 = _mm_aesenc_si128(b3, rk[r]);
+    }
+    b0 = _mm_aesenclast_si128(b0, rk[Nr]);
+    b1 = _mm_aesenclast_si128(b1, rk[Nr]);
+    b2 = _mm_aesenclast_si128(b2, rk[Nr]);
+    b3 = _mm_aesenclast_si128(b3, rk[Nr]);
+
+    _mm_storeu_si128((__m128i *) buf, _mm_xor_si128(b0, _mm_loadu_si128((const __m128i *) buf)));
+    _mm_storeu_si128((__m128i *) (buf + 16), _mm_xor_si128(b1, _mm_loadu_si128((const __m128i *) (buf + 16))));
+    _mm_storeu_si128((__m128i *) (buf + 32), _mm_xor_si128(b2, _mm_loadu_si128((const __m128i *) (buf + 32))));
+    _mm_storeu_si128((__m128i *) (buf + 48), _mm_xor_si128(b3, _mm_loadu_si128((const __m128i *) (buf + 48))));
+    //keep last keystream block as the scalar code does
+    if (length == 4*AES_BLOCKLEN)
+      _mm_storeu_si128((__m128i *) ctx->buffer, b3);
+
+    buf += 4*AES_BLOCKLEN;
+    length -= 4*AES_BLOCKLEN;
+  }
+  bi = AES_BLOCKLEN;
+  while (length)
+  {
+    __m128i b = aesni_encrypt_block(AESNI_CTR_BLOCK(hi, lo), rk);
+    AESNI_CTR_INC(hi, lo);
+    if (length >= AES_BLOCKLEN)
+    {
+      _mm_storeu_si128((__m128i *) buf, _mm_xor_si128(b, _mm_loadu_si128((const __m128i *) buf)));
+      if (length == AES_BLOCKLEN)
+        _mm_storeu_si128((__m128i *) ctx->buffer, b);
+      buf += AES_BLOCKLEN;
+      length -= AES_BLOCKLEN;
+    }
+    //partial block, keystream kept in ctx for next call
+    else
+    {
+      _mm_storeu_si128((__m128i *) ctx->buffer, b);
+      for (bi = 0; bi < (int) length; ++bi)
+      {
+        buf[bi] = (buf[bi] ^ ctx->buffer[bi]);
+      }
+      length = 0;
+    }
+  }
+  aesni_store_be64(ctx->Iv, hi);
+  aesni_store_be64(ctx->Iv + 8, lo);
+  ctx->counter_pos = (AES_BLOCKLEN - bi);
+}
+
+#endif // TINYAES_AESNI
+
+
 /*****************************************************************************/
 /* Public functions:                                                         */
 /*****************************************************************************/
@@ -479,12 +742,26 @@ static void InvCipher(state_t* state,u8* RoundKey)
 
 void AES_ECB_encrypt(struct AES_ctx *ctx,const u8* buf)
 {
+#ifdef TINYAES_AESNI
+  if (aesni_available())
+  {
+    aesni_ecb(ctx, (u8*)buf, 0);
+    return;
+  }
+#endif
   // The next function call encrypts the PlainText with the Key using AES algorithm.
   Cipher((state_t*)buf, ctx->RoundKey);
 }
 
 void AES_ECB_decrypt(struct AES_ctx* ctx,const u8* buf)
 {
+#ifdef TINYAES_AESNI
+  if (aesni_available())
+  {
+    aesni_ecb(ctx, (u8*)buf, 1);
+    return;
+  }
+#endif
   // The next function call decrypts the PlainText with the Key using AES algorithm.
   InvCipher((state_t*)buf, ctx->RoundKey);
 }
@@ -512,6 +789,13 @@ void AES_CBC_encrypt_buffer(struct AES_ctx *ctx,u8* buf, u32 length)
 {
   uintptr_t i;
   u8 *Iv = ctx->Iv;
+#ifdef TINYAES_AESNI
+  if (aesni_available())
+  {
+    aesni_cbc_encrypt(ctx, buf, length);
+    return;
+  }
+#endif
   for (i = 0; i < length; i += AES_BLOCKLEN)
   {
     XorWithIv(buf, Iv);
@@ -528,6 +812,13 @@ void AES_CBC_decrypt_buffer(struct AES_ctx* ctx, u8* buf,  u32 length)
 {
   uintptr_t i;
   u8 storeNextIv[AES_BLOCKLEN];
+#ifdef TINYAES_AESNI
+  if (aesni_available())
+  {
+    aesni_cbc_decrypt(ctx, buf, length);
+    return;
+  }
+#endif
   for (i = 0; i < length; i += AES_BLOCKLEN)
   {
     memcpy(storeNextIv, buf, AES_BLOCKLEN);
@@ -551,6 +842,13 @@ void AES_CTR_xcrypt_buffer(struct AES_ctx* ctx, u8* buf, u32 length)
   unsigned i;
   int bi = (AES_BLOCKLEN - ctx->counter_pos);
   gf_assert(ctx->counter_pos<AES_BLOCKLEN);
+#ifdef TINYAES_AESNI
+  if (aesni_available())
+  {
+    aesni_ctr_xcrypt(ctx, buf, length);
+    return;
+  }
+#endif
 
   for (i = 0; i < length; ++i, ++bi)
   {
@@ -137,6 +137,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_fileio_tag_main_thread) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fileio_is_main_thread) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_fileio_set_write_state) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fileio_mem_writer) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_fileio_mem_writer_data) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_set_progress) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_set_progress_callback) )
@@ -330,6 +332,17 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_setup_multicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_is_multicast_address) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_no_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_register) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_unregister) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_sock_is_set) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_get_ready) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_set_usr_data) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_usr_data) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_set_would_block) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_set_usec_wait) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_is_local) )
@@ -491,6 +504,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_parse) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_enable_arena) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_create_attribute) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_append_child) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_xml_dom_get_root) )
@@ -2107,7 +2121,9 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_delete_segment_list) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_parse_master_playlist) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write_patch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_write_m3u8_master_playlist) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_base_url_count) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_resolve_url) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_duration) )
@@ -2322,6 +2338,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_route_dmx_debug_tsi) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_add_cache_entry) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_cache_stats) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_force_headers) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_set_localcache_provider) )
 
@@ -506,25 +506,51 @@ GF_Filter *gf_filter_new(GF_FilterSession *fsess, const GF_FilterRegister *freg,
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Created filter register %s (%p) args %s\n", freg->name, filter, filter->orig_args ? filter->orig_args : "none"));
 	}
 
+	if (freg->flags & GF_FS_REG_SINGLE_THREAD)
+		gf_filter_set_thread(filter, 0);
+
+	return filter;
+}
+
+void gf_filter_set_thread(GF_Filter *filter, u32 th_idx)
+{
 #ifndef GPAC_DISABLE_THREADS
-	if ((freg->flags & GF_FS_REG_SINGLE_THREAD) && gf_list_count(filter->session->threads)) {
-		u32 count = gf_list_count(filter->session->threads);
-		GF_SessionThread *ft;
-		u32 idx=0;
+	GF_SessionThread *ft;
+	u32 i, count = gf_list_count(filter->session->threads);
+	if (!count || (th_idx>count)) return;
+
+	if (!th_idx) {
 		u32 min_th_assigned = 0;
 		for (i=0; i<count; i++) {
 			ft = gf_list_get(filter->session->threads, i);
-			if (!idx || (min_th_assigned>ft->nb_filters_pinned)) {
-				idx = i+1;
+			if (!th_idx || (min_th_assigned>ft->nb_filters_pinned)) {
+				th_idx = i+1;
 				min_th_assigned = ft->nb_filters_pinned;
 			}
 		}
-		ft = gf_list_get(filter->session->threads, idx-1);
-		safe_int_inc(&ft->nb_filters_pinned);
-		filter->restrict_th_idx = idx;
 	}
+	if (filter->restrict_th_idx == th_idx) return;
+	if (filter->restrict_th_idx) {
+		ft = gf_list_get(filter->session->threads, filter->restrict_th_idx-1);
+		safe_int_dec(&ft->nb_filters_pinned);
+	}
+	ft = gf_list_get(filter->session->threads, th_idx-1);
+	safe_int_inc(&ft->nb_filters_pinned);
+	filter->restrict_th_idx = th_idx;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s pinned to thread %d\n", filter->name, th_idx));
 #endif
-	return filter;
+}
+
+GF_EXPORT
+Bool gf_filter_pin_thread(GF_Filter *filter)
+{
+	if (!filter) return GF_FALSE;
+	//already pinned by its register, keep it
+	if (!filter->restrict_th_idx)
+		gf_filter_set_thread(filter, 0);
+	if (!filter->restrict_th_idx) return GF_FALSE;
+	filter->pin_chain = GF_TRUE;
+	return GF_TRUE;
 }
 
 void gf_filter_check_pending_pids(GF_Filter *filter)
@@ -679,8 +705,11 @@ void gf_filter_del(GF_Filter *filter)
 		gf_fq_del(filter->pcks_shared_reservoir, gf_void_del);
 	if (filter->pcks_inst_reservoir)
 		gf_fq_del(filter->pcks_inst_reservoir, gf_void_del);
-	if (filter->pcks_alloc_reservoir)
+	if (filter->pcks_alloc_reservoir) {
+		//keep allocated packets in session depot for other filters
+		gf_filter_pck_slab_flush(filter);
 		gf_fq_del(filter->pcks_alloc_reservoir, gf_filterpacket_del);
+	}
 
 	gf_mx_del(filter->pcks_mx);
 	if (filter->tasks_mx)
@@ -3163,6 +3192,13 @@ static void gf_filter_process_task(GF_FSTask *task)
 #endif
 		e = filter->freg->process(filter);
 
+	//filter did not close its batch dispatch, flush pending wake-ups
+	if (filter->batch_dispatch) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Filter %s batch dispatch not closed at end of process\n", filter->name));
+		filter->batch_dispatch = 1;
+		gf_filter_batch_dispatch(filter, GF_FALSE);
+	}
+
 	filter->in_process_callback = GF_FALSE;
 	gf_rmt_end();
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s process done\n", filter->name));
@@ -3299,6 +3335,13 @@ void gf_filter_process_inline(GF_Filter *filter)
 #endif
 		e = filter->freg->process(filter);
 
+	//filter did not close its batch dispatch, flush pending wake-ups
+	if (filter->batch_dispatch) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Filter %s batch dispatch not closed at end of process\n", filter->name));
+		filter->batch_dispatch = 1;
+		gf_filter_batch_dispatch(filter, GF_FALSE);
+	}
+
 	filter->in_process_callback = GF_FALSE;
 	filter->in_process = GF_FALSE;
 
@@ -5318,6 +5361,7 @@ GF_Err gf_filter_push_caps(GF_Filter *filter, u32 code, GF_PropertyValue *value,
 	GF_FilterRegister *freg = (GF_FilterRegister *)filter->freg;
 	freg->caps = filter->forced_caps;
 	freg->nb_caps = filter->nb_forced_caps;
+	filter->session->link_cache_reg_ok = GF_FALSE;
 	gf_filter_sess_reset_graph(filter->session, filter->freg);
 	gf_filter_sess_build_graph(filter->session, filter->freg);
 
@@ -5450,6 +5494,35 @@ void gf_filter_lock(GF_Filter *filter, Bool do_lock)
 		gf_mx_v(filter->tasks_mx);
 }
 
+static void gf_filter_batch_flush(GF_Filter *filter)
+{
+	u32 i, j, count = gf_list_count(filter->output_pids);
+	for (i=0; i<count; i++) {
+		GF_FilterPid *pid = gf_list_get(filter->output_pids, i);
+		u32 nb_dst = pid->num_destinations;
+		for (j=0; j<nb_dst; j++) {
+			GF_FilterPidInst *dst = gf_list_get(pid->destinations, j);
+			if (!dst || !dst->batch_post_pending) continue;
+			dst->batch_post_pending = GF_FALSE;
+			gf_filter_post_process_task_internal(dst->filter, pid->direct_dispatch);
+		}
+	}
+}
+
+GF_EXPORT
+void gf_filter_batch_dispatch(GF_Filter *filter, Bool start)
+{
+	if (!filter) return;
+	if (start) {
+		filter->batch_dispatch++;
+		return;
+	}
+	if (!filter->batch_dispatch) return;
+	filter->batch_dispatch--;
+	if (!filter->batch_dispatch)
+		gf_filter_batch_flush(filter);
+}
+
 GF_EXPORT
 void gf_filter_lock_all(GF_Filter *filter, Bool do_lock)
 {
@@ -5714,6 +5787,8 @@ GF_Err gf_filter_get_possible_destinations(GF_Filter *filter, s32 opid_idx, char
 		if (!filter->num_output_pids) return GF_FILTER_NOT_FOUND;
 	}
 	*res_list = NULL;
+	//graph is not loaded at startup when using link cache
+	gf_fs_ensure_graph(filter->session);
 	count = gf_list_count(filter->session->links);
 	for (i=0; i<count; i++) {
 		Bool is_match=GF_FALSE;
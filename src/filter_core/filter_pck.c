@@ -25,6 +25,10 @@
 
 #include "filter_session.h"
 
+#ifdef GPAC_CONFIG_LINUX
+#include <sys/mman.h>
+#endif
+
 static void gf_filter_pck_reset_props(GF_FilterPacket *pck, GF_FilterPid *pid)
 {
 	memset(&pck->info, 0, sizeof(GF_FilterPckInfo));
@@ -73,81 +77,179 @@ GF_Err gf_filter_pck_merge_properties(GF_FilterPacket *pck_src, GF_FilterPacket
 	return gf_filter_pck_merge_properties_filter(pck_src, pck_dst, NULL, NULL);
 }
 
-typedef struct
+//get size class for a payload of the given size, rounding up. Returns -1 if size is too large to be pooled
+static s32 pck_slab_class(u32 size, u32 *class_size)
 {
-	u32 data_size;
-	GF_FilterPacket *pck;
-	GF_FilterPacket *closest;
-} GF_PckQueueEnum;
+	u32 nbits, shift, q;
+	if (size <= (1<<GF_PCK_SLAB_MIN_BITS)) {
+		if (class_size) *class_size = 1<<GF_PCK_SLAB_MIN_BITS;
+		return 0;
+	}
+	nbits = gf_get_bit_size(size-1);
+	if (nbits > GF_PCK_SLAB_MAX_BITS) return -1;
+	//keep the 2 bits following the MSB, giving 4 classes per power of two
+	shift = nbits - 3;
+	q = ((size-1) >> shift) + 1;
+	if (class_size) *class_size = q << shift;
+	return 1 + 4*(nbits - GF_PCK_SLAB_MIN_BITS - 1) + (q - 5);
+}
+
+//get size class in which a payload of the given allocated size can be stored, rounding down
+static s32 pck_slab_class_floor(u32 alloc_size)
+{
+	u32 class_size;
+	s32 c;
+	if (alloc_size < (1<<GF_PCK_SLAB_MIN_BITS)) return -1;
+	c = pck_slab_class(alloc_size, &class_size);
+	if (c<0) return GF_PCK_SLAB_NUM_CLASSES-1;
+	if (class_size > alloc_size) c--;
+	return c;
+}
 
-static void pck_queue_enum(void *udta, void *item)
+static void pck_slab_depot_push(GF_FilterSession *fsess, GF_FilterPacket *pck)
 {
-	GF_PckQueueEnum *enum_state = (GF_PckQueueEnum *) udta;
-	GF_FilterPacket *cur = (GF_FilterPacket *) item;
+	s32 c = pck_slab_class_floor(pck->alloc_size);
+	if ((c<0) || (fsess->pck_slab_depot_size + pck->alloc_size > fsess->pck_slab_depot_max_size)) {
+		fsess->nb_slab_depot_drops++;
+		if (pck->data) gf_free(pck->data);
+		gf_free(pck);
+		return;
+	}
+	pck->slab_next = fsess->pck_slab_depot[c];
+	fsess->pck_slab_depot[c] = pck;
+	fsess->pck_slab_depot_size += pck->alloc_size;
+	fsess->pck_slab_depot_count++;
+}
 
-	if (cur->alloc_size >= enum_state->data_size) {
-		if (!enum_state->pck || (enum_state->pck->alloc_size > cur->alloc_size)) {
-			enum_state->pck = cur;
+static void pck_slab_cache_push(GF_Filter *filter, GF_FilterPacket *pck)
+{
+	s32 c;
+	//cache full, move to session depot
+	if (filter->nb_pck_slabs >= GF_PCK_SLAB_CACHE_MAX) {
+		gf_mx_p(filter->session->pck_slab_mx);
+		pck_slab_depot_push(filter->session, pck);
+		gf_mx_v(filter->session->pck_slab_mx);
+		return;
+	}
+	c = pck_slab_class_floor(pck->alloc_size);
+	if (c<0) {
+		if (pck->data) gf_free(pck->data);
+		gf_free(pck);
+		return;
+	}
+	pck->slab_next = filter->pck_slabs[c];
+	filter->pck_slabs[c] = pck;
+	filter->nb_pck_slabs++;
+}
+
+void gf_filter_pck_slab_flush(GF_Filter *filter)
+{
+	u32 i;
+	GF_FilterPacket *pck;
+	GF_FilterSession *fsess = filter->session;
+	if (!filter->pcks_alloc_reservoir) return;
+
+	gf_mx_p(fsess->pck_slab_mx);
+	while ((pck = gf_fq_pop(filter->pcks_alloc_reservoir))) {
+		pck_slab_depot_push(fsess, pck);
+	}
+	for (i=0; i<GF_PCK_SLAB_NUM_CLASSES; i++) {
+		while ((pck = filter->pck_slabs[i])) {
+			filter->pck_slabs[i] = pck->slab_next;
+			pck_slab_depot_push(fsess, pck);
+		}
+	}
+	filter->nb_pck_slabs = 0;
+	fsess->nb_slab_hits += filter->nb_slab_hits;
+	fsess->nb_slab_misses += filter->nb_slab_misses;
+	filter->nb_slab_hits = filter->nb_slab_misses = 0;
+	gf_mx_v(fsess->pck_slab_mx);
+}
+
+void gf_fs_pck_slab_reset(GF_FilterSession *fsess)
+{
+	u32 i;
+	GF_FilterPacket *pck;
+	gf_mx_p(fsess->pck_slab_mx);
+	for (i=0; i<GF_PCK_SLAB_NUM_CLASSES; i++) {
+		while ((pck = fsess->pck_slab_depot[i])) {
+			fsess->pck_slab_depot[i] = pck->slab_next;
+			if (pck->data) gf_free(pck->data);
+			gf_free(pck);
 		}
 	}
-	else if (!enum_state->closest) enum_state->closest = cur;
-	//small data blocks, find smaller one
-	else if (enum_state->data_size<1000) {
-		if (enum_state->closest->alloc_size > cur->alloc_size) enum_state->closest = cur;
+	fsess->pck_slab_depot_size = 0;
+	fsess->pck_slab_depot_count = 0;
+	gf_mx_v(fsess->pck_slab_mx);
+}
+
+static u8 *pck_slab_alloc_payload(GF_FilterSession *fsess, u32 size)
+{
+	u8 *data = gf_malloc(sizeof(char)*size);
+#if defined(GPAC_CONFIG_LINUX) && defined(MADV_HUGEPAGE)
+	//hint transparent huge pages on the 2MB-aligned part of large payloads
+	if (data && fsess->pck_slab_hugepages && (size >= 2*(1<<20)) ) {
+		u64 hp_size = 2*(1<<20);
+		u64 start = ((u64) (uintptr_t) data + hp_size - 1) & ~(hp_size-1);
+		u64 end = ((u64) (uintptr_t) data + size) & ~(hp_size-1);
+		if (end > start)
+			madvise((void *) (uintptr_t) start, (size_t) (end - start), MADV_HUGEPAGE);
 	}
-	//otherwise find largest one below our target size
-	else if (enum_state->closest->alloc_size < cur->alloc_size) enum_state->closest = cur;
+#endif
+	return data;
 }
 
 static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32 data_size, u8 **data)
 {
 	GF_FilterPacket *pck=NULL;
-	GF_FilterPacket *closest=NULL;
-	u32 count, max_reservoir_size;
+	GF_Filter *filter;
+	u32 alloc_size = data_size;
+	s32 c, i;
 
 	if (PID_IS_INPUT(pid)) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt to allocate a packet on an input PID in filter %s\n", pid->filter->name));
 		return NULL;
 	}
+	filter = pid->filter;
 
-	count = gf_fq_count(pid->filter->pcks_alloc_reservoir);
-
-	if (count) {
-		//don't let reservoir grow too large (may happen if burst of packets are stored/consumed in the upper chain)
-		while (count>30) {
-			GF_FilterPacket *head_pck = gf_fq_pop(pid->filter->pcks_alloc_reservoir);
-			gf_free(head_pck->data);
-			gf_free(head_pck);
-			count--;
+	if (filter->pcks_alloc_reservoir) {
+		GF_FilterPacket *rel_pck;
+		//move released packets to our slab cache. We can safely do this since this filter
+		//is the only one accessing the queue in pop mode, all others are just pushing to it
+		while ((rel_pck = gf_fq_pop(filter->pcks_alloc_reservoir))) {
+			pck_slab_cache_push(filter, rel_pck);
 		}
 
-		GF_PckQueueEnum pck_enum_state;
-		memset(&pck_enum_state, 0, sizeof(GF_PckQueueEnum));
-		pck_enum_state.data_size = data_size;
-		gf_fq_enum(pid->filter->pcks_alloc_reservoir, pck_queue_enum, &pck_enum_state);
-		pck = pck_enum_state.pck;
-		closest = pck_enum_state.closest;
-	}
-
-	//stop allocating after a while - TODO we for sure can design a better algo...
-	max_reservoir_size = pid->num_destinations ? 10 : 1;
-	//if pid is file, force 1 max
-	if (!pck && (pid->stream_type==GF_STREAM_FILE))
-		max_reservoir_size = 1;
-
-	if (!pck && (count>=max_reservoir_size)) {
-		if (!closest) return NULL;
-		closest->alloc_size = data_size;
-		closest->data = gf_realloc(closest->data, closest->alloc_size);
-		if (!closest->data) {
-			gf_free(closest);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
-			return NULL;
+		c = pck_slab_class(data_size, &alloc_size);
+		if (c>=0) {
+			s32 max_c = MIN(c + GF_PCK_SLAB_MAX_UPCLASS, GF_PCK_SLAB_NUM_CLASSES-1);
+			//look in our cache first, then in session depot
+			for (i=c; i<=max_c; i++) {
+				pck = filter->pck_slabs[i];
+				if (!pck) continue;
+				filter->pck_slabs[i] = pck->slab_next;
+				filter->nb_pck_slabs--;
+				filter->nb_slab_hits++;
+				break;
+			}
+			if (!pck && filter->session->pck_slab_depot_count) {
+				GF_FilterSession *fsess = filter->session;
+				gf_mx_p(fsess->pck_slab_mx);
+				for (i=c; i<=max_c; i++) {
+					pck = fsess->pck_slab_depot[i];
+					if (!pck) continue;
+					fsess->pck_slab_depot[i] = pck->slab_next;
+					fsess->pck_slab_depot_size -= pck->alloc_size;
+					fsess->pck_slab_depot_count--;
+					fsess->nb_slab_depot_hits++;
+					break;
+				}
+				gf_mx_v(fsess->pck_slab_mx);
+			}
+		} else {
+			alloc_size = data_size;
 		}
-		pck = closest;
-#ifdef GPAC_MEMORY_TRACKING
-		pid->filter->session->nb_realloc_pck++;
-#endif
+		if (!pck) filter->nb_slab_misses++;
 	}
 
 	if (!pck) {
@@ -156,32 +258,18 @@ static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32
 			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
 			return NULL;
 		}
-		pck->data = gf_malloc(sizeof(char)*data_size);
+		pck->data = pck_slab_alloc_payload(filter->session, alloc_size);
 		if (!pck->data) {
 			gf_free(pck);
 			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
 			return NULL;
 		}
-		pck->alloc_size = data_size;
+		pck->alloc_size = alloc_size;
 #ifdef GPAC_MEMORY_TRACKING
 		pid->filter->session->nb_alloc_pck+=2;
 #endif
-	} else {
-		//pop first item and swap pointers. We can safely do this since this filter
-		//is the only one accessing the queue in pop mode, all others are just pushing to it
-		//this may however imply that we don't get the best matching block size if new packets
-		//were added to the list
-
-		GF_FilterPacket *head_pck = gf_fq_pop(pid->filter->pcks_alloc_reservoir);
-		char *pck_data = pck->data;
-		u32 alloc_size = pck->alloc_size;
-		pck->data = head_pck->data;
-		pck->alloc_size = head_pck->alloc_size;
-		head_pck->data = pck_data;
-		head_pck->alloc_size = alloc_size;
-		pck = head_pck;
 	}
-
+	pck->slab_next = NULL;
 	pck->pck = pck;
 	pck->data_length = data_size;
 	if (data) *data = pck->data;
@@ -1333,8 +1421,12 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 				
 			gf_mx_v(pid->filter->tasks_mx);
 
-			//post process task
-			gf_filter_post_process_task_internal(dst->filter, pid->direct_dispatch);
+			//post process task, deferred until end of batch if any
+			if (pid->filter->batch_dispatch) {
+				dst->batch_post_pending = GF_TRUE;
+			} else {
+				gf_filter_post_process_task_internal(dst->filter, pid->direct_dispatch);
+			}
 		}
 	}
 
@@ -1377,6 +1469,31 @@ GF_Err gf_filter_pck_send(GF_FilterPacket *pck)
 	return gf_filter_pck_send_internal(pck, GF_TRUE);
 }
 
+GF_EXPORT
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks)
+{
+	u32 i;
+	GF_Err e = GF_OK;
+	GF_Filter *filter;
+	if (!pcks || !nb_pcks || !pcks[0] || !pcks[0]->pid) return GF_BAD_PARAM;
+
+	filter = pcks[0]->pid->filter;
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	for (i=0; i<nb_pcks; i++) {
+		GF_Err res;
+		if (!pcks[i]) continue;
+		if (pcks[i]->pid && (pcks[i]->pid->filter != filter)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Filter %s: batch send of packet from another filter %s, not supported\n", filter->name, pcks[i]->pid->filter->name));
+			e = GF_BAD_PARAM;
+			continue;
+		}
+		res = gf_filter_pck_send(pcks[i]);
+		if (res && !e) e = res;
+	}
+	gf_filter_batch_dispatch(filter, GF_FALSE);
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_ref(GF_FilterPacket **pck)
 {
@@ -3155,6 +3155,374 @@ void dump_graph_edges(Bool is_before, GF_FilterRegDesc *reg_dst, GF_List *dijkst
 }
 #endif
 
+typedef struct
+{
+	u8 key[GF_SHA1_DIGEST_SIZE];
+	u32 distance, priority;
+	//space-separated list of name@cap_idx
+	char *chain;
+} GF_LinkCacheEntry;
+
+#define LINK_CACHE_MAX_ENTRIES	4096
+#define LINK_CACHE_HEADER	"gpac-link-cache"
+
+static void link_cache_reset(GF_FilterSession *fsess)
+{
+	while (gf_list_count(fsess->link_cache)) {
+		GF_LinkCacheEntry *lce = gf_list_pop_back(fsess->link_cache);
+		gf_free(lce->chain);
+		gf_free(lce);
+	}
+}
+
+static void link_cache_hash_cap(GF_SHA1Context *sha, const GF_FilterCapability *cap)
+{
+	char szDump[GF_PROP_DUMP_ARG_SIZE];
+	char szCap[100];
+	sprintf(szCap, "%u %u %u %u ", cap->code, cap->flags, cap->priority, cap->val.type);
+	gf_sha1_update(sha, (u8 *) szCap, (u32) strlen(szCap));
+	if (cap->name) gf_sha1_update(sha, (u8 *) cap->name, (u32) strlen(cap->name));
+	if (cap->val.type) {
+		const char *val = gf_props_dump_val(&cap->val, szDump, GF_PROP_DUMP_DATA_NONE, NULL);
+		if (val) gf_sha1_update(sha, (u8 *) val, (u32) strlen(val));
+	}
+}
+
+//hash the filter registry, so that any change in filters or modules available or in their caps invalidates the cache
+static void link_cache_check_registry(GF_FilterSession *fsess)
+{
+	u32 i, j, count;
+	u8 hash[GF_SHA1_DIGEST_SIZE];
+	GF_SHA1Context *sha;
+	const char *version = gf_gpac_version();
+
+	if (fsess->link_cache_reg_ok) return;
+
+	fsess->nb_link_cache_codes = 0;
+	if (!fsess->link_cache_names) fsess->link_cache_names = gf_list_new();
+	gf_list_reset(fsess->link_cache_names);
+
+	sha = gf_sha1_starts();
+	gf_sha1_update(sha, (u8 *) version, (u32) strlen(version));
+	count = gf_list_count(fsess->registry);
+	for (i=0; i<count; i++) {
+		char szReg[100];
+		const GF_FilterRegister *freg = gf_list_get(fsess->registry, i);
+		//scripts and custom filters are never used as intermediate filters and links involving them are not cached
+		if (freg->flags & (GF_FS_REG_SCRIPT|GF_FS_REG_CUSTOM)) continue;
+		gf_sha1_update(sha, (u8 *) freg->name, (u32) strlen(freg->name));
+		if (freg->version) gf_sha1_update(sha, (u8 *) freg->version, (u32) strlen(freg->version));
+		sprintf(szReg, "%u %u %u", freg->flags, freg->priority, freg->nb_caps);
+		gf_sha1_update(sha, (u8 *) szReg, (u32) strlen(szReg));
+
+		for (j=0; j<freg->nb_caps; j++) {
+			u32 k;
+			const GF_FilterCapability *cap = &freg->caps[j];
+			link_cache_hash_cap(sha, cap);
+			if (!(cap->flags & GF_CAPFLAG_INPUT)) continue;
+
+			if (cap->name) {
+				Bool found = GF_FALSE;
+				for (k=0; k<gf_list_count(fsess->link_cache_names); k++) {
+					if (!strcmp(cap->name, gf_list_get(fsess->link_cache_names, k))) {
+						found = GF_TRUE;
+						break;
+					}
+				}
+				if (!found) gf_list_add(fsess->link_cache_names, (void *) cap->name);
+				continue;
+			}
+			if (!cap->code) continue;
+			for (k=0; k<fsess->nb_link_cache_codes; k++) {
+				if (fsess->link_cache_codes[k] == cap->code) break;
+			}
+			if (k<fsess->nb_link_cache_codes) continue;
+			if (!(fsess->nb_link_cache_codes % 32)) {
+				fsess->link_cache_codes = gf_realloc(fsess->link_cache_codes, sizeof(u32) * (fsess->nb_link_cache_codes+32));
+			}
+			fsess->link_cache_codes[fsess->nb_link_cache_codes] = cap->code;
+			fsess->nb_link_cache_codes++;
+		}
+	}
+	gf_sha1_finish(sha, hash);
+	fsess->link_cache_reg_ok = GF_TRUE;
+
+	if (memcmp(hash, fsess->link_cache_reg_hash, GF_SHA1_DIGEST_SIZE)) {
+		if (gf_list_count(fsess->link_cache)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("[Filters] Filter registry changed, resetting link cache\n"));
+			link_cache_reset(fsess);
+		}
+		memcpy(fsess->link_cache_reg_hash, hash, GF_SHA1_DIGEST_SIZE);
+		fsess->link_cache_dirty = GF_TRUE;
+	}
+}
+
+static void link_cache_load(GF_FilterSession *fsess)
+{
+	char szLine[GF_MAX_PATH];
+	char szHash[2*GF_SHA1_DIGEST_SIZE+1];
+	FILE *f;
+	u32 i;
+
+	fsess->link_cache = gf_list_new();
+	link_cache_check_registry(fsess);
+
+	f = gf_fopen(fsess->link_cache_file, "rt");
+	if (!f) return;
+
+	for (i=0; i<GF_SHA1_DIGEST_SIZE; i++)
+		sprintf(szHash + 2*i, "%02x", fsess->link_cache_reg_hash[i]);
+
+	//check registry signature
+	if (!gf_fgets(szLine, GF_MAX_PATH, f)
+		|| strncmp(szLine, LINK_CACHE_HEADER" ", strlen(LINK_CACHE_HEADER)+1)
+		|| strncmp(szLine + strlen(LINK_CACHE_HEADER)+1, szHash, 2*GF_SHA1_DIGEST_SIZE)
+	) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("[Filters] Link cache %s outdated, ignoring\n", fsess->link_cache_file));
+		gf_fclose(f);
+		return;
+	}
+	fsess->link_cache_dirty = GF_FALSE;
+
+	while (gf_fgets(szLine, GF_MAX_PATH, f)) {
+		GF_LinkCacheEntry *lce;
+		u32 dist, prio;
+		char szKey[2*GF_SHA1_DIGEST_SIZE+1];
+		s32 chain_start = -1;
+		u32 len = (u32) strlen(szLine);
+		//drop lines truncated by a concurrent writer
+		if (!len || (szLine[len-1] != '\n')) continue;
+		while (len && ((szLine[len-1]=='\n') || (szLine[len-1]=='\r'))) {
+			szLine[len-1] = 0;
+			len--;
+		}
+		if (sscanf(szLine, "%40s %u %u %n", szKey, &dist, &prio, &chain_start) != 3) continue;
+		if ((strlen(szKey) != 2*GF_SHA1_DIGEST_SIZE) || (chain_start<0)) continue;
+
+		GF_SAFEALLOC(lce, GF_LinkCacheEntry);
+		if (!lce) break;
+		for (i=0; i<GF_SHA1_DIGEST_SIZE; i++) {
+			u32 v;
+			sscanf(szKey + 2*i, "%02x", &v);
+			lce->key[i] = (u8) v;
+		}
+		lce->distance = dist;
+		lce->priority = prio;
+		lce->chain = gf_strdup(szLine + chain_start);
+		gf_list_add(fsess->link_cache, lce);
+	}
+	gf_fclose(f);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("[Filters] Loaded %d entries from link cache %s\n", gf_list_count(fsess->link_cache), fsess->link_cache_file));
+}
+
+static Bool link_cache_key(GF_FilterSession *fsess, GF_FilterPid *pid, GF_Filter *dst, const char *prefRegister, GF_List *tmp_blacklist, u8 key[GF_SHA1_DIGEST_SIZE])
+{
+	char szDump[GF_PROP_DUMP_ARG_SIZE];
+	char szKey[GF_MAX_PATH];
+	GF_SHA1Context *sha;
+	GF_Filter *dst_filter = pid->filter->dst_filter;
+	GF_List *lists[3];
+	u32 i, j;
+
+	//caps negotiation in progress, not cachable
+	if (pid->caps_negotiate)
+		return GF_FALSE;
+	if ((dst->freg->flags | pid->filter->freg->flags) & (GF_FS_REG_SCRIPT|GF_FS_REG_CUSTOM))
+		return GF_FALSE;
+
+	if (!fsess->link_cache) link_cache_load(fsess);
+	else link_cache_check_registry(fsess);
+
+	sha = gf_sha1_starts();
+	gf_sha1_update(sha, fsess->link_cache_reg_hash, GF_SHA1_DIGEST_SIZE);
+	snprintf(szKey, GF_MAX_PATH, "%s|%s|%s|%d|%d|%d|%d|%d|%u|%s", pid->filter->freg->name, dst->freg->name,
+		dst_filter ? dst_filter->freg->name : "", (dst_filter==dst) ? 1 : 0, dst->bundle_idx_at_resolution,
+		dst->max_extra_pids ? 1 : 0, pid->ext_not_trusted, fsess->max_resolve_chain_len, dst->encoder_codec_id, prefRegister);
+	gf_sha1_update(sha, (u8 *) szKey, (u32) strlen(szKey));
+	//caps set on destination instance, e.g. from output file extension
+	for (i=0; i<dst->nb_forced_caps; i++)
+		link_cache_hash_cap(sha, &dst->forced_caps[i]);
+
+	lists[0] = tmp_blacklist;
+	lists[1] = pid->filter->blacklisted;
+	lists[2] = pid->adapters_blacklist;
+	for (i=0; i<3; i++) {
+		const GF_FilterRegister *freg;
+		j=0;
+		gf_sha1_update(sha, (u8 *) "|", 1);
+		while (lists[i] && (freg = gf_list_enum(lists[i], &j))) {
+			gf_sha1_update(sha, (u8 *) freg->name, (u32) strlen(freg->name));
+			gf_sha1_update(sha, (u8 *) " ", 1);
+		}
+	}
+
+	//only properties checked by filter caps matter for the resolution
+	for (i=0; i<fsess->nb_link_cache_codes; i++) {
+		const GF_PropertyValue *p = gf_filter_pid_get_property_first(pid, fsess->link_cache_codes[i]);
+		if (!p) continue;
+		sprintf(szKey, "|%u=", fsess->link_cache_codes[i]);
+		gf_sha1_update(sha, (u8 *) szKey, (u32) strlen(szKey));
+		gf_props_dump_val(p, szDump, GF_PROP_DUMP_DATA_NONE, NULL);
+		gf_sha1_update(sha, (u8 *) szDump, (u32) strlen(szDump));
+	}
+	for (i=0; i<gf_list_count(fsess->link_cache_names); i++) {
+		const char *name = gf_list_get(fsess->link_cache_names, i);
+		const GF_PropertyValue *p = gf_filter_pid_get_property_str_first(pid, name);
+		if (!p) continue;
+		snprintf(szKey, GF_MAX_PATH, "|%s=", name);
+		gf_sha1_update(sha, (u8 *) szKey, (u32) strlen(szKey));
+		gf_props_dump_val(p, szDump, GF_PROP_DUMP_DATA_NONE, NULL);
+		gf_sha1_update(sha, (u8 *) szDump, (u32) strlen(szDump));
+	}
+	gf_sha1_finish(sha, key);
+	return GF_TRUE;
+}
+
+static Bool link_cache_get(GF_FilterSession *fsess, u8 key[GF_SHA1_DIGEST_SIZE], GF_LinkInfo *link_info, GF_List *out_reg_chain)
+{
+	u32 i, count;
+	char *chain;
+	GF_LinkCacheEntry *lce = NULL;
+
+	count = gf_list_count(fsess->link_cache);
+	for (i=0; i<count; i++) {
+		lce = gf_list_get(fsess->link_cache, i);
+		if (!memcmp(lce->key, key, GF_SHA1_DIGEST_SIZE)) break;
+		lce = NULL;
+	}
+	if (!lce) return GF_FALSE;
+
+	chain = lce->chain;
+	while (chain && chain[0]) {
+		u32 j, cap_idx;
+		const GF_FilterRegister *freg = NULL;
+		char *sep = strchr(chain, ' ');
+		char *cap_sep = strchr(chain, '@');
+		if (!cap_sep || (sep && (cap_sep>sep)) || (sscanf(cap_sep+1, "%u", &cap_idx) != 1))
+			goto invalid;
+
+		cap_sep[0] = 0;
+		for (j=0; j<gf_list_count(fsess->registry); j++) {
+			freg = gf_list_get(fsess->registry, j);
+			if (!strcmp(freg->name, chain)) break;
+			freg = NULL;
+		}
+		cap_sep[0] = '@';
+		if (!freg || (cap_idx >= freg->nb_caps))
+			goto invalid;
+
+		gf_list_add(out_reg_chain, (void *) freg);
+		gf_list_add(out_reg_chain, (void *) &freg->caps[cap_idx]);
+		chain = sep ? sep+1 : NULL;
+	}
+	if (link_info) {
+		link_info->distance = lce->distance;
+		link_info->priority = lce->priority;
+	}
+	fsess->link_cache_hits++;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("[Filters] Link cache hit: %s\n", lce->chain[0] ? lce->chain : "no results"));
+	return GF_TRUE;
+
+invalid:
+	GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("[Filters] Invalid link cache entry %s, removing\n", lce->chain));
+	gf_list_reset(out_reg_chain);
+	gf_list_del_item(fsess->link_cache, lce);
+	gf_free(lce->chain);
+	gf_free(lce);
+	fsess->link_cache_dirty = GF_TRUE;
+	return GF_FALSE;
+}
+
+static void link_cache_add(GF_FilterSession *fsess, u8 key[GF_SHA1_DIGEST_SIZE], u32 distance, u32 priority, GF_List *out_reg_chain)
+{
+	u32 i, count;
+	GF_LinkCacheEntry *lce;
+	GF_SAFEALLOC(lce, GF_LinkCacheEntry);
+	if (!lce) return;
+	memcpy(lce->key, key, GF_SHA1_DIGEST_SIZE);
+	lce->distance = distance;
+	lce->priority = priority;
+	count = gf_list_count(out_reg_chain);
+	for (i=0; i+1<count; i+=2) {
+		char szCap[20];
+		const GF_FilterRegister *freg = gf_list_get(out_reg_chain, i);
+		const GF_FilterCapability *cap = gf_list_get(out_reg_chain, i+1);
+		sprintf(szCap, "@%u", (u32) (cap - freg->caps));
+		if (i) gf_dynstrcat(&lce->chain, " ", NULL);
+		gf_dynstrcat(&lce->chain, freg->name, NULL);
+		gf_dynstrcat(&lce->chain, szCap, NULL);
+	}
+	if (!lce->chain) lce->chain = gf_strdup("");
+
+	//drop oldest entries
+	while (gf_list_count(fsess->link_cache) >= LINK_CACHE_MAX_ENTRIES) {
+		GF_LinkCacheEntry *old = gf_list_pop_front(fsess->link_cache);
+		gf_free(old->chain);
+		gf_free(old);
+	}
+	gf_list_add(fsess->link_cache, lce);
+	fsess->link_cache_misses++;
+	fsess->link_cache_dirty = GF_TRUE;
+}
+
+void gf_filter_sess_link_cache_del(GF_FilterSession *fsess)
+{
+	if (!fsess->link_cache_file) return;
+
+	if (fsess->link_cache_hits || fsess->link_cache_misses) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("[Filters] Link cache %s: %d hits %d misses (%d %%)\n", fsess->link_cache_file, fsess->link_cache_hits, fsess->link_cache_misses,
+			(100*fsess->link_cache_hits) / (fsess->link_cache_hits + fsess->link_cache_misses) ));
+	}
+
+	if (fsess->link_cache && fsess->link_cache_dirty) {
+		char *tmp_name = NULL;
+		char szPID[30];
+		FILE *f;
+		sprintf(szPID, ".%u", gf_sys_get_process_id());
+		gf_dynstrcat(&tmp_name, fsess->link_cache_file, NULL);
+		gf_dynstrcat(&tmp_name, szPID, NULL);
+		//write to a temp file so that concurrent sessions never see a partial cache
+		f = tmp_name ? gf_fopen(tmp_name, "wt") : NULL;
+		if (!f) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("[Filters] Failed to open link cache %s for write\n", tmp_name ? tmp_name : fsess->link_cache_file));
+		} else {
+			u32 i, j;
+			GF_LinkCacheEntry *lce;
+			gf_fprintf(f, LINK_CACHE_HEADER" ");
+			for (i=0; i<GF_SHA1_DIGEST_SIZE; i++)
+				gf_fprintf(f, "%02x", fsess->link_cache_reg_hash[i]);
+			gf_fprintf(f, "\n");
+			i=0;
+			while ((lce = gf_list_enum(fsess->link_cache, &i))) {
+				for (j=0; j<GF_SHA1_DIGEST_SIZE; j++)
+					gf_fprintf(f, "%02x", lce->key[j]);
+				gf_fprintf(f, " %u %u %s\n", lce->distance, lce->priority, lce->chain);
+			}
+			gf_fclose(f);
+			//move replaces the cache atomically on POSIX, remove old cache only if the platform cannot overwrite it
+			if (gf_file_move(tmp_name, fsess->link_cache_file) != GF_OK) {
+				gf_file_delete(fsess->link_cache_file);
+				if (gf_file_move(tmp_name, fsess->link_cache_file) != GF_OK) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("[Filters] Failed to write link cache %s\n", fsess->link_cache_file));
+					gf_file_delete(tmp_name);
+				}
+			}
+		}
+		if (tmp_name) gf_free(tmp_name);
+	}
+	if (fsess->link_cache) {
+		link_cache_reset(fsess);
+		gf_list_del(fsess->link_cache);
+		fsess->link_cache = NULL;
+	}
+	if (fsess->link_cache_names) gf_list_del(fsess->link_cache_names);
+	fsess->link_cache_names = NULL;
+	if (fsess->link_cache_codes) gf_free(fsess->link_cache_codes);
+	fsess->link_cache_codes = NULL;
+	gf_free(fsess->link_cache_file);
+	fsess->link_cache_file = NULL;
+}
+
 static void gf_filter_pid_resolve_link_dijkstra(GF_FilterPid *pid, GF_Filter *dst, const char *prefRegister, Bool reconfigurable_only, GF_List *tmp_blacklist, GF_LinkInfo *link_info, GF_List *out_reg_chain)
 {
 	GF_FilterRegDesc *reg_dst, *result;
@@ -3168,8 +3536,18 @@ static void gf_filter_pid_resolve_link_dijkstra(GF_FilterPid *pid, GF_Filter *ds
 	u32 path_weight, pid_stream_type, max_weight=0;
 	u64 dijkstra_time_us, sort_time_us, start_time_us = gf_sys_clock_high_res();
 	const GF_PropertyValue *p;
-	if (!fsess->links || ! gf_list_count( fsess->links))
-	 	gf_filter_sess_build_graph(fsess, NULL);
+	u32 res_distance=0, res_priority=0;
+	u8 link_key[GF_SHA1_DIGEST_SIZE];
+	Bool use_link_cache = GF_FALSE;
+
+	//check persistent link cache before building the graph
+	if (fsess->link_cache_file && !reconfigurable_only) {
+		use_link_cache = link_cache_key(fsess, pid, dst, prefRegister, tmp_blacklist, link_key);
+		if (use_link_cache && link_cache_get(fsess, link_key, link_info, out_reg_chain))
+			return;
+	}
+
+	gf_fs_ensure_graph(fsess);
 
 	dijkstra_nodes = gf_list_new();
 
@@ -3184,7 +3562,7 @@ static void gf_filter_pid_resolve_link_dijkstra(GF_FilterPid *pid, GF_Filter *ds
 	//note that encoders must use reconfigure output
 	if (reconfigurable_only
 		&& pid->caps_negotiate
-		&& (gf_list_count(pid->caps_negotiate->properties)==1)
+		&& (gf_props_count(pid->caps_negotiate)==1)
 	) {
 		const GF_PropertyValue *cid = gf_props_get_property(pid->caps_negotiate, GF_PROP_PID_CODECID, NULL);
 		//for now we only check decoders, encoders must use reconfigure output
@@ -3508,22 +3886,14 @@ static void gf_filter_pid_resolve_link_dijkstra(GF_FilterPid *pid, GF_Filter *ds
 	dijkstra_time_us = gf_sys_clock_high_res() - start_time_us;
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("[Filters] Dijkstra: sorted filters in "LLU" us, Dijkstra done in "LLU" us on %d nodes %d edges\n", sort_time_us, dijkstra_time_us, dijsktra_node_count, dijsktra_edge_count));
 
-	if (link_info) {
-		link_info->distance = 0;
-		link_info->priority = 0;
-	}
 	if (result && result->destination) {
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("[Filters] Dijkstra result: %s(%d)", result->freg->name, result->cap_idx));
-		if (link_info) {
-			link_info->distance += result->dist;
-			link_info->priority += result->priority;
-		}
+		res_distance += result->dist;
+		res_priority += result->priority;
 		result = result->destination;
 		while (result->destination) {
-			if (link_info) {
-				link_info->distance += result->dist;
-				link_info->priority += result->priority;
-			}
+			res_distance += result->dist;
+			res_priority += result->priority;
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, (" %s(%d)", result->freg->name, result->cap_idx ));
 			gf_list_add(out_reg_chain, (void *) result->freg);
 			gf_list_add(out_reg_chain, (void *) &result->freg->caps[result->cap_idx]);
@@ -3533,6 +3903,12 @@ static void gf_filter_pid_resolve_link_dijkstra(GF_FilterPid *pid, GF_Filter *ds
 	} else {
 		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("[Filters] Dijkstra: no results found!\n"));
 	}
+	if (link_info) {
+		link_info->distance = res_distance;
+		link_info->priority = res_priority;
+	}
+	if (use_link_cache)
+		link_cache_add(fsess, link_key, res_distance, res_priority, out_reg_chain);
 	gf_list_del(dijkstra_nodes);
 
 	bundle_cache_free(reg_dst);
@@ -3816,6 +4192,11 @@ static GF_Filter *gf_filter_pid_resolve_link_internal(GF_FilterPid *pid, GF_Filt
 			if (!af) goto exit;
 			af->subsession_id = dst->subsession_id;
 			if (dst->itag) af->itag = gf_strdup(dst->itag);
+			//destination is pinned, run the whole chain on the same thread
+			if (dst->pin_chain) {
+				gf_filter_set_thread(af, dst->restrict_th_idx);
+				af->pin_chain = GF_TRUE;
+			}
 
 			//destination is sink, check if af is a mux (output cap type STREAM=FILE present)
 			//if not, copy subsource_id from pid
@@ -4494,7 +4875,7 @@ static void dump_pid_props(GF_FilterPid *pid)
 	char szDump[GF_PROP_DUMP_ARG_SIZE];
 	const GF_PropertyEntry *p;
 	GF_PropertyMap *pmap = gf_list_get(pid->properties, 0);
-	while (pmap && (p = gf_list_enum(pmap->properties, &idx))) {
+	while (pmap && (idx < gf_props_count(pmap)) && (p = pmap->parray->entries[idx++])) {
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Pid prop %s: %s\n", gf_props_4cc_get_name(p->p4cc), gf_props_dump(p->p4cc, &p->prop, szDump, GF_PROP_DUMP_DATA_NONE) ));
 	}
 }
@@ -6612,6 +6993,30 @@ restart:
 	return (GF_FilterPacket *)pcki;
 }
 
+GF_EXPORT
+u32 gf_filter_pid_get_packets(GF_FilterPid *pid, GF_FilterPacket **pcks, u32 max_pcks)
+{
+	u32 nb_pcks;
+	GF_FilterPidInst *pidinst = (GF_FilterPidInst *)pid;
+	if (!pcks || !max_pcks) return 0;
+	pcks[0] = gf_filter_pid_get_packet(pid);
+	if (!pcks[0]) return 0;
+
+	nb_pcks = 1;
+	while (nb_pcks < max_pcks) {
+		GF_FilterPacketInstance *pcki = (GF_FilterPacketInstance *)gf_fq_get(pidinst->packets, nb_pcks);
+		if (!pcki || !pcki->pck) break;
+		//stop at internal commands, clock references and property/info changes, these are handled when the packet is fetched as head
+		if (pcki->pck->info.flags & (GF_PCK_CMD_MASK|GF_PCK_CKTYPE_MASK|GF_PCKF_PROPS_CHANGED|GF_PCKF_INFO_CHANGED))
+			break;
+		pcks[nb_pcks] = (GF_FilterPacket *)pcki;
+		nb_pcks++;
+	}
+	if (nb_pcks>1)
+		pidinst->last_pck_fetch_time = gf_sys_clock_high_res();
+	return nb_pcks;
+}
+
 static GF_FilterPacketInstance *gf_filter_pid_probe_next_packet(GF_FilterPidInst *pidinst)
 {
 	u32 i=0;
@@ -6808,8 +7213,8 @@ static void gf_filter_pidinst_reset_stats(GF_FilterPidInst *pidi)
 	pidi->first_frame_time = 0;
 }
 
-GF_EXPORT
-void gf_filter_pid_drop_packet(GF_FilterPid *pid)
+//if update_state is false, buffer occupancy is not recomputed and the source pid is not checked for unblocking
+static void gf_filter_pid_drop_packet_internal(GF_FilterPid *pid, Bool update_state)
 {
 #ifdef GPAC_MEMORY_TRACKING
 	u32 prev_nb_allocs, prev_nb_reallocs, nb_allocs, nb_reallocs;
@@ -6863,7 +7268,8 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 
 	//make sure we lock the tasks mutex before getting the packet count, otherwise we might end up with a wrong number of packets
 	//if one thread (the caller here) consumes one packet while the dispatching thread is still upddating the state for that pid
-	gf_mx_p(pid->filter->tasks_mx);
+	if (update_state)
+		gf_mx_p(pid->filter->tasks_mx);
 	nb_pck = gf_fq_count(pidinst->packets);
 
 	if (!nb_pck) {
@@ -6878,7 +7284,8 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 		safe_int64_sub(&pidinst->buffer_duration, (s32) d);
 	}
 
-	if ( (pid->num_destinations==1) || (pid->filter->session->blocking_mode==GF_FS_NOBLOCK_FANOUT)) {
+	//buffer state is only updated on the last drop of a batch
+	if (update_state && ((pid->num_destinations==1) || (pid->filter->session->blocking_mode==GF_FS_NOBLOCK_FANOUT)) ) {
 		if (nb_pck<pid->nb_buffer_unit) {
 			pid->nb_buffer_unit = nb_pck;
 		}
@@ -6888,7 +7295,7 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 	}
 	//handle fan-out: we must browse all other pid instances and compute max buffer/nb_pck per pids
 	//so that we don't unblock the PID if some instance is still blocking
-	else {
+	else if (update_state) {
 		u32 i;
 		u32 min_pck = nb_pck;
 		s64 min_dur = pidinst->buffer_duration;
@@ -6904,9 +7311,10 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 		pid->buffer_duration = min_dur;
 		pid->nb_buffer_unit = min_pck;
 	}
-	gf_filter_pid_check_unblock(pid);
-
-	gf_mx_v(pid->filter->tasks_mx);
+	if (update_state) {
+		gf_filter_pid_check_unblock(pid);
+		gf_mx_v(pid->filter->tasks_mx);
+	}
 
 #ifndef GPAC_DISABLE_LOG
 	if (gf_log_tool_level_on(GF_LOG_FILTER, GF_LOG_DEBUG)) {
@@ -6964,6 +7372,33 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 	gf_rmt_end();
 }
 
+GF_EXPORT
+void gf_filter_pid_drop_packet(GF_FilterPid *pid)
+{
+	gf_filter_pid_drop_packet_internal(pid, GF_TRUE);
+}
+
+GF_EXPORT
+u32 gf_filter_pid_drop_packets(GF_FilterPid *pid, u32 nb_pcks)
+{
+	u32 i, nb_queued;
+	GF_FilterPidInst *pidinst = (GF_FilterPidInst *)pid;
+	if (!pid || !nb_pcks) return 0;
+	if (PID_IS_OUTPUT(pid)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt to discard packets on an output PID in filter %s\n", pid->filter->name));
+		return 0;
+	}
+	nb_queued = gf_fq_count(pidinst->packets);
+	if (nb_pcks > nb_queued) nb_pcks = nb_queued;
+	if (!nb_pcks) return 0;
+
+	//only update buffer state and check unblock on the last drop
+	for (i=0; i<nb_pcks; i++) {
+		gf_filter_pid_drop_packet_internal(pid, (i+1==nb_pcks) ? GF_TRUE : GF_FALSE);
+	}
+	return nb_pcks;
+}
+
 GF_EXPORT
 Bool gf_filter_pid_is_eos(GF_FilterPid *pid)
 {
@@ -813,25 +813,173 @@ Bool gf_props_equal_strict(const GF_PropertyValue *p1, const GF_PropertyValue *p
 	return gf_props_equal_internal(p1, p2, GF_TRUE);
 }
 
-#if GF_PROPS_HASHTABLE_SIZE
-GFINLINE u32 gf_props_hash_djb2(u32 p4cc, const char *str)
+u32 gf_props_hash_djb2(u32 p4cc, const char *str)
 {
 	u32 hash = 5381;
+	int c;
+	//built-in properties are keyed by their 4CC
+	if (p4cc) return p4cc;
+	if (!str) return 0;
+	while ( (c = *str++) )
+		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+	return hash;
+}
 
-	if (p4cc) {
-		hash = ((hash << 5) + hash) + ((p4cc>>24)&0xFF);
-		hash = ((hash << 5) + hash) + ((p4cc>>16)&0xFF);
-		hash = ((hash << 5) + hash) + ((p4cc>>8)&0xFF);
-		hash = ((hash << 5) + hash) + (p4cc&0xFF);
-	} else {
-		int c;
-		while ( (c = *str++) )
-			hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+//get interned name for dynamic property names - returns NULL if table is full, in which case the name shall be copied
+static const char *gf_props_intern_name(GF_FilterSession *fsess, const char *name, u32 hash)
+{
+	u32 i, count;
+	char *iname;
+	GF_List *names;
+	if (!fsess->prop_names) return NULL;
+
+	gf_mx_p(fsess->props_mx);
+	names = fsess->prop_names[hash % GF_PROPS_NAMES_BUCKETS];
+	if (!names) {
+		names = fsess->prop_names[hash % GF_PROPS_NAMES_BUCKETS] = gf_list_new();
+	}
+	count = gf_list_count(names);
+	for (i=0; i<count; i++) {
+		iname = gf_list_get(names, i);
+		if (!strcmp(iname, name)) {
+			gf_mx_v(fsess->props_mx);
+			return iname;
+		}
+	}
+	iname = NULL;
+	if (fsess->nb_prop_names < GF_PROPS_MAX_NAMES) {
+		iname = gf_strdup(name);
+		gf_list_add(names, iname);
+		fsess->nb_prop_names++;
+	}
+	gf_mx_v(fsess->props_mx);
+	return iname;
+}
 
+void gf_props_del_names(GF_FilterSession *fsess)
+{
+	u32 i;
+	if (!fsess->prop_names) return;
+	for (i=0; i<GF_PROPS_NAMES_BUCKETS; i++) {
+		GF_List *names = fsess->prop_names[i];
+		if (!names) continue;
+		while (gf_list_count(names)) {
+			gf_free(gf_list_pop_back(names));
+		}
+		gf_list_del(names);
 	}
-	return (hash % GF_PROPS_HASHTABLE_SIZE);
+	gf_free(fsess->prop_names);
+	fsess->prop_names = NULL;
+	fsess->nb_prop_names = 0;
+}
+
+static GF_PropertyArray *gf_props_array_new(GF_FilterSession *fsess, u32 min_alloc)
+{
+	GF_PropertyArray *arr = fsess ? gf_fq_pop(fsess->prop_arrays_reservoir) : NULL;
+	if (!arr) {
+		GF_SAFEALLOC(arr, GF_PropertyArray);
+		if (!arr) return NULL;
+	}
+	if (arr->nb_alloc < min_alloc) {
+		u32 nb_alloc = MAX(min_alloc, GF_PROPS_ARRAY_MIN_ALLOC);
+		u32 *keys = gf_realloc(arr->keys, sizeof(u32) * nb_alloc);
+		GF_PropertyEntry **entries = keys ? gf_realloc(arr->entries, sizeof(GF_PropertyEntry *) * nb_alloc) : NULL;
+		if (keys) arr->keys = keys;
+		if (entries) arr->entries = entries;
+		if (!keys || !entries) {
+			//recycled arrays may own previous buffers
+			gf_props_array_del(arr);
+			return NULL;
+		}
+		arr->nb_alloc = nb_alloc;
+	}
+	arr->nb_props = 0;
+	arr->reference_count = 1;
+	return arr;
+}
+
+void gf_props_array_del(void *parr)
+{
+	GF_PropertyArray *arr = parr;
+	if (arr->keys) gf_free(arr->keys);
+	if (arr->entries) gf_free(arr->entries);
+	gf_free(arr);
+}
+
+static void gf_props_array_release(GF_FilterSession *fsess, GF_PropertyArray *arr)
+{
+	if (safe_int_dec(&arr->reference_count)) return;
+
+	while (arr->nb_props) {
+		arr->nb_props--;
+		gf_props_del_property(arr->entries[arr->nb_props]);
+	}
+	if (!fsess || gf_fq_res_add(fsess->prop_arrays_reservoir, arr)) {
+		gf_props_array_del(arr);
+	}
+}
+
+//get property array for modification, cloning it if shared with other maps
+static GF_Err gf_props_array_writable(GF_PropertyMap *map, u32 nb_add)
+{
+	GF_PropertyArray *arr = map->parray;
+	if (!arr) {
+		map->parray = gf_props_array_new(map->session, nb_add);
+		return map->parray ? GF_OK : GF_OUT_OF_MEM;
+	}
+	if (arr->reference_count>1) {
+		u32 i;
+		GF_PropertyArray *clone = gf_props_array_new(map->session, arr->nb_props + nb_add);
+		if (!clone) return GF_OUT_OF_MEM;
+		memcpy(clone->keys, arr->keys, sizeof(u32) * arr->nb_props);
+		memcpy(clone->entries, arr->entries, sizeof(GF_PropertyEntry *) * arr->nb_props);
+		clone->nb_props = arr->nb_props;
+		for (i=0; i<clone->nb_props; i++)
+			safe_int_inc(&clone->entries[i]->reference_count);
+		map->parray = clone;
+		gf_props_array_release(map->session, arr);
+		return GF_OK;
+	}
+	if (arr->nb_props + nb_add > arr->nb_alloc) {
+		u32 nb_alloc = MAX(arr->nb_alloc*2, arr->nb_props + nb_add);
+		u32 *keys = gf_realloc(arr->keys, sizeof(u32) * nb_alloc);
+		GF_PropertyEntry **entries;
+		if (!keys) return GF_OUT_OF_MEM;
+		arr->keys = keys;
+		entries = gf_realloc(arr->entries, sizeof(GF_PropertyEntry *) * nb_alloc);
+		if (!entries) return GF_OUT_OF_MEM;
+		arr->entries = entries;
+		arr->nb_alloc = nb_alloc;
+	}
+	return GF_OK;
+}
+
+//locate property in array - returns -1 if not found
+static GFINLINE s32 gf_props_array_find(GF_PropertyArray *arr, u32 hash, u32 p4cc, const char *name)
+{
+	u32 i;
+	if (!arr) return -1;
+	for (i=0; i<arr->nb_props; i++) {
+		GF_PropertyEntry *p;
+		if (arr->keys[i] != hash) continue;
+		p = arr->entries[i];
+		if (!p) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Concurrent read/write access to property map, cannot query property now\n"));
+			return -1;
+		}
+		if (p4cc) {
+			if (p->p4cc==p4cc) return i;
+		} else if (p->pname && ((p->pname==name) || !strcmp(p->pname, name)) ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+u32 gf_props_count(GF_PropertyMap *map)
+{
+	return map->parray ? map->parray->nb_props : 0;
 }
-#endif
 
 GF_PropertyMap * gf_props_new(GF_Filter *filter)
 {
@@ -844,10 +992,6 @@ GF_PropertyMap * gf_props_new(GF_Filter *filter)
 		if (!map) return NULL;
 
 		map->session = filter->session;
-#if GF_PROPS_HASHTABLE_SIZE
-#else
-		map->properties = gf_list_new();
-#endif
 	}
 	gf_assert(!map->reference_count);
 	map->reference_count = 1;
@@ -935,36 +1079,26 @@ void gf_props_del_property(GF_PropertyEntry *it)
 
 void gf_propmap_del(void *pmap)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	gf_free(pamp);
-#else
 	GF_PropertyMap *map = pmap;
-	gf_list_del(map->properties);
+	//maps in reservoir only hold unshared and empty arrays
+	if (map->parray) gf_props_array_del(map->parray);
 	gf_free(map);
-#endif
-
 }
+
 void gf_props_reset(GF_PropertyMap *prop)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i;
-	for (i=0; i<GF_PROPS_HASHTABLE_SIZE; i++) {
-		if (prop->hash_table[i]) {
-			GF_List *l = prop->hash_table[i];
-			while (gf_list_count(l)) {
-				gf_props_del_property((GF_PropertyEntry *) gf_list_pop_back(l) );
-			}
-			prop->hash_table[i] = NULL;
-			if (gf_fq_res_add(prop->session->prop_maps_list_reservoir, l)) {
-				gf_list_del(l);
-			}
-		}
+	GF_PropertyArray *arr = prop->parray;
+	if (!arr) return;
+	//shared with other maps, drop our reference
+	if (arr->reference_count>1) {
+		prop->parray = NULL;
+		gf_props_array_release(prop->session, arr);
+		return;
 	}
-#else
-	while (gf_list_count(prop->properties)) {
-		gf_props_del_property( (GF_PropertyEntry *) gf_list_pop_back(prop->properties) );
+	while (arr->nb_props) {
+		arr->nb_props--;
+		gf_props_del_property(arr->entries[arr->nb_props]);
 	}
-#endif
 }
 
 void gf_props_del(GF_PropertyMap *map)
@@ -977,8 +1111,7 @@ void gf_props_del(GF_PropertyMap *map)
 	map->reference_count = 0;
 	map->timescale = 0;
 	if (!map->session || gf_fq_res_add(map->session->prop_maps_reservoir, map)) {
-		gf_list_del(map->properties);
-		gf_free(map);
+		gf_propmap_del(map);
 	}
 }
 
@@ -987,44 +1120,20 @@ void gf_props_del(GF_PropertyMap *map)
 //purge existing property of same name
 void gf_props_remove_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const char *name)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	if (map->hash_table[hash]) {
-		u32 i, count = gf_list_count(map->hash_table[hash]);
-		for (i=0; i<count; i++) {
-			GF_PropertyEntry *prop = gf_list_get(map->hash_table[hash], i);
-			if ((p4cc && (p4cc==prop->p4cc)) || (name && prop->pname && !strcmp(prop->pname, name)) ) {
-				gf_list_rem(map->hash_table[hash], i);
-				gf_props_del_property(prop);
-				break;
-			}
-		}
-	}
-#else
-	u32 i, count = gf_list_count(map->properties);
-	for (i=0; i<count; i++) {
-		GF_PropertyEntry *prop = gf_list_get(map->properties, i);
-		if ((p4cc && (p4cc==prop->p4cc)) || (name && prop->pname && !strcmp(prop->pname, name)) ) {
-			gf_list_rem(map->properties, i);
-			gf_props_del_property(prop);
-			break;
-		}
+	GF_PropertyEntry *prop;
+	s32 idx = gf_props_array_find(map->parray, hash, p4cc, name);
+	if (idx<0) return;
+	if (gf_props_array_writable(map, 0) != GF_OK) return;
+
+	prop = map->parray->entries[idx];
+	map->parray->nb_props--;
+	if ((u32) idx < map->parray->nb_props) {
+		memmove(&map->parray->keys[idx], &map->parray->keys[idx+1], sizeof(u32) * (map->parray->nb_props - idx));
+		memmove(&map->parray->entries[idx], &map->parray->entries[idx+1], sizeof(GF_PropertyEntry *) * (map->parray->nb_props - idx));
 	}
-#endif
+	gf_props_del_property(prop);
 }
 
-
-#if GF_PROPS_HASHTABLE_SIZE
-GF_List *gf_props_get_list(GF_PropertyMap *map)
-{
-	GF_List *l;
-
-	l = gf_fq_pop(map->session->prop_maps_list_reservoir);
-
-	if (!l) l = gf_list_new();
-	return l;
-}
-#endif
-
 static GF_Err gf_props_assign_value(GF_PropertyEntry *prop, const GF_PropertyValue *value, Bool is_old_prop)
 {
 	char *src_ptr;
@@ -1095,31 +1204,15 @@ GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const c
 {
 	GF_PropertyEntry *prop;
 	GF_Err e;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i, count;
-#endif
 	if ((value->type == GF_PROP_DATA) || (value->type == GF_PROP_DATA_NO_COPY)) {
 		if (!value->value.data.ptr) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt at defining data property %s with NULL pointer, not allowed\n", p4cc ? gf_4cc_to_str(p4cc) : name ? name : dyn_name ));
 			return GF_BAD_PARAM;
 		}
 	}
-#if GF_PROPS_HASHTABLE_SIZE
-	if (! map->hash_table[hash] ) {
-		map->hash_table[hash] = gf_props_get_list(map);
-		if (!map->hash_table[hash]) return GF_OUT_OF_MEM;
-	} else {
-		count = gf_list_count(map->hash_table[hash]);
-		if (count) {
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("PropertyMap hash collision for %s - %d entries before insertion:\n", p4cc ? gf_4cc_to_str(p4cc) : name ? name : dyn_name, gf_list_count(map->hash_table[hash]) ));
-			for (i=0; i<count; i++) {
-				GF_PropertyEntry *prop_c = gf_list_get(map->hash_table[hash], i);
-				GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("\t%s\n\n", prop_c->pname ? prop_c->pname : gf_4cc_to_str(prop_c->p4cc)  ));
-				gf_assert(!prop_c->p4cc || (prop_c->p4cc != p4cc));
-			}
-		}
-	}
-#endif
+	e = gf_props_array_writable(map, 1);
+	if (e) return e;
+
 	if ((value->type == GF_PROP_DATA) && value->value.data.ptr) {
 		prop = gf_fq_pop(map->session->prop_maps_entry_data_alloc_reservoir);
 	} else {
@@ -1136,8 +1229,11 @@ GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const c
 	prop->p4cc = p4cc;
 	prop->pname = (char *) name;
 	if (dyn_name) {
-		prop->pname = gf_strdup(dyn_name);
-		prop->name_alloc=GF_TRUE;
+		prop->pname = (char *) gf_props_intern_name(map->session, dyn_name, hash);
+		if (!prop->pname) {
+			prop->pname = gf_strdup(dyn_name);
+			prop->name_alloc=GF_TRUE;
+		}
 	}
 
 	e = gf_props_assign_value(prop, value, GF_FALSE);
@@ -1145,13 +1241,10 @@ GF_Err gf_props_insert_property(GF_PropertyMap *map, u32 hash, u32 p4cc, const c
 		gf_props_del_property(prop);
 		return e;
 	}
-
-#if GF_PROPS_HASHTABLE_SIZE
-	return gf_list_add(map->hash_table[hash], prop);
-#else
-	return gf_list_add(map->properties, prop);
-#endif
-
+	map->parray->keys[map->parray->nb_props] = hash;
+	map->parray->entries[map->parray->nb_props] = prop;
+	map->parray->nb_props++;
+	return GF_OK;
 }
 
 GF_Err gf_props_set_property(GF_PropertyMap *map, u32 p4cc, const char *name, char *dyn_name, const GF_PropertyValue *value)
@@ -1170,58 +1263,13 @@ GF_Err gf_props_set_property(GF_PropertyMap *map, u32 p4cc, const char *name, ch
 
 const GF_PropertyEntry *gf_props_get_property_entry(GF_PropertyMap *map, u32 prop_4cc, const char *name)
 {
-	u32 i, count, len;
-	const GF_PropertyEntry *res=NULL;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 hash = gf_props_hash_djb2(prop_4cc, name);
-	if (map->hash_table[hash] ) {
-		count = gf_list_count(map->hash_table[hash]);
-		for (i=0; i<count; i++) {
-			GF_PropertyEntry *p = gf_list_get(map->hash_table[hash], i);
-
-			if ((prop_4cc && (p->p4cc==prop_4cc)) || (p->pname && name && !strcmp(p->pname, name)) ) {
-				res = p;
-				break;
-			}
-		}
-	}
-#else
-	count = gf_list_count(map->properties);
-	if (name) {
-		len = (u32) strlen(name);
-	} else {
-		if (!prop_4cc) return NULL;
-		len = 0;
-	}
-	for (i=0; i<count; i++) {
-		GF_PropertyEntry *p = gf_list_get(map->properties, i);
-		if (!p) {
-			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Concurrent read/write access to property map, cannot query property now\n"));
-			return NULL;
-		}
+	s32 idx;
+	GF_PropertyArray *arr = map->parray;
+	if (!prop_4cc && !name) return NULL;
 
-		if (prop_4cc) {
-			if (p->p4cc==prop_4cc) {
-				res = p;
-				break;
-			}
-		} else if (p->pname) {
-			u32 j;
-			for (j=0; j<=len; j++) {
-				char c = p->pname[j];
-				if (!c)
-					break;
-				if (c != name[j])
-					break;
-			}
-			if (j==len) {
-				res = p;
-				break;
-			}
-		}
-	}
-#endif
-	return res;
+	idx = gf_props_array_find(arr, gf_props_hash_djb2(prop_4cc, name), prop_4cc, name);
+	if (idx<0) return NULL;
+	return arr->entries[idx];
 }
 
 const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc, const char *name)
@@ -1234,90 +1282,51 @@ const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc,
 GF_Err gf_props_merge_property(GF_PropertyMap *dst_props, GF_PropertyMap *src_props, gf_filter_prop_filter filter_prop, void *cbk)
 {
 	GF_Err e;
-	u32 i, count;
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 idx;
-#endif
-	GF_List *list;
+	u32 i;
+	GF_PropertyArray *src = src_props->parray;
 	if (src_props->timescale)
 		dst_props->timescale = src_props->timescale;
 
-#if GF_PROPS_HASHTABLE_SIZE
-	for (idx=0; idx<GF_PROPS_HASHTABLE_SIZE; idx++) {
-		if (src_props->hash_table[idx]) {
-			list = src_props->hash_table[idx];
-#else
-			list = src_props->properties;
-#endif
-			count = gf_list_count(list);
-			for (i=0; i<count; i++) {
-				GF_PropertyEntry *prop = gf_list_get(list, i);
-				gf_assert(prop->reference_count);
-				if (!filter_prop || filter_prop(cbk, prop->p4cc, prop->pname, &prop->prop)) {
-					safe_int_inc(&prop->reference_count);
-
-#if GF_PROPS_HASHTABLE_SIZE
-					if (!dst_props->hash_table[idx]) {
-						dst_props->hash_table[idx] = gf_props_get_list(dst_props);
-						if (!dst_props->hash_table[idx]) return GF_OUT_OF_MEM;
-					}
-					e = gf_list_add(dst_props->hash_table[idx], prop);
-					if (e) return e;
-#else
-					e = gf_list_add(dst_props->properties, prop);
-					if (e) return e;
-#endif
-				}
-			}
-#if GF_PROPS_HASHTABLE_SIZE
+	if (!src || !src->nb_props) return GF_OK;
+
+	//no filtering and no properties in destination, share source array until one of the maps is modified
+	if (!filter_prop && !gf_props_count(dst_props)) {
+		if (dst_props->parray) gf_props_array_release(dst_props->session, dst_props->parray);
+		safe_int_inc(&src->reference_count);
+		dst_props->parray = src;
+		return GF_OK;
+	}
+
+	for (i=0; i<src->nb_props; i++) {
+		GF_PropertyEntry *prop = src->entries[i];
+		gf_assert(prop->reference_count);
+		if (!filter_prop || filter_prop(cbk, prop->p4cc, prop->pname, &prop->prop)) {
+			e = gf_props_array_writable(dst_props, 1);
+			if (e) return e;
+			safe_int_inc(&prop->reference_count);
+			dst_props->parray->keys[dst_props->parray->nb_props] = src->keys[i];
+			dst_props->parray->entries[dst_props->parray->nb_props] = prop;
+			dst_props->parray->nb_props++;
 		}
 	}
-#endif
 	return GF_OK;
 }
 
 const GF_PropertyValue *gf_props_enum_property(GF_PropertyMap *props, u32 *io_idx, u32 *prop_4cc, const char **prop_name)
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	u32 i, nb_items = 0;
-#endif
 	u32 idx, count;
-
 	const GF_PropertyEntry *pe;
 	if (!io_idx) return NULL;
 
 	idx = *io_idx;
 	if (idx == 0xFFFFFFFF) return NULL;
 
-#if GF_PROPS_HASHTABLE_SIZE
-	for (i=0; i<GF_PROPS_HASHTABLE_SIZE; i++) {
-		if (props->hash_table[i]) {
-			count = gf_list_count(props->hash_table[i]);
-			nb_items+=count;
-			if (idx >= count) {
-				idx -= count;
-				continue;
-			}
-			pe = gf_list_get(props->hash_table[i], idx);
-			if (!pe) {
-				*io_idx = nb_items;
-				return NULL;
-			}
-			if (prop_4cc) *prop_4cc = pe->p4cc;
-			if (prop_name) *prop_name = pe->pname;
-			*io_idx = (*io_idx) + 1;
-			return &pe->prop;
-		}
-	}
-	*io_idx = nb_items;
-	return NULL;
-#else
-	count = gf_list_count(props->properties);
+	count = gf_props_count(props);
 	if (idx >= count) {
 		*io_idx = count;
 		return NULL;
 	}
-	pe = gf_list_get(props->properties, idx);
+	pe = props->parray->entries[idx];
 	if (!pe) {
 		*io_idx = count;
 		return NULL;
@@ -1326,7 +1335,6 @@ const GF_PropertyValue *gf_props_enum_property(GF_PropertyMap *props, u32 *io_id
 	if (prop_name) *prop_name = pe->pname;
 	*io_idx = (*io_idx) + 1;
 	return &pe->prop;
-#endif
 }
 
 typedef struct
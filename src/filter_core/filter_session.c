@@ -37,6 +37,72 @@ struct _gf_ft_mgr *gf_font_manager_new();
 void gf_font_manager_del(struct _gf_ft_mgr *fm);
 #endif
 
+//get number of tasks in secondary task lists
+static u32 gf_fs_secondary_tasks_count(GF_FilterSession *fsess)
+{
+	u32 nb_tasks = gf_fq_count(fsess->tasks);
+#ifndef GPAC_DISABLE_THREADS
+	if (fsess->work_stealing) {
+		u32 i, count = gf_list_count(fsess->threads);
+		for (i=0; i<count; i++) {
+			GF_SessionThread *sess_th = gf_list_get(fsess->threads, i);
+			nb_tasks += gf_fq_count(sess_th->tasks);
+		}
+	}
+#endif
+	return nb_tasks;
+}
+
+//post a notified task to the secondary task lists. In work-stealing mode, the task is posted to the
+//thread which last processed the filter, if any
+static void gf_fs_add_secondary_task(GF_FilterSession *fsess, GF_FSTask *task)
+{
+#ifndef GPAC_DISABLE_THREADS
+	if (fsess->work_stealing && task->filter && task->filter->sched_th_idx && !task->filter->restrict_th_idx) {
+		GF_SessionThread *sess_th = gf_list_get(fsess->threads, task->filter->sched_th_idx-1);
+		if (sess_th) {
+			gf_fq_add(sess_th->tasks, task);
+			return;
+		}
+	}
+#endif
+	gf_fq_add(fsess->tasks, task);
+}
+
+//get next task from secondary task lists. In work-stealing mode, check the thread task list first, then the shared
+//task list, then steal from other threads starting with the next thread
+static GF_FSTask *gf_fs_pop_secondary_task(GF_FilterSession *fsess, GF_SessionThread *sess_thread, u32 thid)
+{
+	GF_FSTask *task;
+#ifndef GPAC_DISABLE_THREADS
+	u32 i, count;
+	if (!fsess->work_stealing)
+		return gf_fq_pop(fsess->tasks);
+
+	if (sess_thread->tasks) {
+		task = gf_fq_pop(sess_thread->tasks);
+		if (task) return task;
+	}
+	task = gf_fq_pop(fsess->tasks);
+	if (task) return task;
+
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		GF_SessionThread *victim = gf_list_get(fsess->threads, (thid + i) % count);
+		if (victim == sess_thread) continue;
+		task = gf_fq_pop(victim->tasks);
+		if (task) {
+			sess_thread->nb_steals++;
+			return task;
+		}
+	}
+	return NULL;
+#else
+	task = gf_fq_pop(fsess->tasks);
+	return task;
+#endif
+}
+
 static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool main)
 {
 	//we don't use sema on emscripten, we always give control back to main caller or pthread
@@ -60,7 +126,7 @@ static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool ma
 			nb_tasks = 1;
 			//no active threads, count number of tasks. If no posted tasks we are likely at the end of the session, don't block, rather use a sem_wait 
 			if (!fsess->active_threads)
-			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fq_count(fsess->tasks);
+			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fs_secondary_tasks_count(fsess);
 
 			//if main semaphore, keep track that we are going to sleep
 			if (main) {
@@ -137,6 +203,7 @@ void gf_fs_add_filter_register(GF_FilterSession *fsess, const GF_FilterRegister
 	gf_mx_p(fsess->filters_mx);
 	gf_list_add(fsess->registry, (void *) freg);
 	gf_mx_v(fsess->filters_mx);
+	fsess->link_cache_reg_ok = GF_FALSE;
 
 	if (fsess->init_done && fsess->links && gf_list_count( fsess->links)) {
 		gf_filter_sess_build_graph(fsess, freg);
@@ -325,15 +392,19 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, G
 		fsess->props_mx = gf_mx_new("FilterSessionProps");
 
 	if (!(flags & GF_FS_FLAG_NO_RESERVOIR)) {
-#if GF_PROPS_HASHTABLE_SIZE
-		fsess->prop_maps_list_reservoir = gf_fq_new(fsess->props_mx);
-#endif
+		fsess->prop_arrays_reservoir = gf_fq_new(fsess->props_mx);
 		fsess->prop_maps_reservoir = gf_fq_new(fsess->props_mx);
 		fsess->prop_maps_entry_reservoir = gf_fq_new(fsess->props_mx);
 		fsess->prop_maps_entry_data_alloc_reservoir = gf_fq_new(fsess->props_mx);
 		//we also use the props mutex for the this one
 		fsess->pcks_refprops_reservoir = gf_fq_new(fsess->props_mx);
+
+		if (nb_threads)
+			fsess->pck_slab_mx = gf_mx_new("FilterSessionPacketSlabs");
+		fsess->pck_slab_depot_max_size = gf_opts_get_int("core", "pck-pool");
+		fsess->pck_slab_hugepages = gf_opts_get_bool("core", "pck-hugepages");
 	}
+	GF_SAFE_ALLOC_N(fsess->prop_names, GF_PROPS_NAMES_BUCKETS, GF_List *);
 
 
 #ifndef GPAC_DISABLE_REMOTERY
@@ -350,6 +421,9 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, G
 	if (nb_threads) {
 		fsess->info_mx = gf_mx_new("FilterSessionInfo");
 		fsess->ui_mx = gf_mx_new("FilterSessionUIProc");
+#ifndef GPAC_CONFIG_EMSCRIPTEN
+		fsess->par_mx = gf_mx_new("FilterSessionParallelJob");
+#endif
 	}
 
 #ifndef GPAC_DISABLE_THREADS
@@ -368,8 +442,22 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, G
 			continue;
 		}
 		sess_thread->fsess = fsess;
+		if (sched_type==GF_FS_SCHEDULER_WORK_STEAL) {
+			sprintf(szName, "TasksListTh%d", i+1);
+			sess_thread->tasks_mx = gf_mx_new(szName);
+			sess_thread->tasks = gf_fq_new(sess_thread->tasks_mx);
+			if (!sess_thread->tasks) {
+				gf_mx_del(sess_thread->tasks_mx);
+				gf_th_del(sess_thread->th);
+				gf_free(sess_thread);
+				continue;
+			}
+		}
 		gf_list_add(fsess->threads, sess_thread);
 	}
+	if ((sched_type==GF_FS_SCHEDULER_WORK_STEAL) && fsess->threads && gf_list_count(fsess->threads)) {
+		fsess->work_stealing = GF_TRUE;
+	}
 #endif
 
 	gf_fs_set_separators(fsess, NULL);
@@ -418,7 +506,12 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, G
 	fsess->gl_providers = gf_list_new();
 #endif
 
-	if (! (fsess->flags & GF_FS_FLAG_NO_GRAPH_CACHE))
+	opt = gf_opts_get_key("core", "link-cache");
+	if (opt && opt[0])
+		fsess->link_cache_file = gf_strdup(opt);
+
+	//with persistent link cache, graph is only built upon first cache miss
+	if (! (fsess->flags & GF_FS_FLAG_NO_GRAPH_CACHE) && !fsess->link_cache_file)
 		gf_filter_sess_build_graph(fsess, NULL);
 
 	fsess->init_done = GF_TRUE;
@@ -542,6 +635,7 @@ GF_FilterSession *gf_fs_new_defaults(GF_FilterSessionFlags inflags)
 	else if (!strcmp(opt, "direct")) sched_type = GF_FS_SCHEDULER_DIRECT;
 	else if (!strcmp(opt, "free")) sched_type = GF_FS_SCHEDULER_LOCK_FREE;
 	else if (!strcmp(opt, "freex")) sched_type = GF_FS_SCHEDULER_LOCK_FREE_X;
+	else if (!strcmp(opt, "steal")) sched_type = GF_FS_SCHEDULER_WORK_STEAL;
 	else {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Unrecognized scheduler type %s\n", opt));
 		return NULL;
@@ -665,6 +759,7 @@ void gf_fs_remove_filter_register(GF_FilterSession *session, GF_FilterRegister *
 	gf_mx_p(session->filters_mx);
 	gf_list_del_item(session->registry, freg);
 	gf_mx_v(session->filters_mx);
+	session->link_cache_reg_ok = GF_FALSE;
 	gf_filter_sess_reset_graph(session, freg);
 }
 
@@ -828,6 +923,10 @@ void gf_fs_del(GF_FilterSession *fsess)
 		while (gf_list_count(fsess->threads)) {
 			GF_SessionThread *sess_th = gf_list_pop_back(fsess->threads);
 			gf_th_del(sess_th->th);
+			if (sess_th->tasks)
+				gf_fq_del(sess_th->tasks, gf_task_del);
+			if (sess_th->tasks_mx)
+				gf_mx_del(sess_th->tasks_mx);
 			gf_free(sess_th);
 		}
 		gf_list_del(fsess->threads);
@@ -836,10 +935,9 @@ void gf_fs_del(GF_FilterSession *fsess)
 
 	if (fsess->prop_maps_reservoir)
 		gf_fq_del(fsess->prop_maps_reservoir, gf_propmap_del);
-#if GF_PROPS_HASHTABLE_SIZE
-	if (fsess->prop_maps_list_reservoir)
-		gf_fq_del(fsess->prop_maps_list_reservoir, (gf_destruct_fun) gf_list_del);
-#endif
+	if (fsess->prop_arrays_reservoir)
+		gf_fq_del(fsess->prop_arrays_reservoir, gf_props_array_del);
+	gf_props_del_names(fsess);
 	if (fsess->prop_maps_entry_reservoir)
 		gf_fq_del(fsess->prop_maps_entry_reservoir, gf_void_del);
 	if (fsess->prop_maps_entry_data_alloc_reservoir)
@@ -847,6 +945,9 @@ void gf_fs_del(GF_FilterSession *fsess)
 	if (fsess->pcks_refprops_reservoir)
 		gf_fq_del(fsess->pcks_refprops_reservoir, gf_void_del);
 
+	gf_fs_pck_slab_reset(fsess);
+	if (fsess->pck_slab_mx)
+		gf_mx_del(fsess->pck_slab_mx);
 
 	if (fsess->props_mx)
 		gf_mx_del(fsess->props_mx);
@@ -857,6 +958,9 @@ void gf_fs_del(GF_FilterSession *fsess)
 	if (fsess->ui_mx)
 		gf_mx_del(fsess->ui_mx);
 
+	if (fsess->par_mx)
+		gf_mx_del(fsess->par_mx);
+
 	if (fsess->semaphore_other && (fsess->semaphore_other != fsess->semaphore_main) )
 		gf_sema_del(fsess->semaphore_other);
 
@@ -876,6 +980,7 @@ void gf_fs_del(GF_FilterSession *fsess)
 		gf_filter_sess_reset_graph(fsess, NULL);
 		gf_list_del(fsess->links);
 	}
+	gf_filter_sess_link_cache_del(fsess);
 	if (fsess->links_mx) gf_mx_del(fsess->links_mx);
 
 #ifndef GPAC_DISABLE_3D
@@ -1063,7 +1168,7 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 			gf_fs_sema_io(fsess, GF_TRUE, GF_TRUE);
 		} else {
 			gf_assert(task->run_task);
-			gf_fq_add(fsess->tasks, task);
+			gf_fs_add_secondary_task(fsess, task);
 			gf_fs_sema_io(fsess, GF_TRUE, GF_FALSE);
 		}
 	}
@@ -1608,6 +1713,29 @@ const char *gf_th_log_name(GF_Thread *t);
 #define gf_th_log_name(_t) "Main Process"
 #endif
 
+static void gf_fs_parallel_job_run(GF_FSParallelJob *pj, u32 thid)
+{
+	while (1) {
+		u32 first, last, idx = (u32) safe_int_inc(&pj->next_task) - 1;
+		if (idx >= pj->nb_tasks) break;
+		first = idx * pj->task_size;
+		last = first + pj->task_size;
+		if (last > pj->nb_items) last = pj->nb_items;
+		pj->job(pj->udta, first, last, thid);
+		safe_int_inc(&pj->nb_tasks_done);
+	}
+}
+
+//called by idle session threads to help running the pending parallel job
+static void gf_fs_parallel_job_help(GF_FilterSession *fsess, u32 thid)
+{
+	safe_int_inc(&fsess->par_job.nb_helpers);
+	//check again once registered, the job may have completed in between
+	if (fsess->par_job_active)
+		gf_fs_parallel_job_run(&fsess->par_job, thid);
+	safe_int_dec(&fsess->par_job.nb_helpers);
+}
+
 static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 {
 	GF_FilterSession *fsess = sess_thread->fsess;
@@ -1711,6 +1839,10 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			gf_fs_sema_io(fsess, GF_FALSE, use_main_sema);
 			consecutive_filter_tasks = 0;
 			gf_rmt_end();
+
+			//we may have been woken up to help on a parallel job
+			if (fsess->par_job_active)
+				gf_fs_parallel_job_help(fsess, thid);
 		}
 		safe_int_inc(&fsess->active_threads);
 		skip_next_sema_wait = GF_FALSE;
@@ -1724,7 +1856,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 					task = gf_fq_pop(fsess->main_thread_tasks);
 				}
 				if (!task) {
-					task = gf_fq_pop(fsess->tasks);
+					task = gf_fs_pop_secondary_task(fsess, sess_thread, thid);
 					//if task is blocking, don't use it, let a secondary thread deal with it
 					if (task && task->blocking) {
 						gf_fq_add(fsess->tasks, task);
@@ -1742,7 +1874,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 				}
 #endif
 			} else {
-				task = gf_fq_pop(fsess->tasks);
+				task = gf_fs_pop_secondary_task(fsess, sess_thread, thid);
 				if (task && (task->force_main || (task->filter && task->filter->nb_main_thread_forced) ) ) {
 					//post to main
 					gf_fq_add(fsess->main_thread_tasks, task);
@@ -1781,6 +1913,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 		if (!task) {
 			u32 force_nb_notif = 0;
 			next_task_schedule_time = 0;
+			sess_thread->nb_idle++;
 			//no more task and EOS signal
 			if (fsess->run_status != GF_OK)
 				break;
@@ -1816,7 +1949,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 			//no pending tasks and first time main task queue is empty, flush to detect if we
 			//are indeed done
-			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fs_secondary_tasks_count(fsess)) {
 				//maybe last task, force a notify to check if we are truly done
 				sess_thread->has_seen_eot = GF_TRUE;
 				//not main thread and some tasks pending on main, notify only ourselves
@@ -2124,6 +2257,9 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			gf_assert(!current_filter->in_process);
 			current_filter->in_process = GF_TRUE;
 			current_filter->process_th_id = gf_th_id();
+			//remember thread for next tasks of this filter
+			if (thid && fsess->work_stealing)
+				current_filter->sched_th_idx = thid;
 		}
 
 		sess_thread->nb_tasks++;
@@ -2304,12 +2440,12 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 #ifndef GPAC_DISABLE_THREADS
 					//FIXME, we sometimes miss a sema notfiy resulting in secondary tasks being locked
 					//until we find the cause, notify secondary sema if non-main-thread tasks are scheduled and we are the only task in main
-					if (use_main_sema && (thid==0) && fsess->threads && (gf_fq_count(fsess->main_thread_tasks)==1) && gf_fq_count(fsess->tasks)) {
+					if (use_main_sema && (thid==0) && fsess->threads && (gf_fq_count(fsess->main_thread_tasks)==1) && gf_fs_secondary_tasks_count(fsess)) {
 						gf_fs_sema_io(fsess, GF_TRUE, GF_FALSE);
 					}
 #endif
 				} else {
-					gf_fq_add(fsess->tasks, task);
+					gf_fs_add_secondary_task(fsess, task);
 				}
 				gf_fs_sema_io(fsess, GF_TRUE, use_main_sema);
 			}
@@ -2348,7 +2484,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			current_filter->in_process = GF_FALSE;
 		}
 		//not requeuing and first time we have an empty task queue, flush to detect if we are indeed done
-		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fs_secondary_tasks_count(fsess)) {
 			//if not the main thread, or if main thread and task list is empty, enter end of session probing mode
 			if (thid || !gf_fq_count(fsess->main_thread_tasks) ) {
 				//maybe last task, force a notify to check if we are truly done. We only tag "session done" for the non-main
@@ -2360,6 +2496,9 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 		sess_thread->active_time += gf_sys_clock_high_res() - active_start;
 
+		//tasks pending for this thread, process them before waiting on the semaphore to keep filters on the same thread
+		if (!current_filter && sess_thread->tasks && gf_fq_count(sess_thread->tasks))
+			skip_next_sema_wait = GF_TRUE;
 
 		//no main thread, return
 		if (!thid && fsess->non_blocking && !fsess->remove_tasks && !current_filter && !fsess->pid_connect_tasks_pending) {
@@ -2639,7 +2778,7 @@ GF_Err gf_fs_stop(GF_FilterSession *fsess)
 		if (gf_fq_count(fsess->main_thread_tasks))
 			continue;
 
-		if (count && (count == fsess->nb_threads_stopped) && gf_fq_count(fsess->tasks) ) {
+		if (count && (count == fsess->nb_threads_stopped) && gf_fs_secondary_tasks_count(fsess) ) {
 			continue;
 		}
 		break;
@@ -2784,7 +2923,11 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Session stats: "));
 #endif
 
-	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", fsess->main_th.run_time, fsess->main_th.active_time, fsess->main_th.nb_tasks));
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("run_time "LLU" us active_time "LLU" us nb_tasks "LLU"", fsess->main_th.run_time, fsess->main_th.active_time, fsess->main_th.nb_tasks));
+	if (fsess->work_stealing) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" nb_steals "LLU" nb_idle "LLU"", fsess->main_th.nb_steals, fsess->main_th.nb_idle));
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
 
 #ifndef GPAC_DISABLE_THREADS
 	run_time+=fsess->main_th.run_time;
@@ -2794,7 +2937,11 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 	for (i=0; i<count; i++) {
 		GF_SessionThread *s = gf_list_get(fsess->threads, i);
 
-		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", i+2, s->run_time, s->active_time, s->nb_tasks));
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"", i+2, s->run_time, s->active_time, s->nb_tasks));
+		if (fsess->work_stealing) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" nb_steals "LLU" nb_idle "LLU"", s->nb_steals, s->nb_idle));
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
 
 		run_time+=s->run_time;
 		active_time+=s->active_time;
@@ -2802,6 +2949,24 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 	}
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\nTotal: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", run_time, active_time, nb_tasks));
 #endif
+
+	if (!(fsess->flags & GF_FS_FLAG_NO_RESERVOIR)) {
+		u64 slab_hits, slab_misses;
+		gf_mx_p(fsess->filters_mx);
+		gf_mx_p(fsess->pck_slab_mx);
+		slab_hits = fsess->nb_slab_hits;
+		slab_misses = fsess->nb_slab_misses;
+		count = gf_list_count(fsess->filters);
+		for (i=0; i<count; i++) {
+			GF_Filter *f = gf_list_get(fsess->filters, i);
+			slab_hits += f->nb_slab_hits;
+			slab_misses += f->nb_slab_misses;
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Packet pool: "LLU" cache hits "LLU" depot hits "LLU" allocs "LLU" drops - depot %u packets "LLU" bytes\n",
+			slab_hits, fsess->nb_slab_depot_hits, slab_misses, fsess->nb_slab_depot_drops, fsess->pck_slab_depot_count, fsess->pck_slab_depot_size));
+		gf_mx_v(fsess->pck_slab_mx);
+		gf_mx_v(fsess->filters_mx);
+	}
 }
 
 static void gf_fs_print_filter_outputs(GF_Filter *f, GF_List *filters_done, u32 indent, GF_FilterPid *pid, GF_Filter *alias_for, u32 src_num_tiled_pids, Bool skip_print, s32 nb_recursion, u32 max_length)
@@ -3737,6 +3902,9 @@ static void gf_fs_print_jsf_connection(GF_FilterSession *session, char *filter_n
 	Bool has_output, has_input;
 	GF_FilterRegDesc local_reg;
 
+	//graph is not loaded at startup when using link cache
+	gf_fs_ensure_graph(session);
+
 	if (!js_filter) {
 		if (!filter_name) return;
 		js_filter = gf_fs_load_filter(session, filter_name, &e);
@@ -3851,6 +4019,9 @@ void gf_fs_print_all_connections(GF_FilterSession *session, char *filter_name, v
 	u32 i, j, k, count;
 	u32 llev = gf_log_get_tool_level(GF_LOG_FILTER);
 
+	//graph is not loaded at startup when using link cache
+	gf_fs_ensure_graph(session);
+
 	gf_log_set_tool_level(GF_LOG_FILTER, GF_LOG_INFO);
 	//load JS to inspect its connections
 	if (filter_name && strstr(filter_name, ".js")) {
@@ -4082,6 +4253,88 @@ GF_DownloadManager *gf_filter_get_download_manager(GF_Filter *filter)
 	return gf_fs_get_download_manager(filter->session);
 }
 
+GF_EXPORT
+u32 gf_filter_parallel_max_threads(GF_Filter *filter)
+{
+#ifndef GPAC_DISABLE_THREADS
+	if (filter && filter->session->par_mx)
+		return 1 + gf_list_count(filter->session->threads);
+#endif
+	return 1;
+}
+
+GF_EXPORT
+GF_Err gf_filter_parallel_for(GF_Filter *filter, u32 nb_items, u32 min_items, gf_filter_parallel_job job, void *udta)
+{
+	u32 thid = 0;
+	u32 nb_threads;
+	GF_FilterSession *fsess;
+	GF_FSParallelJob *pj;
+	if (!filter || !job) return GF_BAD_PARAM;
+	if (!nb_items) return GF_OK;
+	if (!min_items) min_items = 1;
+
+	fsess = filter->session;
+	nb_threads = gf_filter_parallel_max_threads(filter);
+	if ((nb_threads<2) || (nb_items < 2*min_items))
+		goto run_inline;
+
+#ifndef GPAC_DISABLE_THREADS
+	//locate calling thread, only session threads may post a parallel job
+	if (gf_th_id() != fsess->main_th.th_id) {
+		u32 i, th_id = gf_th_id();
+		for (i=0; i<nb_threads-1; i++) {
+			GF_SessionThread *st = gf_list_get(fsess->threads, i);
+			if (st->th_id == th_id) {
+				thid = i+1;
+				break;
+			}
+		}
+		if (!thid) goto run_inline;
+	}
+#endif
+	//job slot used by another filter (or nested call), run inline
+	if (!gf_mx_try_lock(fsess->par_mx))
+		goto run_inline;
+	if (fsess->par_job_active) {
+		gf_mx_v(fsess->par_mx);
+		goto run_inline;
+	}
+
+	pj = &fsess->par_job;
+	pj->job = job;
+	pj->udta = udta;
+	pj->nb_items = nb_items;
+	//bound task granularity: at least min_items per task, at most GF_FS_PAR_TASKS_PER_THREAD tasks per thread
+	pj->task_size = nb_items / (nb_threads * GF_FS_PAR_TASKS_PER_THREAD);
+	if (pj->task_size < min_items) pj->task_size = min_items;
+	pj->nb_tasks = (nb_items + pj->task_size - 1) / pj->task_size;
+	pj->next_task = 0;
+	pj->nb_tasks_done = 0;
+	safe_int_inc(&fsess->par_job_active);
+
+	//wake up idle threads
+	gf_sema_notify(fsess->semaphore_other, MIN(pj->nb_tasks, nb_threads) - 1);
+	if (thid && fsess->in_main_sem_wait)
+		gf_sema_notify(fsess->semaphore_main, 1);
+
+	gf_fs_parallel_job_run(pj, thid);
+	while (pj->nb_tasks_done < pj->nb_tasks) {
+		gf_sleep(0);
+	}
+	safe_int_dec(&fsess->par_job_active);
+	//wait for helpers to leave before releasing the slot
+	while (pj->nb_helpers) {
+		gf_sleep(0);
+	}
+	gf_mx_v(fsess->par_mx);
+	return GF_OK;
+
+run_inline:
+	job(udta, 0, nb_items, thid);
+	return GF_OK;
+}
+
 GF_EXPORT
 struct _gf_ft_mgr *gf_fs_get_font_manager(GF_FilterSession *fsess)
 {
@@ -4227,7 +4480,7 @@ Bool gf_fs_is_last_task(GF_FilterSession *fsess)
 	if (!fsess) return GF_TRUE;
 	if (fsess->tasks_pending>1) return GF_FALSE;
 	if (gf_fq_count(fsess->main_thread_tasks)) return GF_FALSE;
-	if (gf_fq_count(fsess->tasks)) return GF_FALSE;
+	if (gf_fs_secondary_tasks_count(fsess)) return GF_FALSE;
 	if (fsess->non_blocking && fsess->tasks_in_process) return GF_FALSE;
 	return GF_TRUE;
 }
@@ -4400,11 +4653,21 @@ Bool gf_fs_ui_event(GF_FilterSession *session, GF_Event *uievt)
 	return ret;
 }
 
+//builds the filter registry graph if not loaded, graph may be built lazily by link resolution of other threads
+void gf_fs_ensure_graph(GF_FilterSession *fsess)
+{
+	gf_mx_p(fsess->links_mx);
+	if (!fsess->links || ! gf_list_count( fsess->links))
+		gf_filter_sess_build_graph(fsess, NULL);
+	gf_mx_v(fsess->links_mx);
+}
+
 void gf_fs_check_graph_load(GF_FilterSession *fsess, Bool for_load)
 {
 	if (for_load) {
-		if (!fsess->links || ! gf_list_count( fsess->links))
-			gf_filter_sess_build_graph(fsess, NULL);
+		//graph is built by link resolution upon cache miss
+		if (fsess->link_cache_file) return;
+		gf_fs_ensure_graph(fsess);
 	} else {
 		if (fsess->flags & GF_FS_FLAG_NO_GRAPH_CACHE)
 			gf_filter_sess_reset_graph(fsess, NULL);
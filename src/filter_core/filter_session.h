@@ -62,19 +62,30 @@ struct __gf_prop_entry
 
 #define GF_FS_FLAG_FORCE_DEBUG	(1<<30)
 
-#ifndef GF_PROPS_HASHTABLE_SIZE
-#define GF_PROPS_HASHTABLE_SIZE 0
-#endif
+//initial number of entries in property arrays
+#define GF_PROPS_ARRAY_MIN_ALLOC	16
+//number of buckets for interned property names
+#define GF_PROPS_NAMES_BUCKETS	64
+//max number of interned property names, names are copied in each property beyond that
+#define GF_PROPS_MAX_NAMES	4096
 
 void gf_propmap_del(void *pmap);
 
+//array of properties, shared between maps when properties are merged in an empty map (typically packets inheriting properties)
+//and cloned upon first modification of a shared array
 typedef struct
 {
-#if GF_PROPS_HASHTABLE_SIZE
-	GF_List *hash_table[GF_PROPS_HASHTABLE_SIZE];
-#else
-	GF_List *properties;
-#endif
+	volatile u32 reference_count;
+	u32 nb_props, nb_alloc;
+	//property lookup keys, 4CC for built-in properties or name hash, checked before accessing entries
+	u32 *keys;
+	GF_PropertyEntry **entries;
+} GF_PropertyArray;
+
+typedef struct
+{
+	//properties, NULL if none
+	GF_PropertyArray *parray;
 	volatile u32 reference_count;
 	//number of references hold by packet references - since these may be destroyed at the end of the referring filter
 	//the pid might be dead. This is only used for pid props maps
@@ -97,11 +108,10 @@ const GF_PropertyValue *gf_props_get_property(GF_PropertyMap *map, u32 prop_4cc,
 
 const GF_PropertyEntry *gf_props_get_property_entry(GF_PropertyMap *map, u32 prop_4cc, const char *name);
 
-#if GF_PROPS_HASHTABLE_SIZE
+//get lookup key of property
 u32 gf_props_hash_djb2(u32 p4cc, const char *str);
-#else
-#define gf_props_hash_djb2(_a, _b) 0
-#endif
+
+u32 gf_props_count(GF_PropertyMap *map);
 
 GF_Err gf_props_merge_property(GF_PropertyMap *dst_props, GF_PropertyMap *src_props, gf_filter_prop_filter filter_prop, void *cbk);
 
@@ -110,6 +120,8 @@ const GF_PropertyValue *gf_props_enum_property(GF_PropertyMap *props, u32 *io_id
 Bool gf_props_4cc_check_props();
 
 void gf_props_del_property(GF_PropertyEntry *it);
+void gf_props_del_names(GF_FilterSession *fsess);
+void gf_props_array_del(void *parr);
 
 
 typedef struct __gf_filter_queue GF_FilterQueue;
@@ -268,8 +280,25 @@ struct __gf_filter_pck
 	//note that packets with frame_ifce are always considered as read-only memory
 	u8 filter_owns_mem;
 	u8 is_dangling;
+
+	//next packet in slab cache or session slab depot
+	struct __gf_filter_pck *slab_next;
 };
 
+//packet payload size classes: 4 classes per power of two, from 256 bytes up to 1 GB. Larger payloads are not pooled
+#define GF_PCK_SLAB_MIN_BITS	8
+#define GF_PCK_SLAB_MAX_BITS	30
+#define GF_PCK_SLAB_NUM_CLASSES	(1 + 4*(GF_PCK_SLAB_MAX_BITS - GF_PCK_SLAB_MIN_BITS))
+//max number of packets kept in a filter slab cache before moving them to the session depot
+#define GF_PCK_SLAB_CACHE_MAX	30
+//max number of classes above the requested one checked before allocating (at most 2x the requested size)
+#define GF_PCK_SLAB_MAX_UPCLASS	4
+
+//moves all packets in filter slab cache and filter alloc reservoir to the session depot
+void gf_filter_pck_slab_flush(GF_Filter *filter);
+//destroys all packets in session depot
+void gf_fs_pck_slab_reset(GF_FilterSession *fsess);
+
 /*!
  *	Filter Session Task process function prototype
  */
@@ -339,6 +368,13 @@ typedef struct __gf_fs_thread
 	u64 run_time;
 	u64 active_time;
 
+	//work-stealing scheduler only: tasks posted for filters last run on this thread. The list is mutex-protected
+	//since other threads may steal from it (lock-free queues are only safe with a single consumer)
+	GF_FilterQueue *tasks;
+	GF_Mutex *tasks_mx;
+	//work-stealing scheduler only: number of tasks stolen from other threads, number of wake-ups without task
+	u64 nb_steals, nb_idle;
+
 #ifndef GPAC_DISABLE_REMOTERY
 	u32 rmt_tasks;
 	char rmt_name[20];
@@ -373,6 +409,19 @@ enum
 
 //#define GF_FS_ENABLE_LOCALES
 
+//max number of tasks per thread a parallel job is split into
+#define GF_FS_PAR_TASKS_PER_THREAD	4
+
+//job posted by gf_filter_parallel_for
+typedef struct
+{
+	gf_filter_parallel_job job;
+	void *udta;
+	u32 nb_items, task_size, nb_tasks;
+	//next task to run, number of tasks done, number of session threads currently helping
+	volatile u32 next_task, nb_tasks_done, nb_helpers;
+} GF_FSParallelJob;
+
 
 struct __gf_filter_session
 {
@@ -393,6 +442,8 @@ struct __gf_filter_session
 	GF_FilterQueue *tasks;
 	GF_FilterQueue *main_thread_tasks;
 	GF_FilterQueue *tasks_reservoir;
+	//set if per-thread task lists are used (work-stealing scheduler)
+	Bool work_stealing;
 	volatile Bool in_main_sem_wait;
 	volatile u32 active_threads;
 
@@ -407,15 +458,27 @@ struct __gf_filter_session
 	GF_FilterQueue *prop_maps_entry_reservoir;
 	//reservoir for property entries with allocated data buffers - properties may be inherited between packets
 	GF_FilterQueue *prop_maps_entry_data_alloc_reservoir;
-#if GF_PROPS_HASHTABLE_SIZE
-	//reservoir for property maps hash table entries (GF_Lists) for PID and packets properties
-	GF_FilterQueue *prop_maps_list_reservoir;
-#endif
+	//reservoir for property arrays of property maps
+	GF_FilterQueue *prop_arrays_reservoir;
+	//interned names of dynamic properties, hashed in GF_PROPS_NAMES_BUCKETS lists
+	GF_List **prop_names;
+	u32 nb_prop_names;
 	//reservoir for reference property packets - we mutualize at session level to collect them
 	//it is not possible to do so at filter or pid level because a prop ref packet may be destroyed after the source
 	//pid/packet is destroyed, and we don't want to track them per pid/filter
 	GF_FilterQueue *pcks_refprops_reservoir;
 
+	//session-wide depot of allocated packets, indexed by payload size class. Filters keep their own slab cache
+	//and only use the depot (protected by pck_slab_mx) on cache miss or cache overflow
+	GF_Mutex *pck_slab_mx;
+	GF_FilterPacket *pck_slab_depot[GF_PCK_SLAB_NUM_CLASSES];
+	u64 pck_slab_depot_size, pck_slab_depot_max_size;
+	u32 pck_slab_depot_count;
+	//use transparent huge pages for payloads of 2MB or more (linux only)
+	Bool pck_slab_hugepages;
+	//depot stats, and slab cache stats of destroyed filters
+	u64 nb_slab_hits, nb_slab_misses, nb_slab_depot_hits, nb_slab_depot_drops;
+
 
 	GF_Mutex *props_mx;
 
@@ -439,6 +502,11 @@ struct __gf_filter_session
 	//semaphore for tasks posted in other task list
 	GF_Semaphore *semaphore_other;
 
+	//single parallel job slot, run by the posting thread and by idle session threads
+	GF_Mutex *par_mx;
+	GF_FSParallelJob par_job;
+	volatile u32 par_job_active;
+
 	volatile u32 tasks_pending;
 
 	u32 nb_threads_stopped;
@@ -489,6 +557,17 @@ struct __gf_filter_session
 	GF_Mutex *links_mx;
 	GF_List *links;
 
+	//persistent cache of resolved filter chains, NULL file if disabled
+	char *link_cache_file;
+	GF_List *link_cache;
+	u8 link_cache_reg_hash[GF_SHA1_DIGEST_SIZE];
+	//input cap codes and names of the registry, used to compute link keys
+	u32 *link_cache_codes;
+	u32 nb_link_cache_codes;
+	GF_List *link_cache_names;
+	Bool link_cache_reg_ok, link_cache_dirty;
+	u32 link_cache_hits, link_cache_misses;
+
 
 	GF_List *parsed_args;
 
@@ -637,6 +716,10 @@ struct __gf_filter
 	//set to true when the filter is being processed by a thread
 	volatile Bool in_process;
 	u32 process_th_id, restrict_th_idx;
+	//set when the filter was explicitly pinned, filters loaded when resolving links to this filter inherit restrict_th_idx
+	Bool pin_chain;
+	//work-stealing scheduler only: 1-based index of the secondary thread which last processed this filter, 0 if none
+	u32 sched_th_idx;
 	//user data for the filter implementation
 	void *filter_udta;
 
@@ -662,8 +745,13 @@ struct __gf_filter
 	u32 num_output_pids;
 	u32 num_out_pids_not_connected;
 
-	//reservoir for packets with allocated memory
+	//reservoir for packets with allocated memory - packets are pushed from any thread, and moved
+	//to the slab cache by the filter upon allocation
 	GF_FilterQueue *pcks_alloc_reservoir;
+	//slab cache for packets with allocated memory, indexed by size class - only accessed by the filter allocating packets
+	GF_FilterPacket *pck_slabs[GF_PCK_SLAB_NUM_CLASSES];
+	u32 nb_pck_slabs;
+	u64 nb_slab_hits, nb_slab_misses;
 	//reservoir for packets with shared memory
 	GF_FilterQueue *pcks_shared_reservoir;
 	//reservoir for packets instances - the ones stored in the pid destination(s) with shared memory
@@ -841,6 +929,8 @@ struct __gf_filter
 	//error checking
 	//number of packet release or created during a process() call
 	u32 nb_pck_io;
+	//batch dispatch nesting level, destination wake-ups are deferred while > 0
+	u32 batch_dispatch;
 	//number of consecutive errors during process()
 	u32 nb_consecutive_errors;
 	//system clock of first error
@@ -914,6 +1004,9 @@ void gf_filter_pid_retry_caps_negotiate(GF_FilterPid *src_pid, GF_FilterPid *pid
 
 void gf_filter_reset_pending_packets(GF_Filter *filter);
 
+//pins filter to given 1-based session thread index, or to the least loaded thread if 0
+void gf_filter_set_thread(GF_Filter *filter, u32 th_idx);
+
 void gf_filter_instance_detach_pid(GF_FilterPidInst *pidi);
 
 void filter_parse_logs(GF_Filter *filter, const char *_logs);
@@ -974,6 +1067,8 @@ struct __gf_filter_pid_inst
 	u64 first_frame_time;
 	Bool is_end_of_stream;
 	Bool keepalive_signaled;
+	//set when a packet was sent to this instance during a batch dispatch and the destination was not yet woken up
+	Bool batch_post_pending;
 	Bool is_playing, is_paused;
 	u8 play_queued, stop_queued;
 	
@@ -1194,6 +1289,8 @@ GF_FilterPacket *gf_filter_pck_new_shared_internal(GF_FilterPid *pid, const u8 *
 
 void gf_filter_sess_build_graph(GF_FilterSession *fsess, const GF_FilterRegister *freg);
 void gf_filter_sess_reset_graph(GF_FilterSession *fsess, const GF_FilterRegister *freg);
+//saves persistent link cache if modified and releases it
+void gf_filter_sess_link_cache_del(GF_FilterSession *fsess);
 
 Bool gf_fs_ui_event(GF_FilterSession *session, GF_Event *uievt);
 
@@ -1269,6 +1366,7 @@ const char *gf_fs_path_escape_colon(GF_FilterSession *sess, const char *path);
 const char *gf_fs_path_escape_colon_ex(GF_FilterSession *sess, const char *path, Bool *needs_escape, Bool for_source);
 
 void gf_fs_check_graph_load(GF_FilterSession *fsess, Bool for_load);
+void gf_fs_ensure_graph(GF_FilterSession *fsess);
 
 void gf_filter_renegotiate_output_task(GF_FSTask *task);
 
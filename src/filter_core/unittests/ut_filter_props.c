@@ -0,0 +1,102 @@
+#include <gpac/filters.h>
+#include "../filter_session.h"
+#include "tests.h"
+
+#define UT_PROPS_NB_4CC		12
+#define UT_PROPS_NB_NAMES	4
+
+//names are not copied by gf_filter_pck_set_property_str
+static const char *ut_props_names[UT_PROPS_NB_NAMES] = {"ut_prop_0", "ut_prop_1", "ut_prop_2", "ut_prop_3"};
+
+unittest(filter_props_lookup_merge)
+{
+    GF_Err e;
+    u32 i, nb_props, idx, p4cc;
+    u8 *data;
+    const char *name;
+    GF_PropertyValue val;
+    GF_PropertyArray *arr;
+    GF_FilterSession *fs;
+    GF_Filter *f;
+    GF_FilterPid *pid;
+    GF_FilterPacket *pck, *dst;
+    const GF_PropertyValue *p;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    fs = gf_fs_new_defaults(0);
+    assert_not_null(fs);
+    f = gf_fs_new_filter(fs, "ut_props", 0, &e);
+    assert_not_null(f);
+    pid = gf_filter_pid_new(f);
+    assert_not_null(pid);
+
+    //typical packet: a dozen built-in properties and a few named ones
+    pck = gf_filter_pck_new_alloc(pid, 1, &data);
+    assert_not_null(pck);
+    memset(&val, 0, sizeof(val));
+    val.type = GF_PROP_UINT;
+    for (i=0; i<UT_PROPS_NB_4CC; i++) {
+        val.value.uint = i;
+        assert_equal(gf_filter_pck_set_property(pck, GF_4CC('u','t','p','a'+i), &val), GF_OK);
+    }
+    for (i=0; i<UT_PROPS_NB_NAMES; i++) {
+        val.value.uint = 100+i;
+        assert_equal(gf_filter_pck_set_property_str(pck, ut_props_names[i], &val), GF_OK);
+    }
+
+    arr = pck->props->parray;
+    assert_not_null(arr);
+    nb_props = arr->nb_props;
+    assert_equal(nb_props, UT_PROPS_NB_4CC+UT_PROPS_NB_NAMES);
+
+    //lookups by 4CC and by name
+    for (i=0; i<UT_PROPS_NB_4CC; i++) {
+        p = gf_filter_pck_get_property(pck, GF_4CC('u','t','p','a'+i));
+        assert_not_null(p);
+        assert_true(p == &arr->entries[i]->prop);
+        assert_equal(p->value.uint, i);
+    }
+    for (i=0; i<UT_PROPS_NB_NAMES; i++) {
+        p = gf_filter_pck_get_property_str(pck, ut_props_names[i]);
+        assert_not_null(p);
+        assert_true(p == &arr->entries[UT_PROPS_NB_4CC+i]->prop);
+        assert_equal(p->value.uint, 100+i);
+    }
+    assert_true(gf_filter_pck_get_property(pck, GF_4CC('u','t','p','z')) == NULL);
+    assert_true(gf_filter_pck_get_property_str(pck, "ut_prop_none") == NULL);
+
+    //merged packet shares the same properties, in the same order
+    dst = gf_filter_pck_new_alloc(pid, 1, &data);
+    assert_equal(gf_filter_pck_merge_properties(pck, dst), GF_OK);
+    idx = 0;
+    for (i=0; i<nb_props; i++) {
+        p = gf_filter_pck_enum_properties(dst, &idx, &p4cc, &name);
+        assert_not_null(p);
+        assert_true(p == &arr->entries[i]->prop);
+        if (i<UT_PROPS_NB_4CC) assert_equal(p4cc, GF_4CC('u','t','p','a'+i));
+        else assert_equal_str(name, ut_props_names[i-UT_PROPS_NB_4CC]);
+    }
+    assert_true(gf_filter_pck_enum_properties(dst, &idx, &p4cc, &name) == NULL);
+    //modifying the merged packet does not modify the source
+    val.value.uint = 1000;
+    assert_equal(gf_filter_pck_set_property(dst, GF_4CC('u','t','p','a'), &val), GF_OK);
+    assert_equal(gf_filter_pck_get_property(pck, GF_4CC('u','t','p','a'))->value.uint, 0);
+    assert_equal(gf_filter_pck_get_property(dst, GF_4CC('u','t','p','a'))->value.uint, 1000);
+    assert_equal(gf_filter_pck_get_property_str(dst, ut_props_names[1])->value.uint, 101);
+    gf_filter_pck_discard(dst);
+
+    //all references released
+    for (i=0; i<nb_props; i++) {
+        assert_equal(arr->entries[i]->reference_count, 1);
+    }
+
+    //replacing a property keeps a single entry
+    val.value.uint = 50;
+    assert_equal(gf_filter_pck_set_property(pck, GF_4CC('u','t','p','c'), &val), GF_OK);
+    assert_equal(arr->nb_props, nb_props);
+    assert_equal(gf_filter_pck_get_property(pck, GF_4CC('u','t','p','c'))->value.uint, 50);
+
+    gf_filter_pck_discard(pck);
+    gf_fs_del(fs);
+    gf_sys_close();
+}
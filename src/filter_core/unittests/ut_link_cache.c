@@ -0,0 +1,190 @@
+#include <gpac/filters.h>
+#include "../filter_session.h"
+#include "tests.h"
+
+#define UT_LC_FILE	"ut_link_cache.txt"
+
+static void ut_lc_make_input(void)
+{
+    u32 i;
+    FILE *f = gf_fopen("ut_lc_in.pcm", "wb");
+    assert_not_null(f);
+    for (i=0; i<4800; i++) {
+        Float v = 0;
+        gf_fwrite(&v, sizeof(Float), f);
+    }
+    gf_fclose(f);
+}
+
+static GF_FilterSession *ut_lc_session(void)
+{
+    GF_Err e;
+    GF_Filter *f;
+    GF_FilterSession *fs = gf_fs_new_defaults(0);
+    assert_not_null(fs);
+    f = gf_fs_load_source(fs, "ut_lc_in.pcm:sr=48000:safmt=flt:ch=1", NULL, NULL, &e);
+    assert_not_null(f);
+    f = gf_fs_load_destination(fs, "ut_lc_out.wav:osr=44100", NULL, NULL, &e);
+    assert_not_null(f);
+    return fs;
+}
+
+//runs a session resolving a resampler chain, returns cache hits and misses and the registry hash line of the cache file
+static void ut_lc_run(GF_FilterSession *fs, u32 *hits, u32 *misses, char *header)
+{
+    u8 *data;
+    u32 size;
+    if (!fs) fs = ut_lc_session();
+    assert_equal(gf_fs_run(fs), GF_EOS);
+    *hits = fs->link_cache_hits;
+    *misses = fs->link_cache_misses;
+    gf_fs_del(fs);
+
+    header[0] = 0;
+    assert_equal(gf_file_load_data(UT_LC_FILE, &data, &size), GF_OK);
+    if (data) {
+        char *sep = strchr((char *) data, '\n');
+        assert_not_null(sep);
+        if (sep && (sep - (char *) data < 100)) {
+            memcpy(header, data, sep - (char *) data);
+            header[sep - (char *) data] = 0;
+        }
+        gf_free(data);
+    }
+}
+
+//rewrites the cache file, keeping the header and applying mode to each entry
+enum
+{
+    UT_LC_JUNK=0,
+    UT_LC_INVALID,
+    UT_LC_TRUNCATE,
+};
+static void ut_lc_corrupt(u32 mode)
+{
+    u8 *data;
+    u32 size;
+    char *line, *next;
+    FILE *f;
+    assert_equal(gf_file_load_data(UT_LC_FILE, &data, &size), GF_OK);
+    f = gf_fopen(UT_LC_FILE, "wt");
+    assert_not_null(f);
+    line = (char *) data;
+    next = strchr(line, '\n');
+    assert_not_null(next);
+    next[0] = 0;
+    gf_fprintf(f, "%s\n", line);
+    line = next+1;
+    while (line[0]) {
+        char *chain;
+        next = strchr(line, '\n');
+        if (next) next[0] = 0;
+        switch (mode) {
+        case UT_LC_JUNK:
+            //garbage around valid entries
+            gf_fprintf(f, "not a cache entry\n0123 1 2 rfpcm@0\n%s\n", line);
+            break;
+        case UT_LC_INVALID:
+            //chain pointing to an unknown filter
+            chain = strchr(line, ' ');
+            chain = chain ? strchr(chain+1, ' ') : NULL;
+            chain = chain ? strchr(chain+1, ' ') : NULL;
+            assert_not_null(chain);
+            if (chain) {
+                chain[0] = 0;
+                gf_fprintf(f, "%s ut_no_such_filter@0\n", line);
+            }
+            break;
+        case UT_LC_TRUNCATE:
+            //entries cut by a concurrent writer have no line end
+            gf_fprintf(f, "%s", line);
+            break;
+        }
+        if (!next) break;
+        line = next+1;
+        if (mode==UT_LC_TRUNCATE) break;
+    }
+    gf_fclose(f);
+    gf_free(data);
+}
+
+unittest(filter_link_cache)
+{
+    u32 i, hits, misses, count;
+    char header[100], header2[100];
+    GF_FilterSession *fs;
+    const GF_FilterRegister *freg = NULL;
+    u8 *data;
+    u32 size;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    gf_opts_set_key("core", "link-cache", UT_LC_FILE);
+    gf_file_delete(UT_LC_FILE);
+    ut_lc_make_input();
+
+    //first run fills the cache
+    ut_lc_run(NULL, &hits, &misses, header);
+    assert_equal(hits, 0);
+    assert_greater(misses, 0);
+    assert_true(!strncmp(header, "gpac-link-cache ", 16));
+
+    //reloaded cache gives the same chains, without building the graph
+    fs = ut_lc_session();
+    assert_equal(gf_fs_run(fs), GF_EOS);
+    assert_greater(fs->link_cache_hits, 0);
+    assert_equal(fs->link_cache_misses, 0);
+    assert_equal(gf_list_count(fs->links), 0);
+    gf_fs_del(fs);
+
+    //removing an unused register resets the cache
+    fs = ut_lc_session();
+    count = gf_fs_filters_registers_count(fs);
+    for (i=0; i<count; i++) {
+        freg = gf_fs_get_filter_register(fs, i);
+        if (!strcmp(freg->name, "dasher")) break;
+        freg = NULL;
+    }
+    assert_not_null(freg);
+    if (freg) gf_fs_remove_filter_register(fs, (GF_FilterRegister *) freg);
+    ut_lc_run(fs, &hits, &misses, header2);
+    assert_equal(hits, 0);
+    assert_greater(misses, 0);
+    assert_true(strcmp(header, header2));
+
+    //and so does adding it back, back to the original registry signature
+    ut_lc_run(NULL, &hits, &misses, header2);
+    assert_equal(hits, 0);
+    assert_greater(misses, 0);
+    assert_equal_str(header, header2);
+
+    //junk lines are ignored
+    ut_lc_corrupt(UT_LC_JUNK);
+    ut_lc_run(NULL, &hits, &misses, header2);
+    assert_greater(hits, 0);
+    assert_equal(misses, 0);
+
+    //entries pointing to unknown filters are dropped and resolved again
+    ut_lc_corrupt(UT_LC_INVALID);
+    ut_lc_run(NULL, &hits, &misses, header2);
+    assert_equal(hits, 0);
+    assert_greater(misses, 0);
+    assert_equal(gf_file_load_data(UT_LC_FILE, &data, &size), GF_OK);
+    assert_true(data && !strstr((char *) data, "ut_no_such_filter"));
+    if (data) gf_free(data);
+
+    //truncated entries are ignored
+    ut_lc_corrupt(UT_LC_TRUNCATE);
+    ut_lc_run(NULL, &hits, &misses, header2);
+    assert_equal(hits, 0);
+    assert_greater(misses, 0);
+    //and the cache is valid again
+    ut_lc_run(NULL, &hits, &misses, header2);
+    assert_greater(hits, 0);
+    assert_equal(misses, 0);
+
+    gf_opts_set_key("core", "link-cache", NULL);
+    gf_file_delete(UT_LC_FILE);
+    gf_file_delete("ut_lc_in.pcm");
+    gf_file_delete("ut_lc_out.wav");
+    gf_sys_close();
+}
@@ -199,7 +199,7 @@ typedef struct
 	Bool check_dur, skip_seg, loop, reschedule, scope_deps, keep_src, tpl_force, keep_segs;
 	Double refresh, tsb, subdur;
 	u64 *_p_gentime, *_p_mpdtime;
-	Bool cmpd, dual, sreg, ttml_agg;
+	Bool cmpd, dual, sreg, ttml_agg, patch, muxth;
 	char *styp;
 	Bool sigfrag;
 	u32 sbound, pswitch;
@@ -289,6 +289,12 @@ typedef struct
 	u32 forward_mode;
 
 	u8 last_hls_signature[GF_SHA1_DIGEST_SIZE], last_mpd_signature[GF_SHA1_DIGEST_SIZE], last_hls2_signature[GF_SHA1_DIGEST_SIZE];
+	//largest manifest size generated, used as initial packet allocation size
+	u32 manifest_size_hint;
+	//MPD patch file name, publish time and structure of last MPD sent
+	char *patch_name;
+	u64 patch_publish_time;
+	u8 patch_mpd_sig[GF_SHA1_DIGEST_SIZE];
 
 	GF_CryptInfo *cinfo;
 
@@ -3326,6 +3332,9 @@ static void dasher_open_destination(GF_Filter *filter, GF_DasherCtx *ctx, GF_MPD
 	sprintf(szSRC, "MuxSrc%cdasher_%p", sep_name, ds->dst_filter);
 	gf_filter_reset_source(ds->dst_filter);
 	gf_filter_set_source(ds->dst_filter, filter, szSRC);
+	//pin the output and the multiplexer that will be loaded to connect to it
+	if (ctx->muxth)
+		gf_filter_pin_thread(ds->dst_filter);
 
 	u32 j=2;
 	while (ctx->explicit_mode && !dst_forced) {
@@ -4800,22 +4809,8 @@ static void dasher_update_period_duration(GF_DasherCtx *ctx, Bool is_period_swit
 	}
 }
 
-static void dasher_transfer_file(FILE *f, GF_FilterPid *opid, const char *name, GF_DashStream *ds, Bool is_rel_url)
+static void dasher_send_manifest_packet(GF_FilterPacket *pck, const char *name, GF_DashStream *ds, Bool is_rel_url)
 {
-	GF_FilterPacket *pck;
-	u32 size, nb_read;
-	u8 *output;
-
-	size = (u32) gf_fsize(f);
-
-	pck = gf_filter_pck_new_alloc(opid, size, &output);
-	if (!pck) return;
-
-	nb_read = (u32) gf_fread(output, size, f);
-	if (nb_read != size) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[Dasher] Error reading temp MPD file, read %d bytes but file size is %d\n", nb_read, size ));
-	}
-
 	gf_filter_pck_set_framing(pck, GF_TRUE, GF_TRUE);
 	gf_filter_pck_set_seek_flag(pck, GF_TRUE);
 	if (name) {
@@ -4829,6 +4824,30 @@ static void dasher_transfer_file(FILE *f, GF_FilterPid *opid, const char *name,
 	gf_filter_pck_send(pck);
 }
 
+static void dasher_transfer_file(FILE *f, GF_FilterPid *opid, const char *name, GF_DashStream *ds, Bool is_rel_url)
+{
+	GF_FilterPacket *pck;
+	u32 size, nb_read;
+	u8 *output;
+	//file generated in memory, copy it
+	u8 *data = gf_fileio_mem_writer_data(f, &size);
+
+	if (!data)
+		size = (u32) gf_fsize(f);
+
+	pck = gf_filter_pck_new_alloc(opid, size, &output);
+	if (!pck) return;
+
+	if (data) {
+		memcpy(output, data, size);
+	} else {
+		nb_read = (u32) gf_fread(output, size, f);
+		if (nb_read != size) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[Dasher] Error reading temp MPD file, read %d bytes but file size is %d\n", nb_read, size ));
+		}
+	}
+	dasher_send_manifest_packet(pck, name, ds, is_rel_url);
+}
 
 static u64 dasher_get_utc(GF_DasherCtx *ctx)
 {
@@ -5025,7 +5044,7 @@ static void dasher_forward_mpd(GF_DasherCtx *ctx, const char *manifest)
 
 
 	//and send
-	tmp = gf_file_temp(NULL);
+	tmp = gf_fileio_mem_writer(NULL, NULL, 0);
 	mpd->xml_namespace = ctx->mpd->xml_namespace;
 	mpd->publishTime = dasher_get_utc(ctx);
 	e = gf_mpd_write(mpd, tmp, ctx->cmpd);
@@ -5308,12 +5327,128 @@ static GF_Err dasher_write_index(GF_DasherCtx *ctx, GF_FilterPid *opid)
 }
 
 
+typedef struct
+{
+	GF_FilterPid *opid;
+	GF_FilterPacket *pck;
+} DasherManifestPacket;
+
+static u8 *dasher_manifest_realloc(void *udta, u8 *data, u32 size)
+{
+	u8 *output;
+	u32 cur_size;
+	DasherManifestPacket *mpck = (DasherManifestPacket *) udta;
+	if (!mpck->pck) {
+		mpck->pck = gf_filter_pck_new_alloc(mpck->opid, size, &output);
+		return mpck->pck ? output : NULL;
+	}
+	gf_filter_pck_get_data(mpck->pck, &cur_size);
+	if (gf_filter_pck_expand(mpck->pck, size - cur_size, &output, NULL, NULL))
+		return NULL;
+	return output;
+}
+
+static Bool dasher_sig_match(const u8 *data, u32 size, u32 pos, const char *pattern)
+{
+	u32 len = (u32) strlen(pattern);
+	if (pos + len > size) return GF_FALSE;
+	return memcmp(data+pos, pattern, len) ? GF_FALSE : GF_TRUE;
+}
+
+//returns position of pattern after pos, or size if not found
+static u32 dasher_sig_find(const u8 *data, u32 size, u32 pos, const char *pattern)
+{
+	while (pos<size) {
+		if ((data[pos]==pattern[0]) && dasher_sig_match(data, size, pos, pattern)) return pos;
+		pos++;
+	}
+	return size;
+}
+
+//signature of a serialized MPD without the parts described in MPD patch (publish time and segment timelines) and comments
+GF_STATIC void dasher_patch_mpd_signature(const u8 *data, u32 size, u8 sig[GF_SHA1_DIGEST_SIZE])
+{
+	u32 i=0, start=0;
+	GF_SHA1Context *sha1 = gf_sha1_starts();
+	while (i<size) {
+		u32 skip_start, skip_end;
+		if ((data[i]=='<') && dasher_sig_match(data, size, i, "<!--")) {
+			skip_start = i;
+			skip_end = dasher_sig_find(data, size, i, "-->");
+			if (skip_end<size) skip_end += 3;
+		} else if ((data[i]=='<') && dasher_sig_match(data, size, i, "<SegmentTimeline")) {
+			//keep element, skip its content
+			skip_start = dasher_sig_find(data, size, i, ">");
+			if (skip_start<size) skip_start++;
+			skip_end = dasher_sig_find(data, size, skip_start, "</SegmentTimeline>");
+		} else if ((data[i]=='p') && dasher_sig_match(data, size, i, "publishTime=\"")) {
+			skip_start = i + 13;
+			skip_end = dasher_sig_find(data, size, skip_start, "\"");
+		} else {
+			i++;
+			continue;
+		}
+		gf_sha1_update(sha1, (u8 *) data + start, skip_start - start);
+		start = i = skip_end;
+	}
+	gf_sha1_update(sha1, (u8 *) data + start, size - start);
+	gf_sha1_finish(sha1, sig);
+}
+
+static void dasher_setup_mpd_patch(GF_DasherCtx *ctx)
+{
+	if ((ctx->dmode!=GF_DASH_DYNAMIC) || !ctx->out_path || (ctx->from_index!=IDXMODE_NONE)) {
+		if (ctx->mpd->patch_location) gf_free(ctx->mpd->patch_location);
+		ctx->mpd->patch_location = NULL;
+		return;
+	}
+	if (!ctx->patch_name) {
+		char *sep;
+		ctx->patch_name = gf_strdup(ctx->out_path);
+		sep = gf_file_ext_start(ctx->patch_name);
+		if (sep) sep[0] = 0;
+		gf_dynstrcat(&ctx->patch_name, ".mpp", NULL);
+	}
+	if (!ctx->mpd->patch_location)
+		ctx->mpd->patch_location = gf_strdup(gf_file_basename(ctx->patch_name));
+	//patch requires an MPD ID
+	if (!ctx->mpd->ID)
+		ctx->mpd->ID = gf_strdup("GPACMPD");
+}
+
+static void dasher_send_mpd_patch(GF_DasherCtx *ctx, GF_FilterPid *opid, u8 sig[GF_SHA1_DIGEST_SIZE])
+{
+	//only timeline updates are described, skip patch if anything else changed
+	if (ctx->patch_publish_time && !memcmp(sig, ctx->patch_mpd_sig, GF_SHA1_DIGEST_SIZE)) {
+		DasherManifestPacket mpck;
+		u32 size;
+		mpck.opid = opid;
+		mpck.pck = NULL;
+		FILE *tmp = gf_fileio_mem_writer(dasher_manifest_realloc, &mpck, ctx->manifest_size_hint);
+		if (tmp && (gf_mpd_write_patch(ctx->mpd, tmp, ctx->patch_publish_time, ctx->cmpd) == GF_OK)) {
+			gf_fileio_mem_writer_data(tmp, &size);
+			if (mpck.pck) {
+				gf_filter_pck_truncate(mpck.pck, size);
+				dasher_send_manifest_packet(mpck.pck, ctx->patch_name, NULL, GF_FALSE);
+				mpck.pck = NULL;
+			}
+		}
+		if (mpck.pck) gf_filter_pck_discard(mpck.pck);
+		if (tmp) gf_fclose(tmp);
+	}
+	memcpy(ctx->patch_mpd_sig, sig, GF_SHA1_DIGEST_SIZE);
+	ctx->patch_publish_time = ctx->mpd->publishTime;
+}
+
 static GF_Err dasher_write_and_send_manifest(GF_DasherCtx *ctx, u64 last_period_dur, Bool do_m3u8, Bool m3u8_second_pass, GF_FilterPid *opid, char *alt_name)
 {
 	void *last_signature;
 	u8 sig[GF_SHA1_DIGEST_SIZE];
 	GF_Err e;
 	FILE *tmp;
+	u8 *data;
+	u32 size;
+	DasherManifestPacket mpck;
 
 	ctx->mpd->segment_template = ctx->template;
 	if (ctx->do_index==1) {
@@ -5322,7 +5457,13 @@ static GF_Err dasher_write_and_send_manifest(GF_DasherCtx *ctx, u64 last_period_
 	if (ctx->from_index)
 		ctx->mpd->m3u8_use_repid = GF_TRUE;
 
-	tmp = gf_file_temp(NULL);
+	//serialize manifest directly in packet memory
+	mpck.opid = opid;
+	mpck.pck = NULL;
+	if (ctx->from_index==IDXMODE_CHILD) mpck.opid = NULL;
+	tmp = gf_fileio_mem_writer(mpck.opid ? dasher_manifest_realloc : NULL, &mpck, ctx->manifest_size_hint);
+	if (!tmp) return GF_OUT_OF_MEM;
+
 	if (do_m3u8) {
 		GF_M3U8WriteMode mode = GF_M3U8_WRITE_ALL;
 		if (ctx->from_index==IDXMODE_MANIFEST) mode = GF_M3U8_WRITE_MASTER;
@@ -5345,6 +5486,8 @@ static GF_Err dasher_write_and_send_manifest(GF_DasherCtx *ctx, u64 last_period_
 		char *opath = ctx->explicit_mode ? gf_file_basename(ctx->out_path) : ctx->out_path;
 		e = gf_mpd_write_m3u8_master_playlist(ctx->mpd, tmp, opath, gf_list_last(ctx->mpd->periods), mode);
 	} else {
+		if (ctx->patch)
+			dasher_setup_mpd_patch(ctx);
 		e = gf_mpd_write(ctx->mpd, tmp, ctx->cmpd);
 	}
 	ctx->mpd->segment_template = NULL;
@@ -5352,17 +5495,22 @@ static GF_Err dasher_write_and_send_manifest(GF_DasherCtx *ctx, u64 last_period_
 	if (e) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[Dasher] failed to write %s file: %s\n", do_m3u8 ? "M3U8" : "MPD", gf_error_to_string(e) ));
 		gf_fclose(tmp);
+		if (mpck.pck) gf_filter_pck_discard(mpck.pck);
 		if (ctx->current_period->period)
 			ctx->current_period->period->duration = last_period_dur;
 		return e;
 	}
 
+	data = gf_fileio_mem_writer_data(tmp, &size);
+	if (size > ctx->manifest_size_hint)
+		ctx->manifest_size_hint = size;
+
 	if (ctx->profile == GF_DASH_PROFILE_HBBTV_1_5_ISOBMF_LIVE) {
-		if (gf_ftell(tmp) > 100 * 1024)
-			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[Dasher] manifest MPD is too big for HbbTV 1.5. Limit is 100kB, current size is "LLU"kB\n", gf_ftell(tmp) / 1024));
+		if (size > 100 * 1024)
+			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[Dasher] manifest MPD is too big for HbbTV 1.5. Limit is 100kB, current size is %ukB\n", size / 1024));
 	}
 
-	gf_sha1_file_ptr(tmp, sig);
+	gf_sha1_csum(data, size, sig);
 	if (do_m3u8) {
 		last_signature = (void *) m3u8_second_pass ? ctx->last_hls2_signature : ctx->last_hls_signature;
 	} else {
@@ -5370,11 +5518,23 @@ static GF_Err dasher_write_and_send_manifest(GF_DasherCtx *ctx, u64 last_period_
 	}
 
 	if (memcmp(sig, last_signature, GF_SHA1_DIGEST_SIZE)) {
+		Bool send_patch = (!do_m3u8 && ctx->patch && mpck.opid && ctx->mpd->patch_location) ? GF_TRUE : GF_FALSE;
 		memcpy(last_signature, sig, GF_SHA1_DIGEST_SIZE);
 
-		if (ctx->from_index!=IDXMODE_CHILD)
-			dasher_transfer_file(tmp, opid, alt_name, NULL, GF_FALSE);
+		//computed before sending, packet data is no longer ours once sent
+		if (send_patch)
+			dasher_patch_mpd_signature(data, size, sig);
+
+		if (mpck.pck) {
+			gf_filter_pck_truncate(mpck.pck, size);
+			dasher_send_manifest_packet(mpck.pck, alt_name, NULL, GF_FALSE);
+			mpck.pck = NULL;
+		}
+		if (send_patch)
+			dasher_send_mpd_patch(ctx, opid, sig);
 	}
+	//unchanged manifest
+	if (mpck.pck) gf_filter_pck_discard(mpck.pck);
 	gf_fclose(tmp);
 	return GF_OK;
 }
@@ -5866,6 +6026,7 @@ static GF_Err dasher_reload_context(GF_Filter *filter, GF_DasherCtx *ctx)
 
 	/* parse the MPD */
 	mpd_parser = gf_xml_dom_new();
+	gf_xml_dom_enable_arena(mpd_parser);
 	e = gf_xml_dom_parse(mpd_parser, ctx->state, NULL, NULL);
 
 	if (e != GF_OK) {
@@ -10514,6 +10675,7 @@ static void dasher_finalize(GF_Filter *filter)
 	gf_list_del(ctx->next_period->streams);
 	gf_free(ctx->next_period);
 	if (ctx->out_path) gf_free(ctx->out_path);
+	if (ctx->patch_name) gf_free(ctx->patch_name);
 	gf_list_del(ctx->postponed_pids);
 #ifndef GPAC_DISABLE_CRYPTO
 	if (ctx->cinfo) gf_crypt_info_del(ctx->cinfo);
@@ -10666,6 +10828,7 @@ static const GF_FilterArgs DasherArgs[] =
 
 	{ OFFS(subs_sidx), "number of subsegments per sidx. negative value disables sidx. Only used to inherit sidx option of destination", GF_PROP_SINT, "-1", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(cmpd), "skip line feed and spaces in MPD XML for compactness", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(patch), "generate MPD patch document with segment timeline updates for dynamic MPD, advertised in MPD using `PatchLocation`", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(styp), "indicate the 4CC to use for styp boxes when using ISOBMFF output", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(dual), "indicate to produce both MPD and M3U files", GF_PROP_BOOL, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(sigfrag), "use manifest generation only mode", GF_PROP_BOOL, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
@@ -10738,6 +10901,7 @@ static const GF_FilterArgs DasherArgs[] =
 		, GF_PROP_UINT, "auto", "off|on|auto", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(tpl_force), "use template string as is without trying to add extension or solve conflicts in names", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ttml_agg), "force aggregation of TTML samples of a DASH segment into a single sample", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(muxth), "pin the multiplexing chain of each representation to its own session thread (see filter help)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 
 	{0}
 };
@@ -10862,6 +11026,10 @@ GF_FilterRegister DasherRegister = {
 "This may result in temporary mismatches between segment/part size currently received versus size as advertized in manifest.\n"
 "When [-seg_sync]() is enabled, the segmenter will wait for the last byte of the fragment/segment to be pushed before announcing a new segment in the manifest(s). This can however slightly increase the latency in MPEG-DASH low-latency.\n"
 "\n"
+"Each representation is handled by its own multiplexer instance, and in multi-threaded sessions segment and fragment closing of representations may run concurrently on any of the session threads.\n"
+"When [-muxth]() is set, the multiplexer and output filters of each representation are pinned to a session thread, spreading representations evenly across threads. This reduces the processing spike at segment boundaries when many representations are produced.\n"
+"EX gpac -threads=4 -i source.mp4 -o live.mpd:muxth\n"
+"\n"
 "## Dynamic (real-time live) Mode\n"
 "The dasher does not perform real-time regulation by default.\n"
 "For regular segmentation, you should enable segment regulation [-sreg]() if your sources are not real-time.\n"
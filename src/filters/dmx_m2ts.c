@@ -1538,19 +1538,22 @@ static void m2tsdmx_finalize(GF_Filter *filter)
 
 }
 
+//max number of input packets processed per batch
+#define M2TSDMX_MAX_BATCH	32
+
 static GF_Err m2tsdmx_process(GF_Filter *filter)
 {
 	GF_M2TSDmxCtx *ctx = gf_filter_get_udta(filter);
-	GF_FilterPacket *pck;
+	GF_FilterPacket *pcks[M2TSDMX_MAX_BATCH];
 	Bool check_block = GF_TRUE;
 	const char *data;
-	u32 size;
+	u32 i, size, nb_pcks;
 
 restart:
-	pck = gf_filter_pid_get_packet(ctx->ipid);
-	if (!pck) {
+	nb_pcks = gf_filter_pid_get_packets(ctx->ipid, pcks, M2TSDMX_MAX_BATCH);
+	if (!nb_pcks) {
 		if (gf_filter_pid_is_eos(ctx->ipid)) {
-			u32 i, nb_streams = gf_filter_get_opid_count(filter);
+			u32 nb_streams = gf_filter_get_opid_count(filter);
 
 			gf_m2ts_flush_all(ctx->ts, ctx->is_dash);
 			for (i=0; i<nb_streams; i++) {
@@ -1561,20 +1564,13 @@ restart:
 		}
 		return GF_OK;
 	}
-	if (ctx->sigfrag) {
-		Bool is_start;
-		gf_filter_pck_get_framing(pck, &is_start, NULL);
-		if (is_start) {
-			gf_m2ts_mark_seg_start(ctx->ts);
-		}
-	}
 	//we process even if no stream playing: since we use unframed dispatch we may need to send packets to configure reframers
 	//which will in turn connect to the sink which will send the PLAY event marking stream(s) as playing
 	if (ctx->in_seek) {
 		gf_m2ts_reset_parsers(ctx->ts);
 		ctx->in_seek = GF_FALSE;
 	} else if (check_block && !ctx->wait_for_progs) {
-		u32 i, nb_streams, would_block = 0;
+		u32 nb_streams, would_block = 0;
 		nb_streams = gf_filter_get_opid_count(filter);
 		for (i=0; i<nb_streams; i++) {
 			GF_FilterPid *opid = gf_filter_get_opid(filter, i);
@@ -1599,11 +1595,28 @@ restart:
 		check_block = GF_FALSE;
 	}
 
-	data = gf_filter_pck_get_data(pck, &size);
-	if (data && size)
-		gf_m2ts_process_data(ctx->ts, (char*) data, size);
+	//process all fetched packets, waking up consumers once
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	for (i=0; i<nb_pcks; i++) {
+		if (ctx->sigfrag) {
+			Bool is_start;
+			gf_filter_pck_get_framing(pcks[i], &is_start, NULL);
+			if (is_start) {
+				gf_m2ts_mark_seg_start(ctx->ts);
+			}
+		}
+		data = gf_filter_pck_get_data(pcks[i], &size);
+		if (data && size)
+			gf_m2ts_process_data(ctx->ts, (char*) data, size);
+
+		if (ctx->mux_tune_state==DMX_TUNE_WAIT_SEEK) {
+			i++;
+			break;
+		}
+	}
+	gf_filter_batch_dispatch(filter, GF_FALSE);
 
-	gf_filter_pid_drop_packet(ctx->ipid);
+	gf_filter_pid_drop_packets(ctx->ipid, i);
 
 	if (ctx->mux_tune_state==DMX_TUNE_WAIT_SEEK) {
 		GF_FilterEvent fevt;
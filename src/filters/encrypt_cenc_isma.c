@@ -62,6 +62,9 @@ typedef struct
 	char IV[16];
 	bin128 key;
 	u32 IV_size;
+	//parallel mode: job being filled (0 if none) and keystream bytes used in current sample
+	u32 job_plus_one;
+	u32 ks_pos;
 } CENC_MKey;
 
 typedef struct
@@ -126,21 +129,263 @@ typedef struct
 	GF_List *pssh_templates;
 
 	u64 num_block_crypted;
+	//encryption ops are deferred and run on session threads
+	Bool parallel;
 } GF_CENCStream;
 
+//range of bytes to encrypt in a job, ranges of a job are chained through next_plus_one
+typedef struct
+{
+	u8 *data;
+	u32 size;
+	u32 next_plus_one;
+} CENCRange;
+
+//a job is a set of ranges encrypted in sequence with a single cipher state
+typedef struct
+{
+	bin128 key;
+	bin128 IV;
+	Bool ctr;
+	//CTR only, number of keystream bytes to discard before the first range
+	u32 ks_skip;
+	u32 first_range, last_range;
+	u32 size;
+} CENCJob;
+
+//cipher states used by one thread of parallel jobs
+typedef struct
+{
+	GF_Crypt *ctr, *cbc;
+	bin128 ctr_key, cbc_key;
+	Bool ctr_init, cbc_init;
+} CENCWorker;
+
 typedef struct
 {
 	//options
 	const char *cfile;
-	Bool allc, bk_stats;
+	Bool allc, bk_stats, mt;
 
 	//internal
+	GF_Filter *filter;
 	GF_CryptInfo *cinfo;
 
 	GF_List *streams;
 	GF_BitStream *bs_w, *bs_r;
+
+	//one cipher state per thread index of parallel jobs, NULL if parallel encryption is disabled
+	u32 nb_threads;
+	CENCWorker *workers;
+
+	CENCJob *jobs;
+	u32 nb_jobs, nb_alloc_jobs;
+	CENCRange *ranges;
+	u32 nb_ranges, nb_alloc_ranges;
+	//encrypted packets waiting for their jobs to complete, in send order
+	GF_List *pending_pcks;
 } GF_CENCEncCtx;
 
+//max bytes per CTR job, larger ranges are split so that big samples/subsamples are spread over threads
+#define CENC_JOB_SIZE	32768
+//number of packets fetched per thread in one process call
+#define CENC_BATCH_PER_THREAD	4
+
+
+static void cenc_add_counter(char IV[16], u32 nb_blocks)
+{
+	s32 i;
+	u64 carry = nb_blocks;
+	for (i=15; (i>=0) && carry; i--) {
+		carry += (u8) IV[i];
+		IV[i] = (char) (carry & 0xFF);
+		carry >>= 8;
+	}
+}
+
+static GF_Err cenc_job_new(GF_CENCEncCtx *ctx, CENC_MKey *mk, Bool ctr, u32 ks_skip)
+{
+	CENCJob *job;
+	if (ctx->nb_jobs == ctx->nb_alloc_jobs) {
+		ctx->nb_alloc_jobs = ctx->nb_alloc_jobs ? 2*ctx->nb_alloc_jobs : 64;
+		ctx->jobs = gf_realloc(ctx->jobs, sizeof(CENCJob) * ctx->nb_alloc_jobs);
+		if (!ctx->jobs) {
+			ctx->nb_jobs = ctx->nb_alloc_jobs = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	job = &ctx->jobs[ctx->nb_jobs];
+	memset(job, 0, sizeof(CENCJob));
+	memcpy(job->key, mk->key, 16);
+	memcpy(job->IV, mk->IV, 16);
+	job->ctr = ctr;
+	if (ctr) {
+		//counter for the block containing the current keystream position
+		cenc_add_counter(job->IV, mk->ks_pos / 16);
+		job->ks_skip = ks_skip;
+	}
+	ctx->nb_jobs++;
+	mk->job_plus_one = ctx->nb_jobs;
+	return GF_OK;
+}
+
+static GF_Err cenc_job_add_range(GF_CENCEncCtx *ctx, u32 job_idx, u8 *data, u32 size)
+{
+	CENCRange *r;
+	CENCJob *job = &ctx->jobs[job_idx];
+	if (ctx->nb_ranges == ctx->nb_alloc_ranges) {
+		ctx->nb_alloc_ranges = ctx->nb_alloc_ranges ? 2*ctx->nb_alloc_ranges : 256;
+		ctx->ranges = gf_realloc(ctx->ranges, sizeof(CENCRange) * ctx->nb_alloc_ranges);
+		if (!ctx->ranges) {
+			ctx->nb_ranges = ctx->nb_alloc_ranges = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	r = &ctx->ranges[ctx->nb_ranges];
+	r->data = data;
+	r->size = size;
+	r->next_plus_one = 0;
+	ctx->nb_ranges++;
+	if (job->first_range)
+		ctx->ranges[job->last_range-1].next_plus_one = ctx->nb_ranges;
+	else
+		job->first_range = ctx->nb_ranges;
+	job->last_range = ctx->nb_ranges;
+	job->size += size;
+	return GF_OK;
+}
+
+//encrypt or, in parallel mode, schedule encryption of a range with the current state of the given key
+static GF_Err cenc_crypt(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u32 key_idx, u8 *data, u32 size)
+{
+	GF_Err e;
+	CENC_MKey *mk = &cstr->keys[key_idx];
+	if (!cstr->parallel)
+		return gf_crypt_encrypt(mk->crypt, data, size);
+
+	if (!cstr->ctr_mode) {
+		//constant IV is set at each subsample/sample start, which creates the job
+		if (!mk->job_plus_one) {
+			e = cenc_job_new(ctx, mk, GF_FALSE, 0);
+			if (e) return e;
+		}
+		return cenc_job_add_range(ctx, mk->job_plus_one-1, data, size);
+	}
+	while (size) {
+		u32 len = size;
+		if (!mk->job_plus_one || (ctx->jobs[mk->job_plus_one-1].size >= CENC_JOB_SIZE)) {
+			e = cenc_job_new(ctx, mk, GF_TRUE, mk->ks_pos % 16);
+			if (e) return e;
+		}
+		if (ctx->jobs[mk->job_plus_one-1].size + len > CENC_JOB_SIZE)
+			len = CENC_JOB_SIZE - ctx->jobs[mk->job_plus_one-1].size;
+
+		e = cenc_job_add_range(ctx, mk->job_plus_one-1, data, len);
+		if (e) return e;
+		mk->ks_pos += len;
+		data += len;
+		size -= len;
+	}
+	return GF_OK;
+}
+
+//cbcs with constant IV, restart the CBC chain
+static GF_Err cenc_set_const_IV(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u32 key_idx)
+{
+	CENC_MKey *mk = &cstr->keys[key_idx];
+	if (!cstr->parallel)
+		return gf_crypt_set_IV(mk->crypt, mk->IV, 16);
+	return cenc_job_new(ctx, mk, GF_FALSE, 0);
+}
+
+static void cenc_run_job(GF_CENCEncCtx *ctx, CENCWorker *w, CENCJob *job)
+{
+	u32 ridx;
+	GF_Crypt *mc;
+	if (job->ctr) {
+		char state[17];
+		mc = w->ctr;
+		if (!w->ctr_init) {
+			gf_crypt_init(mc, job->key, job->IV);
+			memcpy(w->ctr_key, job->key, 16);
+			w->ctr_init = GF_TRUE;
+		} else if (memcmp(w->ctr_key, job->key, 16)) {
+			gf_crypt_set_key(mc, job->key);
+			memcpy(w->ctr_key, job->key, 16);
+		}
+		state[0] = 0;
+		memcpy(state+1, job->IV, 16);
+		gf_crypt_set_IV(mc, state, 17);
+		//job starts in the middle of a counter block, consume keystream up to that position
+		if (job->ks_skip) {
+			u8 skip[16];
+			memset(skip, 0, 16);
+			gf_crypt_encrypt(mc, skip, job->ks_skip);
+		}
+	} else {
+		mc = w->cbc;
+		if (!w->cbc_init) {
+			gf_crypt_init(mc, job->key, job->IV);
+			memcpy(w->cbc_key, job->key, 16);
+			w->cbc_init = GF_TRUE;
+		} else if (memcmp(w->cbc_key, job->key, 16)) {
+			gf_crypt_set_key(mc, job->key);
+			memcpy(w->cbc_key, job->key, 16);
+		}
+		gf_crypt_set_IV(mc, job->IV, 16);
+	}
+	ridx = job->first_range;
+	while (ridx) {
+		CENCRange *r = &ctx->ranges[ridx-1];
+		gf_crypt_encrypt(mc, r->data, r->size);
+		ridx = r->next_plus_one;
+	}
+}
+
+static void cenc_jobs_run(void *udta, u32 first, u32 last, u32 thread_idx)
+{
+	u32 i;
+	GF_CENCEncCtx *ctx = (GF_CENCEncCtx *) udta;
+	for (i=first; i<last; i++) {
+		cenc_run_job(ctx, &ctx->workers[thread_idx], &ctx->jobs[i]);
+	}
+}
+
+//run all scheduled jobs and send the corresponding packets in order
+static void cenc_flush_jobs(GF_CENCEncCtx *ctx)
+{
+	u32 i, count;
+	if (ctx->nb_jobs) {
+		gf_filter_parallel_for(ctx->filter, ctx->nb_jobs, 1, cenc_jobs_run, ctx);
+		ctx->nb_jobs = 0;
+		ctx->nb_ranges = 0;
+	}
+	count = gf_list_count(ctx->streams);
+	for (i=0; i<count; i++) {
+		u32 j;
+		GF_CENCStream *cstr = gf_list_get(ctx->streams, i);
+		for (j=0; j<cstr->nb_keys; j++) {
+			cstr->keys[j].job_plus_one = 0;
+		}
+	}
+	while (gf_list_count(ctx->pending_pcks)) {
+		GF_FilterPacket *pck = gf_list_pop_front(ctx->pending_pcks);
+		gf_filter_pck_send(pck);
+	}
+}
+
+//discard jobs scheduled since the given marks, used when a packet fails to encrypt
+static void cenc_cancel_jobs(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u32 nb_jobs, u32 nb_ranges)
+{
+	u32 i;
+	ctx->nb_jobs = nb_jobs;
+	ctx->nb_ranges = nb_ranges;
+	//jobs never span several packets, remaining jobs only hold ranges of previous packets
+	for (i=0; i<cstr->nb_keys; i++) {
+		cstr->keys[i].job_plus_one = 0;
+		cstr->keys[i].ks_pos = 0;
+	}
+}
 
 static GF_Err isma_enc_configure(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, Bool is_isma, const char *scheme_uri, const char *kms_uri)
 {
@@ -1002,6 +1247,18 @@ static GF_Err cenc_enc_configure(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, const
 		cstr->prev_pck_encrypted = cstr->tci->IsEncrypted;
 	}
 
+	//parallel encryption requires the IV of each sample or subsample to be known before encrypting,
+	//i.e. CTR mode or CBC with constant IV; SAES modifies the encrypted payload and is always serial
+	cstr->parallel = GF_FALSE;
+	if (ctx->workers && !cstr->is_saes) {
+		cstr->parallel = GF_TRUE;
+		if (!cstr->ctr_mode) {
+			for (i=0; i<cstr->tci->nb_keys; i++) {
+				if (cstr->tci->keys[i].IV_size) cstr->parallel = GF_FALSE;
+			}
+		}
+	}
+
 	/*set CENC protection properties*/
 
 	gf_filter_pid_set_property(cstr->opid, GF_PROP_PID_PROTECTION_SCHEME_VERSION, &PROP_UINT(0x00010000) );
@@ -1115,6 +1372,9 @@ static GF_Err cenc_enc_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool
 	u32 i, count;
 	Bool force_clear = GF_FALSE;
 
+	//pending packets were encrypted with the current configuration
+	cenc_flush_jobs(ctx);
+
 	if (is_remove) {
 		cstr = gf_filter_pid_get_udta(pid);
 		if (cstr) {
@@ -1540,6 +1800,7 @@ static GF_Err adobe_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPa
 }
 
 
+
 /*Common Encryption*/
 static void increase_counter(char *x, int x_size) {
 	register int i;
@@ -1557,12 +1818,23 @@ static void increase_counter(char *x, int x_size) {
 	return;
 }
 
-static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
+static void cenc_resync_IV(CENC_MKey *mk, u8 IV_size, Bool parallel)
 {
 	char next_IV[17];
 	u32 size = 17;
-
-	gf_crypt_get_IV(mc, (u8 *) next_IV, &size);
+	GF_Crypt *mc = mk->crypt;
+	char *IV = mk->IV;
+
+	if (parallel) {
+		//encryption not done yet, compute counter state after the keystream bytes scheduled for this sample
+		next_IV[0] = (mk->ks_pos % 16) ? 1 : 0;
+		memcpy(next_IV+1, IV, 16);
+		cenc_add_counter(next_IV+1, (mk->ks_pos + 15) / 16);
+		mk->ks_pos = 0;
+		mk->job_plus_one = 0;
+	} else {
+		gf_crypt_get_IV(mc, (u8 *) next_IV, &size);
+	}
 	/*
 		NOTE 1: the next_IV returned by get_state has 17 bytes, the first byte being the current counter position in the following 16 bytes.
 		If this index is 0, this means that we are at the beginning of a new block and we can use it as IV for next sample,
@@ -2013,7 +2285,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 
 					//cbcs scheme with constant IV, reinit at each sub sample,
 					if (!cstr->ctr_mode && !cstr->tci->keys[key_idx].IV_size)
-						gf_crypt_set_IV(cstr->keys[key_idx].crypt, cstr->keys[key_idx].IV, 16);
+						e = cenc_set_const_IV(ctx, cstr, key_idx);
 
 					//pattern encryption
 					if (cstr->crypt_byte_block && cstr->skip_byte_block) {
@@ -2022,10 +2294,10 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 						//don't use modulo in case we use fatal_assert
 						gf_assert((res / 16) * 16 == res);
 
-						while (res) {
+						while (res && !e) {
 							u32 to_crypt = (res >= (u32) (16*cstr->crypt_byte_block)) ? 16*cstr->crypt_byte_block : res;
 
-							e = gf_crypt_encrypt(cstr->keys[key_idx].crypt, output+pos, to_crypt);
+							e = cenc_crypt(ctx, cstr, key_idx, output+pos, to_crypt);
 							cstr->num_block_crypted += to_crypt/16;
 
 							if (res >= (u32) (16 * (cstr->crypt_byte_block + cstr->skip_byte_block))) {
@@ -2037,11 +2309,11 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 						}
 					}
 					//full subsample encryption
-					else {
+					else if (!e) {
 						//clear_bytes_at_end is 0 unless NALU-based cbcs without pattern (not defined in CENC)
 						//in this case, we must only encrypt a multiple of 16-byte blocks
 						u32 to_crypt = nalu_size - clear_bytes - clear_bytes_at_end;
-						e = gf_crypt_encrypt(cstr->keys[key_idx].crypt, output+cur_pos, to_crypt);
+						e = cenc_crypt(ctx, cstr, key_idx, output+cur_pos, to_crypt);
 						cstr->num_block_crypted += to_crypt/16;
 					}
 				}
@@ -2135,7 +2407,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		//CTR full sample
 		else if (cstr->ctr_mode) {
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
-			e = gf_crypt_encrypt(cstr->keys[0].crypt, output, pck_size);
+			e = cenc_crypt(ctx, cstr, 0, output, pck_size);
 			cstr->num_block_crypted += pck_size/16;
 		}
 		//CBC full sample with padding
@@ -2149,11 +2421,11 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 
 			//cbcs scheme with constant IV, reinit at each sample,
 			if (!cstr->tci->keys[0].IV_size)
-				gf_crypt_set_IV(cstr->keys[0].crypt, cstr->keys[0].IV, 16);
+				e = cenc_set_const_IV(ctx, cstr, 0);
 
-			if (pck_size >= 16) {
+			if (!e && (pck_size >= 16)) {
 				u32 to_crypt = pck_size - clear_header - clear_trailing;
-				gf_crypt_encrypt(cstr->keys[0].crypt, output+clear_header, to_crypt);
+				e = cenc_crypt(ctx, cstr, 0, output+clear_header, to_crypt);
 				cstr->num_block_crypted += to_crypt/16;
 			}
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
@@ -2176,7 +2448,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	}
 	if (cstr->ctr_mode) {
 		for (i=0; i<nb_keys; i++) {
-			cenc_resync_IV(cstr->keys[i].crypt, cstr->keys[i].IV, cstr->tci->keys[i].IV_size);
+			cenc_resync_IV(&cstr->keys[i], cstr->tci->keys[i].IV_size, cstr->parallel);
 		}
 	}
 
@@ -2393,7 +2665,10 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		}
 	}
 
-	gf_filter_pck_send(dst_pck);
+	if (cstr->parallel)
+		gf_list_add(ctx->pending_pcks, dst_pck);
+	else
+		gf_filter_pck_send(dst_pck);
 	return GF_OK;
 }
 
@@ -2405,6 +2680,7 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 	Bool all_rap=GF_FALSE;
 	u32 pck_size;
 	Bool force_clear = GF_FALSE;
+	u32 nb_jobs, nb_ranges;
 	u8 sap = gf_filter_pck_get_sap(pck);
 
 	data = gf_filter_pck_get_data(pck, &pck_size);
@@ -2447,6 +2723,11 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 		u32 i, sai_size = 0;
 		Bool signal_sai = GF_FALSE;
 		GF_FilterPacket *dst_pck;
+
+		//previous encrypted packets must be sent first
+		if (cstr->parallel)
+			cenc_flush_jobs(ctx);
+
 		dst_pck = gf_filter_pck_new_ref(cstr->opid, 0, 0, pck);
 		if (!dst_pck) return GF_OUT_OF_MEM;
 
@@ -2578,6 +2859,10 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 			GF_CryptKeyInfo *ki = &cstr->tci->keys[cstr->kidx];
 			u8 key_info[40];
 			u32 key_info_size = 20;
+
+			//send packets encrypted with previous key before signaling the new one
+			if (cstr->parallel)
+				cenc_flush_jobs(ctx);
 			key_info[0] = 0;
 			key_info[1] = 0;
 			key_info[2] = 0;
@@ -2596,8 +2881,12 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 		}
 	}
 
+	nb_jobs = ctx->nb_jobs;
+	nb_ranges = ctx->nb_ranges;
 	e = cenc_encrypt_packet(ctx, cstr, pck);
 	if (e) {
+		if (cstr->parallel)
+			cenc_cancel_jobs(ctx, cstr, nb_jobs, nb_ranges);
 		GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[CENC] Error encrypting packet %d in PID %s: %s\n", cstr->nb_pck, gf_filter_pid_get_name(cstr->ipid), gf_error_to_string(e)) );
 		return e;
 	}
@@ -2631,6 +2920,30 @@ static GF_Err cenc_enc_process(GF_Filter *filter)
 			e = isma_process(ctx, cstr, pck);
 		} else if (cstr->is_adobe) {
 	 		e = adobe_process(ctx, cstr, pck);
+		} else if (cstr->parallel) {
+			u32 nb_pck = 0;
+			//fetch a batch of packets so that their encryption can be spread over session threads
+			while (1) {
+				e = cenc_process(ctx, cstr, pck);
+				nb_pck++;
+				if (e || (nb_pck >= CENC_BATCH_PER_THREAD * ctx->nb_threads))
+					break;
+				gf_filter_pid_drop_packet(cstr->ipid);
+				cstr->nb_pck++;
+				pck = gf_filter_pid_get_packet(cstr->ipid);
+				//stream was reconfigured while fetching, process it at next call
+				if (pck && (!cstr->parallel || cstr->passthrough))
+					pck = NULL;
+				if (!pck) break;
+			}
+			cenc_flush_jobs(ctx);
+			if (!pck) {
+				if (gf_filter_pid_is_eos(cstr->ipid)) {
+					gf_filter_pid_set_eos(cstr->opid);
+					nb_eos++;
+				}
+				continue;
+			}
 		} else {
 			e = cenc_process(ctx, cstr, pck);
 		}
@@ -2658,6 +2971,23 @@ static GF_Err cenc_enc_initialize(GF_Filter *filter)
 	}
 
 	ctx->streams = gf_list_new();
+	ctx->pending_pcks = gf_list_new();
+
+	ctx->filter = filter;
+	ctx->nb_threads = gf_filter_parallel_max_threads(filter);
+	//no parallel encryption in single-threaded sessions
+	if (ctx->mt && (ctx->nb_threads>1)) {
+		u32 i;
+		ctx->workers = gf_malloc(sizeof(CENCWorker) * ctx->nb_threads);
+		if (!ctx->workers) return GF_OUT_OF_MEM;
+		memset(ctx->workers, 0, sizeof(CENCWorker) * ctx->nb_threads);
+		for (i=0; i<ctx->nb_threads; i++) {
+			ctx->workers[i].ctr = gf_crypt_open(GF_AES_128, GF_CTR);
+			ctx->workers[i].cbc = gf_crypt_open(GF_AES_128, GF_CBC);
+			if (!ctx->workers[i].ctr || !ctx->workers[i].cbc) return GF_OUT_OF_MEM;
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[CENCCrypt] Using up to %d threads for CTR and constant-IV CBC encryption\n", ctx->nb_threads));
+	}
 	return GF_OK;
 }
 
@@ -2672,6 +3002,24 @@ static void cenc_enc_finalize(GF_Filter *filter)
 		cenc_free_pid_context(s);
 	}
 	gf_list_del(ctx->streams);
+	if (ctx->pending_pcks) {
+		while (gf_list_count(ctx->pending_pcks)) {
+			GF_FilterPacket *pck = gf_list_pop_back(ctx->pending_pcks);
+			gf_filter_pck_discard(pck);
+		}
+		gf_list_del(ctx->pending_pcks);
+	}
+	if (ctx->workers) {
+		u32 i;
+		for (i=0; i<ctx->nb_threads; i++) {
+			CENCWorker *w = &ctx->workers[i];
+			if (w->ctr) gf_crypt_close(w->ctr);
+			if (w->cbc) gf_crypt_close(w->cbc);
+		}
+		gf_free(ctx->workers);
+	}
+	if (ctx->jobs) gf_free(ctx->jobs);
+	if (ctx->ranges) gf_free(ctx->ranges);
 	if (ctx->bs_w) gf_bs_del(ctx->bs_w);
 	if (ctx->bs_r) gf_bs_del(ctx->bs_r);
 	if (ctx->bk_stats) {
@@ -2696,6 +3044,7 @@ static const GF_FilterArgs GF_CENCEncArgs[] =
 	{ OFFS(cfile), "crypt file location", GF_PROP_STRING, NULL, NULL, 0},
 	{ OFFS(allc), "throw error if no DRM config file is found for a PID", GF_PROP_BOOL, NULL, NULL, 0},
 	{ OFFS(bk_stats), "print number of encrypted blocks to stdout upon exit", GF_PROP_BOOL, NULL, NULL, 0},
+	{ OFFS(mt), "use session threads for encryption of CTR-based and constant IV CBC-based schemes", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -2708,6 +3057,9 @@ GF_FilterRegister CENCEncRegister = {
 	"When the DRM config file is set per PID, the first `CrypTrack` in the DRM config file with the same ID is used, otherwise the first `CrypTrack` is used (regardless of the `CrypTrack` ID).\n"
 	"When the DRM config file is set globally (not per PID), the first `CrypTrack` in the DRM config file with the same ID is used, otherwise the first `CrypTrack` with ID 0 or not set is used.\n"
 	"If no DRM config file is defined for a given PID, this PID will not be encrypted, or an error will be thrown if [-allc]() is specified.\n"
+	"\n"
+	"The [-mt]() option enables encryption on the session threads (see [-threads](CORE)) for `cenc`, `cens`, `piff` and constant IV `cbcs` schemes. Samples are encrypted in parallel, "
+	"and large samples are split across threads. Output packets are sent in input order. Other schemes are always encrypted on the filter thread.\n"
 	)
 	.private_size = sizeof(GF_CENCEncCtx),
 	.max_extra_pids=-1,
@@ -28,6 +28,8 @@
 #ifndef GPAC_DISABLE_EVG
 #include <gpac/evg.h>
 
+#include <gpac/internal/simd.h>
+
 enum
 {
 	EVGS_KEEPAR_OFF=0,
@@ -35,6 +37,35 @@ enum
 	EVGS_KEEPAR_NOSRC,
 };
 
+enum
+{
+	EVGS_ALGO_EVG=0,
+	EVGS_ALGO_BICUBIC,
+	EVGS_ALGO_LANCZOS,
+};
+
+//precomputed coefficients for one direction of one plane
+typedef struct
+{
+	u32 src_size, dst_size, nb_taps;
+	//first source sample used by each destination sample
+	u32 *start;
+	//nb_taps coefficients per destination sample, in EVGS_COEF_BITS fixed point
+	s16 *coefs;
+} EVGSFilterTable;
+
+typedef struct
+{
+	const u8 *src;
+	u32 src_stride;
+	u8 *dst;
+	u32 dst_stride;
+	//horizontally scaled source rows, src_size rows of dst_size samples
+	s16 *tmp;
+	u32 tmp_stride;
+	EVGSFilterTable *h, *v;
+} EVGSPlane;
+
 typedef struct
 {
 	//options
@@ -44,6 +75,7 @@ typedef struct
 	char *padclr;
 	u32 keepar;
 	GF_Fraction osar;
+	u32 algo;
 
 	//internal data
 	GF_FilterPid *ipid;
@@ -60,11 +92,448 @@ typedef struct
 	GF_EVGSurface *surf;
 	GF_EVGStencil *tx;
 	GF_Path *path;
+
+	//separable scaler, used instead of the rasterizer when algo is set and the format allows it
+	Bool use_scaler, sc_sub_w, sc_sub_h;
+	u32 sc_bytes, sc_planes, sc_o_stride_uv;
+	//luma horizontal, luma vertical, chroma horizontal, chroma vertical
+	EVGSFilterTable tables[4];
+	EVGSPlane planes[3];
+	s16 *tmp;
+	u32 tmp_alloc;
+	//rows of all planes are numbered contiguously for parallel jobs, plane i starts at row_start[i]
+	u32 row_start[4];
+	Bool vertical_pass;
 } EVGScaleCtx;
 
 u32 gf_evg_stencil_get_pixel_fast(GF_EVGStencil *st, s32 x, s32 y);
 u64 gf_evg_stencil_get_pixel_wide_fast(GF_EVGStencil *st, s32 x, s32 y);
 
+//coefficients are 14-bit fixed point, horizontal pass keeps 6 (8-bit) or 4 (10-bit) extra bits in the intermediate rows
+#define EVGS_COEF_BITS	14
+#define EVGS_H_SHIFT(_bytes)	((_bytes==1) ? 8 : 10)
+#define EVGS_V_SHIFT(_bytes)	(2*EVGS_COEF_BITS - EVGS_H_SHIFT(_bytes))
+
+static Double evgs_kernel(u32 algo, Double x)
+{
+	if (x<0) x = -x;
+	if (algo==EVGS_ALGO_BICUBIC) {
+		//Keys cubic, a=-0.5
+		if (x<1) return (1.5*x - 2.5)*x*x + 1;
+		if (x<2) return ((-0.5*x + 2.5)*x - 4)*x + 2;
+		return 0;
+	}
+	//3-lobe Lanczos
+	if (x<1e-8) return 1;
+	if (x>=3) return 0;
+	x *= GF_PI;
+	return 3 * sin(x) * sin(x/3) / (x*x);
+}
+
+static void evgs_table_reset(EVGSFilterTable *t)
+{
+	if (t->start) gf_free(t->start);
+	if (t->coefs) gf_free(t->coefs);
+	memset(t, 0, sizeof(EVGSFilterTable));
+}
+
+static GF_Err evgs_table_setup(EVGSFilterTable *t, u32 algo, u32 src_size, u32 dst_size)
+{
+	u32 i, j, nb_taps;
+	Double scale, support;
+	Double *w;
+
+	if ((t->src_size==src_size) && (t->dst_size==dst_size) && t->coefs)
+		return GF_OK;
+	evgs_table_reset(t);
+
+	scale = (Double) src_size / dst_size;
+	//widen the kernel when downscaling so that it acts as a low-pass filter
+	support = (algo==EVGS_ALGO_BICUBIC) ? 2 : 3;
+	if (scale>1) support *= scale;
+
+	//window of nb_taps source samples per output, rounded so that SIMD loops cover full vectors
+	nb_taps = 2 * (u32) ceil(support) + 1;
+	nb_taps = (nb_taps + 7) & ~7;
+	if (nb_taps > src_size) nb_taps = src_size;
+
+	t->start = gf_malloc(sizeof(u32) * dst_size);
+	t->coefs = gf_malloc(sizeof(s16) * dst_size * nb_taps);
+	w = gf_malloc(sizeof(Double) * nb_taps);
+	if (!t->start || !t->coefs || !w) {
+		if (w) gf_free(w);
+		evgs_table_reset(t);
+		return GF_OUT_OF_MEM;
+	}
+	t->src_size = src_size;
+	t->dst_size = dst_size;
+	t->nb_taps = nb_taps;
+
+	for (i=0; i<dst_size; i++) {
+		Double center = (i + 0.5) * scale - 0.5;
+		Double sum = 0;
+		s32 k, left = (s32) floor(center - support) + 1;
+		s32 right = (s32) floor(center + support);
+		s32 start = left;
+		s32 isum, max_idx;
+		s16 *c = t->coefs + i*nb_taps;
+
+		if (start > (s32) (src_size - nb_taps)) start = src_size - nb_taps;
+		if (start < 0) start = 0;
+		t->start[i] = start;
+
+		memset(w, 0, sizeof(Double) * nb_taps);
+		for (k=left; k<=right; k++) {
+			Double v = evgs_kernel(algo, (k - center) / ((scale>1) ? scale : 1));
+			//edge samples are repeated
+			s32 idx = (k<0) ? 0 : ((k >= (s32) src_size) ? (s32) src_size-1 : k);
+			idx -= start;
+			if ((idx<0) || (idx >= (s32) nb_taps)) continue;
+			w[idx] += v;
+			sum += v;
+		}
+		if (sum==0) sum = 1;
+
+		isum = 0;
+		max_idx = 0;
+		for (j=0; j<nb_taps; j++) {
+			s32 v = (s32) floor(w[j] * (1<<EVGS_COEF_BITS) / sum + 0.5);
+			if (v>32767) v = 32767;
+			else if (v<-32768) v = -32768;
+			c[j] = (s16) v;
+			isum += v;
+			if (ABS(c[j]) > ABS(c[max_idx])) max_idx = j;
+		}
+		//make sure each output has unity gain
+		c[max_idx] += (1<<EVGS_COEF_BITS) - isum;
+	}
+	gf_free(w);
+	return GF_OK;
+}
+
+static void evgs_hscale(const u8 *src, s16 *dst, EVGSFilterTable *t, u32 bytes)
+{
+	u32 x, i, n = t->nb_taps;
+	s32 rnd = 1 << (EVGS_H_SHIFT(bytes) - 1);
+	u32 shift = EVGS_H_SHIFT(bytes);
+
+	for (x=0; x<t->dst_size; x++) {
+		const s16 *c = t->coefs + x*n;
+		s32 sum = 0;
+		i = 0;
+		if (bytes==1) {
+			const u8 *s = src + t->start[x];
+#if defined(GPAC_HAS_SSE2)
+			__m128i zero = _mm_setzero_si128();
+			__m128i acc = zero;
+			for (; i+8<=n; i+=8) {
+				__m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (s+i)), zero);
+				acc = _mm_add_epi32(acc, _mm_madd_epi16(px, _mm_loadu_si128((const __m128i *) (c+i))));
+			}
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+			sum = _mm_cvtsi128_si32(acc);
+#elif defined(GPAC_HAS_NEON)
+			int32x4_t acc = vdupq_n_s32(0);
+			for (; i+8<=n; i+=8) {
+				int16x8_t px = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(s+i)));
+				int16x8_t cf = vld1q_s16(c+i);
+				acc = vmlal_s16(acc, vget_low_s16(px), vget_low_s16(cf));
+				acc = vmlal_s16(acc, vget_high_s16(px), vget_high_s16(cf));
+			}
+			sum = vaddvq_s32(acc);
+#endif
+			for (; i<n; i++)
+				sum += s[i] * c[i];
+		} else {
+			const u16 *s = ((const u16 *) src) + t->start[x];
+#if defined(GPAC_HAS_SSE2)
+			__m128i acc = _mm_setzero_si128();
+			for (; i+8<=n; i+=8) {
+				__m128i px = _mm_loadu_si128((const __m128i *) (s+i));
+				acc = _mm_add_epi32(acc, _mm_madd_epi16(px, _mm_loadu_si128((const __m128i *) (c+i))));
+			}
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+			acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+			sum = _mm_cvtsi128_si32(acc);
+#elif defined(GPAC_HAS_NEON)
+			int32x4_t acc = vdupq_n_s32(0);
+			for (; i+8<=n; i+=8) {
+				int16x8_t px = vreinterpretq_s16_u16(vld1q_u16(s+i));
+				int16x8_t cf = vld1q_s16(c+i);
+				acc = vmlal_s16(acc, vget_low_s16(px), vget_low_s16(cf));
+				acc = vmlal_s16(acc, vget_high_s16(px), vget_high_s16(cf));
+			}
+			sum = vaddvq_s32(acc);
+#endif
+			for (; i<n; i++)
+				sum += s[i] * c[i];
+		}
+		dst[x] = (s16) ((sum + rnd) >> shift);
+	}
+}
+
+static void evgs_vscale(EVGSPlane *pl, u32 y, u32 bytes)
+{
+	EVGSFilterTable *t = pl->v;
+	u32 x=0, i, n = t->nb_taps;
+	u32 width = pl->h->dst_size;
+	const s16 *c = t->coefs + y*n;
+	const s16 *rows = pl->tmp + t->start[y] * pl->tmp_stride;
+	u8 *dst = pl->dst + y * pl->dst_stride;
+	u32 shift = EVGS_V_SHIFT(bytes);
+	s32 rnd = 1 << (shift-1);
+	s32 max_val = (bytes==1) ? 255 : 1023;
+
+#if defined(GPAC_HAS_SSE2)
+	__m128i v_rnd = _mm_set1_epi32(rnd);
+	__m128i v_shift = _mm_cvtsi32_si128(shift);
+	__m128i v_max = _mm_set1_epi16(max_val);
+	__m128i zero = _mm_setzero_si128();
+	for (; x+8<=width; x+=8) {
+		__m128i lo = v_rnd, hi = v_rnd, res;
+		//process taps by pairs, interleaving two rows so that madd applies both coefficients
+		for (i=0; i+2<=n; i+=2) {
+			__m128i r0 = _mm_loadu_si128((const __m128i *) (rows + i*pl->tmp_stride + x));
+			__m128i r1 = _mm_loadu_si128((const __m128i *) (rows + (i+1)*pl->tmp_stride + x));
+			__m128i cf = _mm_set1_epi32( (u16) c[i] | ((u32) (u16) c[i+1] << 16) );
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), cf));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), cf));
+		}
+		if (i<n) {
+			__m128i r0 = _mm_loadu_si128((const __m128i *) (rows + i*pl->tmp_stride + x));
+			__m128i cf = _mm_set1_epi32( (u16) c[i] );
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(r0, zero), cf));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(r0, zero), cf));
+		}
+		lo = _mm_sra_epi32(lo, v_shift);
+		hi = _mm_sra_epi32(hi, v_shift);
+		res = _mm_packs_epi32(lo, hi);
+		if (bytes==1) {
+			_mm_storel_epi64((__m128i *) (dst+x), _mm_packus_epi16(res, res));
+		} else {
+			res = _mm_min_epi16(_mm_max_epi16(res, zero), v_max);
+			_mm_storeu_si128((__m128i *) (dst+2*x), res);
+		}
+	}
+#elif defined(GPAC_HAS_NEON)
+	int32x4_t v_shift = vdupq_n_s32(- (s32) shift);
+	int16x8_t v_max = vdupq_n_s16(max_val);
+	int16x8_t zero = vdupq_n_s16(0);
+	for (; x+8<=width; x+=8) {
+		int32x4_t lo = vdupq_n_s32(0), hi = vdupq_n_s32(0);
+		int16x8_t res;
+		for (i=0; i<n; i++) {
+			int16x8_t r = vld1q_s16(rows + i*pl->tmp_stride + x);
+			lo = vmlal_n_s16(lo, vget_low_s16(r), c[i]);
+			hi = vmlal_n_s16(hi, vget_high_s16(r), c[i]);
+		}
+		//rounding shift right
+		lo = vrshlq_s32(lo, v_shift);
+		hi = vrshlq_s32(hi, v_shift);
+		res = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+		if (bytes==1) {
+			vst1_u8(dst+x, vqmovun_s16(res));
+		} else {
+			res = vminq_s16(vmaxq_s16(res, zero), v_max);
+			vst1q_u16((u16 *) (dst+2*x), vreinterpretq_u16_s16(res));
+		}
+	}
+#endif
+
+	for (; x<width; x++) {
+		s32 sum = rnd;
+		for (i=0; i<n; i++)
+			sum += rows[i*pl->tmp_stride + x] * c[i];
+		sum >>= shift;
+		if (sum<0) sum = 0;
+		else if (sum>max_val) sum = max_val;
+		if (bytes==1) dst[x] = (u8) sum;
+		else ((u16 *) dst)[x] = (u16) sum;
+	}
+}
+
+//rows are source rows for the horizontal pass, destination rows for the vertical pass
+static void evgs_job(void *udta, u32 first, u32 last, u32 thread_idx)
+{
+	u32 i, y;
+	EVGScaleCtx *ctx = (EVGScaleCtx *) udta;
+	for (i=0; i<ctx->sc_planes; i++) {
+		EVGSPlane *pl = &ctx->planes[i];
+		u32 p_first = MAX(first, ctx->row_start[i]);
+		u32 p_last = MIN(last, ctx->row_start[i+1]);
+		if (p_first >= p_last) continue;
+		p_first -= ctx->row_start[i];
+		p_last -= ctx->row_start[i];
+		if (!ctx->vertical_pass) {
+			for (y=p_first; y<p_last; y++) {
+				evgs_hscale(pl->src + y*pl->src_stride, pl->tmp + y*pl->tmp_stride, pl->h, ctx->sc_bytes);
+			}
+		} else {
+			for (y=p_first; y<p_last; y++) {
+				evgs_vscale(pl, y, ctx->sc_bytes);
+			}
+		}
+	}
+}
+
+//rows of all planes are split in bands run by session threads
+static void evgs_run_pass(GF_Filter *filter, EVGScaleCtx *ctx, Bool vertical)
+{
+	u32 i;
+	ctx->row_start[0] = 0;
+	for (i=0; i<ctx->sc_planes; i++) {
+		u32 nb_rows = vertical ? ctx->planes[i].v->dst_size : ctx->planes[i].v->src_size;
+		ctx->row_start[i+1] = ctx->row_start[i] + nb_rows;
+	}
+	ctx->vertical_pass = vertical;
+	gf_filter_parallel_for(filter, ctx->row_start[ctx->sc_planes], 16, evgs_job, ctx);
+}
+
+static void evgs_scaler_reset(EVGScaleCtx *ctx)
+{
+	u32 i;
+	for (i=0; i<4; i++)
+		evgs_table_reset(&ctx->tables[i]);
+	ctx->use_scaler = GF_FALSE;
+}
+
+//check if the separable scaler can be used and setup coefficient tables
+static GF_Err evgs_scaler_setup(EVGScaleCtx *ctx, u32 pfmt)
+{
+	GF_Err e;
+	u32 i, dst_w, dst_h, src_uv_w, src_uv_h, dst_uv_w, dst_uv_h, tmp_size, o_size, o_stride;
+	u32 nb_planes=3, bytes=1;
+	Bool sub_w=GF_FALSE, sub_h=GF_FALSE;
+
+	ctx->use_scaler = GF_FALSE;
+	if (ctx->algo==EVGS_ALGO_EVG) return GF_OK;
+
+	switch (pfmt) {
+	case GF_PIXEL_YUV_10:
+		bytes = 2;
+		//fallthrough
+	case GF_PIXEL_YUV:
+	case GF_PIXEL_YVU:
+		sub_w = sub_h = GF_TRUE;
+		break;
+	case GF_PIXEL_YUV422_10:
+		bytes = 2;
+		//fallthrough
+	case GF_PIXEL_YUV422:
+		sub_w = GF_TRUE;
+		break;
+	case GF_PIXEL_YUV444_10:
+		bytes = 2;
+		//fallthrough
+	case GF_PIXEL_YUV444:
+		break;
+	case GF_PIXEL_GREYSCALE:
+		nb_planes = 1;
+		break;
+	default:
+		pfmt = 0;
+		break;
+	}
+	//no color conversion nor range change in the scaler
+	if (!pfmt || (pfmt != ctx->ofmt) || (ctx->ofr != ctx->fullrange)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_MEDIA, ("[EVGS] %s scaler only supports planar YUV 8 and 10 bits without format or range conversion, using EVG rasterizer\n", (ctx->algo==EVGS_ALGO_BICUBIC) ? "Bicubic" : "Lanczos"));
+		return GF_OK;
+	}
+
+	dst_w = ctx->o_w - 2*ctx->offset_w;
+	dst_h = ctx->o_h - 2*ctx->offset_h;
+	src_uv_w = sub_w ? (ctx->i_w+1)/2 : ctx->i_w;
+	src_uv_h = sub_h ? (ctx->i_h+1)/2 : ctx->i_h;
+	dst_uv_w = sub_w ? (dst_w+1)/2 : dst_w;
+	dst_uv_h = sub_h ? (dst_h+1)/2 : dst_h;
+	if (!dst_w || !dst_h || !dst_uv_w || !dst_uv_h) return GF_OK;
+
+	e = evgs_table_setup(&ctx->tables[0], ctx->algo, ctx->i_w, dst_w);
+	if (!e) e = evgs_table_setup(&ctx->tables[1], ctx->algo, ctx->i_h, dst_h);
+	if (!e && (nb_planes>1)) e = evgs_table_setup(&ctx->tables[2], ctx->algo, src_uv_w, dst_uv_w);
+	if (!e && (nb_planes>1)) e = evgs_table_setup(&ctx->tables[3], ctx->algo, src_uv_h, dst_uv_h);
+	if (e) return e;
+
+	o_stride = ctx->sc_o_stride_uv = 0;
+	gf_pixel_get_size_info(ctx->ofmt, ctx->o_w, ctx->o_h, &o_size, &o_stride, &ctx->sc_o_stride_uv, NULL, NULL);
+
+	//intermediate rows are padded to a multiple of 8 samples
+	tmp_size = 0;
+	for (i=0; i<nb_planes; i++) {
+		EVGSPlane *pl = &ctx->planes[i];
+		pl->h = &ctx->tables[i ? 2 : 0];
+		pl->v = &ctx->tables[i ? 3 : 1];
+		pl->tmp_stride = (pl->h->dst_size + 7) & ~7;
+		tmp_size += pl->tmp_stride * pl->v->src_size;
+	}
+	if (tmp_size > ctx->tmp_alloc) {
+		ctx->tmp = gf_realloc(ctx->tmp, sizeof(s16) * tmp_size);
+		if (!ctx->tmp) {
+			ctx->tmp_alloc = 0;
+			return GF_OUT_OF_MEM;
+		}
+		ctx->tmp_alloc = tmp_size;
+	}
+	tmp_size = 0;
+	for (i=0; i<nb_planes; i++) {
+		ctx->planes[i].tmp = ctx->tmp + tmp_size;
+		tmp_size += ctx->planes[i].tmp_stride * ctx->planes[i].v->src_size;
+	}
+
+	ctx->sc_bytes = bytes;
+	ctx->sc_planes = nb_planes;
+	ctx->sc_sub_w = sub_w;
+	ctx->sc_sub_h = sub_h;
+	ctx->use_scaler = GF_TRUE;
+	GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[EVGS] Using %s scaler with %d/%d taps\n", (ctx->algo==EVGS_ALGO_BICUBIC) ? "bicubic" : "Lanczos", ctx->tables[0].nb_taps, ctx->tables[1].nb_taps));
+	return GF_OK;
+}
+
+static GF_Err evgs_scaler_process(GF_Filter *filter, EVGScaleCtx *ctx, const u8 *data, GF_FilterFrameInterface *frame_ifce, u8 *output)
+{
+	u32 i, off_x, off_y;
+
+	if (data) {
+		u32 uv_height = ctx->planes[1].v ? ctx->planes[1].v->src_size : 0;
+		ctx->planes[0].src = data;
+		ctx->planes[0].src_stride = ctx->i_stride;
+		for (i=1; i<ctx->sc_planes; i++) {
+			ctx->planes[i].src = data + ctx->i_stride * ctx->i_h + (i-1) * ctx->i_stride_uv * uv_height;
+			ctx->planes[i].src_stride = ctx->i_stride_uv;
+		}
+	} else if (frame_ifce && frame_ifce->get_plane) {
+		for (i=0; i<ctx->sc_planes; i++) {
+			GF_Err e = frame_ifce->get_plane(frame_ifce, i, &ctx->planes[i].src, &ctx->planes[i].src_stride);
+			if (e) return e;
+		}
+	} else {
+		return GF_NOT_SUPPORTED;
+	}
+
+	//setup destination planes, scaled picture is centered when aspect ratio is kept
+	for (i=0; i<ctx->sc_planes; i++) {
+		EVGSPlane *pl = &ctx->planes[i];
+		off_x = ctx->offset_w;
+		off_y = ctx->offset_h;
+		if (!i) {
+			pl->dst = output;
+			pl->dst_stride = ctx->o_stride;
+		} else {
+			u32 o_uv_h = ctx->sc_sub_h ? (ctx->o_h+1)/2 : ctx->o_h;
+			pl->dst = output + ctx->o_stride * ctx->o_h + (i-1) * ctx->sc_o_stride_uv * o_uv_h;
+			pl->dst_stride = ctx->sc_o_stride_uv;
+			if (ctx->sc_sub_w) off_x /= 2;
+			if (ctx->sc_sub_h) off_y /= 2;
+		}
+		pl->dst += off_y * pl->dst_stride + off_x * ctx->sc_bytes;
+	}
+
+	evgs_run_pass(filter, ctx, GF_FALSE);
+	evgs_run_pass(filter, ctx, GF_TRUE);
+	return GF_OK;
+}
+
 static GF_Err evgs_process(GF_Filter *filter)
 {
 	const char *data;
@@ -123,8 +592,9 @@ static GF_Err evgs_process(GF_Filter *filter)
 	GF_Err e;
 	e = gf_evg_surface_attach_to_buffer(ctx->surf, output, ctx->o_w, ctx->o_h, 0, ctx->o_stride, ctx->ofmt);
 	CHK_EXIT("Failed to create output surface");
-	//threading must be enabled once the surface is configured
-	gf_evg_enable_threading(ctx->surf, ctx->nbth);
+	//threading must be enabled once the surface is configured, the separable scaler uses session threads
+	if (!ctx->use_scaler)
+		gf_evg_enable_threading(ctx->surf, ctx->nbth);
 
 	if (ctx->offset_w || ctx->offset_h) {
 		u32 color = ctx->padclr ? gf_color_parse(ctx->padclr) : 0xFF000000;
@@ -132,6 +602,14 @@ static GF_Err evgs_process(GF_Filter *filter)
 		CHK_EXIT("Failed to clear surface");
 	}
 
+	if (ctx->use_scaler) {
+		e = evgs_scaler_process(filter, ctx, data, frame_ifce, output);
+		CHK_EXIT("Failed to rescale frame");
+		gf_filter_pck_send(dst_pck);
+		gf_filter_pid_drop_packet(ctx->ipid);
+		return GF_OK;
+	}
+
 	if (data) {
 		e = gf_evg_stencil_set_texture_planes(ctx->tx, ctx->i_w, ctx->i_h, ctx->i_pfmt, data, ctx->i_stride, NULL, NULL, ctx->i_stride_uv, NULL, 0);
 	} else if (frame_ifce && frame_ifce->get_plane) {
@@ -384,6 +862,11 @@ static GF_Err evgs_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_r
 		ctx->fullrange = fullrange;
 		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[EVGS] Setup rescaler from %dx%d fmt %s to %dx%d fmt %s\n", w, h, gf_pixel_fmt_name(ofmt), ctx->o_w, ctx->o_h, gf_pixel_fmt_name(ctx->ofmt)));
 	}
+	//output size may change without input changes, always check the scaler setup
+	if (!ctx->passthrough && (evgs_scaler_setup(ctx, ofmt) != GF_OK)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[EVGS] Failed to setup %s scaler\n", (ctx->algo==EVGS_ALGO_BICUBIC) ? "bicubic" : "Lanczos"));
+		return GF_OUT_OF_MEM;
+	}
 
 	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_WIDTH, &PROP_UINT(ctx->o_w));
 	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_HEIGHT, &PROP_UINT(ctx->o_h));
@@ -437,6 +920,8 @@ static void evgs_finalize(GF_Filter *filter)
 	gf_evg_surface_delete(ctx->surf);
 	gf_evg_stencil_delete(ctx->tx);
 	gf_path_del(ctx->path);
+	evgs_scaler_reset(ctx);
+	if (ctx->tmp) gf_free(ctx->tmp);
 	return;
 }
 
@@ -472,8 +957,13 @@ static GF_FilterArgs EVGSArgs[] =
 	, GF_PROP_UINT, "off", "off|full|nosrc", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(padclr), "clear color when aspect ration preservation is used", GF_PROP_STRING, "black", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(osar), "force output pixel aspect ratio", GF_PROP_FRACTION, "0/1", NULL, GF_FS_ARG_HINT_EXPERT},
-	{ OFFS(nbth), "number of threads to use, -1 means all cores", GF_PROP_SINT, "-1", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(nbth), "number of threads to use for the EVG rasterizer, -1 means all cores", GF_PROP_SINT, "-1", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(hq), "use bilinear interpolation instead of closest pixel", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(algo), "scaling algorithm\n"
+	"- evg: use EVG rasterizer, closest pixel or bilinear depending on [-hq]()\n"
+	"- bicubic: use separable bicubic scaler\n"
+	"- lanczos: use separable 3-lobe Lanczos scaler"
+	, GF_PROP_UINT, "evg", "evg|bicubic|lanczos", GF_FS_ARG_HINT_ADVANCED},
 
 	{0}
 };
@@ -511,6 +1001,11 @@ GF_FilterRegister EVGSRegister = {
 	"When sample aspect ratio is kept, the filter will:\n"
 	"- center the rescaled input frame on the output frame\n"
 	"- fill extra pixels with [-padclr]()\n"
+	"## Separable scaler\n"
+	"When [-algo]() is set to `bicubic` or `lanczos`, a separable scaler with precomputed coefficients is used instead of the EVG rasterizer. "
+	"Each frame is filtered horizontally then vertically, and rows are split in bands processed by the session threads (see [-threads](CORE)).\n"
+	"This scaler only handles 8 and 10 bit planar YUV and greyscale formats, without pixel format or range conversion. Other cases use the EVG rasterizer.\n"
+	"EX gpac -i src.mp4 evgs:osize=1280x720:algo=lanczos vout\n"
 	)
 	.private_size = sizeof(EVGScaleCtx),
 	.args = EVGSArgs,
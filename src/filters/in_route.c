@@ -750,6 +750,8 @@ GF_FilterRegister ROUTEInRegister = {
 	"If [-max_segs]() is set, old files will be deleted.\n"
 	"\n"
 	"# File Repair\n"
+	"When Reed-Solomon AL-FEC repair symbols (FEC Encoding ID 5, RFC 5510) are received for an object, lost source symbols are recovered before any other repair is attempted.\n"
+	"\n"
 	"In case of losses or incomplete segment reception (during tune-in), the files are patched as follows:\n"
 	"- MPEG-2 TS: all lost ranges are adjusted to 188-bytes boundaries, and transformed into NULL TS packets.\n"
 	"- ISOBMFF: all top-level boxes are scanned, and incomplete boxes are transformed in `free` boxes, except mdat kept as is if [-repair]() is set to simple.\n"
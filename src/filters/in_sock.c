@@ -78,12 +78,18 @@ typedef struct
 	Bool is_stop;
 
 	char *buffer;
+	//datagram slots for batched UDP reception, and index of next datagram to deliver
+	GF_SockDatagram *dgrams;
+	u8 *dgram_buffer;
+	u32 nb_dgrams, dgram_idx;
 
 	GF_SockGroup *active_sockets;
 	u32 last_rcv_time;
 	u32 last_timeout_sec;
 } GF_SockInCtx;
 
+#define SOCKIN_NB_DGRAMS	16
+#define SOCKIN_DGRAM_SIZE	65536
 
 
 static GF_Err sockin_initialize(GF_Filter *filter)
@@ -195,6 +201,17 @@ static GF_Err sockin_initialize(GF_Filter *filter)
 
 	ctx->buffer = gf_malloc(ctx->block_size + 1);
 	if (!ctx->buffer) return GF_OUT_OF_MEM;
+	if (ctx->is_udp) {
+		u32 i;
+		ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * SOCKIN_NB_DGRAMS);
+		ctx->dgram_buffer = gf_malloc(SOCKIN_NB_DGRAMS * SOCKIN_DGRAM_SIZE);
+		if (!ctx->dgrams || !ctx->dgram_buffer) return GF_OUT_OF_MEM;
+		for (i=0; i<SOCKIN_NB_DGRAMS; i++) {
+			ctx->dgrams[i].buffer = ctx->dgram_buffer + i*SOCKIN_DGRAM_SIZE;
+			ctx->dgrams[i].size = SOCKIN_DGRAM_SIZE;
+			ctx->dgrams[i].read = 0;
+		}
+	}
 	//ext/mime given and not mpeg2, disable probe
 	if (ctx->ext && !strstr("ts|m2t|mts|dmb|trp", ctx->ext)) ctx->tsprobe = GF_FALSE;
 	if (ctx->mime && !strstr(ctx->mime, "mpeg-2") && !strstr(ctx->mime, "mp2t")) ctx->tsprobe = GF_FALSE;
@@ -233,6 +250,8 @@ static void sockin_finalize(GF_Filter *filter)
 	}
 	sockin_client_reset(&ctx->sock_c);
 	if (ctx->buffer) gf_free(ctx->buffer);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
+	if (ctx->dgram_buffer) gf_free(ctx->dgram_buffer);
 	if (ctx->active_sockets) gf_sk_group_del(ctx->active_sockets);
 }
 
@@ -280,6 +299,29 @@ static Bool sockin_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 	return GF_FALSE;
 }
 
+//fetch next datagram, refilling the datagram slots with a single batched receive when all have been consumed
+static GF_Err sockin_receive_dgram(GF_SockInCtx *ctx, GF_SockInClient *sock_c, u8 *buffer, u32 size, u32 *read)
+{
+	GF_SockDatagram *dg;
+	*read = 0;
+	if (ctx->dgram_idx == ctx->nb_dgrams) {
+		GF_Err e;
+		ctx->dgram_idx = ctx->nb_dgrams = 0;
+		e = gf_sk_receive_batch(sock_c->socket, ctx->dgrams, SOCKIN_NB_DGRAMS, &ctx->nb_dgrams);
+		if (e) return e;
+		if (!ctx->nb_dgrams) return GF_IP_NETWORK_EMPTY;
+	}
+	dg = &ctx->dgrams[ctx->dgram_idx];
+	//not enough space left in block, keep datagram for next packet
+	if ((dg->read > size) && (size < ctx->block_size))
+		return GF_IP_NETWORK_EMPTY;
+
+	*read = MIN(dg->read, size);
+	memcpy(buffer, dg->buffer, *read);
+	ctx->dgram_idx++;
+	return GF_OK;
+}
+
 static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockInClient *sock_c)
 {
 	u32 nb_read, pos;
@@ -302,7 +344,10 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 	nb_read=0;
 	while (pos < ctx->block_size) {
 		u32 read=0;
-		e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer+pos, ctx->block_size - pos, &read);
+		if (ctx->dgrams)
+			e = sockin_receive_dgram(ctx, sock_c, ctx->buffer+pos, ctx->block_size - pos, &read);
+		else
+			e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer+pos, ctx->block_size - pos, &read);
 		if (e) {
 			if (nb_read) break;
 			switch (e) {
@@ -474,13 +519,20 @@ static GF_Err sockin_check_eos(GF_Filter *filter, GF_SockInCtx *ctx)
 
 static GF_Err sockin_process(GF_Filter *filter)
 {
-	GF_Socket *new_conn=NULL;
+	GF_Socket *new_conn=NULL, *sk;
 	GF_Err e;
 	u32 i, count;
 	GF_SockInCtx *ctx = (GF_SockInCtx *) gf_filter_get_udta(filter);
 
 	if (ctx->is_stop) return GF_EOS;
 
+	//datagrams left from previous batch, deliver them before polling again
+	if (ctx->dgram_idx < ctx->nb_dgrams) {
+		e = sockin_read_client(filter, ctx, &ctx->sock_c);
+		gf_filter_ask_rt_reschedule(filter, 1);
+		return e;
+	}
+
 	e = gf_sk_group_select(ctx->active_sockets, 1, GF_SK_SELECT_READ);
 	if (e==GF_IP_NETWORK_EMPTY) {
 		if (ctx->is_udp) {
@@ -537,6 +589,7 @@ static GF_Err sockin_process(GF_Filter *filter)
 				sc->done = GF_FALSE;
 
 				sc->socket = new_conn;
+				gf_sk_set_usr_data(new_conn, sc);
 				strcpy(sc->address, "unknown");
 				gf_sk_get_remote_address(new_conn, sc->address);
 				gf_sk_set_block_mode(new_conn, !ctx->block);
@@ -550,12 +603,12 @@ static GF_Err sockin_process(GF_Filter *filter)
 	}
 	if (!ctx->listen) return GF_OK;
 
-	count = gf_list_count(ctx->clients);
-	for (i=0; i<count; i++) {
-		GF_SockInClient *sc = gf_list_get(ctx->clients, i);
-		if (!sc->socket) continue;
-
-		if (!gf_sk_group_sock_is_set(ctx->active_sockets, sc->socket, GF_SK_SELECT_READ)) continue;
+	//only visit clients with a ready socket
+	i=0;
+	while ((sk = gf_sk_group_get_ready(ctx->active_sockets, &i, GF_SK_SELECT_READ))) {
+		GF_SockInClient *sc = gf_sk_get_usr_data(sk);
+		//listening socket
+		if (!sc) continue;
 
 	 	e = sockin_read_client(filter, ctx, sc);
 	 	if (e == GF_IP_CONNECTION_CLOSED) {
@@ -571,12 +624,11 @@ static GF_Err sockin_process(GF_Filter *filter)
 	 		}
 	 		gf_free(sc);
 	 		gf_list_del_item(ctx->clients, sc);
-	 		i--;
-	 		count--;
 		} else {
 			if (e) return e;
 		}
 	}
+	count = gf_list_count(ctx->clients);
 	if (!ctx->had_clients) {
 		//we should use socket groups and selects !
 		gf_filter_ask_rt_reschedule(filter, 100000);
@@ -55,6 +55,13 @@ enum
 	MP4DMX_XPS_REMOVE,
 };
 
+enum
+{
+	MP4DMX_SIC_NO=0,
+	MP4DMX_SIC_READ,
+	MP4DMX_SIC_AUTO,
+};
+
 typedef struct
 {
 	//options
@@ -67,7 +74,9 @@ typedef struct
 	u32 frame_size;
 	char* tkid;
 	u32 analyze;
-	Bool norw;
+	Bool norw, mmap;
+	u32 sicache;
+	char *sicdir;
 	u32 xps_check;
 	char *catseg;
 	Bool sigfrag;
@@ -131,6 +140,8 @@ typedef struct
 	u64 last_min_offset;
 	GF_Err in_error;
 	Bool force_fetch;
+	//references on file mappings used by zero-copy packets
+	GF_List *mmap_refs;
 } ISOMReader;
 
 typedef struct
@@ -212,6 +223,8 @@ typedef struct
 
 	GF_FilterPacket *pck;
 	u32 alloc_size;
+	//static sample data points to the file mapping
+	u8 sample_mmap;
 
 	u32 nb_empty_retry;
 } ISOMChannel;
@@ -30,6 +30,9 @@
 #include <gpac/crypt_tools.h>
 #include <gpac/media_tools.h>
 
+GF_Err gf_isom_enable_mmap(GF_ISOFile *the_file, void **mmap_ref);
+void gf_isom_mmap_unref(void *mmap_ref);
+
 enum
 {
 	EDITS_AUTO=0,
@@ -64,6 +67,8 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read, Bool input_is_e
 {
 	char *url;
 	char *tmp, *src;
+	char *sic_name = NULL;
+	Bool sic_used = GF_FALSE;
 	GF_Err e;
 	const GF_PropertyValue *prop;
 	if (!read) return GF_SERVICE_ERROR;
@@ -141,12 +146,22 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read, Bool input_is_e
 	}
 
 	read->missing_bytes = 0;
-	e = gf_isom_open_progressive(url, read->start_range, read->end_range, read->sigfrag, &read->mov, &read->missing_bytes);
+	e = GF_NOT_FOUND;
+	//try sample index cache first, only for complete file opens
+	if (read->sicache && !read->start_range && !read->end_range && !read->sigfrag && !read->catseg) {
+		sic_name = gf_isom_sample_index_get_name(url, read->sicdir);
+		if (sic_name) e = gf_isom_open_indexed(url, sic_name, &read->mov);
+	}
+	if (e)
+		e = gf_isom_open_progressive(url, read->start_range, read->end_range, read->sigfrag, &read->mov, &read->missing_bytes);
+	else
+		sic_used = GF_TRUE;
 
 	if (e == GF_ISOM_INCOMPLETE_FILE) {
 		if (input_is_eos) {
 			e = GF_ISOM_INVALID_FILE;
 		} else {
+			if (sic_name) gf_free(sic_name);
 			gf_free(url);
 			read->moov_not_loaded = 1;
 			return GF_OK;
@@ -165,11 +180,17 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read, Bool input_is_e
 	if (e != GF_OK) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[IsoMedia] error while opening %s, error=%s\n", url,gf_error_to_string(e)));
 		gf_filter_setup_failure(filter, e);
+		if (sic_name) gf_free(sic_name);
 		gf_free(url);
 		return e;
 	}
 	read->frag_type = gf_isom_is_fragmented(read->mov) ? 1 : 0;
 
+	//build cache for next open, ignoring failures
+	if (sic_name && !sic_used && (read->sicache==MP4DMX_SIC_AUTO) && read->input_loaded && !read->frag_type)
+		gf_isom_sample_index_build(read->mov, sic_name);
+	if (sic_name) gf_free(sic_name);
+
 	read->timescale = gf_isom_get_timescale(read->mov);
 	if (!read->input_loaded && read->frag_type)
 		read->refresh_fragmented = GF_TRUE;
@@ -177,6 +198,17 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read, Bool input_is_e
 	if (read->strtxt)
 		gf_isom_text_set_streaming_mode(read->mov, GF_TRUE);
 
+	//memory-map complete local files, mapping may outlive the file while packets are pending
+	if (read->mmap && read->input_loaded && !read->frag_type && !read->nodata && !read->start_range && !read->end_range) {
+		void *mmap_ref = NULL;
+		if (gf_isom_enable_mmap(read->mov, &mmap_ref) == GF_OK) {
+			if (!read->mmap_refs) read->mmap_refs = gf_list_new();
+			gf_list_add(read->mmap_refs, mmap_ref);
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Cannot memory-map %s, using regular file access\n", url));
+		}
+	}
+
 	gf_free(url);
 	e = isor_declare_objects(read);
 	if (e && (e!= GF_ISOM_INCOMPLETE_FILE)) {
@@ -566,6 +598,12 @@ static void isoffin_finalize(GF_Filter *filter)
 	if (!read->extern_mov && read->mov) gf_isom_close(read->mov);
 	read->mov = NULL;
 
+	while (gf_list_count(read->mmap_refs)) {
+		void *mmap_ref = gf_list_pop_back(read->mmap_refs);
+		gf_isom_mmap_unref(mmap_ref);
+	}
+	gf_list_del(read->mmap_refs);
+
 	if (read->mem_blob.data) gf_free(read->mem_blob.data);
 	if (read->mem_url) {
 		gf_blob_unregister(&read->mem_blob);
@@ -1821,6 +1859,12 @@ static const GF_FilterArgs ISOFFInArgs[] =
 	"- set to `-1` to use the `cslg` box info or the minimum cts offset present in the track\n"
 	"- set to `-2` to use the minimum cts offset present in the track (`cslg` ignored)", GF_PROP_SINT, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(norw), "skip reformating of samples - should only be used when rewriting fragments", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mmap), "memory-map complete local files and dispatch sample payloads without copy when not modified by the reader", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(sicache), "use sample index cache files for complete local files (see filter help)\n"
+	"- no: disable cache\n"
+	"- read: use cache if present and valid\n"
+	"- auto: use cache if present and valid, create it otherwise", GF_PROP_UINT, "no", "no|read|auto", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(sicdir), "directory for sample index cache files, if not set cache is stored next to the source file", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -1870,6 +1914,12 @@ GF_FilterRegister ISOFFInRegister = {
 		"- smode=splitx: extractors are kept in the bitstream, and every track of the scalable set is declared. In this mode, each enhancement track has a base decoder config\n"
 		" (copied from base) and an enhancement decoder config. This is mostly used for DASHing content.\n"
 		"Warning: smode=splitx will result in extractor NAL units still present in the output bitstream, which shall only be true if the output is ISOBMFF based\n"
+		"# Sample Index Cache\n"
+		"Opening large files requires loading all sample sizes and chunk offsets of the movie box, which can be slow for long files.\n"
+		"The [-sicache]() option allows using a sample index cache file, storing precomputed sample tables. The cache is memory-mapped when possible, and sample sizes and chunk offsets are not loaded from the movie box.\n"
+		"The cache is identified by the source file size, modification time and movie box position, and ignored if any of these changed. Cache files can also be created and fully checked using MP4Box `-sic-build` and `-sic-check`.\n"
+		"EX gpac -i long.mp4:sicache=auto inspect\n"
+		"This will create `long.mp4.gsix` on first run and use it for subsequent runs.\n"
 	 	)
 	.private_size = sizeof(ISOMReader),
 	.flags = GF_FS_REG_USE_SYNC_READ,
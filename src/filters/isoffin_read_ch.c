@@ -32,6 +32,7 @@
 #include <gpac/avparse.h>
 
 GF_Err gf_isom_set_sample_alloc(GF_ISOFile *the_file, u32 trackNumber, 	u8 *(*sample_realloc)(u32 size, void *cbk), void *udta);
+GF_Err gf_isom_set_sample_mmap(GF_ISOFile *the_file, u32 trackNumber, u8 *(*sample_mmap)(u8 *data, u32 size, void *cbk), void *udta);
 
 void isor_reset_reader(ISOMChannel *ch)
 {
@@ -39,6 +40,12 @@ void isor_reset_reader(ISOMChannel *ch)
 	isor_reader_release_sample(ch);
 
 	if (ch->static_sample) {
+		//mapped data is not owned by the sample
+		if (ch->sample_mmap) {
+			ch->static_sample->data = NULL;
+			ch->static_sample->alloc_size = 0;
+			ch->sample_mmap = 0;
+		}
 		ch->static_sample->dataLength = ch->static_sample->alloc_size;
 		gf_isom_sample_del(&ch->static_sample);
 	}
@@ -310,6 +317,12 @@ u8 *isor_sample_alloc(u32 size, void *udta)
 {
 	u8 *output;
 	ISOMChannel *ch = (ISOMChannel *)udta;
+	//pending packet is referencing the file mapping, cannot be reused
+	if (ch->pck && ch->sample_mmap) {
+		gf_filter_pck_discard(ch->pck);
+		ch->pck = NULL;
+	}
+	ch->sample_mmap = 0;
 	if (ch->pck) {
 		if (size<ch->alloc_size) {
 			u32 size;
@@ -324,6 +337,35 @@ u8 *isor_sample_alloc(u32 size, void *udta)
 	return output;
 }
 
+u8 *isor_sample_mmap(u8 *data, u32 size, void *udta)
+{
+	ISOMChannel *ch = (ISOMChannel *)udta;
+	//parameter sets may be stripped from payload, we need a writable copy
+	if (ch->check_avc_ps || ch->check_hevc_ps || ch->check_vvc_ps)
+		return NULL;
+
+	if (ch->pck) {
+		gf_filter_pck_discard(ch->pck);
+		ch->pck = NULL;
+	}
+	//shared packets are released before the filter is destroyed, mapping refs are only dropped at finalize
+	ch->pck = gf_filter_pck_new_shared(ch->pid, data, size, NULL);
+	if (!ch->pck) return NULL;
+	//mapping is read-only, in-place clones must copy
+	gf_filter_pck_set_readonly(ch->pck);
+	ch->alloc_size = 0;
+	ch->sample_mmap = 1;
+	return data;
+}
+
+static void isor_set_sample_cbk(ISOMChannel *ch)
+{
+	if (ch->owner->nodata) return;
+	gf_isom_set_sample_alloc(ch->owner->mov, ch->track, isor_sample_alloc, ch);
+	if (ch->owner->mmap_refs)
+		gf_isom_set_sample_mmap(ch->owner->mov, ch->track, isor_sample_mmap, ch);
+}
+
 void isor_reader_get_sample(ISOMChannel *ch)
 {
 	GF_Err e;
@@ -333,14 +375,12 @@ void isor_reader_get_sample(ISOMChannel *ch)
 
 	if (ch->next_track) {
 		ch->track = ch->next_track;
-		if (!ch->owner->nodata)
-			gf_isom_set_sample_alloc(ch->owner->mov, ch->track, isor_sample_alloc, ch);
+		isor_set_sample_cbk(ch);
 		ch->next_track = 0;
 	}
 
 	if (ch->to_init) {
-		if (!ch->owner->nodata)
-			gf_isom_set_sample_alloc(ch->owner->mov, ch->track, isor_sample_alloc, ch);
+		isor_set_sample_cbk(ch);
 		init_reader(ch);
 		sample_desc_index = ch->last_sample_desc_index;
 	} else if (ch->speed < 0) {
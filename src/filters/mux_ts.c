@@ -116,7 +116,10 @@ typedef struct
 
 	Bool check_pcr;
 	Bool update_mux;
-	char *pack_buffer;
+	//output packet being filled by the muxer, kept across process calls
+	GF_FilterPacket *out_pck;
+	u8 *out_data;
+	u32 out_nb_pack;
 	u64 nb_pck;
 	Bool init_buffering;
 	u32 last_log_time;
@@ -1200,7 +1203,6 @@ static GF_Err tsmux_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_
 			//use large pack buffer for dash unless not default value
 			if (ctx->nb_pack==4) {
 				ctx->nb_pack = 200;
-				ctx->pack_buffer = gf_realloc(ctx->pack_buffer, sizeof(u8)*188*ctx->nb_pack);
 			}
 			//in dash, force singel PES per AU, some demuxers have issues with PES packets with no ADTS headers (middle of a frame)
 			gf_m2ts_mux_use_single_au_pes_mode(ctx->mux, GF_M2TS_PACK_NONE);
@@ -1807,45 +1809,47 @@ static GF_Err tsmux_process(GF_Filter *filter)
 
 	nb_pck_in_call = 0;
 	nb_pck_in_pack=0;
+	//wake up consumers once for all TS packets produced in this call
+	gf_filter_batch_dispatch(filter, GF_TRUE);
 	while (1) {
 		u64 pck_ts;
-		u8 *output;
 		u32 osize;
 		Bool is_pack_flush = GF_FALSE;
-		const char *ts_pck;
+		const u8 *ts_pck;
 
-		ts_pck = gf_m2ts_mux_process(ctx->mux, &status, &usec_till_next);
+		//TS packets are written by the muxer directly in the output packet
+		if (!ctx->out_pck) {
+			ctx->out_nb_pack = ctx->nb_pack ? ctx->nb_pack : 1;
+			if (ctx->force_seg_sync) {
+				ctx->out_pck = gf_filter_pck_new_alloc_destructor(ctx->opid, 188 * ctx->out_nb_pack, &ctx->out_data, ts_mux_on_packet_del);
+			} else {
+				ctx->out_pck = gf_filter_pck_new_alloc(ctx->opid, 188 * ctx->out_nb_pack, &ctx->out_data);
+			}
+			if (!ctx->out_pck) {
+				gf_filter_batch_dispatch(filter, GF_FALSE);
+				return GF_OUT_OF_MEM;
+			}
+		}
+
+		ts_pck = gf_m2ts_mux_process_ex(ctx->mux, &status, &usec_till_next, ctx->out_data + 188 * nb_pck_in_pack);
 		if (ts_pck == NULL) {
 			if (!nb_pck_in_pack)
 				break;
-			ts_pck = (const char *) ctx->pack_buffer;
 			is_pack_flush = GF_TRUE;
 		} else {
-
 			tsmux_insert_sidx(ctx, GF_FALSE);
-
-			if (ctx->nb_pack>1) {
-				memcpy(ctx->pack_buffer + 188 * nb_pck_in_pack, ts_pck, 188);
-				nb_pck_in_pack++;
-
-				if (nb_pck_in_pack < ctx->nb_pack)
-					continue;
-
-				ts_pck = (const char *) ctx->pack_buffer;
-			} else {
-				nb_pck_in_pack = 1;
-			}
+			nb_pck_in_pack++;
+			if (nb_pck_in_pack < ctx->out_nb_pack)
+				continue;
 		}
 		osize = nb_pck_in_pack * 188;
-		if (ctx->force_seg_sync) {
-			pck = gf_filter_pck_new_alloc_destructor(ctx->opid, osize, &output, ts_mux_on_packet_del);
-			if (pck) ctx->pending_packets++;
-		} else {
-			pck = gf_filter_pck_new_alloc(ctx->opid, osize, &output);
-		}
-		if (!pck) return GF_OUT_OF_MEM;
-		
-		memcpy(output, ts_pck, osize);
+		pck = ctx->out_pck;
+		ctx->out_pck = NULL;
+		if (nb_pck_in_pack < ctx->out_nb_pack)
+			gf_filter_pck_truncate(pck, osize);
+		if (ctx->force_seg_sync)
+			ctx->pending_packets++;
+
 		gf_filter_pck_set_framing(pck, ctx->nb_pck ? ctx->next_is_start : GF_TRUE, (status==GF_M2TS_STATE_EOS) ? GF_TRUE : GF_FALSE);
 
 		if (ctx->next_is_start && ctx->dash_mode) {
@@ -1904,6 +1908,7 @@ static GF_Err tsmux_process(GF_Filter *filter)
 		if (nb_pck_in_call>100)
 			break;
 	}
+	gf_filter_batch_dispatch(filter, GF_FALSE);
 
 	if (ctx->wait_dash_flush || ctx->wait_llhls_flush) {
 		u32 i, done=0, count = gf_list_count(ctx->pids);
@@ -2017,7 +2022,6 @@ static GF_Err tsmux_initialize(GF_Filter *filter)
 		ctx->init_buffering = GF_TRUE;
 	}
 	ctx->pids = gf_list_new();
-	if (ctx->nb_pack>1) ctx->pack_buffer = gf_malloc(sizeof(u8)*188*ctx->nb_pack);
 
 #ifdef GPAC_ENABLE_COVERAGE
 	if (gf_sys_is_cov_mode()) {
@@ -2047,7 +2051,11 @@ static void tsmux_finalize(GF_Filter *filter)
 	}
 	gf_list_del(ctx->pids);
 	gf_m2ts_mux_del(ctx->mux);
-	if (ctx->pack_buffer) gf_free(ctx->pack_buffer);
+	if (ctx->out_pck) {
+		//not sent, don't account it in seg sync
+		ctx->force_seg_sync = GF_FALSE;
+		gf_filter_pck_discard(ctx->out_pck);
+	}
 	if (ctx->sidx_entries) gf_free(ctx->sidx_entries);
 	if (ctx->idx_bs) gf_bs_del(ctx->idx_bs);
 	if (ctx->cur_file_suffix) gf_free(ctx->cur_file_suffix);
@@ -51,6 +51,8 @@ void gf_dm_sess_set_timeout(GF_DownloadSession *sess, u32 timeout);
 
 GF_Socket *gf_dm_sess_get_socket(GF_DownloadSession *);
 GF_Err gf_dm_sess_send(GF_DownloadSession *sess, u8 *data, u32 size);
+GF_Err gf_dm_sess_sendv(GF_DownloadSession *sess, const u8 **buffers, const u32 *sizes, u32 nb_buffers);
+GF_Err gf_dm_sess_send_file(GF_DownloadSession *sess, s32 fd, u64 offset, u32 size, const u8 *hdr, u32 hdr_size, const u8 *trailer, u32 trailer_size, u32 *sent, u32 *sent_zc);
 void gf_dm_sess_clear_headers(GF_DownloadSession *sess);
 void  gf_dm_sess_set_header(GF_DownloadSession *sess, const char *name, const char *value);
 void  gf_dm_sess_set_header_ex(GF_DownloadSession *sess, const char *name, const char *value, Bool allow_overwrite);
@@ -107,7 +109,7 @@ typedef struct
 	char *js;
 #endif
 	GF_PropStringList rdirs;
-	Bool close, hold, quit, post, dlist, ice, reopen, blockio;
+	Bool close, hold, quit, post, dlist, ice, reopen, blockio, zcopy;
 	u32 port, block_size, maxc, maxp, timeout, hmode, sutc, cors, max_client_errors, max_async_buf, ka, zmax;
 	s32 max_cache_segs;
 	GF_PropStringList hdrs;
@@ -235,6 +237,10 @@ struct __httpout_session {
 	FILE *resource;
 	char *path, *mime;
 	u64 file_size, file_pos, nb_bytes, bytes_in_req;
+	//bytes sent without copy to user memory
+	u64 nb_bytes_zc;
+	//file position no longer matches file_pos after zero-copy send
+	Bool resource_seek;
 	u8 *buffer;
 	Bool done;
 	u32 flush_close;
@@ -1495,6 +1501,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 		}
 		sess->file_in_progress = GF_FALSE;
 		sess->nb_bytes = 0;
+		sess->nb_bytes_zc = 0;
 		sess->done = GF_FALSE;
 		gf_assert(full_path);
 		if (sess->path) gf_free(sess->path);
@@ -1760,6 +1767,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	sess->use_chunk_transfer = GF_FALSE;
 	sess->put_in_progress = 0;
 	sess->nb_bytes = 0;
+	sess->nb_bytes_zc = 0;
 	sess->upload_type = 0;
 
 	if (parameter->reply==GF_HTTP_DELETE) {
@@ -3252,7 +3260,11 @@ static void log_request_done(GF_HTTPOutSession *sess)
 			unit = "kbps";
 			bps/=1000;
 		}
-		GF_LOG(GF_LOG_INFO, GF_LOG_ALL, ("[HTTPOut] %sREQ#"LLU" %s done: reply %d - "LLU" bytes in %d ms at %g %s\n", sprefix, sess->req_id, get_method_name(sess->method_type), sess->reply_code, sess->nb_bytes, (u32) (diff_us/1000), bps, unit));
+		if (sess->nb_bytes_zc) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_ALL, ("[HTTPOut] %sREQ#"LLU" %s done: reply %d - "LLU" bytes ("LLU" zero-copy) in %d ms at %g %s\n", sprefix, sess->req_id, get_method_name(sess->method_type), sess->reply_code, sess->nb_bytes, sess->nb_bytes_zc, (u32) (diff_us/1000), bps, unit));
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_ALL, ("[HTTPOut] %sREQ#"LLU" %s done: reply %d - "LLU" bytes in %d ms at %g %s\n", sprefix, sess->req_id, get_method_name(sess->method_type), sess->reply_code, sess->nb_bytes, (u32) (diff_us/1000), bps, unit));
+		}
 	}
 }
 
@@ -3590,6 +3602,43 @@ resend:
 		//rescedule asap while we send
 		ctx->next_wake_us = 1;
 
+		//zero-copy for regular files not being produced, sent as a whole or by ranges
+		if (ctx->zcopy && sess->resource && !sess->comp_data && !sess->is_h2
+			&& !file_in_progress && !sess->put_in_progress && !gf_fileio_check(sess->resource)
+		) {
+			u32 sent=0, sent_zc=0;
+			u32 hdr_len=0;
+			char szHdr[100];
+			//keep block size: large sends on small socket buffers stall on delayed ACKs
+			if (to_read > (u64) sess->ctx->block_size)
+				to_read = (u64) sess->ctx->block_size;
+			if (sess->use_chunk_transfer) {
+				sprintf(szHdr, "%X\r\n", (u32) to_read);
+				hdr_len = (u32) strlen(szHdr);
+			}
+			e = gf_dm_sess_send_file(sess->http_sess, fileno(sess->resource), sess->file_pos, (u32) to_read, (u8 *) szHdr, hdr_len, hdr_len ? (u8 *) "\r\n" : NULL, hdr_len ? 2 : 0, &sent, &sent_zc);
+			if (e != GF_NOT_SUPPORTED) {
+				sess->resource_seek = GF_TRUE;
+				sess->nb_bytes_zc += sent_zc;
+				//socket full, wait for next select
+				if (e==GF_IP_NETWORK_EMPTY) {
+					sess->last_active_time = gf_sys_clock_high_res();
+					return;
+				}
+				//end of file reached while bytes are still expected, file was truncated
+				if (!e && !sent) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTPOut] File %s truncated at "LLU" bytes while sending to %s, closing connection\n", sess->path, sess->file_pos, sess->peer_address));
+					sess->done = GF_TRUE;
+					sess->canceled = GF_FALSE;
+					httpout_close_session(sess, GF_IO_ERR);
+					log_request_done(sess);
+					return;
+				}
+				read = sent;
+				goto data_sent;
+			}
+		}
+
 		if (to_read > (u64) sess->ctx->block_size)
 			to_read = (u64) sess->ctx->block_size;
 
@@ -3598,6 +3647,10 @@ resend:
 			read = (u32) to_read;
 		}
 		else if (sess->resource) {
+			if (sess->resource_seek) {
+				gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
+				sess->resource_seek = GF_FALSE;
+			}
 			read = (u32) gf_fread(sess->buffer, (u32) to_read, sess->resource);
 			//may happen when file writing is in progress
 			if (!read) {
@@ -3610,16 +3663,22 @@ resend:
 		//transfer of file being uploaded, use chunk transfer
 		if (!sess->is_h2 && sess->use_chunk_transfer) {
 			char szHdr[100];
-			u32 len;
+			const u8 *bufs[3];
+			u32 sizes[3];
 			sprintf(szHdr, "%X\r\n", read);
-			len = (u32) strlen(szHdr);
-
-			e = gf_dm_sess_send(sess->http_sess, szHdr, len);
-			e |= gf_dm_sess_send(sess->http_sess, sess->buffer, read);
-			e |= gf_dm_sess_send(sess->http_sess, "\r\n", 2);
+			//send chunk framing and data in one call
+			bufs[0] = (u8 *) szHdr;
+			sizes[0] = (u32) strlen(szHdr);
+			bufs[1] = sess->buffer;
+			sizes[1] = read;
+			bufs[2] = (u8 *) "\r\n";
+			sizes[2] = 2;
+			e = gf_dm_sess_sendv(sess->http_sess, bufs, sizes, 3);
 		} else {
 			e = gf_dm_sess_send(sess->http_sess, sess->buffer, read);
 		}
+
+data_sent:
 		sess->last_active_time = gf_sys_clock_high_res();
 
 		sess->file_pos += read;
@@ -3679,7 +3738,7 @@ session_done:
 		sess->comp_data = NULL;
 
 		if (sess->nb_bytes) {
-			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Done sending %s to %s ("LLU"/"LLU" bytes)\n", sess->path, sess->peer_address, sess->nb_bytes, sess->bytes_in_req));
+			GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTPOut] Done sending %s to %s ("LLU"/"LLU" bytes, "LLU" zero-copy)\n", sess->path, sess->peer_address, sess->nb_bytes, sess->bytes_in_req, sess->nb_bytes_zc));
 		}
 
 		//keep resource active
@@ -5016,6 +5075,7 @@ static const GF_FilterArgs HTTPOutArgs[] =
 	{ OFFS(reopen), "in server mode with no read dir, accept requests on files already over but with input pid not in end of stream", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(max_async_buf), "maximum async buffer size in bytes when sharing output over multiple connection without file IO", GF_PROP_UINT, "100000", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(blockio), "use blocking IO in push or source mode or in server mode with no read dir", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(zcopy), "send files without user-space copy (sendfile) for clear-text HTTP/1.1 when possible", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ka), "keep input alive if failure in push mode", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(hdrs), "additional HTTP headers to inject, even values are names, odd values are values ", GF_PROP_STRING_LIST, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 #ifdef GPAC_HAS_QJS
@@ -52,7 +52,7 @@ typedef struct
 	char *dst, *ext, *mime, *ifce, *ip;
 	u32 carousel, first_port, bsid, mtu, splitlct, ttl, brinc, runfor;
 	Bool korean, llmode, noreg, nozip, furl;
-	u32 csum;
+	u32 csum, fec, fecsbl;
 
 	//caps, overloaded at init
 	GF_FilterCapability in_caps[2];
@@ -68,6 +68,9 @@ typedef struct
 	//preallocated buffer for LCT packet formating
 	u8 *lct_buffer;
 	GF_BitStream *lct_bs;
+	//scratch buffer for FEC repair symbols
+	u8 *fec_buf;
+	u32 fec_buf_size;
 
 	u64 reschedule_us;
 	//TOI for raw files
@@ -214,6 +217,9 @@ typedef struct
 	const u8 *pck_data;
 	u32 pck_size, pck_offset;
 	char *seg_name;
+	//segment data reassembled for FEC when sent in several packets
+	u8 *fec_data;
+	u32 fec_data_alloc;
 
 	//cumulated segment size in RAW dash (for event signaling)
 	u64 res_size;
@@ -370,6 +376,7 @@ void routeout_remove_pid(ROUTEPid *rpid, Bool is_rem)
 	if (rpid->hld_child_pl_name) gf_free(rpid->hld_child_pl_name);
 	if (rpid->template) gf_free(rpid->template);
 	if (rpid->seg_name) gf_free(rpid->seg_name);
+	if (rpid->fec_data) gf_free(rpid->fec_data);
 
 	if (rpid->current_pck)
 		gf_filter_pck_unref(rpid->current_pck);
@@ -773,6 +780,15 @@ static GF_Err routeout_initialize(GF_Filter *filter)
 	ctx->lct_bs = gf_bs_new(ctx->lct_buffer, ctx->mtu, GF_BITSTREAM_WRITE);
 	ctx->flute_msize = ctx->mtu - 11*4; //max size of headers and extensins
 
+	if (ctx->fec) {
+		if (ctx->dvb_mabr && ctx->llmode) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[%s] FEC not supported for DVB-MABR in low latency mode, disabling\n", ctx->log_name));
+			ctx->fec = 0;
+		}
+		if (!ctx->fecsbl) ctx->fecsbl = 1;
+		else if (ctx->fecsbl>254) ctx->fecsbl = 254;
+	}
+
 	if (!ctx->carousel) ctx->carousel = 1000;
 	//move to microseconds
 	ctx->carousel *= 1000;
@@ -799,6 +815,7 @@ static void routeout_finalize(GF_Filter *filter)
 		gf_sk_del(ctx->sock_dvb_mabr);
 
 	if (ctx->lct_buffer) gf_free(ctx->lct_buffer);
+	if (ctx->fec_buf) gf_free(ctx->fec_buf);
 	if (ctx->lls_slt_table) gf_free(ctx->lls_slt_table);
 	if (ctx->lls_time_table) gf_free(ctx->lls_time_table);
 	if (ctx->dvb_mabr_config) gf_free(ctx->dvb_mabr_config);
@@ -1432,7 +1449,13 @@ static GF_Err routeout_update_stsid_bundle(GF_ROUTEOutCtx *ctx, ROUTEService *se
 static void inject_fdt_file_desc(GF_ROUTEOutCtx *ctx, char **payload, ROUTEService *serv, char *url, char *mime, const u8 *data, u32 size, u32 TOI, Bool use_full_url)
 {
 	char tmp[100];
-	gf_dynstrcat(payload, "<File FEC-OTI-FEC-Encoding-ID=\"0\" FEC-OTI-Maximum-Source-Block-Length=\"65535\" Content-Length=\"", NULL);
+	if (ctx->fec) {
+		sprintf(tmp, "<File FEC-OTI-FEC-Encoding-ID=\"%u\" FEC-OTI-Maximum-Source-Block-Length=\"%u", GF_FEC_ENCODING_RS, ctx->fecsbl);
+		gf_dynstrcat(payload, tmp, NULL);
+		gf_dynstrcat(payload, "\" Content-Length=\"", NULL);
+	} else {
+		gf_dynstrcat(payload, "<File FEC-OTI-FEC-Encoding-ID=\"0\" FEC-OTI-Maximum-Source-Block-Length=\"65535\" Content-Length=\"", NULL);
+	}
 	sprintf(tmp, "%u", size);
 	gf_dynstrcat(payload, tmp, NULL);
 	gf_dynstrcat(payload, "\" Transfer-Length=\"", NULL);
@@ -1533,7 +1556,8 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	Bool is_flute = ctx->dvb_mabr;
 
 	if (is_flute) {
-		codepoint = 0;
+		//Reed-Solomon FEC payload ID needs the object size to locate source blocks
+		codepoint = (ctx->fec && toi && total_size) ? GF_FEC_ENCODING_RS : 0;
 		hdr_len = 2;
 		if ((tsi<0xFFFF) && (toi<0xFFFF)) {
 			hdr_len+=1;
@@ -1620,8 +1644,18 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 			gf_bs_write_u32(ctx->lct_bs, ctx->mtu);
 			hpos+=16; //4 32bit words
 		}
-		PUT_U16(0)
-		PUT_U16(ESI)
+		if (codepoint==GF_FEC_ENCODING_RS) {
+			u32 sbn=0, block_offset=0, block_k=0;
+			while (sbn < gf_route_fec_source_block(total_size, ctx->flute_msize, ctx->fecsbl, sbn, &block_offset, &block_k)) {
+				if (ESI < block_offset/ctx->flute_msize + block_k) break;
+				sbn++;
+			}
+			ESI -= block_offset/ctx->flute_msize;
+			PUT_U32( ((sbn<<8) | ESI) )
+		} else {
+			PUT_U16(0)
+			PUT_U16(ESI)
+		}
 	} else {
 
 		//total length
@@ -1660,12 +1694,132 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	return send_payl_size;
 }
 
+static void routeout_lct_send_repair(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u32 total_size, u32 sbn, u32 esi, u32 max_n, u8 *symbol, ROUTEService *serv)
+{
+	GF_Err e;
+	u32 hpos;
+	u32 E = ctx->flute_msize;
+
+	gf_bs_reassign_buffer(ctx->lct_bs, ctx->lct_buffer, ctx->mtu);
+	//V=b0001, C=b00, PSI=b00 for repair packets
+	gf_bs_write_u8(ctx->lct_bs, 0x10);
+	//S=b1, O=b01, h=b0, res=b00, A=b0, B=b0
+	gf_bs_write_u8(ctx->lct_bs, 0xA0);
+	//4 words of header and 3 words of FTI
+	gf_bs_write_u8(ctx->lct_bs, 7);
+	gf_bs_write_u8(ctx->lct_bs, GF_FEC_ENCODING_RS);
+	//CCI=0
+	gf_bs_write_u32(ctx->lct_bs, 0);
+	gf_bs_write_u32(ctx->lct_bs, tsi);
+	gf_bs_write_u32(ctx->lct_bs, toi);
+	//FTI for Reed-Solomon
+	gf_bs_write_u8(ctx->lct_bs, GF_LCT_EXT_FTI);
+	gf_bs_write_u8(ctx->lct_bs, 3);
+	gf_bs_write_long_int(ctx->lct_bs, total_size, 48);
+	gf_bs_write_u16(ctx->lct_bs, E);
+	gf_bs_write_u8(ctx->lct_bs, ctx->fecsbl);
+	gf_bs_write_u8(ctx->lct_bs, max_n);
+	//FEC payload ID
+	gf_bs_write_int(ctx->lct_bs, sbn, 24);
+	gf_bs_write_u8(ctx->lct_bs, esi);
+	hpos = (u32) gf_bs_get_position(ctx->lct_bs);
+
+	gf_assert(hpos + E <= ctx->mtu);
+	memcpy(ctx->lct_buffer + hpos, symbol, E);
+	e = gf_sk_send(sock, ctx->lct_buffer, hpos + E);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Failed to send LCT repair symbol TSI %u TOI %u: %s\n", serv ? serv->log_name : ctx->log_name, tsi, toi, gf_error_to_string(e) ));
+	}
+	ctx->bytes_sent += hpos + E;
+}
+
+//send Reed-Solomon repair symbols for a complete object
+static void routeout_send_repair(GF_ROUTEOutCtx *ctx, ROUTEService *serv, GF_Socket *sock, u32 tsi, u32 toi, const u8 *payload, u32 size)
+{
+	u32 sbn, nb_blocks, max_n=0;
+	u32 E = ctx->flute_msize;
+
+	nb_blocks = gf_route_fec_source_block(size, E, ctx->fecsbl, 0, NULL, NULL);
+	for (sbn=0; sbn<nb_blocks; sbn++) {
+		u32 j, k, block_offset, nb_rep;
+		u8 *src[255], *rep[255];
+
+		gf_route_fec_source_block(size, E, ctx->fecsbl, sbn, &block_offset, &k);
+		nb_rep = (k * ctx->fec + 99) / 100;
+		if (k + nb_rep > 255) nb_rep = 255 - k;
+		if (!nb_rep) continue;
+		//first block is the largest
+		if (!max_n) max_n = k + nb_rep;
+
+		//repair symbols, followed by last source symbol zero-padded to symbol size
+		if (ctx->fec_buf_size < (nb_rep+1) * E) {
+			ctx->fec_buf_size = (nb_rep+1) * E;
+			ctx->fec_buf = gf_realloc(ctx->fec_buf, ctx->fec_buf_size);
+			if (!ctx->fec_buf) {
+				ctx->fec_buf_size = 0;
+				return;
+			}
+		}
+		for (j=0; j<k; j++) {
+			u32 start = block_offset + j*E;
+			if (start + E > size) {
+				src[j] = ctx->fec_buf + nb_rep*E;
+				memcpy(src[j], payload + start, size - start);
+				memset(src[j] + size - start, 0, E - (size - start));
+			} else {
+				src[j] = (u8 *) payload + start;
+			}
+		}
+		for (j=0; j<nb_rep; j++)
+			rep[j] = ctx->fec_buf + j*E;
+
+		if (gf_route_fec_rs_encode(src, k, E, rep, nb_rep) != GF_OK) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Failed to compute repair symbols for TSI %u TOI %u\n", serv ? serv->log_name : ctx->log_name, tsi, toi));
+			return;
+		}
+		for (j=0; j<nb_rep; j++)
+			routeout_lct_send_repair(ctx, sock, tsi, toi, size, sbn, k+j, max_n, rep[j], serv);
+	}
+}
+
+//send repair symbols once a segment or file is completely sent
+static void routeout_pid_send_repair(GF_ROUTEOutCtx *ctx, ROUTEService *serv, ROUTEPid *rpid)
+{
+	const u8 *data = rpid->pck_data;
+	u32 size = rpid->pck_size;
+
+	if (!ctx->dvb_mabr && (rpid->frag_idx || !rpid->full_frame_size)) {
+		//segment sent in several packets, reassemble it
+		if (rpid->frag_offset + rpid->pck_size > rpid->fec_data_alloc) {
+			rpid->fec_data_alloc = rpid->frag_offset + rpid->pck_size;
+			rpid->fec_data = gf_realloc(rpid->fec_data, rpid->fec_data_alloc);
+			if (!rpid->fec_data) {
+				rpid->fec_data_alloc = 0;
+				return;
+			}
+		}
+		memcpy(rpid->fec_data + rpid->frag_offset, rpid->pck_data, rpid->pck_size);
+		if (!rpid->full_frame_size) return;
+		data = rpid->fec_data;
+		size = rpid->full_frame_size;
+	}
+	//one object per packet in FLUTE, only protect complete segments
+	else if (rpid->full_frame_size != rpid->pck_size) {
+		return;
+	}
+	if (size)
+		routeout_send_repair(ctx, serv, rpid->rlct->sock, rpid->tsi, rpid->current_toi, data, size);
+}
+
 static void routeout_send_file(GF_ROUTEOutCtx *ctx, ROUTEService *serv, GF_Socket *sock, u32 tsi, u32 toi, u8 *payload, u32 size, u32 codepoint)
 {
 	u32 offset=0;
 	while (offset<size) {
 		offset += routeout_lct_send(ctx, sock, tsi, toi, codepoint, payload, size, offset, serv, size, offset);
 	}
+	//no FEC on FDT
+	if (ctx->fec && size && (toi || !ctx->dvb_mabr))
+		routeout_send_repair(ctx, serv, sock, tsi, toi, payload, size);
 }
 
 static GF_Err routeout_service_send_stsid_bundle(GF_ROUTEOutCtx *ctx, ROUTEService *serv)
@@ -2228,6 +2382,9 @@ next_packet:
 		assert (rpid->pck_offset <= rpid->pck_size);
 
 		if (rpid->pck_offset == rpid->pck_size) {
+			if (ctx->fec)
+				routeout_pid_send_repair(ctx, serv, rpid);
+
 			//print fragment push info except if single fragment
 			if (rpid->frag_idx || !rpid->full_frame_size) {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] pushed fragment %s#%d (%d bytes) in "LLU" us - target push "LLU" us\n", rpid->route->log_name, rpid->seg_name, rpid->frag_idx+1, rpid->pck_size, ctx->clock - rpid->clock_at_pck, rpid->current_dur_us));
@@ -2849,6 +3006,8 @@ static const GF_FilterArgs ROUTEOutArgs[] =
 	{ OFFS(runfor), "run for the given time in ms", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(nozip), "do not zip signaling package (STSID+manifest)", GF_PROP_BOOL, "false", NULL, 0},
 	{ OFFS(furl), "inject full URLs of source service in the signaling instead of stripped server path", GF_PROP_BOOL, "false", NULL, 0},
+	{ OFFS(fec), "AL-FEC repair overhead in percent of source symbols, using Reed-Solomon (RFC 5510) - 0 disables FEC", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(fecsbl), "maximum number of source symbols per FEC source block", GF_PROP_UINT, "64", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(csum), "send MD5 checksum for DVB flute\n"
 		"- no: do not send checksum\n"
 		"- meta: only send checksum for configuration files, manifests and init segments\n"
@@ -2930,6 +3089,12 @@ GF_FilterRegister ROUTEOutRegister = {
 		"\n"
 		"The FLUTE session always uses a symbol length of [-mtu]() minus 44 bytes.\n"
 		"\n"
+		"# Forward error correction\n"
+		"When [-fec]() is set, each object is protected using Reed-Solomon codes over GF(2^8) (FEC Encoding ID 5, RFC 5510) with a symbol length of [-mtu]() minus 44 bytes.\n"
+		"Objects are split in source blocks of at most [-fecsbl]() symbols, and repair symbols are sent once the object is completely sent.\n"
+		"In ROUTE mode, source packets are unchanged and repair packets are sent on the same TSI and TOI with PSI set to 0.\n"
+		"In DVB-MABR mode, FEC is signaled in the FDT and source packets use the Reed-Solomon FEC payload ID. FEC is not supported in low latency mode.\n"
+		"\n"
 		"# Low latency mode\n"
 		"When using low-latency mode, the input media segments are not re-assembled in a single packet but are instead sent as they are received.\n"
 		"In order for the real-time scheduling of data chunks to work, each fragment of the segment should have a CTS and timestamp describing its timing.\n"
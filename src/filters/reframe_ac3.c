@@ -337,7 +337,7 @@ static GFINLINE void ac3dmx_update_cts(GF_AC3DmxCtx *ctx)
 	}
 }
 
-GF_Err ac3dmx_process(GF_Filter *filter)
+static GF_Err ac3dmx_process_frames(GF_Filter *filter)
 {
 	GF_AC3DmxCtx *ctx = gf_filter_get_udta(filter);
 	GF_FilterPacket *pck, *dst_pck;
@@ -551,6 +551,16 @@ restart:
 	return GF_OK;
 }
 
+GF_Err ac3dmx_process(GF_Filter *filter)
+{
+	GF_Err e;
+	//batch dispatch of parsed frames
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	e = ac3dmx_process_frames(filter);
+	gf_filter_batch_dispatch(filter, GF_FALSE);
+	return e;
+}
+
 static void ac3dmx_finalize(GF_Filter *filter)
 {
 	GF_AC3DmxCtx *ctx = gf_filter_get_udta(filter);
@@ -554,7 +554,7 @@ static GFINLINE void adts_dmx_update_cts(GF_ADTSDmxCtx *ctx)
 	}
 }
 
-GF_Err adts_dmx_process(GF_Filter *filter)
+static GF_Err adts_dmx_process_frames(GF_Filter *filter)
 {
 	GF_ADTSDmxCtx *ctx = gf_filter_get_udta(filter);
 	GF_FilterPacket *pck, *dst_pck;
@@ -906,6 +906,16 @@ drop_byte:
 	return GF_OK;
 }
 
+GF_Err adts_dmx_process(GF_Filter *filter)
+{
+	GF_Err e;
+	//dispatch all ADTS frames parsed in this call as one batch
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	e = adts_dmx_process_frames(filter);
+	gf_filter_batch_dispatch(filter, GF_FALSE);
+	return e;
+}
+
 static void adts_dmx_finalize(GF_Filter *filter)
 {
 	GF_ADTSDmxCtx *ctx = gf_filter_get_udta(filter);
@@ -454,7 +454,7 @@ static GFINLINE void latm_dmx_update_cts(GF_LATMDmxCtx *ctx)
 	}
 }
 
-GF_Err latm_dmx_process(GF_Filter *filter)
+static GF_Err latm_dmx_process_frames(GF_Filter *filter)
 {
 	GF_LATMDmxCtx *ctx = gf_filter_get_udta(filter);
 	GF_FilterPacket *pck, *dst_pck;
@@ -616,6 +616,15 @@ restart:
 	return GF_OK;
 }
 
+GF_Err latm_dmx_process(GF_Filter *filter)
+{
+	GF_Err e;
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	e = latm_dmx_process_frames(filter);
+	gf_filter_batch_dispatch(filter, GF_FALSE);
+	return e;
+}
+
 static void latm_dmx_finalize(GF_Filter *filter)
 {
 	GF_LATMDmxCtx *ctx = gf_filter_get_udta(filter);
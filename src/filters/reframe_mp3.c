@@ -506,7 +506,7 @@ static GFINLINE void mp3_dmx_update_cts(GF_MP3DmxCtx *ctx)
 	}
 }
 
-GF_Err mp3_dmx_process(GF_Filter *filter)
+static GF_Err mp3_dmx_process_frames(GF_Filter *filter)
 {
 	GF_MP3DmxCtx *ctx = gf_filter_get_udta(filter);
 	GF_FilterPacket *pck, *dst_pck;
@@ -760,6 +760,16 @@ drop_byte:
 	return GF_OK;
 }
 
+GF_Err mp3_dmx_process(GF_Filter *filter)
+{
+	GF_Err e;
+	//consumers are only woken up once all frames of this call are sent
+	gf_filter_batch_dispatch(filter, GF_TRUE);
+	e = mp3_dmx_process_frames(filter);
+	gf_filter_batch_dispatch(filter, GF_FALSE);
+	return e;
+}
+
 static GF_Err mp3_dmx_initialize(GF_Filter *filter)
 {
 	GF_MP3DmxCtx *ctx = gf_filter_get_udta(filter);
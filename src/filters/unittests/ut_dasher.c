@@ -0,0 +1,103 @@
+#include <gpac/filters.h>
+#include "tests.h"
+
+#if !defined(GPAC_DISABLE_DASHER)
+
+void dasher_patch_mpd_signature(const u8 *data, u32 size, u8 sig[GF_SHA1_DIGEST_SIZE]);
+
+static const char *ut_dasher_mpd =
+    "<?xml version=\"1.0\"?>\n"
+    "<!-- MPD file Generated with GPAC at 2020-01-01T00:00:10.000Z -->\n"
+    "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" id=\"GPACMPD\" type=\"dynamic\" availabilityStartTime=\"2020-01-01T00:00:00.000Z\" publishTime=\"2020-01-01T00:00:10.000Z\" minimumUpdatePeriod=\"PT0H0M2.000S\">\n"
+    " <PatchLocation ttl=\"4\">live.mpp</PatchLocation>\n"
+    " <Period id=\"P1\" start=\"PT0S\" duration=\"PT10S\">\n"
+    "  <AdaptationSet id=\"1\" maxWidth=\"320\">\n"
+    "   <SegmentTemplate timescale=\"1000\" media=\"v_$Time$.m4s\">\n"
+    "    <SegmentTimeline>\n"
+    "     <S t=\"0\" d=\"2000\" r=\"4\"/>\n"
+    "    </SegmentTimeline>\n"
+    "   </SegmentTemplate>\n"
+    "   <Representation id=\"v1\" bandwidth=\"100000\"/>\n"
+    "  </AdaptationSet>\n"
+    " </Period>\n"
+    " <Period id=\"P2\" start=\"PT10S\">\n"
+    "  <AdaptationSet id=\"1\" maxWidth=\"320\">\n"
+    "   <SegmentTemplate timescale=\"1000\" media=\"v_$Time$.m4s\">\n"
+    "    <SegmentTimeline>\n"
+    "     <S t=\"10000\" d=\"2000\"/>\n"
+    "    </SegmentTimeline>\n"
+    "   </SegmentTemplate>\n"
+    "   <Representation id=\"v1\" bandwidth=\"100000\"/>\n"
+    "  </AdaptationSet>\n"
+    " </Period>\n"
+    " <UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:http-iso:2014\" value=\"http://time.example.com\"/>\n"
+    "</MPD>\n";
+
+//signature of the MPD with the nth occurence of what replaced by with
+static void ut_dasher_sig(const char *what, u32 nth, const char *with, u8 sig[GF_SHA1_DIGEST_SIZE])
+{
+    char *mpd = gf_strdup(ut_dasher_mpd);
+    if (what) {
+        char *pos = strstr(mpd, what);
+        while (pos && nth--) pos = strstr(pos+1, what);
+        assert_not_null(pos);
+        if (pos) {
+            char *res = NULL;
+            pos[0] = 0;
+            gf_dynstrcat(&res, mpd, NULL);
+            gf_dynstrcat(&res, with, NULL);
+            gf_dynstrcat(&res, pos + strlen(what), NULL);
+            gf_free(mpd);
+            mpd = res;
+        }
+    }
+    dasher_patch_mpd_signature((u8 *) mpd, (u32) strlen(mpd), sig);
+    gf_free(mpd);
+}
+
+static Bool ut_dasher_sig_changed(const char *what, u32 nth, const char *with)
+{
+    u8 ref[GF_SHA1_DIGEST_SIZE], sig[GF_SHA1_DIGEST_SIZE];
+    ut_dasher_sig(NULL, 0, NULL, ref);
+    ut_dasher_sig(what, nth, with, sig);
+    return memcmp(ref, sig, GF_SHA1_DIGEST_SIZE) ? GF_TRUE : GF_FALSE;
+}
+
+//MPD patch is only sent if the MPD differs from the previous one by publish time and segment timelines
+unittest(dasher_patch_mpd_signature)
+{
+    u32 i, size;
+    u8 sig[GF_SHA1_DIGEST_SIZE], ref[GF_SHA1_DIGEST_SIZE];
+    const char *truncated[] = {"<!-- no end", "<SegmentTimeline", "<SegmentTimeline><S t=\"0\"/>", "<MPD publishTime=\"2020"};
+
+    //parts described by the patch
+    assert_false(ut_dasher_sig_changed("publishTime=\"2020-01-01T00:00:10.000Z\"", 0, "publishTime=\"2020-01-01T00:00:12.000Z\""));
+    assert_false(ut_dasher_sig_changed("at 2020-01-01T00:00:10.000Z", 0, "at 2020-01-01T00:00:12.000Z"));
+    assert_false(ut_dasher_sig_changed(" r=\"4\"", 0, " r=\"5\""));
+    assert_false(ut_dasher_sig_changed("<S t=\"0\" d=\"2000\" r=\"4\"/>", 0, "<S t=\"2000\" d=\"2000\" r=\"3\"/>\n     <S d=\"1000\"/>"));
+    assert_false(ut_dasher_sig_changed("<S t=\"10000\" d=\"2000\"/>", 0, "<S t=\"10000\" d=\"2000\" r=\"1\"/>"));
+
+    //anything else
+    assert_true(ut_dasher_sig_changed("availabilityStartTime=\"2020-01-01T00:00:00.000Z\"", 0, "availabilityStartTime=\"2020-01-01T00:00:01.000Z\""));
+    assert_true(ut_dasher_sig_changed("PT0H0M2.000S", 0, "PT0H0M4.000S"));
+    assert_true(ut_dasher_sig_changed("duration=\"PT10S\"", 0, "duration=\"PT12S\""));
+    assert_true(ut_dasher_sig_changed("maxWidth=\"320\"", 0, "maxWidth=\"640\""));
+    assert_true(ut_dasher_sig_changed("maxWidth=\"320\"", 1, "maxWidth=\"640\""));
+    assert_true(ut_dasher_sig_changed("media=\"v_$Time$.m4s\"", 0, "media=\"v2_$Time$.m4s\""));
+    assert_true(ut_dasher_sig_changed("bandwidth=\"100000\"", 0, "bandwidth=\"200000\""));
+    assert_true(ut_dasher_sig_changed("http://time.example.com", 0, "http://time2.example.com"));
+    assert_true(ut_dasher_sig_changed("</Period>", 0, "</Period>\n <Period id=\"P3\"/>"));
+    //timeline added or removed
+    assert_true(ut_dasher_sig_changed("<SegmentTimeline>", 0, "<SegmentTimeline>\n     <S t=\"0\" d=\"2000\"/>\n    </SegmentTimeline>\n    <SegmentTimeline>"));
+    assert_true(ut_dasher_sig_changed("    <SegmentTimeline>\n     <S t=\"10000\" d=\"2000\"/>\n    </SegmentTimeline>\n", 0, ""));
+
+    //unterminated constructs do not read past the data
+    for (i=0; i<sizeof(truncated)/sizeof(char*); i++) {
+        size = (u32) strlen(truncated[i]);
+        dasher_patch_mpd_signature((const u8 *) truncated[i], size, sig);
+    }
+    dasher_patch_mpd_signature((const u8 *) "<MPD publishTime=\"", 18, ref);
+    assert_equal_mem(sig, ref, GF_SHA1_DIGEST_SIZE);
+}
+
+#endif
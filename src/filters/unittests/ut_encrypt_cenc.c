@@ -0,0 +1,152 @@
+#include <gpac/filters.h>
+#include <gpac/isomedia.h>
+#include <gpac/internal/media_dev.h>
+#include "tests.h"
+
+#define UT_CENC_SAMPLES	24
+
+static const struct {
+    Bool avc;
+    const char *drm;
+} ut_cenc_cfg[] = {
+    {GF_FALSE, 
+    "<GPACDRM type=\"CENC AES-CTR\"><CrypTrack IV_size=\"8\" first_IV=\"0x0a610676cb88f302\" isEncrypted=\"1\" saiSavedBox=\"senc\">"
+    "<key KID=\"0x279926496a7f5d25da69f2b3b2799a7f\" value=\"0xcc00ed5e1b5d8e9e8ba1fbf20e85e3b5\"/></CrypTrack></GPACDRM>"},
+    {GF_FALSE, "<GPACDRM type=\"CENC AES-CBC\"><CrypTrack scheme_type=\"cbcs\" constant_IV_size=\"16\" constant_IV=\"0x0a610676cb88f3020a610676cb88f302\" isEncrypted=\"1\" saiSavedBox=\"senc\">"
+    "<key KID=\"0x279926496a7f5d25da69f2b3b2799a7f\" value=\"0xcc00ed5e1b5d8e9e8ba1fbf20e85e3b5\"/></CrypTrack></GPACDRM>"},
+    //subsamples not aligned on AES blocks, CTR jobs start in the middle of a counter block
+    {GF_TRUE, "<GPACDRM type=\"CENC AES-CTR\"><CrypTrack IV_size=\"16\" first_IV=\"0x0a610676cb88f3020a610676cb88f3ff\" isEncrypted=\"1\" saiSavedBox=\"senc\" encryptSliceHeader=\"yes\" blockAlign=\"disable\">"
+    "<key KID=\"0x279926496a7f5d25da69f2b3b2799a7f\" value=\"0xcc00ed5e1b5d8e9e8ba1fbf20e85e3b5\"/></CrypTrack></GPACDRM>"},
+};
+
+//parallel encryption runs on session threads
+static void ut_cenc_encrypt(const char *drm_file, u32 nb_threads, const char *dst)
+{
+    GF_Err e;
+    char args[GF_MAX_PATH];
+    GF_Filter *f;
+    GF_FilterSession *fs = gf_fs_new(nb_threads, GF_FS_SCHEDULER_LOCK_FREE, 0, NULL);
+    assert_not_null(fs);
+    f = gf_fs_load_source(fs, "ut_cenc_in.mp4", NULL, NULL, &e);
+    assert_not_null(f);
+    snprintf(args, GF_MAX_PATH, "cecrypt:cfile=%s:mt=%s", drm_file, nb_threads ? "yes" : "no");
+    f = gf_fs_load_filter(fs, args, &e);
+    assert_not_null(f);
+    f = gf_fs_load_destination(fs, dst, NULL, NULL, &e);
+    assert_not_null(f);
+    assert_equal(gf_fs_run(fs), GF_EOS);
+    gf_fs_del(fs);
+}
+
+static void ut_cenc_make_input(Bool avc)
+{
+    u32 i, j, track, di;
+    GF_GenericSampleDescription udesc;
+    GF_ISOSample samp;
+    u32 rand_state = 1;
+    GF_ISOFile *file = gf_isom_open("ut_cenc_in.mp4", GF_ISOM_OPEN_WRITE, NULL);
+    assert_not_null(file);
+    track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 25);
+    assert_greater(track, 0);
+    if (avc) {
+        GF_AVCConfig *avcc = gf_odf_avc_cfg_new();
+        avcc->configurationVersion = 1;
+        avcc->AVCProfileIndication = 66;
+        avcc->AVCLevelIndication = 30;
+        avcc->nal_unit_size = 4;
+        assert_equal(gf_isom_avc_config_new(file, track, avcc, NULL, NULL, &di), GF_OK);
+        gf_odf_avc_cfg_del(avcc);
+        gf_isom_set_visual_info(file, track, di, 320, 240);
+    } else {
+        memset(&udesc, 0, sizeof(udesc));
+        udesc.codec_tag = GF_4CC('t','e','s','t');
+        udesc.width = 320;
+        udesc.height = 240;
+        assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di), GF_OK);
+    }
+    memset(&samp, 0, sizeof(samp));
+    for (i=0; i<UT_CENC_SAMPLES; i++) {
+        //sizes spread over several CTR jobs, not block-aligned
+        samp.dataLength = 1000 + 9*i*i*i;
+        samp.data = gf_malloc(samp.dataLength);
+        for (j=0; j<samp.dataLength; j++) {
+            rand_state = rand_state * 1103515245 + 12345;
+            samp.data[j] = (u8) (rand_state>>16);
+        }
+        if (avc) {
+            //split in NALs of odd sizes
+            u32 pos = 0;
+            while (pos + 5 < samp.dataLength) {
+                u32 nal_size = 200 + 37*(pos%1000);
+                if (pos + 4 + nal_size > samp.dataLength) nal_size = samp.dataLength - pos - 4;
+                samp.data[pos] = nal_size>>24;
+                samp.data[pos+1] = (nal_size>>16) & 0xFF;
+                samp.data[pos+2] = (nal_size>>8) & 0xFF;
+                samp.data[pos+3] = nal_size & 0xFF;
+                samp.data[pos+4] = (i%8) ? GF_AVC_NALU_NON_IDR_SLICE : GF_AVC_NALU_IDR_SLICE;
+                pos += 4 + nal_size;
+            }
+            samp.dataLength = pos;
+        }
+        samp.DTS = i;
+        samp.IsRAP = (i%8) ? 0 : RAP;
+        assert_equal(gf_isom_add_sample(file, track, di, &samp), GF_OK);
+        gf_free(samp.data);
+    }
+    assert_equal(gf_isom_close(file), GF_OK);
+}
+
+//parallel encryption must give the same samples as serial encryption
+unittest(cecrypt_parallel)
+{
+    u32 i, k;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+
+    for (k=0; k<sizeof(ut_cenc_cfg)/sizeof(ut_cenc_cfg[0]); k++) {
+        GF_ISOFile *in, *ser, *par;
+        FILE *drm;
+        ut_cenc_make_input(ut_cenc_cfg[k].avc);
+        drm = gf_fopen("ut_cenc_drm.xml", "wb");
+        assert_not_null(drm);
+        gf_fwrite(ut_cenc_cfg[k].drm, (u32) strlen(ut_cenc_cfg[k].drm), drm);
+        gf_fclose(drm);
+
+        ut_cenc_encrypt("ut_cenc_drm.xml", 0, "ut_cenc_ser.mp4");
+        ut_cenc_encrypt("ut_cenc_drm.xml", 4, "ut_cenc_par.mp4");
+
+        in = gf_isom_open("ut_cenc_in.mp4", GF_ISOM_OPEN_READ, NULL);
+        ser = gf_isom_open("ut_cenc_ser.mp4", GF_ISOM_OPEN_READ, NULL);
+        par = gf_isom_open("ut_cenc_par.mp4", GF_ISOM_OPEN_READ, NULL);
+        assert_not_null(in);
+        assert_not_null(ser);
+        assert_not_null(par);
+        assert_true(gf_isom_is_cenc_media(ser, 1, 1));
+        assert_true(gf_isom_is_cenc_media(par, 1, 1));
+        assert_equal(gf_isom_get_sample_count(ser, 1), UT_CENC_SAMPLES);
+        assert_equal(gf_isom_get_sample_count(par, 1), UT_CENC_SAMPLES);
+        for (i=0; i<UT_CENC_SAMPLES; i++) {
+            GF_ISOSample *s_in = gf_isom_get_sample(in, 1, i+1, NULL);
+            GF_ISOSample *s_ser = gf_isom_get_sample(ser, 1, i+1, NULL);
+            GF_ISOSample *s_par = gf_isom_get_sample(par, 1, i+1, NULL);
+            assert_not_null(s_in);
+            assert_not_null(s_ser);
+            assert_not_null(s_par);
+            assert_equal(s_ser->dataLength, s_in->dataLength);
+            assert_equal(s_par->dataLength, s_in->dataLength);
+            assert_false(!memcmp(s_ser->data, s_in->data, s_in->dataLength));
+            assert_equal_mem(s_par->data, s_ser->data, s_ser->dataLength);
+            gf_isom_sample_del(&s_in);
+            gf_isom_sample_del(&s_ser);
+            gf_isom_sample_del(&s_par);
+        }
+        gf_isom_close(in);
+        gf_isom_close(ser);
+        gf_isom_close(par);
+    }
+    gf_file_delete("ut_cenc_in.mp4");
+    gf_file_delete("ut_cenc_ser.mp4");
+    gf_file_delete("ut_cenc_par.mp4");
+    gf_file_delete("ut_cenc_drm.xml");
+    gf_sys_close();
+}
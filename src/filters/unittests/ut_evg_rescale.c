@@ -0,0 +1,68 @@
+#include <gpac/filters.h>
+#include "tests.h"
+
+#define UT_EVGS_Y	100
+#define UT_EVGS_U	60
+#define UT_EVGS_V	200
+
+//scales a flat YUV 4:2:0 picture, all output samples including the last chroma row and column must be written
+static void ut_evgs_check(const char *algo, u32 i_w, u32 i_h, u32 o_w, u32 o_h)
+{
+    GF_Err e;
+    u8 *data;
+    u32 i, size, y_size, uv_size, nb_bad = 0;
+    char args[GF_MAX_PATH];
+    GF_Filter *f;
+    GF_FilterSession *fs;
+    FILE *in = gf_fopen("ut_evgs_in.yuv", "wb");
+    assert_not_null(in);
+    y_size = i_w * i_h;
+    uv_size = ((i_w+1)/2) * ((i_h+1)/2);
+    for (i=0; i<y_size; i++) gf_fputc(UT_EVGS_Y, in);
+    for (i=0; i<uv_size; i++) gf_fputc(UT_EVGS_U, in);
+    for (i=0; i<uv_size; i++) gf_fputc(UT_EVGS_V, in);
+    gf_fclose(in);
+
+    fs = gf_fs_new_defaults(0);
+    assert_not_null(fs);
+    snprintf(args, GF_MAX_PATH, "ut_evgs_in.yuv:size=%ux%u:spfmt=yuv420", i_w, i_h);
+    f = gf_fs_load_source(fs, args, NULL, NULL, &e);
+    assert_not_null(f);
+    snprintf(args, GF_MAX_PATH, "evgs:osize=%ux%u:algo=%s", o_w, o_h, algo);
+    f = gf_fs_load_filter(fs, args, &e);
+    assert_not_null(f);
+    f = gf_fs_load_destination(fs, "ut_evgs_out.yuv", NULL, NULL, &e);
+    assert_not_null(f);
+    assert_equal(gf_fs_run(fs), GF_EOS);
+    gf_fs_del(fs);
+
+    assert_equal(gf_file_load_data("ut_evgs_out.yuv", &data, &size), GF_OK);
+    y_size = o_w * o_h;
+    uv_size = ((o_w+1)/2) * ((o_h+1)/2);
+    assert_equal(size, y_size + 2*uv_size);
+    if (size == y_size + 2*uv_size) {
+        for (i=0; i<y_size; i++) {
+            if (data[i] != UT_EVGS_Y) nb_bad++;
+        }
+        for (i=0; i<uv_size; i++) {
+            if (data[y_size + i] != UT_EVGS_U) nb_bad++;
+            if (data[y_size + uv_size + i] != UT_EVGS_V) nb_bad++;
+        }
+    }
+    assert_equal(nb_bad, 0);
+    gf_free(data);
+    gf_file_delete("ut_evgs_in.yuv");
+    gf_file_delete("ut_evgs_out.yuv");
+}
+
+unittest(evgs_scaler_odd_sizes)
+{
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    ut_evgs_check("bicubic", 64, 48, 32, 24);
+    //odd output width and height
+    ut_evgs_check("bicubic", 64, 48, 33, 25);
+    ut_evgs_check("lanczos", 64, 48, 97, 71);
+    //odd input and output
+    ut_evgs_check("lanczos", 35, 27, 21, 13);
+    gf_sys_close();
+}
@@ -0,0 +1,119 @@
+#include <gpac/filters.h>
+#include "tests.h"
+
+#define UT_RS_FREQ	1000
+//GF_PI is single precision
+#define UT_RS_PI	3.14159265358979323846
+
+static void ut_rs_make_input(u32 nb_samples, u32 nb_zeros)
+{
+    u32 i;
+    FILE *f = gf_fopen("ut_rs_in.pcm", "wb");
+    assert_not_null(f);
+    for (i=0; i<nb_samples+nb_zeros; i++) {
+        Float v = (i<nb_samples) ? (Float) (0.5 * sin(2 * UT_RS_PI * UT_RS_FREQ * i / 48000)) : 0;
+        gf_fwrite(&v, sizeof(Float), f);
+    }
+    gf_fclose(f);
+}
+
+//resample ut_rs_in.pcm from 48k to 44.1k
+static void ut_rs_run(const char *mode, Float **out, u32 *nb_out)
+{
+    GF_Err e;
+    u8 *data;
+    u32 size;
+    char args[GF_MAX_PATH];
+    GF_Filter *f;
+    GF_FilterSession *fs = gf_fs_new_defaults(0);
+    assert_not_null(fs);
+    f = gf_fs_load_source(fs, "ut_rs_in.pcm:sr=48000:safmt=flt:ch=1", NULL, NULL, &e);
+    assert_not_null(f);
+    snprintf(args, GF_MAX_PATH, "resample:osr=44100:osfmt=flt:mode=%s", mode);
+    f = gf_fs_load_filter(fs, args, &e);
+    assert_not_null(f);
+    f = gf_fs_load_destination(fs, "ut_rs_out.flt", NULL, NULL, &e);
+    assert_not_null(f);
+    assert_equal(gf_fs_run(fs), GF_EOS);
+    gf_fs_del(fs);
+
+    assert_equal(gf_file_load_data("ut_rs_out.flt", &data, &size), GF_OK);
+    *out = (Float *) data;
+    *nb_out = size / sizeof(Float);
+}
+
+//SNR of a 44.1k sine, after least-square fit of amplitude and phase, skipping edges
+static Double ut_rs_snr(const Float *out, u32 nb_out)
+{
+    u32 i, skip = 256;
+    Double ss=0, cc=0, sc=0, sy=0, cy=0, a, b, sig=0, err=0;
+    for (i=skip; i+skip<nb_out; i++) {
+        Double s = sin(2 * UT_RS_PI * UT_RS_FREQ * i / 44100);
+        Double c = cos(2 * UT_RS_PI * UT_RS_FREQ * i / 44100);
+        ss += s*s;
+        cc += c*c;
+        sc += s*c;
+        sy += s*out[i];
+        cy += c*out[i];
+    }
+    a = (sy*cc - cy*sc) / (ss*cc - sc*sc);
+    b = (cy*ss - sy*sc) / (ss*cc - sc*sc);
+    for (i=skip; i+skip<nb_out; i++) {
+        Double fit = a * sin(2 * UT_RS_PI * UT_RS_FREQ * i / 44100) + b * cos(2 * UT_RS_PI * UT_RS_FREQ * i / 44100);
+        sig += fit*fit;
+        err += (out[i]-fit) * (out[i]-fit);
+    }
+    return 10 * log10(sig / err);
+}
+
+//end of stream flush must behave as if the input was followed by silence
+unittest(resample_sinc_flush)
+{
+    u32 i, nb_out, nb_ref;
+    Float *out, *ref;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+
+    //not a multiple of the input frame size nor of the resampling ratio
+    ut_rs_make_input(10007, 0);
+    ut_rs_run("sinc", &out, &nb_out);
+    ut_rs_make_input(10007, 1024);
+    ut_rs_run("sinc", &ref, &nb_ref);
+
+    assert_equal(nb_out, (10007 * 441 + 479) / 480);
+    assert_greater(nb_ref, nb_out);
+    for (i=0; i<nb_out; i++) {
+        assert_true(fabs(out[i] - ref[i]) < 1e-6);
+    }
+    gf_free(out);
+    gf_free(ref);
+    gf_file_delete("ut_rs_in.pcm");
+    gf_file_delete("ut_rs_out.flt");
+    gf_sys_close();
+}
+
+//compare sinc mode with the audio mixer (linear) resampler
+unittest(resample_sinc_snr)
+{
+    u32 nb_lin, nb_sinc, nb_in = 48000*2;
+    Double snr_lin, snr_sinc;
+    Float *out_lin, *out_sinc;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+
+    ut_rs_make_input(nb_in, 0);
+    ut_rs_run("lin", &out_lin, &nb_lin);
+    ut_rs_run("sinc", &out_sinc, &nb_sinc);
+    assert_equal(nb_lin, nb_sinc);
+    snr_lin = ut_rs_snr(out_lin, nb_lin);
+    snr_sinc = ut_rs_snr(out_sinc, nb_sinc);
+
+    assert_greater(snr_sinc, snr_lin);
+    assert_greater(snr_sinc, 100);
+
+    gf_free(out_lin);
+    gf_free(out_sinc);
+    gf_file_delete("ut_rs_in.pcm");
+    gf_file_delete("ut_rs_out.flt");
+    gf_sys_close();
+}
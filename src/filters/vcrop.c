@@ -55,6 +55,13 @@ typedef struct
 	Bool packed_422;
 
 	GF_List *frames, *frames_res;
+
+	//planes being copied by parallel jobs, rows of all planes are numbered contiguously
+	struct {
+		u8 *src, *dst;
+		u32 src_stride, dst_stride, line_size, first_row;
+	} copies[5];
+	u32 nb_copies, nb_copy_rows;
 } GF_VCropCtx;
 
 typedef struct
@@ -93,6 +100,34 @@ void vcrop_packet_destruct(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket
 }
 
 
+static void vcrop_add_copy(GF_VCropCtx *ctx, u8 *src, u32 src_stride, u8 *dst, u32 dst_stride, u32 line_size, u32 nb_lines)
+{
+	if (!nb_lines) return;
+	ctx->copies[ctx->nb_copies].src = src;
+	ctx->copies[ctx->nb_copies].dst = dst;
+	ctx->copies[ctx->nb_copies].src_stride = src_stride;
+	ctx->copies[ctx->nb_copies].dst_stride = dst_stride;
+	ctx->copies[ctx->nb_copies].line_size = line_size;
+	ctx->copies[ctx->nb_copies].first_row = ctx->nb_copy_rows;
+	ctx->nb_copies++;
+	ctx->nb_copy_rows += nb_lines;
+}
+
+static void vcrop_copy_job(void *udta, u32 first, u32 last, u32 thread_idx)
+{
+	u32 i, j;
+	GF_VCropCtx *ctx = (GF_VCropCtx *) udta;
+	for (i=0; i<ctx->nb_copies; i++) {
+		u32 end = (i+1<ctx->nb_copies) ? ctx->copies[i+1].first_row : ctx->nb_copy_rows;
+		u32 p_first = MAX(first, ctx->copies[i].first_row);
+		u32 p_last = MIN(last, end);
+		for (j=p_first; j<p_last; j++) {
+			u32 y = j - ctx->copies[i].first_row;
+			memcpy(ctx->copies[i].dst + y * ctx->copies[i].dst_stride, ctx->copies[i].src + y * ctx->copies[i].src_stride, ctx->copies[i].line_size);
+		}
+	}
+}
+
 static GF_Err vcrop_process(GF_Filter *filter)
 {
 	const u8 *data;
@@ -100,7 +135,6 @@ static GF_Err vcrop_process(GF_Filter *filter)
 	u32 size;
 	u32 bps;
 	u32 s_off_x, s_off_y, d_off_x, d_off_y, i, copy_w, copy_h;
-	u8 *src, *dst;
 	u8 *src_planes[5];
 	u8 *dst_planes[5];
 	Bool do_memset = GF_FALSE;
@@ -249,72 +283,40 @@ static GF_Err vcrop_process(GF_Filter *filter)
 		memset(output, 0x00, sizeof(char)*ctx->out_size);
 	}
 
+	ctx->nb_copies = ctx->nb_copy_rows = 0;
 	//YUYV variations need *2 on horizontal dimension
 	if (ctx->packed_422) {
-		src = src_planes[0] + s_off_x * bps * 2 + ctx->src_stride[0] * s_off_y;
-		dst = dst_planes[0] + d_off_x * bps * 2 + ctx->dst_stride[0] * d_off_y;
-		for (i=0; i<copy_h; i++) {
-			memcpy(dst, src, bps * copy_w * 2);
-			src += ctx->src_stride[0];
-			dst += ctx->dst_stride[0];
-		}
+		vcrop_add_copy(ctx, src_planes[0] + s_off_x * bps * 2 + ctx->src_stride[0] * s_off_y, ctx->src_stride[0],
+			dst_planes[0] + d_off_x * bps * 2 + ctx->dst_stride[0] * d_off_y, ctx->dst_stride[0], bps * copy_w * 2, copy_h);
 	} else {
 		//copy first plane
-		src = src_planes[0] + s_off_x * bps + ctx->src_stride[0] * s_off_y;
-		dst = dst_planes[0] + d_off_x * bps + ctx->dst_stride[0] * d_off_y;
-		for (i=0; i<copy_h; i++) {
-			memcpy(dst, src, bps * copy_w);
-			src += ctx->src_stride[0];
-			dst += ctx->dst_stride[0];
-		}
+		vcrop_add_copy(ctx, src_planes[0] + s_off_x * bps + ctx->src_stride[0] * s_off_y, ctx->src_stride[0],
+			dst_planes[0] + d_off_x * bps + ctx->dst_stride[0] * d_off_y, ctx->dst_stride[0], bps * copy_w, copy_h);
 	}
 
 	//nv12/21
 	if (ctx->nb_planes==2) {
-		src = src_planes[1] + s_off_x * bps + ctx->src_stride[1] * s_off_y/2;
-		dst = dst_planes[1] + d_off_x * bps + ctx->dst_stride[1] * d_off_y/2;
-		//half vertical res (/2)
-		for (i=0; i<copy_h/2; i++) {
-			//half horizontal res (/2) but two chroma packed per pixel (*2)
-			memcpy(dst, src, bps * copy_w);
-			src += ctx->src_stride[1];
-			dst += ctx->dst_stride[1];
-		}
+		//half vertical res (/2), half horizontal res (/2) but two chroma packed per pixel (*2)
+		vcrop_add_copy(ctx, src_planes[1] + s_off_x * bps + ctx->src_stride[1] * s_off_y/2, ctx->src_stride[1],
+			dst_planes[1] + d_off_x * bps + ctx->dst_stride[1] * d_off_y/2, ctx->dst_stride[1], bps * copy_w, copy_h/2);
 	} else if ((ctx->nb_planes==3) || (ctx->nb_planes==4)) {
 		u32 div_x, div_y;
 		//alpha/depth/other plane, treat as luma plane
 		if (ctx->nb_planes==4) {
-			src = src_planes[3] + s_off_x * bps + ctx->src_stride[3] * s_off_y;
-			dst = dst_planes[3] + d_off_x * bps + ctx->dst_stride[3] * d_off_y;
-			for (i=0; i<copy_h; i++) {
-				memcpy(dst, src, bps * copy_w);
-				src += ctx->src_stride[3];
-				dst += ctx->dst_stride[3];
-			}
+			vcrop_add_copy(ctx, src_planes[3] + s_off_x * bps + ctx->src_stride[3] * s_off_y, ctx->src_stride[3],
+				dst_planes[3] + d_off_x * bps + ctx->dst_stride[3] * d_off_y, ctx->dst_stride[3], bps * copy_w, copy_h);
 		}
 
 		div_x = (ctx->src_stride[1]==ctx->src_stride[0]) ? 1 : 2;
 		div_y = (ctx->src_uv_height==ctx->h) ? 1 : 2;
 
-		src = src_planes[1] + s_off_x * bps / div_x + ctx->src_stride[1] * s_off_y / div_y;
-		dst = dst_planes[1] + d_off_x * bps / div_x + ctx->dst_stride[1] * d_off_y / div_y;
-		copy_h /= div_y;
-		copy_w /= div_x;
-
-		for (i=0; i<copy_h; i++) {
-			memcpy(dst, src, bps * copy_w);
-			src += ctx->src_stride[1];
-			dst += ctx->dst_stride[1];
-		}
-
-		src = src_planes[2] + s_off_x * bps / div_x + ctx->src_stride[2] * s_off_y / div_y;
-		dst = dst_planes[2] + d_off_x * bps / div_x + ctx->dst_stride[2] * d_off_y / div_y;
-		for (i=0; i<copy_h; i++) {
-			memcpy(dst, src, bps * copy_w);
-			src += ctx->src_stride[1];
-			dst += ctx->dst_stride[1];
-		}
+		vcrop_add_copy(ctx, src_planes[1] + s_off_x * bps / div_x + ctx->src_stride[1] * s_off_y / div_y, ctx->src_stride[1],
+			dst_planes[1] + d_off_x * bps / div_x + ctx->dst_stride[1] * d_off_y / div_y, ctx->dst_stride[1], bps * (copy_w / div_x), copy_h / div_y);
+		vcrop_add_copy(ctx, src_planes[2] + s_off_x * bps / div_x + ctx->src_stride[2] * s_off_y / div_y, ctx->src_stride[1],
+			dst_planes[2] + d_off_x * bps / div_x + ctx->dst_stride[2] * d_off_y / div_y, ctx->dst_stride[1], bps * (copy_w / div_x), copy_h / div_y);
 	}
+	//rows are copied by bands of at least 32 lines using session threads
+	gf_filter_parallel_for(filter, ctx->nb_copy_rows, 32, vcrop_copy_job, ctx);
 
 	gf_filter_pck_send(dst_pck);
 	gf_filter_pid_drop_packet(ctx->ipid);
@@ -52,9 +52,14 @@ typedef struct
 	Bool packed_422;
 
 
+	//one line per thread for each buffer
 	char *line_buffer_vf; //vertical flip
 	char *line_buffer_hf; //horizontal flip
 
+	//plane being processed by parallel jobs
+	u8 *job_src, *job_dst;
+	u32 job_height, job_plane, job_wiB, *job_src_stride;
+	Bool job_vertical;
 } GF_VFlipCtx;
 
 enum
@@ -90,7 +95,7 @@ static void swap_2Ys_YUVpixel(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_dst, u32
 	line_dst[FourBytes_start_index + 0 + isFirstY_indexOne]=line_src[FourBytes_start_index + 2 + isFirstY_indexOne];
 }
 
-static void horizontal_flip_per_line(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_dst, u32 plane_idx, u32 wiB)
+static void horizontal_flip_per_line(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_dst, u32 plane_idx, u32 wiB, u8 *line_buffer)
 {
 	u32 j, line_size = wiB;
 
@@ -106,8 +111,8 @@ static void horizontal_flip_per_line(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_ds
 	} else if (ctx->packed_422) {
 		//If the source data is assigned to the output packet during the destination pack allocation
 		//i.e dst_planes[0]= src_planes[0], line_src is going to change while reading it as far as writing on line_dst=line_src
-		//To avoid this situation, ctx->line_buffer_hf keeps the values of line_src
-		memcpy(ctx->line_buffer_hf, line_src, wiB);
+		//To avoid this situation, line_buffer keeps the values of line_src
+		memcpy(line_buffer, line_src, wiB);
 
 		//reversing of 4-bytes sequences
 		u32 fourBytesSize = wiB/4;
@@ -116,7 +121,7 @@ static void horizontal_flip_per_line(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_ds
 			u32 last_4bytes_index = wiB-4-(4*j);
 			u32 p, first_4bytes_index = 4*j;
 			for (p = 0; p < 4; p++) {
-				line_dst[first_4bytes_index+p] = ctx->line_buffer_hf[last_4bytes_index+p];
+				line_dst[first_4bytes_index+p] = line_buffer[last_4bytes_index+p];
 			}
 			//exchanging of Ys within a yuv pixel
 			swap_2Ys_YUVpixel(ctx, line_dst, line_dst, first_4bytes_index);
@@ -182,33 +187,56 @@ static void horizontal_flip_per_line(GF_VFlipCtx *ctx, u8 *line_src, u8 *line_ds
 	}
 }
 
-static void horizontal_flip(GF_VFlipCtx *ctx, u8 *src_plane, u8 *dst_plane, u32 height, u32 plane_idx, u32 wiB, u32 *src_stride)
+static void horizontal_flip(GF_VFlipCtx *ctx, u8 *src_plane, u8 *dst_plane, u32 first, u32 last, u32 plane_idx, u32 wiB, u32 *src_stride, u8 *line_buffer)
 {
 	u32 i;
-	for (i=0; i<height; i++) {
+	for (i=first; i<last; i++) {
 		u8 *src_first_line = src_plane + i * src_stride[plane_idx];
 		u8 *dst_first_line = dst_plane + i * ctx->dst_stride[plane_idx];
 
-		horizontal_flip_per_line(ctx, src_first_line, dst_first_line, plane_idx, wiB);
+		horizontal_flip_per_line(ctx, src_first_line, dst_first_line, plane_idx, wiB, line_buffer);
 	}
 }
 
-static void vertical_flip(GF_VFlipCtx *ctx, u8 *src_plane, u8 *dst_plane, u32 height, u32 plane_idx, u32 wiB){
-	u32 hy, i;
-	hy = height/2;
-	for (i=0; i<hy; i++) {
+//swap lines [first, last[ with their symmetric lines
+static void vertical_flip(GF_VFlipCtx *ctx, u8 *src_plane, u8 *dst_plane, u32 height, u32 first, u32 last, u32 plane_idx, u32 wiB, u8 *line_buffer){
+	u32 i;
+	for (i=first; i<last; i++) {
 		u8 *src_first_line = src_plane+ i*ctx->src_stride[plane_idx];
 		u8 *src_last_line  = src_plane+ (height  - 1 - i) * ctx->src_stride[plane_idx];
 
 		u8 *dst_first_line = dst_plane+ i*ctx->dst_stride[plane_idx];
 		u8 *dst_last_line  = dst_plane+ (height  - 1 - i) * ctx->dst_stride[plane_idx];
 
-		memcpy(ctx->line_buffer_vf, src_last_line, wiB);
+		memcpy(line_buffer, src_last_line, wiB);
 		memcpy(dst_last_line, src_first_line, wiB);
-		memcpy(dst_first_line, ctx->line_buffer_vf, wiB);
+		memcpy(dst_first_line, line_buffer, wiB);
 	}
 }
 
+static void vflip_job(void *udta, u32 first, u32 last, u32 thread_idx)
+{
+	GF_VFlipCtx *ctx = (GF_VFlipCtx *) udta;
+	if (ctx->job_vertical) {
+		vertical_flip(ctx, ctx->job_src, ctx->job_dst, ctx->job_height, first, last, ctx->job_plane, ctx->job_wiB, (u8 *) ctx->line_buffer_vf + thread_idx * ctx->dst_stride[0]);
+	} else {
+		horizontal_flip(ctx, ctx->job_src, ctx->job_dst, first, last, ctx->job_plane, ctx->job_wiB, ctx->job_src_stride, (u8 *) ctx->line_buffer_hf + thread_idx * ctx->src_stride[0]);
+	}
+}
+
+//lines are processed by bands of at least 16 lines using session threads
+static void vflip_run_plane(GF_Filter *filter, GF_VFlipCtx *ctx, Bool vertical, u8 *src_plane, u8 *dst_plane, u32 height, u32 plane_idx, u32 wiB, u32 *src_stride)
+{
+	ctx->job_vertical = vertical;
+	ctx->job_src = src_plane;
+	ctx->job_dst = dst_plane;
+	ctx->job_height = height;
+	ctx->job_plane = plane_idx;
+	ctx->job_wiB = wiB;
+	ctx->job_src_stride = src_stride;
+	gf_filter_parallel_for(filter, vertical ? height/2 : height, 16, vflip_job, ctx);
+}
+
 static GF_Err vflip_process(GF_Filter *filter)
 {
 	const char *data;
@@ -328,12 +356,12 @@ static GF_Err vflip_process(GF_Filter *filter)
 
 		//processing according selected mode
 		if (ctx->mode==VFLIP_VERT){
-			vertical_flip(ctx, src_planes[i], dst_planes[i], height, i, wiB);
+			vflip_run_plane(filter, ctx, GF_TRUE, src_planes[i], dst_planes[i], height, i, wiB, ctx->src_stride);
 		}else if (ctx->mode==VFLIP_HORIZ){
-			horizontal_flip(ctx, src_planes[i], dst_planes[i], height, i, wiB, ctx->src_stride);
+			vflip_run_plane(filter, ctx, GF_FALSE, src_planes[i], dst_planes[i], height, i, wiB, ctx->src_stride);
 		}else if (ctx->mode==VFLIP_BOTH){
-			vertical_flip(ctx, src_planes[i], dst_planes[i], height, i, wiB);
-			horizontal_flip(ctx, dst_planes[i], dst_planes[i], height, i, wiB, ctx->dst_stride);
+			vflip_run_plane(filter, ctx, GF_TRUE, src_planes[i], dst_planes[i], height, i, wiB, ctx->src_stride);
+			vflip_run_plane(filter, ctx, GF_FALSE, dst_planes[i], dst_planes[i], height, i, wiB, ctx->dst_stride);
 		}
 	}
 
@@ -394,6 +422,7 @@ static GF_Err vflip_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_
 		ctx->passthrough = GF_TRUE;
 	} else {
 		Bool res;
+		u32 nb_threads;
 
 		ctx->w = w;
 		ctx->h = h;
@@ -433,8 +462,9 @@ static GF_Err vflip_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_
 
 		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[VFlip] Configured output full frame size %dx%d\n", ctx->w, ctx->h));
 
-		ctx->line_buffer_vf = gf_realloc(ctx->line_buffer_vf, sizeof(char)*ctx->dst_stride[0] );
-		ctx->line_buffer_hf = gf_realloc(ctx->line_buffer_hf, sizeof(char)*ctx->src_stride[0] );
+		nb_threads = gf_filter_parallel_max_threads(filter);
+		ctx->line_buffer_vf = gf_realloc(ctx->line_buffer_vf, sizeof(char)*ctx->dst_stride[0] * nb_threads);
+		ctx->line_buffer_hf = gf_realloc(ctx->line_buffer_hf, sizeof(char)*ctx->src_stride[0] * nb_threads);
 
 		ctx->packed_422 = GF_FALSE;
 		switch (pfmt) {
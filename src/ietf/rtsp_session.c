@@ -476,6 +476,7 @@ GF_Err gf_rtsp_check_connection(GF_RTSPSession *sess)
 				GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[SSL] Cannot connect, error %s\n", msg));
 				return GF_IP_CONNECTION_FAILURE;
 			} else if ((ret==SSL_ERROR_WANT_READ) || (ret==SSL_ERROR_WANT_WRITE)) {
+				gf_sk_set_would_block(sess->connection, (ret==SSL_ERROR_WANT_READ) ? GF_SK_SELECT_READ : GF_SK_SELECT_WRITE);
 				sess->ssl_connect_pending = 1;
 				return GF_IP_NETWORK_EMPTY;
 			} else {
@@ -735,6 +736,7 @@ static GF_Err rstp_do_write_sock(GF_RTSPSession *sess, GF_Socket *sock, const u8
 			if (len != to_write) {
 				int err = SSL_get_error(ssl_sock, len);
 				if ((err==SSL_ERROR_WANT_READ) || (err==SSL_ERROR_WANT_WRITE)) {
+					gf_sk_set_would_block(sock, (err==SSL_ERROR_WANT_READ) ? GF_SK_SELECT_READ : GF_SK_SELECT_WRITE);
 					return GF_IP_NETWORK_EMPTY;
 				}
 				if (err==SSL_ERROR_SSL) {
@@ -870,6 +872,7 @@ static GF_Err gf_rtsp_http_tunnel_setup(GF_RTSPSession *sess)
 				GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[SSL] Cannot connect, error %s\n", msg));
 				return GF_IP_CONNECTION_FAILURE;
 			} else if ((ret==SSL_ERROR_WANT_READ) || (ret==SSL_ERROR_WANT_WRITE)) {
+				gf_sk_set_would_block(sess->http, (ret==SSL_ERROR_WANT_READ) ? GF_SK_SELECT_READ : GF_SK_SELECT_WRITE);
 				sess->ssl_connect_pending = 1;
 				return GF_IP_NETWORK_EMPTY;
 			} else {
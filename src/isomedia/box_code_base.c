@@ -51,6 +51,13 @@ GF_Err co64_box_read(GF_Box *s,GF_BitStream *bs)
 		return GF_ISOM_INVALID_FILE;
 	}
 
+	//offsets are provided by the sample index cache
+	if (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_SKIP_SAMPLE_TABLES) {
+		ISOM_DECREASE_SIZE(ptr, ptr->nb_entries*8)
+		gf_bs_skip_bytes(bs, (u64) ptr->nb_entries * 8);
+		return GF_OK;
+	}
+
 	ptr->offsets = (u64 *) gf_malloc(ptr->nb_entries * sizeof(u64) );
 	if (ptr->offsets == NULL) return GF_OUT_OF_MEM;
 	ptr->alloc_size = ptr->nb_entries;
@@ -74,6 +81,8 @@ GF_Err co64_box_write(GF_Box *s, GF_BitStream *bs)
 	GF_Err e;
 	u32 i;
 	GF_ChunkLargeOffsetBox *ptr = (GF_ChunkLargeOffsetBox *) s;
+	//offsets not loaded (sample index cache)
+	if (ptr->nb_entries && !ptr->offsets) return GF_NOT_SUPPORTED;
 
 	e = gf_isom_full_box_write(s, bs);
 	if (e) return e;
@@ -5442,6 +5451,13 @@ GF_Err stco_box_read(GF_Box *s, GF_BitStream *bs)
 		return GF_ISOM_INVALID_FILE;
 	}
 
+	//offsets are provided by the sample index cache
+	if (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_SKIP_SAMPLE_TABLES) {
+		ISOM_DECREASE_SIZE(ptr, ptr->nb_entries*4)
+		gf_bs_skip_bytes(bs, (u64) ptr->nb_entries * 4);
+		return GF_OK;
+	}
+
 	if (ptr->nb_entries) {
 		ptr->offsets = (u32 *) gf_malloc(ptr->nb_entries * sizeof(u32) );
 		if (ptr->offsets == NULL) return GF_OUT_OF_MEM;
@@ -5469,6 +5485,8 @@ GF_Err stco_box_write(GF_Box *s, GF_BitStream *bs)
 	GF_Err e;
 	u32 i;
 	GF_ChunkOffsetBox *ptr = (GF_ChunkOffsetBox *)s;
+	//offsets not loaded (sample index cache)
+	if (ptr->nb_entries && !ptr->offsets) return GF_NOT_SUPPORTED;
 	e = gf_isom_full_box_write(s, bs);
 	if (e) return e;
 	gf_bs_write_u32(bs, ptr->nb_entries);
@@ -5557,6 +5575,7 @@ void stsc_box_del(GF_Box *s)
 	GF_SampleToChunkBox *ptr = (GF_SampleToChunkBox *)s;
 	if (ptr == NULL) return;
 	if (ptr->entries) gf_free(ptr->entries);
+	if (ptr->r_index) gf_free(ptr->r_index);
 	gf_free(ptr);
 }
 
@@ -5862,7 +5881,7 @@ void stsz_box_del(GF_Box *s)
 {
 	GF_SampleSizeBox *ptr = (GF_SampleSizeBox *)s;
 	if (ptr == NULL) return;
-	if (ptr->sizes) gf_free(ptr->sizes);
+	if (ptr->sizes && !ptr->sizes_mapped) gf_free(ptr->sizes);
 	gf_free(ptr);
 }
 
@@ -5918,6 +5937,12 @@ GF_Err stsz_box_read(GF_Box *s, GF_BitStream *bs)
 				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stsz\n", ptr->sampleCount));
 				return GF_ISOM_INVALID_FILE;
 			}
+			//sizes are provided by the sample index cache
+			if (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_SKIP_SAMPLE_TABLES) {
+				ISOM_DECREASE_SIZE(ptr, ptr->sampleCount*4)
+				gf_bs_skip_bytes(bs, (u64) ptr->sampleCount * 4);
+				return GF_OK;
+			}
 			ptr->sizes = (u32 *) gf_malloc(ptr->sampleCount * sizeof(u32));
 			if (! ptr->sizes) return GF_OUT_OF_MEM;
 			ptr->alloc_size = ptr->sampleCount;
@@ -6114,6 +6139,7 @@ void stts_box_del(GF_Box *s)
 {
 	GF_TimeToSampleBox *ptr = (GF_TimeToSampleBox *)s;
 	if (ptr->entries) gf_free(ptr->entries);
+	if (ptr->r_index) gf_free(ptr->r_index);
 	gf_free(ptr);
 }
 
@@ -24,6 +24,7 @@
  */
 
 #include <gpac/internal/isomedia_dev.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -1821,18 +1822,66 @@ void gf_isom_registry_disable(u32 boxCode, Bool disable)
 	}
 }
 
-static u32 get_box_reg_idx(u32 boxCode, u32 parent_type, u32 start_from)
+//box registry lookup table, indexed by (box 4CC, parent 4CC) - parent 4CC 0 gives the first registry entry for the box 4CC
+#define BOX_REG_HASH_BITS	12
+#define BOX_REG_HASH_SIZE	(1<<BOX_REG_HASH_BITS)
+
+static struct {
+	u32 box_4cc;
+	u32 parent_4cc;
+	u32 idx;
+} box_reg_hash[BOX_REG_HASH_SIZE];
+//next registry entry with the same 4CC, 0 if none
+static u16 box_reg_next[sizeof(box_registry) / sizeof(struct box_registry_entry)];
+static volatile u32 box_reg_hash_ready = 0;
+static u32 box_reg_hash_init = 0;
+
+static GFINLINE u32 box_reg_hash_slot(u32 box_4cc, u32 parent_4cc)
 {
-	u32 i=0, count = gf_isom_get_num_supported_boxes();
+	return ((box_4cc * 0x9E3779B1) ^ (parent_4cc * 0x85EBCA77)) >> (32 - BOX_REG_HASH_BITS);
+}
+
+static u32 box_reg_hash_get(u32 box_4cc, u32 parent_4cc)
+{
+	u32 i, slot = box_reg_hash_slot(box_4cc, parent_4cc);
+	for (i=0; i<BOX_REG_HASH_SIZE; i++) {
+		if (!box_reg_hash[slot].idx) return 0;
+		if ((box_reg_hash[slot].box_4cc==box_4cc) && (box_reg_hash[slot].parent_4cc==parent_4cc))
+			return box_reg_hash[slot].idx;
+		slot = (slot+1) & (BOX_REG_HASH_SIZE-1);
+	}
+	return 0;
+}
+
+static void box_reg_hash_set(u32 box_4cc, u32 parent_4cc, u32 idx)
+{
+	u32 i, slot = box_reg_hash_slot(box_4cc, parent_4cc);
+	for (i=0; i<BOX_REG_HASH_SIZE/2; i++) {
+		if (!box_reg_hash[slot].idx || ((box_reg_hash[slot].box_4cc==box_4cc) && (box_reg_hash[slot].parent_4cc==parent_4cc))) {
+			box_reg_hash[slot].box_4cc = box_4cc;
+			box_reg_hash[slot].parent_4cc = parent_4cc;
+			box_reg_hash[slot].idx = idx;
+			return;
+		}
+		slot = (slot+1) & (BOX_REG_HASH_SIZE-1);
+	}
+	//table too crowded, lookups for this key will browse the registry
+}
+
+//browse registry entries with the given 4CC
+GF_STATIC u32 box_reg_find(u32 boxCode, u32 parent_type, u32 start_from)
+{
+	u32 i;
 	if (!start_from) start_from = 1;
 
-	for (i=start_from; i<count; i++) {
+	i = box_reg_hash_get(boxCode, 0);
+	while (i && (i<start_from))
+		i = box_reg_next[i];
+
+	for (; i; i=box_reg_next[i]) {
 		u32 start_par_from;
 		char p4cc[GF_4CC_MSIZE];
 
-		if (box_registry[i].box_4cc != boxCode)
-			continue;
-
 		if ((boxCode== GF_ISOM_BOX_TYPE_MOOV) && (parent_type==GF_QT_BOX_TYPE_CMOV))
 			return i;
 
@@ -1854,7 +1903,7 @@ static u32 get_box_reg_idx(u32 boxCode, u32 parent_type, u32 start_from)
 		start_par_from = 0;
 		while (parent_type) {
 			//locate parent registry
-			u32 j = get_box_reg_idx(parent_type, 0, start_par_from);
+			u32 j = box_reg_find(parent_type, 0, start_par_from);
 			if (!j) break;
 			//if parent registry has "stsd" as parent, this is a sample entry
 			if (box_registry[j].parents_4cc && (strstr(box_registry[j].parents_4cc, "stsd") != NULL))
@@ -1865,11 +1914,58 @@ static u32 get_box_reg_idx(u32 boxCode, u32 parent_type, u32 start_from)
 	return 0;
 }
 
+static void box_reg_hash_build()
+{
+	u32 i, count = gf_isom_get_num_supported_boxes();
+
+	//chain entries with the same 4CC, in registry order
+	for (i=count-1; i>=1; i--) {
+		box_reg_next[i] = box_reg_hash_get(box_registry[i].box_4cc, 0);
+		box_reg_hash_set(box_registry[i].box_4cc, 0, i);
+	}
+	//resolve all (4CC, parent 4CC) listed in the registry
+	for (i=1; i<count; i++) {
+		const char *parents = box_registry[i].parents_4cc;
+		while (parents && parents[0]) {
+			u32 len;
+			while (parents[0]==' ') parents++;
+			len = 0;
+			while (parents[len] && (parents[len]!=' ')) len++;
+			if (len==4) {
+				u32 parent_4cc = GF_4CC(parents[0], parents[1], parents[2], parents[3]);
+				if (!box_reg_hash_get(box_registry[i].box_4cc, parent_4cc)) {
+					u32 idx = box_reg_find(box_registry[i].box_4cc, parent_4cc, 0);
+					if (idx) box_reg_hash_set(box_registry[i].box_4cc, parent_4cc, idx);
+				}
+			}
+			parents += len;
+		}
+	}
+}
+
+GF_STATIC u32 get_box_reg_idx(u32 boxCode, u32 parent_type)
+{
+	u32 idx;
+	if (!box_reg_hash_ready) {
+		if (safe_int_inc(&box_reg_hash_init) == 1) {
+			box_reg_hash_build();
+			safe_int_inc(&box_reg_hash_ready);
+		} else {
+			while (!box_reg_hash_ready)
+				gf_sleep(0);
+		}
+	}
+	idx = box_reg_hash_get(boxCode, parent_type);
+	if (idx || !parent_type) return idx;
+	//parent not listed in registry (sample entries, wildcards), browse registry entries for this 4CC
+	return box_reg_find(boxCode, parent_type, 0);
+}
+
 GF_Box *gf_isom_box_new_ex(u32 boxType, u32 parentType, Bool skip_logs, Bool is_root_box, Bool is_uuid)
 {
 	GF_Box *a;
 	const char *opt;
-	s32 idx = get_box_reg_idx(boxType, parentType, 0);
+	s32 idx = get_box_reg_idx(boxType, parentType);
 	if (idx==0) {
 #ifndef GPAC_DISABLE_LOG
 		if (!skip_logs && (boxType != GF_ISOM_BOX_TYPE_UNKNOWN) && (boxType != GF_ISOM_BOX_TYPE_UUID)) {
@@ -27,10 +27,6 @@
 #include <gpac/network.h>
 #include <gpac/thread.h>
 
-
-/*File Mapping object, read-only mode on complete files (no download)*/
-//#define GF_ISOM_DATA_FILE_MAPPING 0x02
-
 #ifndef GPAC_DISABLE_ISOM
 
 #ifdef GPAC_HAS_FD
@@ -55,11 +51,9 @@ void gf_isom_datamap_del(GF_DataMap *ptr)
 	case GF_ISOM_DATA_MEM:
 		gf_isom_fdm_del((GF_FileDataMap *)ptr);
 		break;
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		gf_isom_fmo_del((GF_FileMappingDataMap *)ptr);
 		break;
-#endif
 	default:
 		if (ptr->bs) gf_bs_del(ptr->bs);
 		gf_free(ptr);
@@ -290,10 +284,8 @@ u32 gf_isom_datamap_get_data(GF_DataMap *map, u8 *buffer, u32 bufferLength, u64
 	case GF_ISOM_DATA_MEM:
 		return gf_isom_fdm_get_data((GF_FileDataMap *)map, buffer, bufferLength, Offset, is_corrupted);
 
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		return gf_isom_fmo_get_data((GF_FileMappingDataMap *)map, buffer, bufferLength, Offset, is_corrupted);
-#endif
 
 	default:
 		return 0;
@@ -742,4 +734,132 @@ u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLengt
 #endif //win32
 #endif //file mapping disabled
 
+#if defined(GPAC_CONFIG_LINUX)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//max distance between two consecutive reads considered as sequential access (interleaved tracks)
+#define FMO_SEQ_WINDOW	(4*1024*1024)
+//number of out-of-window reads before switching the mapping to random access
+#define FMO_RAND_SWITCH	4
+//number of in-window reads before switching the mapping back to sequential access
+#define FMO_SEQ_SWITCH	32
+
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
+{
+	GF_FileMappingDataMap *tmp;
+	struct stat st;
+	void *map;
+	int fd;
+
+	//only in read only
+	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
+	if (!sPath) return NULL;
+
+	fd = open(sPath, O_RDONLY);
+	if (fd<0) return NULL;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size || ((u64) st.st_size != (u64) (size_t) st.st_size)) {
+		close(fd);
+		return NULL;
+	}
+	map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	//mapping keeps its own reference on the file
+	close(fd);
+	if (map == MAP_FAILED) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] Failed to map file %s: %s\n", sPath, strerror(errno) ));
+		return NULL;
+	}
+
+	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
+	if (!tmp) {
+		munmap(map, (size_t) st.st_size);
+		return NULL;
+	}
+	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
+	tmp->mode = mode;
+	tmp->name = gf_strdup(sPath);
+	tmp->file_size = (u64) st.st_size;
+	tmp->byte_map = (u8 *) map;
+	tmp->nb_refs = 1;
+	madvise(tmp->byte_map, (size_t) tmp->file_size, MADV_SEQUENTIAL);
+
+	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
+	return (GF_DataMap *)tmp;
+}
+
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
+{
+	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return;
+	if (safe_int_dec(&ptr->nb_refs)) return;
+
+	if (ptr->bs) gf_bs_del(ptr->bs);
+	if (ptr->byte_map) munmap(ptr->byte_map, (size_t) ptr->file_size);
+	if (ptr->name) gf_free(ptr->name);
+	gf_free(ptr);
+}
+
+//switch paging hints between read-ahead and random access depending on how samples are fetched
+static void fmo_check_access(GF_FileMappingDataMap *ptr, u64 fileOffset, u32 size)
+{
+	u64 dist = (fileOffset > ptr->byte_pos) ? fileOffset - ptr->byte_pos : ptr->byte_pos - fileOffset;
+	ptr->byte_pos = fileOffset + size;
+
+	if (dist <= FMO_SEQ_WINDOW) {
+		ptr->nb_rand = 0;
+		ptr->nb_seq++;
+		if (ptr->random_access && (ptr->nb_seq >= FMO_SEQ_SWITCH)) {
+			ptr->random_access = GF_FALSE;
+			madvise(ptr->byte_map, (size_t) ptr->file_size, MADV_SEQUENTIAL);
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] File mapping of %s switched to sequential access\n", ptr->name));
+		}
+		return;
+	}
+	ptr->nb_seq = 0;
+	ptr->nb_rand++;
+	if (!ptr->random_access && (ptr->nb_rand >= FMO_RAND_SWITCH)) {
+		ptr->random_access = GF_TRUE;
+		madvise(ptr->byte_map, (size_t) ptr->file_size, MADV_RANDOM);
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] File mapping of %s switched to random access\n", ptr->name));
+	}
+}
+
+u8 *gf_isom_fmo_get_ptr(GF_FileMappingDataMap *ptr, u64 fileOffset, u32 size)
+{
+	if (!ptr || (fileOffset + size > ptr->file_size)) return NULL;
+	fmo_check_access(ptr, fileOffset, size);
+	return ptr->byte_map + fileOffset;
+}
+
+u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset, GF_BlobRangeStatus *range_status)
+{
+	u8 *data = gf_isom_fmo_get_ptr(ptr, fileOffset, bufferLength);
+	if (range_status) *range_status = GF_BLOB_RANGE_VALID;
+	if (!data) return 0;
+	memcpy(buffer, data, bufferLength);
+	return bufferLength;
+}
+
+#else
+
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
+{
+	return NULL;
+}
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
+{
+}
+u8 *gf_isom_fmo_get_ptr(GF_FileMappingDataMap *ptr, u64 fileOffset, u32 size)
+{
+	return NULL;
+}
+u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset, GF_BlobRangeStatus *range_status)
+{
+	return 0;
+}
+
+#endif //GPAC_CONFIG_LINUX
+
 #endif /*GPAC_DISABLE_ISOM*/
@@ -1105,6 +1105,11 @@ void gf_isom_delete_movie(GF_ISOFile *mov)
 
 	//these are our two main files
 	if (mov->movieFileMap) gf_isom_datamap_del(mov->movieFileMap);
+	//release our reference on the file mapping, zero-copy users may still hold one
+	if (mov->mmap_map) gf_isom_fmo_del(mov->mmap_map);
+	if (mov->sample_index_map) gf_isom_fmo_del(mov->sample_index_map);
+	if (mov->sample_index_data) gf_free(mov->sample_index_data);
+	if (mov->sample_index_tracks) gf_free(mov->sample_index_tracks);
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	if (mov->editFileMap) {
@@ -26,6 +26,7 @@
 
 #include <gpac/internal/isomedia_dev.h>
 #include <gpac/constants.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -3254,6 +3255,8 @@ static void gf_isom_recreate_tables(GF_TrackBox *trak)
 	GF_Box *a;
 	GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
 
+	stbl_reset_lookup_index(stbl);
+
 	if (stbl->ChunkOffset) {
 		if (stbl->ChunkOffset->type==GF_ISOM_BOX_TYPE_CO64) {
 			GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
@@ -6243,7 +6246,12 @@ GF_Err gf_isom_get_chunk_info(GF_ISOFile *movie, u32 trackNumber, u32 chunk_num,
 	if (first_sample_num) *first_sample_num = nb_samples;
 	if (sample_desc_idx) *sample_desc_idx = sample_desc_index;
 	if (chunk_offset) {
-		if (stco)
+		GF_SampleTableIndex *sidx = trak->Media->information->sampleTable->sample_index;
+		if (sidx) {
+			if (nb_samples > sidx->nb_samples) return GF_ISOM_INVALID_FILE;
+			*chunk_offset = sidx->offsets[nb_samples-1];
+		}
+		else if (stco)
 			*chunk_offset = stco->offsets[chunk_num-1];
 		else
 			*chunk_offset = co64->offsets[chunk_num-1];
@@ -6500,6 +6508,523 @@ GF_Err gf_isom_set_sample_alloc(GF_ISOFile *the_file, u32 trackNumber, 	u8 *(*sa
 	return GF_OK;
 }
 
+GF_Err gf_isom_set_sample_mmap(GF_ISOFile *the_file, u32 trackNumber, u8 *(*sample_mmap)(u8 *data, u32 size, void *cbk), void *udta)
+{
+	GF_TrackBox *trak;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak) return GF_BAD_PARAM;
+	trak->sample_mmap_cbk = sample_mmap;
+	trak->sample_mmap_udta = udta;
+	return GF_OK;
+}
+
+GF_Err gf_isom_enable_mmap(GF_ISOFile *the_file, void **mmap_ref)
+{
+	GF_FileDataMap *fdm;
+	if (!the_file || !mmap_ref) return GF_BAD_PARAM;
+	*mmap_ref = NULL;
+	if (the_file->openMode != GF_ISOM_OPEN_READ) return GF_NOT_SUPPORTED;
+	if (!the_file->mmap_map) {
+		//only map regular local files, the mapping covers the file size at the time of the call
+		if (!the_file->fileName || !the_file->movieFileMap || (the_file->movieFileMap->type != GF_ISOM_DATA_FILE))
+			return GF_NOT_SUPPORTED;
+		fdm = (GF_FileDataMap *) the_file->movieFileMap;
+		if (fdm->blob || the_file->read_byte_offset || the_file->bytes_removed || strstr(the_file->fileName, "://"))
+			return GF_NOT_SUPPORTED;
+
+		the_file->mmap_map = (GF_FileMappingDataMap *) gf_isom_fmo_new(the_file->fileName, GF_ISOM_DATA_MAP_READ);
+		if (!the_file->mmap_map) return GF_NOT_SUPPORTED;
+	}
+	safe_int_inc(&the_file->mmap_map->nb_refs);
+	*mmap_ref = the_file->mmap_map;
+	return GF_OK;
+}
+
+void gf_isom_mmap_unref(void *mmap_ref)
+{
+	gf_isom_fmo_del((GF_FileMappingDataMap *) mmap_ref);
+}
+
+/*sample index cache file, stored in host byte order:
+- GF_SampleIndexHeader
+- one GF_SampleIndexTrack per track
+- for each track, 8-byte aligned tables of nb_samples entries: offsets (u64), dts (u64), sizes (u32), cts offsets (s32), durations (u32), chunk numbers (u32) and infos (u32)
+*/
+#define GSIX_VERSION	1
+#define GSIX_BYTES_PER_SAMPLE	36
+#define GSIX_TABLES_SIZE(_nb_samples)	( ( ((u64) (_nb_samples) * GSIX_BYTES_PER_SAMPLE) + 7) & ~((u64) 7) )
+
+typedef struct
+{
+	u32 magic;
+	u32 version;
+	u64 file_size;
+	u64 file_mtime;
+	u64 moov_offset;
+	u64 moov_size;
+	u8 moov_hash[GF_SHA1_DIGEST_SIZE];
+	u32 nb_tracks;
+} GF_SampleIndexHeader;
+
+typedef struct
+{
+	u32 track_id;
+	u32 nb_samples;
+	u32 max_size;
+	u32 reserved;
+	u64 total_size;
+	u64 tables_offset;
+} GF_SampleIndexTrack;
+
+GF_EXPORT
+char *gf_isom_sample_index_get_name(const char *fileName, const char *cache_dir)
+{
+	char *name;
+	char szKey[30];
+	u32 len;
+	if (!fileName) return NULL;
+	if (!cache_dir) {
+		name = gf_strdup(fileName);
+		gf_dynstrcat(&name, ".gsix", NULL);
+		return name;
+	}
+	name = gf_strdup(cache_dir);
+	len = (u32) strlen(name);
+	if (len && (name[len-1] != '/') && (name[len-1] != '\\'))
+		gf_dynstrcat(&name, "/", NULL);
+	gf_dynstrcat(&name, gf_file_basename(fileName), NULL);
+	//identify source files with the same name in different directories
+	sprintf(szKey, "_%08X.gsix", gf_crc_32((u8 *) fileName, (u32) strlen(fileName)));
+	gf_dynstrcat(&name, szKey, NULL);
+	return name;
+}
+
+//get size of movie box at the given offset and optionally its hash
+static GF_Err gsix_get_moov_info(const char *fileName, u64 moov_offset, u64 *moov_size, u8 *hash)
+{
+	u8 buf[4096];
+	u64 size, file_size;
+	FILE *f = gf_fopen(fileName, "rb");
+	if (!f) return GF_URL_ERROR;
+	file_size = gf_fsize(f);
+	if ((moov_offset + 16 > file_size) || gf_fseek(f, moov_offset, SEEK_SET) || (gf_fread(buf, 16, f) != 16)) {
+		gf_fclose(f);
+		return GF_IO_ERR;
+	}
+	size = GF_4CC(buf[0], buf[1], buf[2], buf[3]);
+	if (GF_4CC(buf[4], buf[5], buf[6], buf[7]) != GF_ISOM_BOX_TYPE_MOOV) {
+		gf_fclose(f);
+		return GF_CORRUPTED_DATA;
+	}
+	if (size==1) {
+		size = ((u64) GF_4CC(buf[8], buf[9], buf[10], buf[11])) << 32;
+		size |= GF_4CC(buf[12], buf[13], buf[14], buf[15]);
+	} else if (!size) {
+		size = file_size - moov_offset;
+	}
+	if (size > file_size - moov_offset) {
+		gf_fclose(f);
+		return GF_CORRUPTED_DATA;
+	}
+	*moov_size = size;
+	if (hash) {
+		GF_SHA1Context *ctx = gf_sha1_starts();
+		gf_fseek(f, moov_offset, SEEK_SET);
+		while (size) {
+			u32 to_read = (size > sizeof(buf)) ? (u32) sizeof(buf) : (u32) size;
+			if (gf_fread(buf, to_read, f) != to_read) break;
+			gf_sha1_update(ctx, buf, to_read);
+			size -= to_read;
+		}
+		gf_sha1_finish(ctx, hash);
+		if (size) {
+			gf_fclose(f);
+			return GF_IO_ERR;
+		}
+	}
+	gf_fclose(f);
+	return GF_OK;
+}
+
+//load cache file, mapping it if possible
+static GF_Err gsix_load(const char *idx_file, GF_FileMappingDataMap **map, u8 **data, const u8 **base, u64 *size)
+{
+	GF_Err e;
+	u32 data_size;
+	GF_DataMap *dmap;
+
+	*map = NULL;
+	*data = NULL;
+	if (!gf_file_exists(idx_file)) return GF_NOT_FOUND;
+
+	dmap = gf_isom_fmo_new(idx_file, GF_ISOM_DATA_MAP_READ);
+	if (dmap && (dmap->type == GF_ISOM_DATA_FILE_MAPPING)) {
+		*map = (GF_FileMappingDataMap *) dmap;
+		*base = (*map)->byte_map;
+		*size = (*map)->file_size;
+		return GF_OK;
+	}
+	if (dmap) gf_isom_datamap_del(dmap);
+
+	e = gf_file_load_data(idx_file, data, &data_size);
+	if (e) return e;
+	*base = *data;
+	*size = data_size;
+	return GF_OK;
+}
+
+//check cache header against the source file
+static GF_Err gsix_check_header(const char *fileName, const u8 *base, u64 size)
+{
+	GF_Err e;
+	u32 i;
+	u64 file_size, moov_size, tables_end;
+	FILE *f;
+	GF_SampleIndexHeader *hdr = (GF_SampleIndexHeader *) base;
+	GF_SampleIndexTrack *trk = (GF_SampleIndexTrack *) (base + sizeof(GF_SampleIndexHeader));
+
+	if (size < sizeof(GF_SampleIndexHeader)) return GF_CORRUPTED_DATA;
+	//magic also catches caches written with another byte order
+	if ((hdr->magic != GF_4CC('G','S','I','X')) || (hdr->version != GSIX_VERSION)) return GF_CORRUPTED_DATA;
+	tables_end = sizeof(GF_SampleIndexHeader) + (u64) hdr->nb_tracks * sizeof(GF_SampleIndexTrack);
+	if (tables_end > size) return GF_CORRUPTED_DATA;
+	for (i=0; i<hdr->nb_tracks; i++) {
+		if ((trk[i].tables_offset % 8) || (trk[i].tables_offset < tables_end)) return GF_CORRUPTED_DATA;
+		if (trk[i].tables_offset + GSIX_TABLES_SIZE(trk[i].nb_samples) > size) return GF_CORRUPTED_DATA;
+	}
+
+	f = gf_fopen(fileName, "rb");
+	if (!f) return GF_URL_ERROR;
+	file_size = gf_fsize(f);
+	gf_fclose(f);
+	if ((file_size != hdr->file_size) || (gf_file_modification_time(fileName) != hdr->file_mtime)) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Sample index cache outdated for %s\n", fileName));
+		return GF_CORRUPTED_DATA;
+	}
+	e = gsix_get_moov_info(fileName, hdr->moov_offset, &moov_size, NULL);
+	if (e) return (e==GF_IO_ERR) ? GF_CORRUPTED_DATA : e;
+	if (moov_size != hdr->moov_size) return GF_CORRUPTED_DATA;
+	return GF_OK;
+}
+
+//get cached properties of a sample
+static GF_Err gsix_get_sample(GF_TrackBox *trak, u32 sampleNumber, GF_ISOSample *samp, u64 *offset, u32 *chunk, u32 *info)
+{
+	GF_Err e;
+	u32 di;
+	e = stbl_GetSampleInfos(trak->Media->information->sampleTable, sampleNumber, offset, chunk, &di, NULL);
+	if (e) return e;
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, &di, GF_TRUE, NULL, GF_FALSE);
+	if (e) return e;
+	*info = (di & 0xFFFF) | ( ((u32) samp->IsRAP & 0xFF) << 16);
+	return GF_OK;
+}
+
+static Bool gsix_can_index(GF_ISOFile *movie)
+{
+	if (!movie || !movie->moov || !movie->fileName) return GF_FALSE;
+	if ((movie->openMode != GF_ISOM_OPEN_READ) || strstr(movie->fileName, "://")) return GF_FALSE;
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+	if (movie->moov->mvex) return GF_FALSE;
+#endif
+	if (movie->moov->compressed_diff || movie->read_byte_offset || movie->bytes_removed) return GF_FALSE;
+	return GF_TRUE;
+}
+
+GF_EXPORT
+GF_Err gf_isom_sample_index_build(GF_ISOFile *movie, const char *idx_file)
+{
+	GF_Err e = GF_OK;
+	u32 i, nb_tracks;
+	u64 pos;
+	FILE *f;
+	char *tmp_name;
+	GF_ISOSample *samp;
+	GF_SampleIndexHeader hdr;
+	GF_SampleIndexTrack *trks;
+
+	if (!idx_file) return GF_BAD_PARAM;
+	if (!gsix_can_index(movie)) return GF_NOT_SUPPORTED;
+
+	memset(&hdr, 0, sizeof(GF_SampleIndexHeader));
+	hdr.magic = GF_4CC('G','S','I','X');
+	hdr.version = GSIX_VERSION;
+	f = gf_fopen(movie->fileName, "rb");
+	if (!f) return GF_URL_ERROR;
+	hdr.file_size = gf_fsize(f);
+	gf_fclose(f);
+	hdr.file_mtime = gf_file_modification_time(movie->fileName);
+	hdr.moov_offset = movie->original_moov_offset;
+	e = gsix_get_moov_info(movie->fileName, hdr.moov_offset, &hdr.moov_size, hdr.moov_hash);
+	if (e) return e;
+
+	nb_tracks = hdr.nb_tracks = gf_list_count(movie->moov->trackList);
+	trks = gf_malloc(sizeof(GF_SampleIndexTrack) * (nb_tracks ? nb_tracks : 1));
+	if (!trks) return GF_OUT_OF_MEM;
+	memset(trks, 0, sizeof(GF_SampleIndexTrack) * nb_tracks);
+	samp = gf_isom_sample_new();
+
+	//write to a temp file and rename it once done, so that concurrent readers never see a partial cache
+	tmp_name = gf_strdup(idx_file);
+	gf_dynstrcat(&tmp_name, ".tmp", NULL);
+	f = gf_fopen(tmp_name, "wb");
+	if (!f) {
+		e = GF_IO_ERR;
+		goto exit;
+	}
+	pos = sizeof(GF_SampleIndexHeader) + nb_tracks * sizeof(GF_SampleIndexTrack);
+	for (i=0; i<nb_tracks; i++) {
+		GF_TrackBox *trak = gf_list_get(movie->moov->trackList, i);
+		GF_SampleSizeBox *stsz = trak->Media->information->sampleTable->SampleSize;
+		trks[i].track_id = trak->Header->trackID;
+		trks[i].nb_samples = stsz ? stsz->sampleCount : 0;
+		trks[i].tables_offset = pos;
+		pos += GSIX_TABLES_SIZE(trks[i].nb_samples);
+	}
+	gf_fwrite(&hdr, sizeof(GF_SampleIndexHeader), f);
+	if (nb_tracks) gf_fwrite(trks, sizeof(GF_SampleIndexTrack) * nb_tracks, f);
+
+	for (i=0; i<nb_tracks; i++) {
+		u32 j, nb_samples = trks[i].nb_samples;
+		u32 pack_num_samples;
+		u64 *offsets, *dts;
+		u32 *sizes, *durations, *chunks, *infos;
+		s32 *cts_offsets;
+		u8 pad[8];
+		GF_TrackBox *trak = gf_list_get(movie->moov->trackList, i);
+		if (!nb_samples) continue;
+
+		offsets = gf_malloc((size_t) GSIX_TABLES_SIZE(nb_samples));
+		if (!offsets) {
+			e = GF_OUT_OF_MEM;
+			break;
+		}
+		dts = offsets + nb_samples;
+		sizes = (u32 *) (dts + nb_samples);
+		cts_offsets = (s32 *) (sizes + nb_samples);
+		durations = (u32 *) (cts_offsets + nb_samples);
+		chunks = durations + nb_samples;
+		infos = chunks + nb_samples;
+
+		//cache individual samples, not packed ones
+		pack_num_samples = trak->pack_num_samples;
+		trak->pack_num_samples = 0;
+		for (j=0; j<nb_samples; j++) {
+			e = gsix_get_sample(trak, j+1, samp, &offsets[j], &chunks[j], &infos[j]);
+			if (e) break;
+			dts[j] = samp->DTS;
+			sizes[j] = samp->dataLength;
+			cts_offsets[j] = samp->CTS_Offset;
+			durations[j] = samp->duration;
+			if (trks[i].max_size < samp->dataLength) trks[i].max_size = samp->dataLength;
+			trks[i].total_size += samp->dataLength;
+		}
+		trak->pack_num_samples = pack_num_samples;
+		if (!e) {
+			u32 tables_size = (u32) ( (u64) nb_samples * GSIX_BYTES_PER_SAMPLE);
+			if (gf_fwrite(offsets, tables_size, f) != tables_size) e = GF_IO_ERR;
+			memset(pad, 0, 8);
+			if (GSIX_TABLES_SIZE(nb_samples) > tables_size)
+				gf_fwrite(pad, (u32) (GSIX_TABLES_SIZE(nb_samples) - tables_size), f);
+		}
+		gf_free(offsets);
+		if (e) break;
+	}
+	//rewrite track headers with sample stats
+	if (!e && nb_tracks) {
+		gf_fseek(f, sizeof(GF_SampleIndexHeader), SEEK_SET);
+		gf_fwrite(trks, sizeof(GF_SampleIndexTrack) * nb_tracks, f);
+	}
+	gf_fclose(f);
+
+	if (!e) e = gf_file_move(tmp_name, idx_file);
+	if (e) {
+		gf_file_delete(tmp_name);
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] Failed to build sample index cache %s: %s\n", idx_file, gf_error_to_string(e) ));
+	} else {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Built sample index cache %s for %s\n", idx_file, movie->fileName));
+	}
+
+exit:
+	gf_free(tmp_name);
+	gf_free(trks);
+	gf_isom_sample_del(&samp);
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_isom_sample_index_check(const char *fileName, const char *idx_file, Bool full_check)
+{
+	GF_Err e;
+	u32 i;
+	u64 size, moov_size;
+	u8 *data;
+	const u8 *base = NULL;
+	u8 hash[GF_SHA1_DIGEST_SIZE];
+	GF_FileMappingDataMap *map;
+	GF_ISOFile *movie = NULL;
+	GF_ISOSample *samp = NULL;
+	GF_SampleIndexHeader *hdr;
+	GF_SampleIndexTrack *trk;
+
+	if (!fileName || !idx_file) return GF_BAD_PARAM;
+	e = gsix_load(idx_file, &map, &data, &base, &size);
+	if (e) return e;
+
+	e = gsix_check_header(fileName, base, size);
+	if (e || !full_check) goto exit;
+
+	hdr = (GF_SampleIndexHeader *) base;
+	trk = (GF_SampleIndexTrack *) (base + sizeof(GF_SampleIndexHeader));
+	e = gsix_get_moov_info(fileName, hdr->moov_offset, &moov_size, hash);
+	if (e) goto exit;
+	if (memcmp(hash, hdr->moov_hash, GF_SHA1_DIGEST_SIZE)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] Sample index cache %s: movie box hash mismatch\n", idx_file));
+		e = GF_CORRUPTED_DATA;
+		goto exit;
+	}
+
+	movie = gf_isom_open(fileName, GF_ISOM_OPEN_READ, NULL);
+	if (!movie) {
+		e = gf_isom_last_error(NULL);
+		goto exit;
+	}
+	if (!gsix_can_index(movie) || (movie->original_moov_offset != hdr->moov_offset) || (gf_list_count(movie->moov->trackList) != hdr->nb_tracks)) {
+		e = GF_CORRUPTED_DATA;
+		goto exit;
+	}
+	samp = gf_isom_sample_new();
+	for (i=0; i<hdr->nb_tracks; i++) {
+		u32 j, nb_samples = trk[i].nb_samples;
+		const u8 *tables = base + trk[i].tables_offset;
+		const u64 *offsets = (const u64 *) tables;
+		const u64 *dts = offsets + nb_samples;
+		const u32 *sizes = (const u32 *) (dts + nb_samples);
+		const s32 *cts_offsets = (const s32 *) (sizes + nb_samples);
+		const u32 *durations = (const u32 *) (cts_offsets + nb_samples);
+		const u32 *chunks = durations + nb_samples;
+		const u32 *infos = chunks + nb_samples;
+		GF_TrackBox *trak = gf_list_get(movie->moov->trackList, i);
+		GF_SampleSizeBox *stsz = trak->Media->information->sampleTable->SampleSize;
+
+		if ((trak->Header->trackID != trk[i].track_id) || ((stsz ? stsz->sampleCount : 0) != nb_samples)) {
+			e = GF_CORRUPTED_DATA;
+			goto exit;
+		}
+		for (j=0; j<nb_samples; j++) {
+			u64 offset;
+			u32 chunk, info;
+			e = gsix_get_sample(trak, j+1, samp, &offset, &chunk, &info);
+			if (e) goto exit;
+			if ((offset != offsets[j]) || (chunk != chunks[j]) || (info != infos[j])
+				|| (samp->DTS != dts[j]) || (samp->dataLength != sizes[j])
+				|| (samp->CTS_Offset != cts_offsets[j]) || (samp->duration != durations[j])
+			) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] Sample index cache %s: mismatch for track %d sample %d\n", idx_file, trk[i].track_id, j+1));
+				e = GF_CORRUPTED_DATA;
+				goto exit;
+			}
+		}
+	}
+
+exit:
+	if (samp) gf_isom_sample_del(&samp);
+	if (movie) gf_isom_close(movie);
+	if (map) gf_isom_fmo_del(map);
+	if (data) gf_free(data);
+	return e;
+}
+
+//attach cache tables to the sample tables of a movie parsed without sample sizes and chunk offsets
+static GF_Err gsix_attach(GF_ISOFile *movie, const u8 *base)
+{
+	u32 i, j, nb_tracks;
+	GF_SampleIndexHeader *hdr = (GF_SampleIndexHeader *) base;
+	GF_SampleIndexTrack *trk = (GF_SampleIndexTrack *) (base + sizeof(GF_SampleIndexHeader));
+
+	if (!gsix_can_index(movie)) return GF_NOT_SUPPORTED;
+	if (movie->original_moov_offset != hdr->moov_offset) return GF_CORRUPTED_DATA;
+
+	nb_tracks = gf_list_count(movie->moov->trackList);
+	if (nb_tracks != hdr->nb_tracks) return GF_CORRUPTED_DATA;
+	movie->sample_index_tracks = gf_malloc(sizeof(GF_SampleTableIndex) * (nb_tracks ? nb_tracks : 1));
+	if (!movie->sample_index_tracks) return GF_OUT_OF_MEM;
+
+	for (i=0; i<nb_tracks; i++) {
+		const u8 *tables;
+		u32 nb_samples;
+		GF_SampleTableIndex *sidx = &movie->sample_index_tracks[i];
+		GF_TrackBox *trak = gf_list_get(movie->moov->trackList, i);
+		GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
+		GF_SampleSizeBox *stsz = stbl->SampleSize;
+
+		for (j=0; j<hdr->nb_tracks; j++) {
+			if (trk[j].track_id == trak->Header->trackID) break;
+		}
+		if ((j==hdr->nb_tracks) || !stsz || (stsz->sampleCount != trk[j].nb_samples))
+			return GF_CORRUPTED_DATA;
+
+		nb_samples = trk[j].nb_samples;
+		tables = base + trk[j].tables_offset;
+		sidx->nb_samples = nb_samples;
+		sidx->offsets = (const u64 *) tables;
+		sidx->dts = sidx->offsets + nb_samples;
+		sidx->sizes = (const u32 *) (sidx->dts + nb_samples);
+		sidx->cts_offsets = (const s32 *) (sidx->sizes + nb_samples);
+		sidx->durations = (const u32 *) (sidx->cts_offsets + nb_samples);
+		sidx->chunks = sidx->durations + nb_samples;
+		sidx->infos = sidx->chunks + nb_samples;
+		stbl->sample_index = sidx;
+
+		if (!stsz->sampleSize && !stsz->sizes) {
+			stsz->sizes = (u32 *) sidx->sizes;
+			stsz->sizes_mapped = GF_TRUE;
+			stsz->max_size = trk[j].max_size;
+			stsz->total_size = trk[j].total_size;
+			stsz->total_samples = nb_samples;
+		}
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_open_indexed(const char *fileName, const char *idx_file, GF_ISOFile **isom_file)
+{
+	GF_Err e;
+	u64 size, bytes_missing=0;
+	const u8 *base = NULL;
+	GF_ISOFile *movie;
+
+	if (!fileName || !idx_file || !isom_file) return GF_BAD_PARAM;
+	*isom_file = NULL;
+	if (strstr(fileName, "://")) return GF_NOT_SUPPORTED;
+
+	movie = gf_isom_new_movie();
+	if (!movie) return GF_OUT_OF_MEM;
+	movie->fileName = gf_strdup(fileName);
+	movie->openMode = GF_ISOM_OPEN_READ;
+
+	e = gsix_load(idx_file, &movie->sample_index_map, &movie->sample_index_data, &base, &size);
+	if (!e) e = gsix_check_header(fileName, base, size);
+	if (!e) e = gf_isom_datamap_new(fileName, NULL, GF_ISOM_DATA_MAP_READ, &movie->movieFileMap);
+	if (!e) {
+		//sample sizes and chunk offsets are not loaded
+		gf_bs_set_cookie(movie->movieFileMap->bs, GF_ISOM_BS_COOKIE_SKIP_SAMPLE_TABLES);
+		e = gf_isom_parse_movie_boxes(movie, NULL, &bytes_missing, GF_TRUE);
+		gf_bs_set_cookie(movie->movieFileMap->bs, 0);
+		if ((e==GF_ISOM_INCOMPLETE_FILE) && movie->moov) e = GF_OK;
+	}
+	if (!e) e = gsix_attach(movie, base);
+	if (e) {
+		GF_LOG((e==GF_NOT_FOUND) ? GF_LOG_DEBUG : GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Cannot use sample index cache %s: %s\n", idx_file, gf_error_to_string(e) ));
+		gf_isom_delete_movie(movie);
+		return e;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[IsoMedia] Opened %s using sample index cache %s\n", fileName, idx_file));
+	*isom_file = movie;
+	return GF_OK;
+}
+
 s32 gf_isom_get_min_negative_cts_offset(GF_ISOFile *the_file, u32 trackNumber, GF_ISOMMinNegCtsQuery query_mode)
 {
 	GF_TrackBox *trak;
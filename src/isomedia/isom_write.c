@@ -1297,6 +1297,7 @@ static GF_Err gf_isom_set_last_sample_duration_internal(GF_ISOFile *movie, u32 t
 	mdur = trak->Media->mediaHeader->duration;
 	stts = trak->Media->information->sampleTable->TimeToSample;
 	if (!stts->nb_entries) return GF_BAD_PARAM;
+	stts->r_index_count = 0;
 
 	if (is_patch) {
 		u32 i, avg_dur, nb_samp=0;
@@ -5158,6 +5159,7 @@ GF_Err gf_isom_set_media_timescale(GF_ISOFile *the_file, u32 trackNumber, u32 ne
 		u32 i;
 		if (!stbl->TimeToSample || !stbl->TimeToSample->nb_entries)
 			return GF_BAD_PARAM;
+		stbl->TimeToSample->r_index_count = 0;
 
 		for (i=0; i<stbl->TimeToSample->nb_entries; i++) {
 			if (!old_ts_inc)
@@ -5247,6 +5249,7 @@ GF_Err gf_isom_set_media_timescale(GF_ISOFile *the_file, u32 trackNumber, u32 ne
 	if (! stbl || !stbl->TimeToSample || !stbl->TimeToSample->nb_entries) {
 		return SetTrackDuration(trak);
 	}
+	stbl->TimeToSample->r_index_count = 0;
 
 	idx = 0;
 	cur_dts = 0;
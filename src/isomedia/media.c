@@ -468,6 +468,42 @@ Bool Media_IsSampleSyncShadow(GF_ShadowSyncBox *stsh, u32 sampleNumber)
 	return 0;
 }
 
+//check if the sample payload is modified once fetched
+static Bool Media_SampleNeedsRewrite(GF_MediaBox *mdia, GF_SampleEntryBox *entry)
+{
+	if (mdia->handler->handlerType == GF_ISOM_MEDIA_OD) return GF_TRUE;
+	if (gf_isom_is_nalu_based_entry(mdia, entry)) return GF_TRUE;
+	if (mdia->mediaTrack->moov->mov->convert_streaming_text
+		&& ((mdia->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SCENE) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SUBT))
+		&& entry && ((entry->type == GF_ISOM_BOX_TYPE_TX3G) || (entry->type == GF_ISOM_BOX_TYPE_TEXT))
+	)
+		return GF_TRUE;
+	return GF_FALSE;
+}
+
+//get number of samples to pack starting from sampleNumber, bounded by the end of the chunk
+static u32 Media_GetPackCount(GF_MediaBox *mdia, u32 sampleNumber, GF_StscEntry *stsc_entry)
+{
+	u32 left_in_chunk;
+	GF_SampleTableIndex *sidx = mdia->information->sampleTable->sample_index;
+	if (!stsc_entry && sidx) {
+		u32 chunk = sidx->chunks[sampleNumber-1];
+		left_in_chunk = 1;
+		while ((left_in_chunk < mdia->mediaTrack->pack_num_samples)
+			&& (sampleNumber + left_in_chunk <= sidx->nb_samples)
+			&& (sidx->chunks[sampleNumber + left_in_chunk - 1] == chunk)
+		) {
+			left_in_chunk++;
+		}
+		return left_in_chunk;
+	}
+	if (!stsc_entry) return 1;
+	left_in_chunk = stsc_entry->samplesPerChunk - (sampleNumber - mdia->information->sampleTable->SampleToChunk->firstSampleInCurrentChunk);
+	if (left_in_chunk > mdia->mediaTrack->pack_num_samples)
+		left_in_chunk = mdia->mediaTrack->pack_num_samples;
+	return left_in_chunk;
+}
+
 GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sIDX, Bool no_data, u64 *out_offset, Bool ext_realloc)
 {
 	GF_Err e;
@@ -488,6 +524,28 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	//the data info
 	if (!sIDX && !no_data) return GF_BAD_PARAM;
 
+	//sample index cache, all info is directly available
+	if (mdia->information->sampleTable->sample_index) {
+		GF_SampleTableIndex *sidx = mdia->information->sampleTable->sample_index;
+		u32 info;
+		if (sampleNumber > sidx->nb_samples) return GF_BAD_PARAM;
+		offset = sidx->offsets[sampleNumber-1];
+		info = sidx->infos[sampleNumber-1];
+		sdesc_idx = info & 0xFFFF;
+		data_size = sidx->sizes[sampleNumber-1];
+		stsc_entry = NULL;
+		if (sIDX) (*sIDX) = sdesc_idx;
+		if (out_offset) *out_offset = offset;
+		if (!samp ) return GF_OK;
+
+		(*samp)->corrupted = 0;
+		(*samp)->DTS = sidx->dts[sampleNumber-1];
+		(*samp)->duration = sidx->durations[sampleNumber-1];
+		(*samp)->CTS_Offset = sidx->cts_offsets[sampleNumber-1];
+		(*samp)->IsRAP = (GF_ISOSAPType) (s8) ((info>>16) & 0xFF);
+		goto sample_info_done;
+	}
+
 	e = stbl_GetSampleInfos(mdia->information->sampleTable, sampleNumber, &offset, &chunkNumber, &sdesc_idx, &stsc_entry);
 	if (e) return e;
 	if (sIDX) (*sIDX) = sdesc_idx;
@@ -540,6 +598,7 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	/*get sync shadow*/
 	if (Media_IsSampleSyncShadow(mdia->information->sampleTable->ShadowSync, sampleNumber)) (*samp)->IsRAP = RAP_REDUNDANT;
 
+sample_info_done:
 	//the data info
 	if (!sIDX && !no_data) return GF_BAD_PARAM;
 //	if (!sIDX && !out_offset) return GF_OK;
@@ -565,10 +624,7 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	if (no_data) {
 		(*samp)->dataLength = data_size;
 		if ( ((*samp)->dataLength != 0) && mdia->mediaTrack->pack_num_samples) {
-			u32 idx_in_chunk = sampleNumber - mdia->information->sampleTable->SampleToChunk->firstSampleInCurrentChunk;
-			u32 left_in_chunk = stsc_entry->samplesPerChunk - idx_in_chunk;
-			if (left_in_chunk > mdia->mediaTrack->pack_num_samples)
-				left_in_chunk = mdia->mediaTrack->pack_num_samples;
+			u32 left_in_chunk = Media_GetPackCount(mdia, sampleNumber, stsc_entry);
 			(*samp)->dataLength *= left_in_chunk;
 			(*samp)->nb_pack = left_in_chunk;
 		}
@@ -581,12 +637,12 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	if (mdia->mediaTrack->moov->mov->openMode == GF_ISOM_OPEN_READ) {
 		//same as last call in read mode
 		if (!mdia->information->dataHandler) {
-			e = gf_isom_datamap_open(mdia, dataRefIndex, stsc_entry->isEdited);
+			e = gf_isom_datamap_open(mdia, dataRefIndex, stsc_entry ? stsc_entry->isEdited : 0);
 			if (e) return e;
 		}
 		mdia->information->dataEntryIndex = dataRefIndex;
 	} else {
-		e = gf_isom_datamap_open(mdia, dataRefIndex, stsc_entry->isEdited);
+		e = gf_isom_datamap_open(mdia, dataRefIndex, stsc_entry ? stsc_entry->isEdited : 0);
 		if (e) return e;
 	}
 
@@ -608,17 +664,38 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 
 	if (data_size != 0) {
 		GF_BlobRangeStatus range_status;
+		GF_ISOFile *mov = mdia->mediaTrack->moov->mov;
+		GF_FileMappingDataMap *fmo = NULL;
 		if (mdia->mediaTrack->pack_num_samples) {
-			u32 idx_in_chunk = sampleNumber - mdia->information->sampleTable->SampleToChunk->firstSampleInCurrentChunk;
-			u32 left_in_chunk = stsc_entry->samplesPerChunk - idx_in_chunk;
-			if (left_in_chunk > mdia->mediaTrack->pack_num_samples)
-				left_in_chunk = mdia->mediaTrack->pack_num_samples;
+			u32 left_in_chunk = Media_GetPackCount(mdia, sampleNumber, stsc_entry);
 			data_size *= left_in_chunk;
 			(*samp)->nb_pack = left_in_chunk;
 		}
+		if (mov->mmap_map) {
+			//sample data still pointing to the mapping from a previous call, never write to it
+			if ((*samp)->data && ((*samp)->data >= mov->mmap_map->byte_map) && ((*samp)->data < mov->mmap_map->byte_map + mov->mmap_map->file_size))
+				(*samp)->data = NULL;
+
+			if ((mdia->information->dataHandler == mov->movieFileMap) && !mov->read_byte_offset && !mov->bytes_removed)
+				fmo = mov->mmap_map;
+		}
 		if (! (*samp)->data)
 			(*samp)->alloc_size = 0;
 
+		//payload not modified after fetch, let the caller reference the mapped data
+		if (fmo && ext_realloc && mdia->mediaTrack->sample_mmap_cbk && !mdia->mediaTrack->padding_bytes && !Media_SampleNeedsRewrite(mdia, entry)) {
+			u8 *mapped = gf_isom_fmo_get_ptr(fmo, offset, data_size);
+			if (mapped)
+				mapped = mdia->mediaTrack->sample_mmap_cbk(mapped, data_size, mdia->mediaTrack->sample_mmap_udta);
+			if (mapped) {
+				(*samp)->data = mapped;
+				(*samp)->dataLength = data_size;
+				(*samp)->alloc_size = 0;
+				mdia->BytesMissing = 0;
+				return GF_OK;
+			}
+		}
+
 		/*and finally get the data, include padding if needed*/
 		if ((*samp)->alloc_size) {
 			if ((*samp)->alloc_size < data_size + mdia->mediaTrack->padding_bytes) {
@@ -649,7 +726,11 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 				return GF_ISOM_INCOMPLETE_FILE;
 			}
 		}
-		bytesRead = gf_isom_datamap_get_data(mdia->information->dataHandler, (*samp)->data, (*samp)->dataLength, offset, &range_status);
+		bytesRead = 0;
+		if (fmo)
+			bytesRead = gf_isom_fmo_get_data(fmo, (*samp)->data, (*samp)->dataLength, offset, &range_status);
+		if (!bytesRead)
+			bytesRead = gf_isom_datamap_get_data(mdia->information->dataHandler, (*samp)->data, (*samp)->dataLength, offset, &range_status);
 		//if bytesRead != sampleSize, we have an IO err
 		if (bytesRead < data_size) {
 			if (range_status == GF_BLOB_RANGE_IN_TRANSFER) {
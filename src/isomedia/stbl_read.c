@@ -27,10 +27,64 @@
 
 #ifndef GPAC_DISABLE_ISOM
 
+//max number of entries walked from the read cache before using the lookup index
+#define STBL_MAX_LINEAR_SCAN	8
+
+//extend the stts lookup index to all entries - entries other than the last one are assumed unchanged since last call
+static Bool stts_update_index(GF_TimeToSampleBox *stts)
+{
+	u32 i;
+	if (!stts->nb_entries) return GF_FALSE;
+	if (stts->r_index_count > stts->nb_entries) stts->r_index_count = 0;
+	else if (stts->r_index_count == stts->nb_entries) return GF_TRUE;
+
+	if (stts->r_index_alloc < stts->nb_entries) {
+		u32 size = MAX(stts->alloc_size, stts->nb_entries);
+		GF_SttsIndexEntry *index = gf_realloc(stts->r_index, sizeof(GF_SttsIndexEntry) * size);
+		if (!index) return GF_FALSE;
+		stts->r_index = index;
+		stts->r_index_alloc = size;
+	}
+	i = stts->r_index_count;
+	if (!i) {
+		stts->r_index[0].first_sample = 1;
+		stts->r_index[0].dts = 0;
+		i = 1;
+	}
+	for (; i<stts->nb_entries; i++) {
+		GF_SttsEntry *ent = &stts->entries[i-1];
+		u64 first_sample = (u64) stts->r_index[i-1].first_sample + ent->sampleCount;
+		//broken table, only index what we can address
+		if (first_sample > 0xFFFFFFFFUL) break;
+		stts->r_index[i].first_sample = (u32) first_sample;
+		stts->r_index[i].dts = stts->r_index[i-1].dts + (u64) ent->sampleCount * ent->sampleDelta;
+	}
+	stts->r_index_count = i;
+	return GF_TRUE;
+}
+
+//get the last entry starting at or before the given sample, or if SampleNumber is 0 the last entry starting strictly before the given DTS
+static u32 stts_find_entry(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 DTS)
+{
+	u32 low, high;
+	if (!stts_update_index(stts)) return 0;
+	low = 0;
+	high = stts->r_index_count;
+	while (low + 1 < high) {
+		u32 mid = (low + high) / 2;
+		if (SampleNumber ? (stts->r_index[mid].first_sample <= SampleNumber) : (stts->r_index[mid].dts < DTS))
+			low = mid;
+		else
+			high = mid;
+	}
+	return low;
+}
+
 //Get the sample number
 GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *sampleNumber, u32 *prevSampleNumber)
 {
 	u32 i, j, curSampNum, count;
+	s32 nb_scan;
 	s32 CTSOffset;
 	u64 curDTS;
 	GF_SttsEntry *ent;
@@ -86,6 +140,7 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 
 	//look for the DTS from this entry
 	count = stbl->TimeToSample->nb_entries;
+	nb_scan = STBL_MAX_LINEAR_SCAN;
 	for (; i<count; i++) {
 		ent = &stbl->TimeToSample->entries[i];
 #if 0
@@ -96,12 +151,29 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 		{
 			CTSOffset = 0;
 		}
-		for (j=0; j<ent->sampleCount; j++) {
-			if (curDTS + CTSOffset >= DTS) goto entry_found;
-			curSampNum += 1;
-			curDTS += ent->sampleDelta;
+		if (curDTS + CTSOffset >= DTS) goto entry_found;
+		if (ent->sampleDelta) {
+			j = (u32) ((DTS - curDTS + ent->sampleDelta - 1) / ent->sampleDelta);
+			if (j < ent->sampleCount) {
+				curSampNum += j;
+				curDTS += (u64) j * ent->sampleDelta;
+				goto entry_found;
+			}
+		}
+		//too far from our cache, jump to the entry using the lookup index
+		if (!nb_scan--) {
+			j = stts_find_entry(stbl->TimeToSample, 0, DTS);
+			if (j > i+1) {
+				stbl->TimeToSample->r_currentEntryIndex = j;
+				curSampNum = stbl->TimeToSample->r_FirstSampleInEntry = stbl->TimeToSample->r_index[j].first_sample;
+				curDTS = stbl->TimeToSample->r_CurrentDTS = stbl->TimeToSample->r_index[j].dts;
+				i = j-1;
+				continue;
+			}
 		}
 		//we're switching to the next entry, update the cache!
+		curSampNum += ent->sampleCount;
+		curDTS += (u64) ent->sampleCount * ent->sampleDelta;
 		stbl->TimeToSample->r_CurrentDTS += (u64)ent->sampleCount * ent->sampleDelta;
 		stbl->TimeToSample->r_currentEntryIndex += 1;
 		stbl->TimeToSample->r_FirstSampleInEntry += ent->sampleCount;
@@ -180,6 +252,7 @@ GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *C
 GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber, u64 *DTS, u32 *duration)
 {
 	u32 i, j, count;
+	s32 nb_scan;
 	GF_SttsEntry *ent;
 
 	(*DTS) = 0;
@@ -203,6 +276,7 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 		stts->r_CurrentDTS = 0;
 	}
 
+	nb_scan = STBL_MAX_LINEAR_SCAN;
 	for (; i < count; i++) {
 		ent = &stts->entries[i];
 
@@ -211,6 +285,17 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 			j = SampleNumber - stts->r_FirstSampleInEntry;
 			goto found;
 		}
+		//too far from our cache, jump to the entry using the lookup index
+		if (!nb_scan--) {
+			j = stts_find_entry(stts, SampleNumber, 0);
+			if (j > i+1) {
+				stts->r_currentEntryIndex = j;
+				stts->r_FirstSampleInEntry = stts->r_index[j].first_sample;
+				stts->r_CurrentDTS = stts->r_index[j].dts;
+				i = j-1;
+				continue;
+			}
+		}
 
 		//update our cache
 		stts->r_CurrentDTS += (u64)ent->sampleCount * ent->sampleDelta;
@@ -396,11 +481,83 @@ void GetGhostNum(GF_StscEntry *ent, u32 EntryIndex, u32 count, GF_SampleTableBox
 	stbl->SampleToChunk->ghostNumber = ghostNum;
 }
 
+//extend the stsc lookup index to all entries - entries other than the last one are assumed unchanged since last call
+static Bool stsc_update_index(GF_SampleTableBox *stbl)
+{
+	u32 i;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+	if (!stsc->nb_entries) return GF_FALSE;
+	if (stsc->r_index_count > stsc->nb_entries) stsc->r_index_count = 0;
+	else if (stsc->r_index_count == stsc->nb_entries) return GF_TRUE;
+
+	if (stsc->r_index_alloc < stsc->nb_entries) {
+		u32 size = MAX(stsc->alloc_size, stsc->nb_entries);
+		u32 *index = gf_realloc(stsc->r_index, sizeof(u32) * size);
+		if (!index) return GF_FALSE;
+		stsc->r_index = index;
+		stsc->r_index_alloc = size;
+	}
+	i = stsc->r_index_count;
+	if (!i) {
+		stsc->r_index[0] = 1;
+		i = 1;
+	}
+	for (; i<stsc->nb_entries; i++) {
+		GF_StscEntry *ent = &stsc->entries[i-1];
+		u64 first_sample;
+		//not the last entry, ghost number does not depend on chunk offsets
+		GetGhostNum(ent, i-1, stsc->nb_entries, stbl);
+		first_sample = (u64) stsc->r_index[i-1] + (u64) stsc->ghostNumber * ent->samplesPerChunk;
+		//broken table, only index what we can address
+		if (first_sample > 0xFFFFFFFFUL) break;
+		stsc->r_index[i] = (u32) first_sample;
+	}
+	stsc->r_index_count = i;
+	return GF_TRUE;
+}
+
+//get the last entry starting at or before the given sample
+static u32 stsc_find_entry(GF_SampleTableBox *stbl, u32 sampleNumber)
+{
+	u32 low, high;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+	u32 ghost = stsc->ghostNumber;
+	Bool res = stsc_update_index(stbl);
+	//restore ghost number of current entry
+	stsc->ghostNumber = ghost;
+	if (!res) return 0;
+	low = 0;
+	high = stsc->r_index_count;
+	while (low + 1 < high) {
+		u32 mid = (low + high) / 2;
+		if (stsc->r_index[mid] <= sampleNumber)
+			low = mid;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+void stbl_reset_lookup_index(GF_SampleTableBox *stbl)
+{
+	if (stbl->TimeToSample) {
+		if (stbl->TimeToSample->r_index) gf_free(stbl->TimeToSample->r_index);
+		stbl->TimeToSample->r_index = NULL;
+		stbl->TimeToSample->r_index_count = stbl->TimeToSample->r_index_alloc = 0;
+	}
+	if (stbl->SampleToChunk) {
+		if (stbl->SampleToChunk->r_index) gf_free(stbl->SampleToChunk->r_index);
+		stbl->SampleToChunk->r_index = NULL;
+		stbl->SampleToChunk->r_index_count = stbl->SampleToChunk->r_index_alloc = 0;
+	}
+}
+
 //Get the offset, descIndex and chunkNumber of a sample...
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **out_ent)
 {
 	GF_Err e;
 	u32 i, k, offsetInChunk, size, chunk_num;
+	s32 nb_scan;
 	GF_ChunkOffsetBox *stco;
 	GF_ChunkLargeOffsetBox *co64;
 	GF_StscEntry *ent;
@@ -411,6 +568,15 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 	if (!stbl || !sampleNumber) return GF_BAD_PARAM;
 	if (!stbl->ChunkOffset || !stbl->SampleToChunk || !stbl->SampleSize) return GF_ISOM_INVALID_FILE;
 
+	//sample index cache, no stsc entry available
+	if (stbl->sample_index) {
+		if (sampleNumber > stbl->sample_index->nb_samples) return GF_BAD_PARAM;
+		(*offset) = stbl->sample_index->offsets[sampleNumber-1];
+		(*chunkNumber) = stbl->sample_index->chunks[sampleNumber-1];
+		(*descIndex) = stbl->sample_index->infos[sampleNumber-1] & 0xFFFF;
+		return GF_OK;
+	}
+
 	if (stbl->SampleSize && stbl->SampleToChunk->nb_entries == stbl->SampleSize->sampleCount) {
 		ent = &stbl->SampleToChunk->entries[sampleNumber-1];
 		if (!ent) return GF_BAD_PARAM;
@@ -455,6 +621,7 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 	}
 
 	//first get the chunk
+	nb_scan = STBL_MAX_LINEAR_SCAN;
 	for (; i < stbl->SampleToChunk->nb_entries; i++) {
 		gf_assert(stbl->SampleToChunk->firstSampleInCurrentChunk <= sampleNumber);
 		//corrupted file (less sample2chunk info than sample count
@@ -484,6 +651,14 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 
 		//not in this entry, get the next entry if not the last one
 		if (i+1 != stbl->SampleToChunk->nb_entries) {
+			//too far from our cache, jump to the entry using the lookup index
+			if (!nb_scan--) {
+				u32 idx = stsc_find_entry(stbl, sampleNumber);
+				if (idx > i+1) {
+					stbl->SampleToChunk->firstSampleInCurrentChunk = stbl->SampleToChunk->r_index[idx];
+					i = idx-1;
+				}
+			}
 			ent = &stbl->SampleToChunk->entries[i+1];
 			//update the GhostNumber
 			GetGhostNum(ent, i+1, stbl->SampleToChunk->nb_entries, stbl);
@@ -533,11 +708,11 @@ sample_found:
 	//now get the chunk
 	if ( stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
 		stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
-		if (stco->nb_entries < (*chunkNumber) ) return GF_ISOM_INVALID_FILE;
+		if (!stco->offsets || (stco->nb_entries < (*chunkNumber)) ) return GF_ISOM_INVALID_FILE;
 		(*offset) = (u64) stco->offsets[(*chunkNumber) - 1] + (u64) offsetInChunk;
 	} else {
 		co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
-		if (co64->nb_entries < (*chunkNumber) ) return GF_ISOM_INVALID_FILE;
+		if (!co64->offsets || (co64->nb_entries < (*chunkNumber)) ) return GF_ISOM_INVALID_FILE;
 		(*offset) = co64->offsets[(*chunkNumber) - 1] + (u64) offsetInChunk;
 	}
 	return GF_OK;
@@ -61,6 +61,7 @@ GF_Err stbl_AddDTS(GF_SampleTableBox *stbl, u64 DTS, u32 *sampleNumber, u32 Last
 
 	//reset the reading cache when adding a sample
 	stts->r_FirstSampleInEntry = 0;
+	stts->r_index_count = 0;
 
 	*sampleNumber = 0;
 
@@ -750,6 +751,7 @@ GF_Err stbl_AddChunkOffset(GF_MediaBox *mdia, u32 sampleNumber, u32 StreamDescIn
 
 	stbl = mdia->information->sampleTable;
 	stsc = stbl->SampleToChunk;
+	stsc->r_index_count = 0;
 
 //	if (stsc->w_lastSampleNumber + 1 < sampleNumber ) return GF_BAD_PARAM;
 	CHECK_PACK(GF_BAD_PARAM)
@@ -1106,6 +1108,7 @@ GF_Err stbl_RemoveDTS(GF_SampleTableBox *stbl, u32 sampleNumber, u32 nb_samples,
 	if ((nb_samples>1) && (sampleNumber>1)) return GF_BAD_PARAM;
 
 	stts = stbl->TimeToSample;
+	stts->r_index_count = 0;
 
 	//we're removing the only sample: empty the sample table
 	if (stbl->SampleSize->sampleCount == 1) {
@@ -1220,6 +1223,7 @@ GF_Err stbl_RemoveDTS(GF_SampleTableBox *stbl, u32 sampleNumber, u32 nb_samples,
 	//reset read the cache to the beginning
 	stts->r_FirstSampleInEntry = stts->r_currentEntryIndex = 0;
 	stts->r_CurrentDTS = 0;
+	stts->r_index_count = 0;
 	return GF_OK;
 }
 
@@ -1296,6 +1300,7 @@ GF_Err stbl_RemoveChunk(GF_SampleTableBox *stbl, u32 sampleNumber, u32 nb_sample
 
 	if ((nb_samples>1) && (sampleNumber>1))
 		return GF_BAD_PARAM;
+	stsc->r_index_count = 0;
 	
 	//raw audio or constant sample size and dur
 	if (stsc->nb_entries < stbl->SampleSize->sampleCount) {
@@ -2257,6 +2262,7 @@ GF_Err stbl_SetChunkAndOffset(GF_SampleTableBox *stbl, u32 sampleNumber, u32 Str
 			//OK, it's the same SampleToChunk, so delete it
 			ent->nextChunk = cur_ent->firstChunk;
 			the_stsc->nb_entries--;
+			the_stsc->r_index_count = 0;
 		}
 	}
 
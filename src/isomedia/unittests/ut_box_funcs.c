@@ -0,0 +1,200 @@
+#include <gpac/internal/isomedia_dev.h>
+#include "tests.h"
+
+u32 get_box_reg_idx(u32 boxCode, u32 parent_type);
+
+#define UT_NB_FRAGS	50
+
+static const u32 ut_parents[] = {
+    0, GF_ISOM_BOX_TYPE_MOOV, GF_ISOM_BOX_TYPE_TRAK, GF_ISOM_BOX_TYPE_MDIA, GF_ISOM_BOX_TYPE_MINF, GF_ISOM_BOX_TYPE_STBL,
+    GF_ISOM_BOX_TYPE_STSD, GF_ISOM_BOX_TYPE_MOOF, GF_ISOM_BOX_TYPE_TRAF, GF_ISOM_BOX_TYPE_MVEX, GF_ISOM_BOX_TYPE_UDTA,
+    GF_ISOM_BOX_TYPE_META, GF_ISOM_BOX_TYPE_DINF, GF_ISOM_BOX_TYPE_SINF, GF_ISOM_BOX_TYPE_SCHI, GF_ISOM_BOX_TYPE_AVC1,
+    GF_ISOM_BOX_TYPE_MP4A, GF_ISOM_BOX_TYPE_HVC1, GF_QT_BOX_TYPE_CMOV, GF_QT_SUBTYPE_RAW, GF_4CC('f','i','l','e'), GF_4CC('a','b','c','d')
+};
+#define UT_NB_PARENTS	(sizeof(ut_parents)/sizeof(u32))
+
+//registry 4CCs and parents, as listed in the registry dump - a few boxes are dumped without their parents
+static u32 *ut_reg_4cc = NULL;
+static char **ut_reg_parents = NULL;
+#define UT_REG_UNKNOWN	0xFFFFFFFF
+
+static u32 ut_box_reg_load(u32 count)
+{
+    u32 i, size, nb_known = 0;
+    u64 *offsets;
+    u8 *data;
+    FILE *trace = gf_fopen("ut_box_reg.xml", "wb");
+    if (!trace) return 0;
+    offsets = gf_malloc(sizeof(u64) * (count+1));
+    ut_reg_4cc = gf_malloc(sizeof(u32) * count);
+    ut_reg_parents = gf_malloc(sizeof(char *) * count);
+    memset(ut_reg_parents, 0, sizeof(char *) * count);
+    for (i=1; i<count; i++) {
+        offsets[i] = gf_ftell(trace);
+        gf_isom_dump_supported_box(i, trace);
+        ut_reg_4cc[i] = gf_isom_get_supported_box_type(i);
+    }
+    offsets[count] = gf_ftell(trace);
+    gf_fclose(trace);
+    if (gf_file_load_data("ut_box_reg.xml", &data, &size) == GF_OK) {
+        for (i=1; i<count; i++) {
+            char *c, *end;
+            u8 sep = data[offsets[i+1]];
+            data[offsets[i+1]] = 0;
+            c = strstr((char *) data + offsets[i], "Container=\"");
+            end = c ? strchr(c + 11, '"') : NULL;
+            if (end) {
+                c += 11;
+                ut_reg_parents[i] = gf_malloc(end - c + 1);
+                memcpy(ut_reg_parents[i], c, end - c);
+                ut_reg_parents[i][end-c] = 0;
+                nb_known++;
+            }
+            data[offsets[i+1]] = sep;
+        }
+        gf_free(data);
+    }
+    gf_free(offsets);
+    gf_file_delete("ut_box_reg.xml");
+    return nb_known;
+}
+
+static void ut_box_reg_unload(u32 count)
+{
+    u32 i;
+    for (i=1; i<count; i++) {
+        if (ut_reg_parents[i]) gf_free(ut_reg_parents[i]);
+    }
+    gf_free(ut_reg_parents);
+    gf_free(ut_reg_4cc);
+    ut_reg_parents = NULL;
+    ut_reg_4cc = NULL;
+}
+
+//linear registry walk as done before the hash index, UT_REG_UNKNOWN if an entry with unknown parents is met
+static u32 ut_box_reg_scan(u32 box_4cc, u32 parent_4cc, u32 start_from, u32 count)
+{
+    u32 i;
+    char p4cc[GF_4CC_MSIZE];
+    if (!start_from) start_from = 1;
+    for (i=start_from; i<count; i++) {
+        u32 start_par_from;
+        if (ut_reg_4cc[i] != box_4cc) continue;
+        if ((box_4cc == GF_ISOM_BOX_TYPE_MOOV) && (parent_4cc == GF_QT_BOX_TYPE_CMOV)) return i;
+        if (!parent_4cc) return i;
+        if (!ut_reg_parents[i]) return UT_REG_UNKNOWN;
+        if (strstr(ut_reg_parents[i], gf_4cc_to_str_safe(parent_4cc, p4cc))) return i;
+        if (strstr(ut_reg_parents[i], "*")) return i;
+        if (!strstr(ut_reg_parents[i], "sample_entry")) continue;
+        if (parent_4cc == GF_QT_SUBTYPE_RAW) return i;
+        //parent is a sample entry if one of its registry entries has stsd as parent
+        start_par_from = 0;
+        while (1) {
+            u32 j = ut_box_reg_scan(parent_4cc, 0, start_par_from, count);
+            if (!j) break;
+            if (!ut_reg_parents[j]) return UT_REG_UNKNOWN;
+            if (strstr(ut_reg_parents[j], "stsd")) return i;
+            start_par_from = j+1;
+        }
+    }
+    return 0;
+}
+
+//compares hashed lookup with the registry walk, returns 1 if different
+static u32 ut_box_reg_check(u32 box_4cc, u32 parent_4cc, u32 count, u32 *nb_checks)
+{
+    u32 ref = ut_box_reg_scan(box_4cc, parent_4cc, 0, count);
+    if (ref == UT_REG_UNKNOWN) return 0;
+    (*nb_checks)++;
+    return (get_box_reg_idx(box_4cc, parent_4cc) != ref) ? 1 : 0;
+}
+
+//(box, parent) pairs met when parsing a fragmented AVC file
+static const u32 ut_parse_pairs[][2] = {
+    {GF_ISOM_BOX_TYPE_FTYP, 0}, {GF_ISOM_BOX_TYPE_MOOV, 0}, {GF_ISOM_BOX_TYPE_MVHD, GF_ISOM_BOX_TYPE_MOOV},
+    {GF_ISOM_BOX_TYPE_TRAK, GF_ISOM_BOX_TYPE_MOOV}, {GF_ISOM_BOX_TYPE_TKHD, GF_ISOM_BOX_TYPE_TRAK},
+    {GF_ISOM_BOX_TYPE_MDIA, GF_ISOM_BOX_TYPE_TRAK}, {GF_ISOM_BOX_TYPE_MDHD, GF_ISOM_BOX_TYPE_MDIA},
+    {GF_ISOM_BOX_TYPE_HDLR, GF_ISOM_BOX_TYPE_MDIA}, {GF_ISOM_BOX_TYPE_MINF, GF_ISOM_BOX_TYPE_MDIA},
+    {GF_ISOM_BOX_TYPE_VMHD, GF_ISOM_BOX_TYPE_MINF}, {GF_ISOM_BOX_TYPE_DINF, GF_ISOM_BOX_TYPE_MINF},
+    {GF_ISOM_BOX_TYPE_DREF, GF_ISOM_BOX_TYPE_DINF}, {GF_ISOM_BOX_TYPE_URL, GF_ISOM_BOX_TYPE_DREF},
+    {GF_ISOM_BOX_TYPE_STBL, GF_ISOM_BOX_TYPE_MINF}, {GF_ISOM_BOX_TYPE_STSD, GF_ISOM_BOX_TYPE_STBL},
+    {GF_ISOM_BOX_TYPE_AVC1, GF_ISOM_BOX_TYPE_STSD}, {GF_ISOM_BOX_TYPE_AVCC, GF_ISOM_BOX_TYPE_AVC1},
+    {GF_ISOM_BOX_TYPE_STTS, GF_ISOM_BOX_TYPE_STBL}, {GF_ISOM_BOX_TYPE_STSC, GF_ISOM_BOX_TYPE_STBL},
+    {GF_ISOM_BOX_TYPE_STSZ, GF_ISOM_BOX_TYPE_STBL}, {GF_ISOM_BOX_TYPE_STCO, GF_ISOM_BOX_TYPE_STBL},
+    {GF_ISOM_BOX_TYPE_MVEX, GF_ISOM_BOX_TYPE_MOOV}, {GF_ISOM_BOX_TYPE_TREX, GF_ISOM_BOX_TYPE_MVEX},
+    {GF_ISOM_BOX_TYPE_STYP, 0}, {GF_ISOM_BOX_TYPE_SIDX, 0}, {GF_ISOM_BOX_TYPE_MOOF, 0},
+    {GF_ISOM_BOX_TYPE_MFHD, GF_ISOM_BOX_TYPE_MOOF}, {GF_ISOM_BOX_TYPE_TRAF, GF_ISOM_BOX_TYPE_MOOF},
+    {GF_ISOM_BOX_TYPE_TFHD, GF_ISOM_BOX_TYPE_TRAF}, {GF_ISOM_BOX_TYPE_TFDT, GF_ISOM_BOX_TYPE_TRAF},
+    {GF_ISOM_BOX_TYPE_TRUN, GF_ISOM_BOX_TYPE_TRAF}, {GF_ISOM_BOX_TYPE_MDAT, 0}
+};
+#define UT_NB_PAIRS	(sizeof(ut_parse_pairs)/sizeof(ut_parse_pairs[0]))
+
+unittest(box_registry_lookup)
+{
+    u32 i, j, count = gf_isom_get_num_supported_boxes();
+    u32 nb_diff = 0, nb_checks = 0;
+
+    //all but a handful of registry entries dump their parents
+    assert_greater(ut_box_reg_load(count), count - 20);
+
+    //hashed lookup must match the registry walk for every registered 4CC
+    for (i=1; i<count; i++) {
+        for (j=0; j<UT_NB_PARENTS; j++) {
+            nb_diff += ut_box_reg_check(ut_reg_4cc[i], ut_parents[j], count, &nb_checks);
+        }
+        //and every parent listed in the registry
+        for (j=1; ut_reg_parents[i] && (j<count); j++) {
+            if (strstr(ut_reg_parents[i], gf_4cc_to_str(ut_reg_4cc[j])))
+                nb_diff += ut_box_reg_check(ut_reg_4cc[i], ut_reg_4cc[j], count, &nb_checks);
+        }
+    }
+    assert_equal(nb_diff, 0);
+    assert_greater(nb_checks, count * UT_NB_PARENTS / 2);
+
+    //pairs met when parsing a fragmented file
+    for (i=0; i<UT_NB_PAIRS; i++) {
+        u32 idx = get_box_reg_idx(ut_parse_pairs[i][0], ut_parse_pairs[i][1]);
+        assert_greater(idx, 0);
+        assert_equal(idx, ut_box_reg_scan(ut_parse_pairs[i][0], ut_parse_pairs[i][1], 0, count));
+    }
+    //unknown boxes
+    assert_equal(get_box_reg_idx(GF_4CC('a','b','c','d'), 0), 0);
+    assert_equal(get_box_reg_idx(GF_4CC('a','b','c','d'), GF_ISOM_BOX_TYPE_MOOV), 0);
+    ut_box_reg_unload(count);
+}
+
+unittest(box_parse_fragments)
+{
+    u32 i, track, di;
+    u8 data[16];
+    GF_ISOSample samp;
+    GF_GenericSampleDescription udesc;
+    GF_ISOFile *file = gf_isom_open("ut_box_frag.mp4", GF_ISOM_OPEN_WRITE, NULL);
+    assert_not_null(file);
+    track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_TEXT, 1000);
+    assert_greater(track, 0);
+    memset(&udesc, 0, sizeof(udesc));
+    udesc.codec_tag = GF_4CC('t','e','s','t');
+    assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di), GF_OK);
+    assert_equal(gf_isom_setup_track_fragment(file, gf_isom_get_track_id(file, track), di, 10, 0, 1, 0, 0, GF_FALSE), GF_OK);
+    assert_equal(gf_isom_finalize_for_fragment(file, 0, GF_TRUE), GF_OK);
+
+    memset(data, 0, sizeof(data));
+    memset(&samp, 0, sizeof(samp));
+    samp.data = data;
+    samp.dataLength = sizeof(data);
+    samp.IsRAP = RAP;
+    for (i=0; i<UT_NB_FRAGS; i++) {
+        samp.DTS = i*10;
+        assert_equal(gf_isom_start_fragment(file, GF_ISOM_FRAG_MOOF_FIRST), GF_OK);
+        assert_equal(gf_isom_fragment_add_sample(file, gf_isom_get_track_id(file, track), &samp, di, 10, 0, 0, GF_FALSE), GF_OK);
+    }
+    assert_equal(gf_isom_close(file), GF_OK);
+
+    //each fragment is moof/mfhd/traf/tfhd/tfdt/trun/mdat
+    file = gf_isom_open("ut_box_frag.mp4", GF_ISOM_OPEN_READ, NULL);
+    assert_not_null(file);
+    assert_equal(gf_isom_get_sample_count(file, 1), UT_NB_FRAGS);
+    gf_isom_close(file);
+    gf_file_delete("ut_box_frag.mp4");
+}
@@ -0,0 +1,155 @@
+#include <gpac/isomedia.h>
+#include "tests.h"
+
+#define UT_SIX_SAMPLES	500
+
+static void ut_six_make_input(void)
+{
+    u32 i, j, t, di, desc[2];
+    GF_GenericSampleDescription udesc;
+    u8 data[600];
+    GF_ISOFile *file = gf_isom_open("ut_six.mp4", GF_ISOM_OPEN_WRITE, NULL);
+    assert_not_null(file);
+    for (j=0; j<sizeof(data); j++) data[j] = (u8) (j*7);
+
+    //video-like track with reordering and two descriptions, audio-like track with constant sample size
+    for (t=1; t<=2; t++) {
+        u32 track = gf_isom_new_track(file, 0, (t==1) ? GF_ISOM_MEDIA_VISUAL : GF_ISOM_MEDIA_AUDIO, (t==1) ? 25 : 1000);
+        assert_equal(track, t);
+        memset(&udesc, 0, sizeof(udesc));
+        udesc.codec_tag = GF_4CC('t','e','s','t');
+        assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &desc[0]), GF_OK);
+        assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &desc[1]), GF_OK);
+        for (i=0; i<UT_SIX_SAMPLES; i++) {
+            GF_ISOSample s;
+            memset(&s, 0, sizeof(s));
+            s.data = data;
+            if (t==1) {
+                s.dataLength = 20 + (i*37) % 500;
+                s.DTS = i;
+                s.CTS_Offset = (i%3) ? 1 : 2;
+                s.IsRAP = (i%10) ? 0 : RAP;
+                di = desc[(i/13) % 2];
+            } else {
+                s.dataLength = 64;
+                s.DTS = i*21;
+                s.IsRAP = RAP;
+                di = desc[0];
+            }
+            assert_equal(gf_isom_add_sample(file, track, di, &s), GF_OK);
+        }
+    }
+    //several chunks per track
+    gf_isom_set_storage_mode(file, GF_ISOM_STORE_DRIFT_INTERLEAVED);
+    gf_isom_set_interleave_time(file, 1000);
+    assert_equal(gf_isom_close(file), GF_OK);
+}
+
+//samples read through the cache must match samples read from the sample tables
+static void ut_six_compare(GF_ISOFile *ref, GF_ISOFile *idx)
+{
+    u32 t, i;
+    assert_equal(gf_isom_get_track_count(idx), gf_isom_get_track_count(ref));
+    for (t=1; t<=gf_isom_get_track_count(ref); t++) {
+        assert_equal(gf_isom_get_sample_count(idx, t), gf_isom_get_sample_count(ref, t));
+        for (i=1; i<=gf_isom_get_sample_count(ref, t); i++) {
+            u32 di_ref, di_idx;
+            u64 off_ref, off_idx;
+            GF_ISOSample *s_ref = gf_isom_get_sample(ref, t, i, &di_ref);
+            GF_ISOSample *s_idx = gf_isom_get_sample(idx, t, i, &di_idx);
+            assert_not_null(s_ref);
+            assert_not_null(s_idx);
+            assert_equal(di_idx, di_ref);
+            assert_equal(s_idx->DTS, s_ref->DTS);
+            assert_equal(s_idx->CTS_Offset, s_ref->CTS_Offset);
+            assert_equal(s_idx->IsRAP, s_ref->IsRAP);
+            assert_equal(s_idx->dataLength, s_ref->dataLength);
+            assert_equal_mem(s_idx->data, s_ref->data, s_ref->dataLength);
+            gf_isom_sample_del(&s_ref);
+            gf_isom_sample_del(&s_idx);
+
+            s_ref = gf_isom_get_sample_info(ref, t, i, &di_ref, &off_ref);
+            s_idx = gf_isom_get_sample_info(idx, t, i, &di_idx, &off_idx);
+            assert_not_null(s_ref);
+            assert_not_null(s_idx);
+            assert_equal(off_idx, off_ref);
+            assert_equal(s_idx->dataLength, s_ref->dataLength);
+            gf_isom_sample_del(&s_ref);
+            gf_isom_sample_del(&s_idx);
+            assert_equal(gf_isom_get_sample_duration(idx, t, i), gf_isom_get_sample_duration(ref, t, i));
+        }
+    }
+}
+
+static void ut_six_write(const char *name, u8 *data, u32 size)
+{
+    FILE *f = gf_fopen(name, "wb");
+    assert_not_null(f);
+    assert_equal(gf_fwrite(data, size, f), size);
+    gf_fclose(f);
+}
+
+unittest(sample_index_cache)
+{
+    u8 *data;
+    u32 size, track;
+    FILE *trace;
+    GF_ISOFile *ref, *idx, *clone;
+
+    ut_six_make_input();
+    ref = gf_isom_open("ut_six.mp4", GF_ISOM_OPEN_READ, NULL);
+    assert_not_null(ref);
+    assert_greater(gf_isom_get_sample_count(ref, 1), 0);
+
+    //no cache yet
+    assert_equal(gf_isom_open_indexed("ut_six.mp4", "ut_six.gsix", &idx), GF_NOT_FOUND);
+    assert_true(idx == NULL);
+
+    assert_equal(gf_isom_sample_index_build(ref, "ut_six.gsix"), GF_OK);
+    assert_equal(gf_isom_sample_index_check("ut_six.mp4", "ut_six.gsix", GF_TRUE), GF_OK);
+    assert_equal(gf_isom_open_indexed("ut_six.mp4", "ut_six.gsix", &idx), GF_OK);
+    assert_not_null(idx);
+    ut_six_compare(ref, idx);
+
+    //chunk offsets are not loaded, dumping must not crash and cloned tracks must not carry sample tables
+    trace = gf_fopen("ut_six.xml", "wb");
+    assert_not_null(trace);
+    assert_equal(gf_isom_dump(idx, trace, GF_FALSE, GF_FALSE), GF_OK);
+    gf_fclose(trace);
+    clone = gf_isom_open("ut_six_clone.mp4", GF_ISOM_OPEN_WRITE, NULL);
+    assert_not_null(clone);
+    assert_equal(gf_isom_clone_track(idx, 1, clone, 0, &track), GF_OK);
+    assert_equal(gf_isom_get_sample_count(clone, track), 0);
+    gf_isom_delete(clone);
+    gf_isom_close(idx);
+
+    assert_equal(gf_file_load_data("ut_six.gsix", &data, &size), GF_OK);
+    assert_greater(size, 64);
+
+    //bad magic
+    data[0] ^= 0xFF;
+    ut_six_write("ut_six.gsix", data, size);
+    assert_equal(gf_isom_sample_index_check("ut_six.mp4", "ut_six.gsix", GF_FALSE), GF_CORRUPTED_DATA);
+    assert_equal(gf_isom_open_indexed("ut_six.mp4", "ut_six.gsix", &idx), GF_CORRUPTED_DATA);
+    assert_true(idx == NULL);
+    data[0] ^= 0xFF;
+
+    //truncated tables
+    ut_six_write("ut_six.gsix", data, size/2);
+    assert_equal(gf_isom_sample_index_check("ut_six.mp4", "ut_six.gsix", GF_FALSE), GF_CORRUPTED_DATA);
+    assert_equal(gf_isom_open_indexed("ut_six.mp4", "ut_six.gsix", &idx), GF_CORRUPTED_DATA);
+    assert_true(idx == NULL);
+
+    //restored cache is usable again
+    ut_six_write("ut_six.gsix", data, size);
+    assert_equal(gf_isom_open_indexed("ut_six.mp4", "ut_six.gsix", &idx), GF_OK);
+    ut_six_compare(ref, idx);
+    gf_isom_close(idx);
+
+    gf_free(data);
+    gf_isom_close(ref);
+    gf_file_delete("ut_six.mp4");
+    gf_file_delete("ut_six.gsix");
+    gf_file_delete("ut_six.xml");
+    gf_file_delete("ut_six_clone.mp4");
+}
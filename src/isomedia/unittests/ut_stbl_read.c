@@ -0,0 +1,81 @@
+#include <gpac/isomedia.h>
+#include "tests.h"
+
+#define UT_NB_SAMPLES	3000
+
+unittest(stbl_lookup_index)
+{
+    u32 i, di, track, desc[2];
+    u64 base_offset;
+    GF_GenericSampleDescription udesc;
+    u8 data[32];
+    static u64 dts[UT_NB_SAMPLES+1], offsets[UT_NB_SAMPLES];
+    static u32 descs[UT_NB_SAMPLES];
+    GF_ISOSample *samp;
+    GF_ISOFile *file = gf_isom_open("ut_stbl.mp4", GF_ISOM_WRITE_EDIT, NULL);
+    assert_not_null(file);
+    track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_TEXT, 1000);
+    assert_greater(track, 0);
+    memset(&udesc, 0, sizeof(udesc));
+    udesc.codec_tag = GF_4CC('t','e','s','t');
+    assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &desc[0]), GF_OK);
+    assert_equal(gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &desc[1]), GF_OK);
+
+    //durations changing every 7 samples and description changing every 13 samples give many stts and stsc entries
+    memset(data, 0xAB, sizeof(data));
+    dts[0] = 0;
+    offsets[0] = 0;
+    for (i=0; i<UT_NB_SAMPLES; i++) {
+        GF_ISOSample s;
+        memset(&s, 0, sizeof(s));
+        s.data = data;
+        s.dataLength = 10 + i%17;
+        s.DTS = dts[i];
+        s.IsRAP = RAP;
+        descs[i] = desc[(i/13) % 2];
+        assert_equal(gf_isom_add_sample(file, track, descs[i], &s), GF_OK);
+        dts[i+1] = dts[i] + 1 + (i/7)%5;
+        if (i) offsets[i] = offsets[i-1] + 10 + (i-1)%17;
+    }
+    assert_equal(gf_isom_get_sample_count(file, track), UT_NB_SAMPLES);
+
+    samp = gf_isom_get_sample_info(file, track, 1, &di, &base_offset);
+    assert_not_null(samp);
+    gf_isom_sample_del(&samp);
+
+    //random access in both directions against the reference tables
+    for (i=0; i<2000; i++) {
+        u64 offset;
+        u32 sample_num, n = 1 + ut_rand() % UT_NB_SAMPLES;
+        GF_ISOSample *s;
+
+        assert_equal(gf_isom_get_sample_dts(file, track, n), dts[n-1]);
+
+        s = gf_isom_get_sample_info(file, track, n, &di, &offset);
+        assert_not_null(s);
+        assert_equal(s->DTS, dts[n-1]);
+        assert_equal(di, descs[n-1]);
+        assert_equal(offset, base_offset + offsets[n-1]);
+        gf_isom_sample_del(&s);
+
+        s = NULL;
+        assert_equal(gf_isom_get_sample_for_media_time(file, track, dts[n-1], &di, GF_ISOM_SEARCH_BACKWARD, &s, &sample_num, NULL), GF_OK);
+        assert_equal(sample_num, n);
+        gf_isom_sample_del(&s);
+
+        //time inside sample duration: backward gives the sample, forward gives the next one
+        if (dts[n] > dts[n-1] + 1) {
+            s = NULL;
+            assert_equal(gf_isom_get_sample_for_media_time(file, track, dts[n-1]+1, &di, GF_ISOM_SEARCH_BACKWARD, &s, &sample_num, NULL), GF_OK);
+            assert_equal(sample_num, n);
+            gf_isom_sample_del(&s);
+            if (n<UT_NB_SAMPLES) {
+                s = NULL;
+                assert_equal(gf_isom_get_sample_for_media_time(file, track, dts[n-1]+1, &di, GF_ISOM_SEARCH_FORWARD, &s, &sample_num, NULL), GF_OK);
+                assert_equal(sample_num, n+1);
+                gf_isom_sample_del(&s);
+            }
+        }
+    }
+    gf_isom_delete(file);
+}
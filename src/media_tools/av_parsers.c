@@ -4755,16 +4755,10 @@ const char *gf_avc_hevc_get_chroma_format_name(u8 chroma_format)
 
 u32 gf_bs_read_ue_log_idx3(GF_BitStream *bs, const char *fname, s32 idx1, s32 idx2, s32 idx3)
 {
-	u32 val=0, code;
-	s32 nb_lead = -1;
-	u32 bits = 0;
-	for (code=0; !code; nb_lead++) {
-		if (nb_lead>=32) {
-			break;
-		}
-		code = gf_bs_read_int(bs, 1);
-		bits++;
-	}
+	u32 val=0;
+	//read up to 33 zero bits, error if no 1 bit found in the first 33 bits
+	u32 nb_lead = gf_bs_read_leading_zeros(bs, 33);
+	u32 bits = nb_lead + 1;
 
 	if (nb_lead>=32) {
 		if (gf_bs_is_overflow(bs)<2) {
@@ -4863,42 +4857,80 @@ void gf_bs_write_se(GF_BitStream *bs, s32 num)
 
 #ifndef GPAC_DISABLE_AV_PARSERS
 
+#include <gpac/internal/simd.h>
+
+static GFINLINE u32 nalu_ctz(u64 mask)
+{
+#if defined(__GNUC__)
+	return (u32) __builtin_ctzll(mask);
+#else
+	u32 res = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		res++;
+	}
+	return res;
+#endif
+}
+
+/*returns position of the first two consecutive zero bytes at or after pos, or size if none
+all NAL scanning (start codes, emulation prevention) only needs to look at such positions*/
+static u32 nalu_next_zero_pair(const u8 *data, u32 pos, u32 size)
+{
+#if defined(GPAC_HAS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	while (pos + 17 <= size) {
+		__m128i a = _mm_loadu_si128((const __m128i *) (data + pos));
+		__m128i b = _mm_loadu_si128((const __m128i *) (data + pos + 1));
+		u32 mask = (u32) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, zero), _mm_cmpeq_epi8(b, zero)));
+		if (mask) return pos + nalu_ctz(mask);
+		pos += 16;
+	}
+#elif defined(GPAC_HAS_NEON)
+	while (pos + 17 <= size) {
+		uint8x16_t a = vld1q_u8(data + pos);
+		uint8x16_t b = vld1q_u8(data + pos + 1);
+		uint8x16_t eq = vandq_u8(vceqzq_u8(a), vceqzq_u8(b));
+		//narrow to 4 bits per byte
+		u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+		if (mask) return pos + nalu_ctz(mask) / 4;
+		pos += 16;
+	}
+#endif
+	while (pos + 1 < size) {
+		if (data[pos+1]) {
+			pos += 2;
+		} else if (data[pos]) {
+			pos++;
+		} else {
+			return pos;
+		}
+	}
+	return size;
+}
+
 GF_EXPORT
 u32 gf_media_nalu_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
 {
-	u32 avail = data_len;
-	const u8 *cur = data;
+	u32 pos = 0;
 
-	while (cur) {
-		u32 v, bpos;
-		u8 *next_zero = memchr(cur, 0, avail);
-		if (!next_zero) return data_len;
+	while (1) {
+		pos = nalu_next_zero_pair(data, pos, data_len);
+		if (pos + 2 >= data_len)
+			return data_len;
 
-		v = 0xffffff00;
-		bpos = (u32)(next_zero - data) + 1;
-		while (1) {
-			u8 cval;
-			if (bpos == (u32)data_len)
-				return data_len;
-
-			cval = data[bpos];
-			v = ((v << 8) & 0xFFFFFF00) | ((u32)cval);
-			bpos++;
-			if (v == 0x00000001) {
+		if (data[pos+2] == 0x01) {
+			//the zero pair at pos-1 has already been checked, no need to check bounds
+			if (pos && !data[pos-1]) {
 				*sc_size = 4;
-				return bpos - 4;
-			}
-			else if ((v & 0x00FFFFFF) == 0x00000001) {
-				*sc_size = 3;
-				return bpos - 3;
+				return pos - 1;
 			}
-			if (cval)
-				break;
+			*sc_size = 3;
+			return pos;
 		}
-		if (bpos >= data_len)
-			break;
-		cur = data + bpos;
-		avail = data_len - bpos;
+		//00 00 00: next pair starts at pos+1
+		if (!data[pos+2]) pos++;
+		else pos += 3;
 	}
 	return data_len;
 }
@@ -5041,6 +5073,11 @@ u32 gf_media_nalu_emulation_bytes_remove_count(const u8 *buffer, u32 nal_size)
 
 	while (i < nal_size)
 	{
+		//no emulation code possible before the next zero pair
+		if (!num_zero) {
+			i = nalu_next_zero_pair(buffer, i, nal_size);
+			if (i >= nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  \96 0x00000300
@@ -5079,6 +5116,15 @@ u32 gf_media_nalu_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u
 
 	while (i < nal_size)
 	{
+		//no emulation code possible before the next zero pair, copy as is
+		if (!num_zero) {
+			u32 next = nalu_next_zero_pair(buffer_src, i, nal_size);
+			if (next > i) {
+				memmove(buffer_dst + i - emulation_bytes_count, buffer_src + i, next - i);
+				i = next;
+				if (i >= nal_size) break;
+			}
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  0x00000300
@@ -2164,6 +2164,7 @@ static GF_Err gf_dash_solve_representation_xlink(GF_DashClient *dash, GF_MPD_Rep
 	memcpy(last_sig, signature, GF_SHA1_DIGEST_SIZE);
 
 	parser = gf_xml_dom_new();
+	gf_xml_dom_enable_arena(parser);
 	e = gf_xml_dom_parse(parser, local_url, NULL, NULL);
 	if (is_local) gf_free(url);
 
@@ -2550,6 +2551,7 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 		/* It means we have to reparse the file ... */
 		/* parse the MPD */
 		mpd_parser = gf_xml_dom_new();
+		gf_xml_dom_enable_arena(mpd_parser);
 		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
 		if (e != GF_OK) {
 			gf_xml_dom_del(mpd_parser);
@@ -6046,6 +6048,7 @@ static void gf_dash_solve_period_xlink(GF_DashClient *dash, GF_List *period_list
 
 	/* parse the MPD */
 	parser = gf_xml_dom_new();
+	gf_xml_dom_enable_arena(parser);
 	e = gf_xml_dom_parse(parser, local_url, NULL, NULL);
 	if (url) gf_free(url);
 	url = NULL;
@@ -8596,6 +8599,7 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 
 		/* parse the MPD */
 		mpd_parser = gf_xml_dom_new();
+		gf_xml_dom_enable_arena(mpd_parser);
 		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
 
 		if (sep_cgi) sep_cgi[0] = '?';
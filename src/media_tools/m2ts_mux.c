@@ -449,13 +449,14 @@ void gf_m2ts_mux_table_update_mpeg4(GF_M2TS_Mux_Stream *stream, u8 table_id, u16
 	/*MPEG-4 tables are input streams for the mux, the bitrate is updated when fetching AUs*/
 }
 
-static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u16 pid,
+//writes adaptation field directly in the TS packet, returns number of bytes written
+static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, u8 *out, u16 pid,
                                   Bool has_pcr, u64 pcr_time,
                                   Bool is_rap,
                                   u32 padding_length,
                                   char *af_descriptors, u32 af_descriptors_size, Bool set_discontinuity)
 {
-	u32 adaptation_length;
+	u32 adaptation_length, pos;
 
 	adaptation_length = ADAPTATION_FLAGS_LENGTH + (has_pcr?PCR_LENGTH:0) + padding_length;
 
@@ -464,22 +465,25 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 		adaptation_length += ADAPTATION_EXTENSION_LENGTH_LENGTH + ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size;
 	}
 
-	gf_bs_write_int(bs,	adaptation_length, 8);
-	gf_bs_write_int(bs,	set_discontinuity ? 1 : 0, 1);			// discontinuity indicator
-	gf_bs_write_int(bs,	is_rap, 1);		// random access indicator
-	gf_bs_write_int(bs,	0, 1);			// es priority indicator
-	gf_bs_write_int(bs,	has_pcr, 1);	// PCR_flag
-	gf_bs_write_int(bs,	0, 1);			// OPCR flag
-	gf_bs_write_int(bs,	0, 1);			// splicing point flag
-	gf_bs_write_int(bs,	0, 1);			// transport private data flag
-	gf_bs_write_int(bs,	af_descriptors_size ? 1 : 0, 1);			// adaptation field extension flag
+	out[0] = (u8) adaptation_length;
+	out[1] = (set_discontinuity ? 0x80 : 0) // discontinuity indicator
+		| (is_rap ? 0x40 : 0) // random access indicator
+		| (has_pcr ? 0x10 : 0) // PCR_flag
+		| (af_descriptors_size ? 0x01 : 0); // adaptation field extension flag - ES priority, OPCR, splicing point and private data flags are 0
+	pos = 2;
+
 	if (has_pcr) {
 		u64 PCR_base, PCR_ext;
 		PCR_base = pcr_time/300;
-		gf_bs_write_long_int(bs, PCR_base, 33);
-		gf_bs_write_int(bs,	0, 6); // reserved
 		PCR_ext = pcr_time - PCR_base*300;
-		gf_bs_write_long_int(bs, PCR_ext, 9);
+		//33 bits base, 6 bits reserved (0), 9 bits extension
+		out[2] = (u8) (PCR_base >> 25);
+		out[3] = (u8) (PCR_base >> 17);
+		out[4] = (u8) (PCR_base >> 9);
+		out[5] = (u8) (PCR_base >> 1);
+		out[6] = (u8) (((PCR_base & 1) << 7) | ((PCR_ext >> 8) & 1));
+		out[7] = (u8) (PCR_ext & 0xFF);
+		pos += PCR_LENGTH;
 		if (prog->last_pcr > pcr_time) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] PID %d: Sending PCR "LLD" earlier than previous PCR "LLD" - drift %f sec - discontinuity set\n", pid, pcr_time, prog->last_pcr, (prog->last_pcr - pcr_time) /27000000.0 ));
 		}
@@ -494,27 +498,26 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 	}
 
 	if (af_descriptors_size) {
-		gf_bs_write_int(bs,	ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size, 8);
-
-		gf_bs_write_int(bs,	0, 1);			// ltw_flag
-		gf_bs_write_int(bs,	0, 1);			// piecewise_rate_flag
-		gf_bs_write_int(bs,	0, 1);			// seamless_splice_flag
-		gf_bs_write_int(bs,	0, 1);			// af_descriptor_not_present_flag
-		gf_bs_write_int(bs,	0xF, 4);			// reserved
-
-		gf_bs_write_data(bs, af_descriptors, af_descriptors_size);
+		out[pos++] = (u8) (ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size);
+		//ltw_flag, piecewise_rate_flag, seamless_splice_flag, af_descriptor_not_present_flag all 0, 4 bits reserved
+		out[pos++] = 0x0F;
+		memcpy(out+pos, af_descriptors, af_descriptors_size);
+		pos += af_descriptors_size;
 	}
 
-	gf_bs_write_byte(bs, 0xFF, padding_length); // stuffing byte
+	if (padding_length) {
+		memset(out+pos, 0xFF, padding_length); // stuffing byte
+		pos += padding_length;
+	}
 
-	return adaptation_length + ADAPTATION_LENGTH_LENGTH;
+	return pos;
 }
 
 //#define USE_AF_STUFFING
 
-static void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stream *stream, char *packet)
+static void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stream *stream, u8 *packet)
 {
-	GF_BitStream *bs;
+	u32 pos;
 	GF_M2TS_Mux_Table *table;
 	GF_M2TS_Mux_Section *section;
 	u32 payload_length, payload_start;
@@ -535,8 +538,6 @@ static void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stre
 	section = stream->current_section;
 	gf_assert(section);
 
-	bs = mux->pck_bs;
-
 	if (!stream->current_section_offset) payload_length = 183;
 	else payload_length = 184;
 
@@ -572,33 +573,26 @@ static void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stre
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_reassign_buffer(bs, packet, 188);
-	gf_bs_write_int(bs,	0x47, 8); // sync
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	if (stream->current_section_offset == 0) {
-		gf_bs_write_int(bs,	1, 1);    // payload start indicator
-	} else {
-		/* No section concatenation yet!!!*/
-		gf_bs_write_int(bs,	0, 1);    // payload start indicator
-	}
-	gf_bs_write_int(bs,	0, 1);    /*priority indicator*/
-	gf_bs_write_int(bs,	stream->pid, 13); /*pid*/
-	gf_bs_write_int(bs,	0, 2);    /*scrambling indicator*/
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    /*we do not use adaptation field for sections */
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   /*continuity counter*/
+	packet[0] = 0x47; // sync byte
+	packet[1] = (stream->pid>>8) & 0x1F; //high bits of PID, no error or priority indicator
+	/* No section concatenation yet!!!*/
+	if (stream->current_section_offset == 0) packet[1] |= 0x40; // payload start indicator
+	packet[2] = stream->pid & 0xFF; //low bits of PID
+	packet[3] = (adaptation_field_control<<4) | (stream->continuity_counter & 0xF); //no scrambling, AF + CC
+	pos = 4;
 
 	if (stream->continuity_counter < 15) stream->continuity_counter++;
 	else stream->continuity_counter=0;
 
 #ifdef USE_AF_STUFFING
 	if (adaptation_field_control != GF_M2TS_ADAPTATION_NONE)
-		gf_m2ts_add_adaptation(stream->program, bs, stream->pid, 0, 0, 0, padding_length, NULL, 0, GF_FALSE);
+		pos += gf_m2ts_add_adaptation(stream->program, packet+pos, stream->pid, 0, 0, 0, padding_length, NULL, 0, GF_FALSE);
 #endif
 
 	/*pointer field*/
 	if (!stream->current_section_offset) {
 		/* no concatenations of sections in ts packets, so start address is 0 */
-		gf_bs_write_u8(bs, 0);
+		packet[pos++] = 0;
 	}
 
 	memcpy(packet+188-payload_start, section->data + stream->current_section_offset, payload_length);
@@ -1916,14 +1910,25 @@ static u32 gf_m2ts_stream_get_pes_header_length(GF_M2TS_Mux_Stream *stream)
 	return hdr_len;
 }
 
-u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
+static GFINLINE void gf_m2ts_write_pes_timestamp(u8 *out, u8 prefix, u64 ts)
+{
+	out[0] = (prefix<<4) | (u8) (((ts >> 30) & 0x7) << 1) | 1;
+	out[1] = (u8) (ts >> 22);
+	out[2] = (u8) (((ts >> 15) & 0x7F) << 1) | 1;
+	out[3] = (u8) (ts >> 7);
+	out[4] = (u8) ((ts & 0x7F) << 1) | 1;
+}
+
+//writes PES header directly in the TS packet, returns number of bytes written
+static u32 gf_m2ts_stream_add_pes_header(u8 *out, GF_M2TS_Mux_Stream *stream)
 {
-	u64 t, dts, cts;
-	u32 pes_len;
+	u64 dts, cts;
+	u32 pes_len, pos;
 	Bool use_pts, use_dts;
 
-	gf_bs_write_int(bs,	0x1, 24);//packet start code
-	gf_bs_write_u8(bs,	stream->mpeg2_stream_id);// stream id
+	out[0] = out[1] = 0;
+	out[2] = 1; //packet start code
+	out[3] = stream->mpeg2_stream_id; // stream id
 
 	/*next AU start in current PES and current AU began in previous PES, use next AU timing*/
 	if (stream->pck_offset && stream->copy_from_next_packets) {
@@ -1950,54 +1955,34 @@ u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
 	if (use_dts) pes_len += 5;
 
 	if (pes_len>0xFFFF) pes_len = 0;
-	gf_bs_write_int(bs, pes_len, 16); // pes packet length
+	out[4] = (pes_len >> 8) & 0xFF; // pes packet length
+	out[5] = pes_len & 0xFF;
 
-	gf_bs_write_int(bs, 0x2, 2); // reserved
-	gf_bs_write_int(bs, 0x0, 2); // scrambling
-	gf_bs_write_int(bs, 0x0, 1); // priority
-	gf_bs_write_int(bs, stream->pck_offset ? 0 : 1, 1); // alignment indicator - we could also check start codes to see if we are aligned at slice/video packet level
-	gf_bs_write_int(bs, 0x0, 1); // copyright
-	gf_bs_write_int(bs, 0x0, 1); // original or copy
+	//'10' reserved, no scrambling, no priority, no copyright, not original
+	out[6] = 0x80;
+	// alignment indicator - we could also check start codes to see if we are aligned at slice/video packet level
+	if (!stream->pck_offset) out[6] |= 0x04;
 
-	gf_bs_write_int(bs, use_pts, 1);
-	gf_bs_write_int(bs, use_dts, 1);
-	gf_bs_write_int(bs, 0x0, 6); //6 flags = 0 (ESCR, ES_rate, DSM_trick, additional_copy, PES_CRC, PES_extension)
-
-	gf_bs_write_int(bs, use_dts*5+use_pts*5, 8);
+	//6 flags = 0 (ESCR, ES_rate, DSM_trick, additional_copy, PES_CRC, PES_extension)
+	out[7] = (use_pts ? 0x80 : 0) | (use_dts ? 0x40 : 0);
+	out[8] = use_dts*5+use_pts*5;
+	pos = 9;
 
 	if (use_pts) {
-		gf_bs_write_int(bs, use_dts ? 0x3 : 0x2, 4); // reserved '0011' || '0010'
-		t = ((cts >> 30) & 0x7);
-		gf_bs_write_long_int(bs, t, 3);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = ((cts >> 15) & 0x7fff);
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = cts & 0x7fff;
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
+		gf_m2ts_write_pes_timestamp(out+pos, use_dts ? 0x3 : 0x2, cts); // reserved '0011' || '0010'
+		pos += 5;
 	}
-
 	if (use_dts) {
-		gf_bs_write_int(bs, 0x1, 4); // reserved '0001'
-		t = ((dts >> 30) & 0x7);
-		gf_bs_write_long_int(bs, t, 3);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = ((dts >> 15) & 0x7fff);
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = dts & 0x7fff;
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
+		gf_m2ts_write_pes_timestamp(out+pos, 0x1, dts); // reserved '0001'
+		pos += 5;
 	}
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] PID %d: Adding PES header at PCR "LLD" - has PTS %d ("LLU") - has DTS %d ("LLU") - Payload length %d\n", stream->pid, gf_m2ts_get_pcr(stream)/300, use_pts, cts, use_dts, dts, pes_len));
 
-	return pes_len+4; // 4 = start code + stream_id
+	return pos;
 }
 
-void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
+void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, u8 *packet)
 {
-	GF_BitStream *bs;
 	Bool needs_pcr, first_pass;
 	u32 adaptation_field_control, payload_length, payload_to_copy, padding_length, hdr_len, pos, copy_next;
 
@@ -2142,27 +2127,12 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		else stream->continuity_counter--;
 	}
 
-	bs = stream->program->mux->pck_bs;
-	gf_bs_reassign_buffer(bs, packet, 188);
-
-	//small opt for formatting TS header for PES, don't use bitstream for header, slightly faster
-#if 0
-	gf_bs_write_int(bs,	0x47, 8); // sync byte
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	gf_bs_write_int(bs,	hdr_len ? 1 : 0, 1); // start ind
-	gf_bs_write_int(bs,	0, 1);	  // transport priority
-	gf_bs_write_int(bs,	stream->pid, 13); // pid
-	gf_bs_write_int(bs,	0, 2);    // scrambling
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    // we do not use adaptation field for sections
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   // continuity counter
-#else
 	packet[0] = 0x47; // sync byte
 	packet[1] = (stream->pid>>8) & 0x1F; //high bits of PID
 	if (hdr_len) packet[1] |= 0x40; // start ind
 	packet[2] = stream->pid & 0xFF; //low bits of PID
 	packet[3] = (adaptation_field_control<<4) | (stream->continuity_counter & 0xF); //AF + CC
-	gf_bs_seek(bs, 4);
-#endif
+	pos = 4;
 
 	if (stream->continuity_counter < 15) stream->continuity_counter++;
 	else stream->continuity_counter=0;
@@ -2203,7 +2173,7 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 			stream->program->nb_pck_last_pcr = stream->program->mux->tot_pck_sent;
 		}
 		is_rap = (hdr_len && (stream->curr_pck.sap_type) ) ? GF_TRUE : GF_FALSE;
-		gf_m2ts_add_adaptation(stream->program, bs, stream->pid, needs_pcr, pcr, is_rap, padding_length, hdr_len ? stream->curr_pck.mpeg2_af_descriptors : NULL, hdr_len ? stream->curr_pck.mpeg2_af_descriptors_size : 0, stream->set_initial_disc);
+		pos += gf_m2ts_add_adaptation(stream->program, packet+pos, stream->pid, needs_pcr, pcr, is_rap, padding_length, hdr_len ? stream->curr_pck.mpeg2_af_descriptors : NULL, hdr_len ? stream->curr_pck.mpeg2_af_descriptors_size : 0, stream->set_initial_disc);
 		stream->set_initial_disc = GF_FALSE;
 
 		if (stream->curr_pck.mpeg2_af_descriptors) {
@@ -2218,15 +2188,13 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 	stream->pck_sap_type = 0;
 	stream->pck_sap_time = 0;
 	if (hdr_len) {
-		gf_m2ts_stream_add_pes_header(bs, stream);
+		pos += gf_m2ts_stream_add_pes_header(packet+pos, stream);
 		if (stream->curr_pck.sap_type) {
 			stream->pck_sap_type = 1;
 			stream->pck_sap_time = stream->curr_pck.cts;
 		}
 	}
 
-	pos = (u32) gf_bs_get_position(bs);
-
 	if (adaptation_field_control == GF_M2TS_ADAPTATION_ONLY) {
 		return;
 	}
@@ -3276,6 +3244,12 @@ static Bool gf_m2ts_stream_too_early(GF_M2TS_Mux_Stream *stream, GF_M2TS_Mux *mu
 
 GF_EXPORT
 const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next)
+{
+	return gf_m2ts_mux_process_ex(muxer, status, usec_till_next, NULL);
+}
+
+GF_EXPORT
+const u8 *gf_m2ts_mux_process_ex(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next, u8 *dst_pck)
 {
 	GF_M2TS_Mux_Program *program;
 	GF_M2TS_Mux_Stream *stream, *stream_to_process;
@@ -3287,6 +3261,7 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 	Bool flush_all_pes = GF_FALSE;
 	Bool check_max_time = GF_FALSE;
 
+	if (!dst_pck) dst_pck = (u8 *) muxer->dst_pck;
 	nb_streams = nb_streams_done = 0;
 	*status = GF_M2TS_STATE_IDLE;
 
@@ -3463,7 +3438,7 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 
 				/*next is rap on this stream, check flushing of other pes (we could use a goto)*/
 				if (!flush_all_pes && muxer->force_pat)
-					return gf_m2ts_mux_process(muxer, status, usec_till_next);
+					return gf_m2ts_mux_process_ex(muxer, status, usec_till_next, dst_pck);
 
 				if (res) {
 					/*always schedule the earliest data*/
@@ -3515,13 +3490,17 @@ send_pck:
 		if (muxer->fixed_rate) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG2-TS Muxer] Inserting empty packet at %d:%09d\n", time.sec, time.nanosec));
 			ret = muxer->null_pck;
+			if (dst_pck != (u8 *) muxer->dst_pck) {
+				memcpy(dst_pck, muxer->null_pck, 188);
+				ret = (char *) dst_pck;
+			}
 			muxer->tot_pad_sent++;
 		}
 	} else {
 		if (stream_to_process->tables) {
-			gf_m2ts_mux_table_get_next_packet(muxer, stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_table_get_next_packet(muxer, stream_to_process, dst_pck);
 		} else {
-			gf_m2ts_mux_pes_get_next_packet(stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_pes_get_next_packet(stream_to_process, dst_pck);
 			if (stream_to_process->pid == muxer->ref_pid) {
 				if (stream_to_process->pck_sap_type) {
 					muxer->sap_inserted = GF_TRUE;
@@ -3533,7 +3512,7 @@ send_pck:
 			}
 		}
 
-		ret = muxer->dst_pck;
+		ret = (char *) dst_pck;
 		*status = GF_M2TS_STATE_DATA;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG2-TS Muxer] Sending %s from PID %d at %d:%09d - mux time %d:%09d\n", stream_to_process->tables ? "table" : "PES", stream_to_process->pid, time.sec, time.nanosec, muxer->time.sec, muxer->time.nanosec));
@@ -35,12 +35,18 @@
 			if (!_elem->x_attributes) _elem->x_attributes = gf_list_new();	\
 			i--;	\
 			gf_list_rem(root->attributes, i);	\
+			if (root->in_arena) att = gf_xml_dom_create_attribute(att->name, att->value);	\
 			gf_list_add(_elem->x_attributes, att);	\
 
 #define MPD_STORE_EXTENSION_NODE(_elem)	\
 		if (!_elem->x_children) _elem->x_children = gf_list_new();	\
 		i--;	\
 		gf_list_rem(root->content, i);	\
+		if (child->in_arena) {	\
+			GF_XMLNode *_clone = gf_xml_dom_node_clone(child);	\
+			gf_xml_dom_node_del(child);	\
+			child = _clone;	\
+		}	\
 		child->orig_pos = child_idx;\
 		gf_list_add(_elem->x_children, child);	\
 
@@ -1152,6 +1158,8 @@ void gf_mpd_segment_base_free(void *_item)
 	gf_free(ptr);
 }
 
+static void gf_mpd_frag_cache_del(GF_MPD_FragmentCache *fc);
+
 void gf_mpd_segment_entry_free(void *_item)
 {
 	gf_free(_item);
@@ -1160,6 +1168,7 @@ void gf_mpd_segment_timeline_free(void *_item)
 {
 	GF_MPD_SegmentTimeline *ptr = (GF_MPD_SegmentTimeline *)_item;
 	gf_mpd_del_list(ptr->entries, gf_mpd_segment_entry_free, 0);
+	gf_mpd_frag_cache_del(ptr->print_cache);
 	gf_free(ptr);
 }
 
@@ -1309,6 +1318,7 @@ void gf_mpd_representation_free(void *_item)
 	}
 	if (ptr->m3u8_var_name) gf_free(ptr->m3u8_var_name);
 	if (ptr->m3u8_var_file) gf_fclose(ptr->m3u8_var_file);
+	gf_mpd_frag_cache_del(ptr->m3u8_cache);
 	if (ptr->res_url) gf_free(ptr->res_url);
 	gf_free(ptr);
 }
@@ -1366,6 +1376,7 @@ void gf_mpd_del(GF_MPD *mpd)
 	gf_mpd_del_list(mpd->program_infos, gf_mpd_prog_info_free, 0);
 	gf_mpd_del_list(mpd->base_URLs, gf_mpd_base_url_free, 0);
 	gf_mpd_del_list(mpd->locations, gf_mpd_string_free, 0);
+	if (mpd->patch_location) gf_free(mpd->patch_location);
 	gf_mpd_del_list(mpd->metrics, NULL/*TODO*/, 0);
 	gf_mpd_del_list(mpd->periods, gf_mpd_period_free, 0);
 	if (mpd->profiles) gf_free(mpd->profiles);
@@ -2663,13 +2674,8 @@ static GFINLINE void gf_mpd_lf(FILE *out, s32 indent)
 }
 static GFINLINE void gf_mpd_nl(FILE *out, s32 indent)
 {
-	if (indent>=0) {
-		u32 i=(u32)indent;
-		while (i) {
-			gf_fprintf(out, " ");
-			i--;
-		}
-	}
+	if (indent>0)
+		gf_fprintf(out, "%*s", indent, "");
 }
 
 /*time is given in ms*/
@@ -2778,57 +2784,261 @@ static void gf_mpd_print_segment_base(FILE *out, GF_MPD_SegmentBase *s, s32 inde
 	gf_mpd_lf(out, indent);
 }
 
+/*serialization cache of stable fragments (segment timeline S elements, m3u8 segments)
+a fragment is reused as long as its source items are still in the source list and the writer state before the fragment is unchanged*/
+typedef struct
+{
+	//first source item of the fragment and value used to detect item changes or memory reuse
+	void *src;
+	u64 check;
+	//writer state before and after the fragment
+	u64 state, next_state;
+	//last source item of the fragment and number of source items
+	void *last;
+	u32 nb_src;
+	//fragment text in cache
+	u32 offset, size;
+} GF_MPD_Fragment;
+
+struct _gf_mpd_frag_cache
+{
+	GF_MPD_Fragment *frags;
+	u32 nb_frags, nb_alloc;
+	//text of all fragments
+	FILE *text;
+	//serialization parameters of cached fragments
+	u64 params;
+	u32 nb_writes;
+	//current write pass: first fragment matched, next fragment to match, pending text to write
+	Bool matched;
+	u32 first_frag, next_frag;
+	u32 pending_offset, pending_size;
+	u32 start_offset;
+};
+
+static void gf_mpd_frag_cache_del(GF_MPD_FragmentCache *fc)
+{
+	if (!fc) return;
+	if (fc->text) gf_fclose(fc->text);
+	if (fc->frags) gf_free(fc->frags);
+	gf_free(fc);
+}
+
+//starts a write pass, returns NULL if cache is not used for this pass
+static GF_MPD_FragmentCache *gf_mpd_frag_cache_begin(GF_MPD_FragmentCache **p_fc, u64 params)
+{
+	GF_MPD_FragmentCache *fc = *p_fc;
+	if (!fc) {
+		GF_SAFEALLOC(fc, GF_MPD_FragmentCache);
+		if (!fc) return NULL;
+		*p_fc = fc;
+	}
+	//only cache if written more than once
+	fc->nb_writes++;
+	if (fc->nb_writes<2) return NULL;
+
+	if (!fc->text) {
+		fc->text = gf_fileio_mem_writer(NULL, NULL, 0);
+		if (!fc->text) return NULL;
+	}
+	if (fc->params != params) {
+		fc->params = params;
+		fc->nb_frags = 0;
+		gf_fseek(fc->text, 0, SEEK_SET);
+	}
+	fc->matched = GF_FALSE;
+	fc->first_frag = fc->next_frag = 0;
+	fc->pending_size = 0;
+	return fc;
+}
+
+static void gf_mpd_frag_cache_flush(GF_MPD_FragmentCache *fc, FILE *out)
+{
+	if (!fc || !fc->pending_size) return;
+	u8 *data = gf_fileio_mem_writer_data(fc->text, NULL);
+	gf_fwrite(data + fc->pending_offset, fc->pending_size, out);
+	fc->pending_size = 0;
+}
+
+static void gf_mpd_frag_cache_push(GF_MPD_FragmentCache *fc, FILE *out, u32 offset, u32 size)
+{
+	if (fc->pending_size && (fc->pending_offset + fc->pending_size == offset)) {
+		fc->pending_size += size;
+		return;
+	}
+	gf_mpd_frag_cache_flush(fc, out);
+	fc->pending_offset = offset;
+	fc->pending_size = size;
+}
+
+//looks for a cached fragment starting at item idx with the given writer state, and schedules its text for output
+static GF_MPD_Fragment *gf_mpd_frag_cache_match(GF_MPD_FragmentCache *fc, FILE *out, GF_List *items, u32 idx, u32 count, u64 check, u64 state)
+{
+	u32 i, max_frag;
+	void *src = gf_list_get(items, idx);
+	if (!fc) return NULL;
+
+	//once matched, fragments must follow each other - until then, skip fragments of items purged since last pass
+	max_frag = fc->next_frag + (fc->matched ? 1 : 4);
+	if (max_frag > fc->nb_frags) max_frag = fc->nb_frags;
+
+	for (i=fc->next_frag; i<max_frag; i++) {
+		GF_MPD_Fragment *frag = &fc->frags[i];
+		if ((frag->src != src) || (frag->check != check) || (frag->state != state)) continue;
+		if ((idx + frag->nb_src > count) || (gf_list_get(items, idx + frag->nb_src - 1) != frag->last)) break;
+
+		if (!fc->matched) {
+			fc->matched = GF_TRUE;
+			fc->first_frag = i;
+		}
+		fc->next_frag = i+1;
+		gf_mpd_frag_cache_push(fc, out, frag->offset, frag->size);
+		return frag;
+	}
+	return NULL;
+}
+
+//starts serializing a new stable fragment, returns the file to write the fragment to
+static FILE *gf_mpd_frag_cache_start(GF_MPD_FragmentCache *fc)
+{
+	//discard fragments not matched, they can no longer be used
+	fc->nb_frags = fc->next_frag;
+	if (fc->nb_frags) {
+		GF_MPD_Fragment *frag = &fc->frags[fc->nb_frags-1];
+		fc->start_offset = frag->offset + frag->size;
+	} else {
+		fc->start_offset = 0;
+	}
+	gf_fseek(fc->text, fc->start_offset, SEEK_SET);
+	return fc->text;
+}
+
+static void gf_mpd_frag_cache_end(GF_MPD_FragmentCache *fc, FILE *out, void *src, u64 check, u64 state, u64 next_state, void *last, u32 nb_src)
+{
+	u32 size;
+	GF_MPD_Fragment *frag;
+	gf_fileio_mem_writer_data(fc->text, &size);
+	size -= fc->start_offset;
+
+	if (fc->nb_frags == fc->nb_alloc) {
+		fc->nb_alloc = fc->nb_alloc ? 2*fc->nb_alloc : 32;
+		fc->frags = gf_realloc(fc->frags, sizeof(GF_MPD_Fragment) * fc->nb_alloc);
+		if (!fc->frags) {
+			fc->nb_alloc = fc->nb_frags = fc->next_frag = 0;
+			return;
+		}
+	}
+	frag = &fc->frags[fc->nb_frags];
+	frag->src = src;
+	frag->check = check;
+	frag->state = state;
+	frag->next_state = next_state;
+	frag->last = last;
+	frag->nb_src = nb_src;
+	frag->offset = fc->start_offset;
+	frag->size = size;
+	if (!fc->matched) {
+		fc->matched = GF_TRUE;
+		fc->first_frag = fc->nb_frags;
+	}
+	fc->nb_frags++;
+	fc->next_frag = fc->nb_frags;
+	gf_mpd_frag_cache_push(fc, out, frag->offset, frag->size);
+}
+
+//ends a write pass, flushing pending text and removing fragments no longer used
+static void gf_mpd_frag_cache_done(GF_MPD_FragmentCache *fc, FILE *out)
+{
+	u32 i, offset, size;
+	u8 *data;
+	if (!fc) return;
+	gf_mpd_frag_cache_flush(fc, out);
+
+	if (!fc->matched) {
+		fc->nb_frags = 0;
+		gf_fseek(fc->text, 0, SEEK_SET);
+		return;
+	}
+	if (!fc->first_frag && (fc->next_frag == fc->nb_frags)) return;
+
+	fc->nb_frags = fc->next_frag;
+	data = gf_fileio_mem_writer_data(fc->text, &size);
+	offset = fc->frags[fc->first_frag].offset;
+	size = fc->frags[fc->nb_frags-1].offset + fc->frags[fc->nb_frags-1].size - offset;
+	if (offset) memmove(data, data + offset, size);
+	gf_fseek(fc->text, size, SEEK_SET);
+
+	fc->nb_frags -= fc->first_frag;
+	if (fc->first_frag) memmove(fc->frags, &fc->frags[fc->first_frag], sizeof(GF_MPD_Fragment) * fc->nb_frags);
+	for (i=0; i<fc->nb_frags; i++)
+		fc->frags[i].offset -= offset;
+}
+
 static void gf_mpd_print_segment_timeline(FILE *out, GF_MPD_SegmentTimeline *tl, s32 indent, u32 tsb_first_entry)
 {
-	u32 i, count, rcount;
+	u32 i, count;
 	u64 start_time=0;
-	GF_MPD_SegmentTimelineEntry *se, *prev;
+	GF_MPD_FragmentCache *fc;
 
 	gf_mpd_nl(out, indent);
 	gf_fprintf(out, "<SegmentTimeline>");
 	gf_mpd_lf(out, indent);
 
-	prev = gf_list_get(tl->entries, tsb_first_entry);
 	count = gf_list_count(tl->entries);
-	if (!prev) goto done_tl;
-
-	gf_mpd_nl(out, indent+1);
-	gf_fprintf(out, "<S");
-	gf_fprintf(out, " t=\""LLD"\"", prev->start_time);
-	if (prev->duration) gf_fprintf(out, " d=\"%d\"", prev->duration);
-	rcount = prev->repeat_count;
-	start_time = prev->start_time + (prev->repeat_count+1) * prev->duration;
-
-	for (i = tsb_first_entry+1; i<count && prev; i++) {
-		se = gf_list_get(tl->entries, i);
-		//close entry
-		if ((se->start_time != start_time) || (prev->duration!=se->duration)) {
-			if (rcount) gf_fprintf(out, " r=\"%d\"", rcount);
-			gf_fprintf(out, "/>");
-			gf_mpd_lf(out, indent);
-			//start new one
-			gf_mpd_nl(out, indent+1);
-			gf_fprintf(out, "<S");
-			if (se->start_time != start_time) {
-				gf_fprintf(out, " t=\""LLD"\"", se->start_time);
-				start_time = se->start_time;
+	fc = gf_mpd_frag_cache_begin(&tl->print_cache, (u64) indent);
+
+	i = tsb_first_entry;
+	while (i<count) {
+		u32 last, rcount;
+		u64 end_time;
+		FILE *s_out = out;
+		GF_MPD_SegmentTimelineEntry *se = gf_list_get(tl->entries, i);
+
+		//first entry is always written, it has explicit start time and is modified when purging the timeline
+		if (i>tsb_first_entry) {
+			GF_MPD_Fragment *frag = gf_mpd_frag_cache_match(fc, out, tl->entries, i, count, se->start_time, start_time);
+			if (frag) {
+				start_time = frag->next_state;
+				i += frag->nb_src;
+				continue;
 			}
-			if (se->duration) gf_fprintf(out, " d=\"%d\"", se->duration);
-			rcount=0;
-		} else {
-			rcount++;
 		}
-		start_time += (se->repeat_count+1) * se->duration;
-		rcount += se->repeat_count;
-		prev = se;
-	}
-	//close last entry
-	if (rcount) gf_fprintf(out, " r=\"%d\"", rcount);
-	gf_fprintf(out, "/>");
-	gf_mpd_lf(out, indent);
 
+		//merge following entries in this element
+		last = i;
+		rcount = se->repeat_count;
+		end_time = se->start_time + (se->repeat_count+1) * se->duration;
+		while (last+1<count) {
+			GF_MPD_SegmentTimelineEntry *next = gf_list_get(tl->entries, last+1);
+			if ((next->start_time != end_time) || (next->duration != se->duration)) break;
+			rcount += next->repeat_count + 1;
+			end_time += (next->repeat_count+1) * next->duration;
+			last++;
+		}
+
+		//the last two entries may still be modified, only cache elements not using them
+		if (fc) {
+			if ((i>tsb_first_entry) && (last+4 <= count)) s_out = gf_mpd_frag_cache_start(fc);
+			else gf_mpd_frag_cache_flush(fc, out);
+		}
+
+		gf_mpd_nl(s_out, indent+1);
+		gf_fprintf(s_out, "<S");
+		if ((i==tsb_first_entry) || (se->start_time != start_time))
+			gf_fprintf(s_out, " t=\""LLD"\"", se->start_time);
+		if (se->duration) gf_fprintf(s_out, " d=\"%d\"", se->duration);
+		if (rcount) gf_fprintf(s_out, " r=\"%d\"", rcount);
+		gf_fprintf(s_out, "/>");
+		gf_mpd_lf(s_out, indent);
+
+		if (s_out != out)
+			gf_mpd_frag_cache_end(fc, out, se, se->start_time, start_time, end_time, gf_list_get(tl->entries, last), last - i + 1);
+
+		start_time = end_time;
+		i = last+1;
+	}
+	gf_mpd_frag_cache_done(fc, out);
 
-done_tl:
 	gf_mpd_nl(out, indent);
 	gf_fprintf(out, "</SegmentTimeline>");
 	gf_mpd_lf(out, indent);
@@ -3714,9 +3924,8 @@ static const char *gf_mpd_m3u8_get_init_seg(const GF_MPD_Period *period, const G
 	return url;
 }
 
-static void hls_insert_crypt_info(FILE *out, GF_MPD_Representation *rep, GF_DASH_SegmentContext *sctx, const char **last_kms)
+static const char *hls_get_kms(GF_MPD_Representation *rep, GF_DASH_SegmentContext *sctx)
 {
-	if (!rep->crypto_type) return;
 	const char *kms;
 	if (!sctx->encrypted)
 		kms = "NONE";
@@ -3728,6 +3937,29 @@ static void hls_insert_crypt_info(FILE *out, GF_MPD_Representation *rep, GF_DASH
 			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[HLS] Missing key URI in one or more keys - will use dummy one %s\n", kms));
 		}
 	}
+	return kms;
+}
+
+//crypto state of the playlist writer, used to check cached segments
+static u64 hls_crypt_state(GF_MPD_Representation *rep, const char *last_kms)
+{
+	if (!rep->crypto_type || !last_kms) return 0;
+	return 1 + (u64) gf_crc_32(last_kms, (u32) strlen(last_kms));
+}
+
+//update crypto state for a segment written from cache
+static void hls_update_crypt_state(GF_MPD_Representation *rep, GF_DASH_SegmentContext *sctx, const char **last_kms)
+{
+	if (!rep->crypto_type) return;
+	const char *kms = hls_get_kms(rep, sctx);
+	if (! *last_kms || strcmp(kms, *last_kms))
+		*last_kms = (rep->crypto_type==2) ? kms : NULL;
+}
+
+static void hls_insert_crypt_info(FILE *out, GF_MPD_Representation *rep, GF_DASH_SegmentContext *sctx, const char **last_kms)
+{
+	if (!rep->crypto_type) return;
+	const char *kms = hls_get_kms(rep, sctx);
 
 	if (! *last_kms || strcmp(kms, *last_kms)) {
 		if (!strcmp(kms, "NONE")) {
@@ -3763,6 +3995,8 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 	char *force_url=NULL;
 	const char *last_kms = NULL;
 	Bool close_file = GF_FALSE;
+	GF_MPD_FragmentCache *fc;
+	u64 cache_params;
 
 	if (!strcmp(m3u8_name, "std")) out = stdout;
 	else if (mpd->create_m3u8_files) {
@@ -3770,7 +4004,7 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 		if (!out) return GF_IO_ERR;
 		close_file = GF_TRUE;
 	} else {
-		out = gf_file_temp(NULL);
+		out = gf_fileio_mem_writer(NULL, NULL, 0);
 		if (rep->m3u8_var_file) gf_fclose(rep->m3u8_var_file);
 		rep->m3u8_var_file = out;
 	}
@@ -3812,6 +4046,12 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 		gf_fprintf(out,"#EXT-X-I-FRAMES-ONLY\n");
 	}
 
+	//segment lines only depend on crypto, base URL and segment mode
+	cache_params = rep->crypto_type;
+	if (force_base_url) cache_params |= ((u64) gf_crc_32(force_base_url, (u32) strlen(force_base_url))) << 8;
+	if (sctx && sctx->filename) cache_params |= 0x80;
+	fc = gf_mpd_frag_cache_begin(&rep->m3u8_cache, cache_params);
+
 	//one file per segment
 	if (sctx && sctx->filename) {
 		if (rep->hls_single_file_name) {
@@ -3828,10 +4068,23 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 
 		for (i=rep->tsb_first_entry; i<count; i++) {
 			Double dur;
+			u64 crypt_state=0;
+			FILE *seg_out = out;
 			sctx = gf_list_get(rep->state_seg_list, i);
 			gf_assert(sctx->filename);
 
-			hls_insert_crypt_info(out, rep, sctx, &last_kms);
+			if (fc) {
+				crypt_state = hls_crypt_state(rep, last_kms);
+				if (gf_mpd_frag_cache_match(fc, out, rep->state_seg_list, i, count, sctx->seg_num, crypt_state)) {
+					hls_update_crypt_state(rep, sctx, &last_kms);
+					continue;
+				}
+				//segments no longer listing parts are done and can be cached
+				if (i+4<count) seg_out = gf_mpd_frag_cache_start(fc);
+				else gf_mpd_frag_cache_flush(fc, out);
+			}
+
+			hls_insert_crypt_info(seg_out, rep, sctx, &last_kms);
 
 			u64 next_br_start_plus_one=0;
 			u32 next_seg_idx=0;
@@ -3873,6 +4126,7 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 				}
 				//live edge not done yet
 				if (!sctx->llhls_mode) {
+					gf_mpd_frag_cache_done(fc, out);
 					if (close_file)
 						gf_fclose(out);
 					return GF_OK;
@@ -3936,29 +4190,32 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 								gf_dynstrcat(&par_url, "../", NULL);
 								gf_dynstrcat(&par_url, o_name, NULL);
 							}
-							fprintf(out, "#EXT-X-RENDITION-REPORT:URI=\"%s\",LAST-MSN=%d,LAST-PART=%d\n", par_url ? par_url : o_name, o_sctx->seg_num, o_sctx->nb_frags);
+							gf_fprintf(out, "#EXT-X-RENDITION-REPORT:URI=\"%s\",LAST-MSN=%d,LAST-PART=%d\n", par_url ? par_url : o_name, o_sctx->seg_num, o_sctx->nb_frags);
 							if (par_url) gf_free(par_url);
 						}
 					}
 				}
 
+				gf_mpd_frag_cache_done(fc, out);
 				if (close_file)
 					gf_fclose(out);
 				return GF_OK;
 			}
 			dur = (Double) sctx->dur;
 			dur /= rep->timescale;
-			gf_fprintf(out,"#EXTINF:%g,\n", dur);
+			gf_fprintf(seg_out,"#EXTINF:%g,\n", dur);
 
 			if (force_base_url)
 				force_url = gf_url_concatenate(force_base_url, sctx->filename);
 
-			gf_fprintf(out,"%s\n", force_url ? force_url : sctx->filename);
+			gf_fprintf(seg_out,"%s\n", force_url ? force_url : sctx->filename);
 
 			if (force_url) {
 				gf_free(force_url);
 				force_url = NULL;
 			}
+			if (seg_out != out)
+				gf_mpd_frag_cache_end(fc, out, sctx, sctx->seg_num, crypt_state, 0, sctx, 1);
 		}
 	}
 	//byte-range in single file
@@ -3977,6 +4234,7 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 
 		base_url = gf_list_get(rep->base_URLs, 0);
 		if (!base_url) {
+			gf_mpd_frag_cache_done(fc, out);
 			if (close_file)
 				gf_fclose(out);
 			return GF_SERVICE_ERROR;
@@ -4001,27 +4259,42 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 
 		for (i=rep->tsb_first_entry; i<count; i++) {
 			Double dur;
+			u64 crypt_state=0;
+			FILE *seg_out = out;
 			sctx = gf_list_get(rep->state_seg_list, i);
 			gf_assert(!sctx->filename);
 			gf_assert(sctx->file_size);
 
-			hls_insert_crypt_info(out, rep, sctx, &last_kms);
+			if (fc) {
+				crypt_state = hls_crypt_state(rep, last_kms);
+				if (gf_mpd_frag_cache_match(fc, out, rep->state_seg_list, i, count, sctx->seg_num, crypt_state)) {
+					hls_update_crypt_state(rep, sctx, &last_kms);
+					continue;
+				}
+				if (i+4<count) seg_out = gf_mpd_frag_cache_start(fc);
+				else gf_mpd_frag_cache_flush(fc, out);
+			}
+
+			hls_insert_crypt_info(seg_out, rep, sctx, &last_kms);
 
 			dur = (Double) sctx->dur;
 			dur /= rep->timescale;
-			gf_fprintf(out,"#EXTINF:%g\n", dur);
-			gf_fprintf(out,"#EXT-X-BYTERANGE:%d@"LLU"\n", sctx->file_size, sctx->file_offset);
+			gf_fprintf(seg_out,"#EXTINF:%g\n", dur);
+			gf_fprintf(seg_out,"#EXT-X-BYTERANGE:%d@"LLU"\n", sctx->file_size, sctx->file_offset);
 			if (force_base_url)
 				force_url = gf_url_concatenate(force_base_url, b_url);
 
-			gf_fprintf(out,"%s\n", force_url ? force_url : b_url);
+			gf_fprintf(seg_out,"%s\n", force_url ? force_url : b_url);
 
 			if (force_url) {
 				gf_free(force_url);
 				force_url = NULL;
 			}
+			if (seg_out != out)
+				gf_mpd_frag_cache_end(fc, out, sctx, sctx->seg_num, crypt_state, 0, sctx, 1);
 		}
 	}
+	gf_mpd_frag_cache_done(fc, out);
 
 	if (mpd->type != GF_MPD_TYPE_DYNAMIC)
 		gf_fprintf(out,"\n#EXT-X-ENDLIST\n");
@@ -4033,6 +4306,7 @@ static GF_Err gf_mpd_write_m3u8_playlist(const GF_MPD *mpd, const GF_MPD_Period
 }
 
 
+GF_EXPORT
 GF_Err gf_mpd_write_m3u8_master_playlist(GF_MPD const * const mpd, FILE *out, const char* m3u8_name, GF_MPD_Period *period, GF_M3U8WriteMode mode)
 {
 	u32 i, j, hls_version;
@@ -4333,6 +4607,7 @@ GF_Err gf_mpd_write_m3u8_master_playlist(GF_MPD const * const mpd, FILE *out, co
 
 
 
+GF_EXPORT
 GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact)
 {
 	u32 i, count, child_idx;
@@ -4468,6 +4743,12 @@ GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact)
 		gf_xml_dump_string(out, "<Location>", text, "</Location>");
 		gf_mpd_lf(out, indent);
 	}
+	if (mpd->patch_location) {
+		gf_mpd_extensible_print_nodes(out, mpd->x_children, indent, &child_idx, GF_FALSE);
+		gf_mpd_nl(out, indent+1);
+		gf_xml_dump_string(out, "<PatchLocation>", mpd->patch_location, "</PatchLocation>");
+		gf_mpd_lf(out, indent);
+	}
 
 	if (mpd->inject_service_desc) {
 		gf_mpd_extensible_print_nodes(out, mpd->x_children, indent, &child_idx, GF_FALSE);
@@ -4527,6 +4808,96 @@ print_periods:
 	return GF_OK;
 }
 
+static void gf_mpd_write_patch_timeline(FILE *out, GF_MPD_MultipleSegmentBase *ms, Bool is_template, const char *sel, s32 indent, s32 tl_indent)
+{
+	if (!ms || !ms->segment_timeline) return;
+	gf_mpd_nl(out, indent+1);
+	gf_fprintf(out, "<replace sel=\"%s/%s/SegmentTimeline\">", sel, is_template ? "SegmentTemplate" : "SegmentList");
+	gf_mpd_lf(out, indent);
+	//use same indentation as in the MPD to share the timeline serialization cache
+	gf_mpd_print_segment_timeline(out, ms->segment_timeline, tl_indent, ms->tsb_first_entry);
+	gf_mpd_nl(out, indent+1);
+	gf_fprintf(out, "</replace>");
+	gf_mpd_lf(out, indent);
+}
+
+GF_EXPORT
+GF_Err gf_mpd_write_patch(GF_MPD const * const mpd, FILE *out, u64 original_publish_time, Bool compact)
+{
+	u32 i, j, k;
+	s32 indent = compact ? GF_INT_MIN : 0;
+	GF_MPD_Period *period;
+	char *sel_p=NULL, *sel_as=NULL, *sel_rep=NULL;
+	char szID[100];
+
+	if (!mpd || !mpd->ID || (mpd->type != GF_MPD_TYPE_DYNAMIC)) return GF_BAD_PARAM;
+
+	gf_fprintf(out, "<?xml version=\"1.0\"?>");
+	gf_mpd_lf(out, indent);
+	gf_xml_dump_string(out, "<Patch xmlns=\"urn:mpeg:dash:schema:mpd-patch:2020\" mpdId=\"", mpd->ID, "\"");
+	gf_mpd_print_date(out, "originalPublishTime", original_publish_time);
+	gf_mpd_print_date(out, "publishTime", mpd->publishTime);
+	gf_fprintf(out, ">");
+	gf_mpd_lf(out, indent);
+
+	gf_mpd_nl(out, indent+1);
+	gf_fprintf(out, "<replace sel=\"/MPD/@publishTime\">");
+	gf_mpd_print_date(out, NULL, mpd->publishTime);
+	gf_fprintf(out, "</replace>");
+	gf_mpd_lf(out, indent);
+
+	i=0;
+	while ((period = gf_list_enum(mpd->periods, &i))) {
+		GF_MPD_AdaptationSet *as;
+		if (period->ID) {
+			gf_dynstrcat(&sel_p, "/MPD/Period[@id='", NULL);
+			gf_dynstrcat(&sel_p, period->ID, NULL);
+			gf_dynstrcat(&sel_p, "']", NULL);
+		} else {
+			sprintf(szID, "/MPD/Period[%d]", i);
+			gf_dynstrcat(&sel_p, szID, NULL);
+		}
+		gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) period->segment_template, GF_TRUE, sel_p, indent, indent+3);
+		gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) period->segment_list, GF_FALSE, sel_p, indent, indent+3);
+
+		j=0;
+		while ((as = gf_list_enum(period->adaptation_sets, &j))) {
+			GF_MPD_Representation *rep;
+			gf_dynstrcat(&sel_as, sel_p, NULL);
+			if (as->id>=0) sprintf(szID, "/AdaptationSet[@id='%d']", as->id);
+			else sprintf(szID, "/AdaptationSet[%d]", j);
+			gf_dynstrcat(&sel_as, szID, NULL);
+			gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) as->segment_template, GF_TRUE, sel_as, indent, indent+4);
+			gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) as->segment_list, GF_FALSE, sel_as, indent, indent+4);
+
+			k=0;
+			while ((rep = gf_list_enum(as->representations, &k))) {
+				if (!rep->segment_template && !rep->segment_list) continue;
+				gf_dynstrcat(&sel_rep, sel_as, NULL);
+				if (rep->id) {
+					gf_dynstrcat(&sel_rep, "/Representation[@id='", NULL);
+					gf_dynstrcat(&sel_rep, rep->id, NULL);
+					gf_dynstrcat(&sel_rep, "']", NULL);
+				} else {
+					sprintf(szID, "/Representation[%d]", k);
+					gf_dynstrcat(&sel_rep, szID, NULL);
+				}
+				gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) rep->segment_template, GF_TRUE, sel_rep, indent, indent+5);
+				gf_mpd_write_patch_timeline(out, (GF_MPD_MultipleSegmentBase *) rep->segment_list, GF_FALSE, sel_rep, indent, indent+5);
+				sel_rep[0] = 0;
+			}
+			sel_as[0] = 0;
+		}
+		sel_p[0] = 0;
+	}
+	if (sel_p) gf_free(sel_p);
+	if (sel_as) gf_free(sel_as);
+	if (sel_rep) gf_free(sel_rep);
+
+	gf_fprintf(out, "</Patch>");
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_mpd_write_file(GF_MPD const * const mpd, const char *file_name)
 {
@@ -5630,7 +6001,9 @@ GF_EXPORT
 GF_Err gf_mpd_smooth_to_mpd(char * smooth_file, GF_MPD *mpd, const char *default_base_url)
 {
 	GF_DOMParser *dom = gf_xml_dom_new();
-	GF_Err e = gf_xml_dom_parse(dom, smooth_file, NULL, 0);
+	GF_Err e;
+	gf_xml_dom_enable_arena(dom);
+	e = gf_xml_dom_parse(dom, smooth_file, NULL, 0);
 	if (!e) {
 		e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(dom), mpd, default_base_url);
 		if (e) {
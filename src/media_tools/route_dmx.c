@@ -113,6 +113,10 @@ typedef struct {
 	u16 flute_symbol_size, flute_nb_symbols;
 } GF_FLUTELLMapEntry;
 
+typedef struct {
+	u32 sbn, esi;
+} GF_LCTRepairInfo;
+
 
 typedef struct
 {
@@ -140,6 +144,12 @@ typedef struct
 
 	u32 flute_symbol_size, flute_nb_symbols;
 
+	//AL-FEC parameters, and repair symbols received for source blocks not yet recovered
+	u32 fec_symbol_size, fec_max_sbl;
+	u32 fec_nb_repairs, fec_alloc_repairs;
+	GF_LCTRepairInfo *fec_repairs;
+	u8 *fec_data;
+
     char solved_path[GF_MAX_PATH];
 
 	//for flute ll, we rebuild the complete segment so we need a map of chunk TOIs
@@ -167,7 +177,7 @@ typedef enum
 	GF_ROUTE_TUNE_SLS_ONLY,
 } GF_ROUTETuneMode;
 
-typedef GF_Err (*gf_service_process)(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess);
+typedef GF_Err (*gf_service_process)(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, u8 *data, u32 nb_read);
 struct __route_service
 {
 	u32 service_id;
@@ -203,6 +213,10 @@ struct __route_service
 //- following segment for packet reorder tests
 #define MAX_SEG_IN_NRT	4
 
+//number of datagrams fetched at once on a socket, and max size of a datagram
+#define GF_ROUTE_NB_DGRAMS	32
+#define GF_ROUTE_DGRAM_SIZE	10000
+
 struct __gf_routedmx {
 	const char *ip_ifce;
 	const char *netcap_id;
@@ -211,6 +225,12 @@ struct __gf_routedmx {
 	u32 buffer_size;
 	u8 *unz_buffer;
 	u32 unz_buffer_size;
+	//datagram slots for batched reception
+	GF_SockDatagram dgrams[GF_ROUTE_NB_DGRAMS];
+	u8 *dgram_buffer;
+	//scratch buffer for AL-FEC recovery
+	u8 *fec_buf;
+	u32 fec_buf_size;
 
 	u64 reorder_timeout;
 	Bool force_in_order;
@@ -244,8 +264,210 @@ struct __gf_routedmx {
 	Bool dvb_mabr;
 };
 
-static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess);
-static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess);
+static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, u8 *data, u32 nb_read);
+static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, u8 *data, u32 nb_read);
+
+/*
+	Reed-Solomon erasure code over GF(2^8), FEC Encoding ID 5 of RFC 5510
+
+	Encoding symbol j of a block is the evaluation of the block message on column j of the Vandermonde matrix
+	V[i][j] = alpha^(i*j), the message being chosen so that the first k encoding symbols are the source symbols.
+	Any k encoding symbols of ESI S give back the message u = c_S * V_S^-1, from which any other symbol is computed
+*/
+//powers of alpha (twice, to avoid modulo on log sums) and logs in GF(2^8) with primitive polynomial x^8 + x^4 + x^3 + x^2 + 1
+static const u8 rs_exp[510] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+	0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+	0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+	0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+	0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+	0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+	0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+	0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+	0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+	0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+	0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+	0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+	0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+	0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+	0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+	0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+	0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+	0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+	0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+	0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+	0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+	0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+	0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+	0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+	0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+	0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+	0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+	0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+	0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+	0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+	0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+	0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E
+};
+
+//rs_log[0] is unused
+static const u8 rs_log[256] = {
+	0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+	0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+	0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+	0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+	0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+	0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+	0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+	0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+	0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+	0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+	0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+	0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+	0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+	0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+	0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+	0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF
+};
+
+static GFINLINE u8 rs_mul(u8 a, u8 b)
+{
+	if (!a || !b) return 0;
+	return rs_exp[rs_log[a] + rs_log[b]];
+}
+
+//dst ^= c * src
+static void rs_addmul(u8 *dst, const u8 *src, u8 c, u32 size)
+{
+	u32 i;
+	u8 row[256];
+	if (!c) return;
+	if (c==1) {
+		for (i=0; i<size; i++) dst[i] ^= src[i];
+		return;
+	}
+	row[0] = 0;
+	for (i=1; i<256; i++) row[i] = rs_exp[rs_log[i] + rs_log[c]];
+	for (i=0; i<size; i++) dst[i] ^= row[src[i]];
+}
+
+//computes symbols of ESIs out_esis from the k symbols of ESIs in_esis, output buffers must be zeroed
+static GF_Err rs_combine(u8 **in, const u32 *in_esis, u32 k, u8 **out, const u32 *out_esis, u32 nb_out, u32 symbol_size)
+{
+	u32 i, j, l;
+	u8 *mat, *inv;
+
+	for (i=0; i<k; i++) {
+		if (in_esis[i]>=255) return GF_BAD_PARAM;
+	}
+	for (i=0; i<nb_out; i++) {
+		if (out_esis[i]>=255) return GF_BAD_PARAM;
+	}
+	mat = gf_malloc(sizeof(u8) * k * k * 2);
+	if (!mat) return GF_OUT_OF_MEM;
+	inv = mat + k*k;
+	//mat = V_S, inv = identity
+	for (i=0; i<k; i++) {
+		for (j=0; j<k; j++) {
+			mat[i*k + j] = rs_exp[(i*in_esis[j]) % 255];
+			inv[i*k + j] = (i==j) ? 1 : 0;
+		}
+	}
+	//Gauss-Jordan elimination
+	for (j=0; j<k; j++) {
+		u8 pinv;
+		u32 piv = j;
+		while ((piv<k) && !mat[piv*k + j]) piv++;
+		if (piv==k) {
+			gf_free(mat);
+			return GF_CORRUPTED_DATA;
+		}
+		if (piv != j) {
+			for (l=0; l<k; l++) {
+				u8 t = mat[j*k + l]; mat[j*k + l] = mat[piv*k + l]; mat[piv*k + l] = t;
+				t = inv[j*k + l]; inv[j*k + l] = inv[piv*k + l]; inv[piv*k + l] = t;
+			}
+		}
+		pinv = rs_exp[255 - rs_log[mat[j*k + j]]];
+		for (l=0; l<k; l++) {
+			mat[j*k + l] = rs_mul(mat[j*k + l], pinv);
+			inv[j*k + l] = rs_mul(inv[j*k + l], pinv);
+		}
+		for (i=0; i<k; i++) {
+			u8 f = mat[i*k + j];
+			if ((i==j) || !f) continue;
+			for (l=0; l<k; l++) {
+				mat[i*k + l] ^= rs_mul(f, mat[j*k + l]);
+				inv[i*k + l] ^= rs_mul(f, inv[j*k + l]);
+			}
+		}
+	}
+	//out_j = sum_l in_l * (V_S^-1 * V_j)[l], we reuse mat for the coefficient vector
+	for (j=0; j<nb_out; j++) {
+		for (l=0; l<k; l++) {
+			u8 c = 0;
+			for (i=0; i<k; i++) {
+				c ^= rs_mul(inv[l*k + i], rs_exp[(i*out_esis[j]) % 255]);
+			}
+			mat[l] = c;
+		}
+		for (l=0; l<k; l++) {
+			rs_addmul(out[j], in[l], mat[l], symbol_size);
+		}
+	}
+	gf_free(mat);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_route_fec_rs_encode(u8 **src, u32 k, u32 symbol_size, u8 **repair, u32 nb_repair)
+{
+	u32 i, esis[255], out_esis[255];
+	if (!src || !repair || !k || (k+nb_repair>255)) return GF_BAD_PARAM;
+	for (i=0; i<k; i++) esis[i] = i;
+	for (i=0; i<nb_repair; i++) {
+		out_esis[i] = k+i;
+		memset(repair[i], 0, symbol_size);
+	}
+	return rs_combine(src, esis, k, repair, out_esis, nb_repair, symbol_size);
+}
+
+GF_EXPORT
+GF_Err gf_route_fec_rs_decode(u8 **symbols, const u32 *esis, u32 k, u32 symbol_size, u8 **sources)
+{
+	u32 i, nb_out=0, out_esis[255];
+	u8 *out[255];
+	if (!symbols || !esis || !sources || !k || (k>255)) return GF_BAD_PARAM;
+	for (i=0; i<k; i++) {
+		if (!sources[i]) continue;
+		out[nb_out] = sources[i];
+		out_esis[nb_out] = i;
+		memset(sources[i], 0, symbol_size);
+		nb_out++;
+	}
+	if (!nb_out) return GF_OK;
+	return rs_combine(symbols, esis, k, out, out_esis, nb_out, symbol_size);
+}
+
+GF_EXPORT
+u32 gf_route_fec_source_block(u32 transfer_length, u32 symbol_size, u32 max_sbl, u32 sbn, u32 *block_offset, u32 *block_k)
+{
+	u32 T, N, A_large, A_small, I;
+	if (!transfer_length || !symbol_size || !max_sbl) return 0;
+	T = (transfer_length + symbol_size - 1) / symbol_size;
+	N = (T + max_sbl - 1) / max_sbl;
+	A_large = (T + N - 1) / N;
+	A_small = T / N;
+	I = T - A_small * N;
+	if (sbn < N) {
+		if (block_offset) {
+			if (sbn < I) *block_offset = sbn * A_large * symbol_size;
+			else *block_offset = (I * A_large + (sbn - I) * A_small) * symbol_size;
+		}
+		if (block_k) *block_k = (sbn < I) ? A_large : A_small;
+	}
+	return N;
+}
 
 
 static void gf_route_static_files_del(GF_List *files)
@@ -283,6 +505,8 @@ static void gf_route_lct_obj_del(GF_LCTObject *o)
 		gf_free(o->rlct_file);
 	}
 	if (o->ll_map) gf_free(o->ll_map);
+	if (o->fec_repairs) gf_free(o->fec_repairs);
+	if (o->fec_data) gf_free(o->fec_data);
 	gf_free(o);
 }
 
@@ -316,6 +540,8 @@ void gf_route_dmx_del(GF_ROUTEDmx *routedmx)
 
 	if (routedmx->buffer) gf_free(routedmx->buffer);
 	if (routedmx->unz_buffer) gf_free(routedmx->unz_buffer);
+	if (routedmx->dgram_buffer) gf_free(routedmx->dgram_buffer);
+	if (routedmx->fec_buf) gf_free(routedmx->fec_buf);
 	if (routedmx->atsc_sock) gf_sk_del(routedmx->atsc_sock);
     if (routedmx->dom) gf_xml_dom_del(routedmx->dom);
     if (routedmx->blob_mx) gf_mx_del(routedmx->blob_mx);
@@ -342,6 +568,7 @@ static GF_ROUTEDmx *gf_route_dmx_new_internal(const char *ifce, u32 sock_buffer_
 							  void (*on_event)(void *udta, GF_ROUTEEventType evt, u32 evt_param, GF_ROUTEEventFileInfo *info),
 							  void *udta, const char *log_name)
 {
+	u32 i;
 	GF_ROUTEDmx *routedmx;
 	GF_Err e;
 	GF_SAFEALLOC(routedmx, GF_ROUTEDmx);
@@ -358,6 +585,7 @@ static GF_ROUTEDmx *gf_route_dmx_new_internal(const char *ifce, u32 sock_buffer_
 		gf_route_dmx_del(routedmx);
 		return NULL;
 	}
+	gf_xml_dom_enable_arena(routedmx->dom);
 	routedmx->services = gf_list_new();
 	if (!routedmx->services) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Failed to allocate ROUTE service list\n", log_name));
@@ -393,6 +621,16 @@ static GF_ROUTEDmx *gf_route_dmx_new_internal(const char *ifce, u32 sock_buffer_
 		gf_route_dmx_del(routedmx);
 		return NULL;
 	}
+	routedmx->dgram_buffer = gf_malloc(GF_ROUTE_NB_DGRAMS * GF_ROUTE_DGRAM_SIZE);
+	if (!routedmx->dgram_buffer) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Failed to allocate socket buffer\n", log_name));
+		gf_route_dmx_del(routedmx);
+		return NULL;
+	}
+	for (i=0; i<GF_ROUTE_NB_DGRAMS; i++) {
+		routedmx->dgrams[i].buffer = routedmx->dgram_buffer + i * GF_ROUTE_DGRAM_SIZE;
+		routedmx->dgrams[i].size = GF_ROUTE_DGRAM_SIZE;
+	}
 
 	routedmx->active_sockets = gf_sk_group_new();
 	if (!routedmx->active_sockets) {
@@ -488,6 +726,7 @@ static GF_ROUTEService *gf_route_create_service(GF_ROUTEDmx *routedmx, const cha
 	service->log_name = gf_strdup(log_name);
 
 	service->sock = gf_sk_new_ex(GF_SOCK_TYPE_UDP, routedmx->netcap_id);
+	gf_sk_set_usr_data(service->sock, service);
 	if (gf_sk_has_nrt_netcap(service->sock))
 		routedmx->nrt_max_seg = MAX_SEG_IN_NRT;
 
@@ -783,6 +1022,8 @@ static void gf_route_obj_to_reservoir(GF_ROUTEDmx *routedmx, GF_ROUTEService *s,
 	obj->ll_maps_count = 0;
 	obj->ll_map_last = 0;
 	obj->flute_type = 0;
+	obj->fec_nb_repairs = 0;
+	obj->fec_max_sbl = 0;
 
 	obj->rlct = NULL;
 	//flute rlct file, delete
@@ -954,6 +1195,7 @@ static GF_Err gf_route_dmx_process_dvb_flute_signaling(GF_ROUTEDmx *routedmx, GF
 		u32 content_length=0;
 		char *content_type=NULL;
 		u32 flute_symbol_size = 0;
+		u32 fec_enc_id = 0, fec_max_sbl = 0;
 		u32 a_idx=0;
 
 		while ( (att = gf_list_enum(fdt->attributes, &a_idx)) ) {
@@ -962,6 +1204,8 @@ static GF_Err gf_route_dmx_process_dvb_flute_signaling(GF_ROUTEDmx *routedmx, GF
 			else if (!strcmp(att->name, "Content-Type")) content_type = att->value;
 			else if (!strcmp(att->name, "Transfer-Length")) content_length = atoi(att->value);
 			else if (!strcmp(att->name, "FEC-OTI-Encoding-Symbol-Length")) flute_symbol_size = atoi(att->value);
+			else if (!strcmp(att->name, "FEC-OTI-FEC-Encoding-ID")) fec_enc_id = atoi(att->value);
+			else if (!strcmp(att->name, "FEC-OTI-Maximum-Source-Block-Length")) fec_max_sbl = atoi(att->value);
 			else if (!strcmp(att->name, "TOI")) toi = atoi(att->value);
 		}
 		if (!toi) continue;
@@ -1080,6 +1324,7 @@ static GF_Err gf_route_dmx_process_dvb_flute_signaling(GF_ROUTEDmx *routedmx, GF
 
 		obj->flute_symbol_size = flute_symbol_size;
 		obj->flute_nb_symbols = flute_nb_symbols;
+		obj->fec_max_sbl = (fec_enc_id==GF_FEC_ENCODING_RS) ? fec_max_sbl : 0;
 
 		obj->rlct = fdt_obj->rlct;
 		obj->flute_type = GF_FLUTE_OBJ;
@@ -1275,6 +1520,7 @@ static GF_Err gf_route_dmx_process_dvb_mcast_signaling(GF_ROUTEDmx *routedmx, GF
 			//need a new socket for the session
 			if ((strcmp(new_s->dst_ip, dst_add)) || (new_s->port != dst_port) ) {
 				rsess->sock = gf_sk_new_ex(GF_SOCK_TYPE_UDP, routedmx->netcap_id);
+				gf_sk_set_usr_data(rsess->sock, new_s);
 				if (gf_sk_has_nrt_netcap(rsess->sock))
 					routedmx->nrt_max_seg = MAX_SEG_IN_NRT;
 
@@ -1856,6 +2102,196 @@ check_done:
 	return gf_route_service_flush_object(s, obj);
 }
 
+static GF_LCTObject *gf_route_service_find_object(GF_ROUTEService *s, u32 tsi, u32 toi)
+{
+	u32 i=0;
+	GF_LCTObject *obj = s->last_active_obj;
+	if (obj && (obj->tsi==tsi) && (obj->toi==toi)) return obj;
+	while ((obj = gf_list_enum(s->objects, &i))) {
+		if ((obj->tsi==tsi) && (obj->toi==toi)) return obj;
+	}
+	return NULL;
+}
+
+static Bool gf_route_obj_has_range(GF_LCTObject *obj, u32 start, u32 end)
+{
+	u32 i;
+	//fragments are sorted and merged
+	for (i=0; i<obj->nb_frags; i++) {
+		if (obj->frags[i].offset > start) return GF_FALSE;
+		if (obj->frags[i].offset + obj->frags[i].size >= end) return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+//try to recover missing source symbols of a block from received source and repair symbols
+static GF_Err gf_route_service_fec_repair_block(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj, u32 sbn, GF_LCTObject **gather_obj)
+{
+	GF_Err e;
+	u32 i, j, k, block_offset, nb_in=0, nb_missing=0, nb_rep=0;
+	u32 E = obj->fec_symbol_size;
+	u32 esis[255];
+	u8 *symbols[255], *sources[255];
+	u8 *pad_src=NULL;
+
+	if (!gf_route_fec_source_block(obj->total_length, E, obj->fec_max_sbl, sbn, &block_offset, &k))
+		return GF_OK;
+	if (!k || (k>255)) return GF_OK;
+
+	for (i=0; i<obj->fec_nb_repairs; i++) {
+		if (obj->fec_repairs[i].sbn==sbn) nb_rep++;
+	}
+	for (j=0; j<k; j++) {
+		u32 start = block_offset + j*E;
+		u32 end = MIN(start+E, obj->total_length);
+		if (gf_route_obj_has_range(obj, start, end)) continue;
+		nb_missing++;
+	}
+	//not enough symbols yet
+	if (!nb_missing || (nb_rep < nb_missing)) return GF_OK;
+
+	//source symbols are recovered in scratch buffer, followed by last source symbol zero-padded to symbol size
+	if (routedmx->fec_buf_size < (nb_missing+1) * E) {
+		routedmx->fec_buf_size = (nb_missing+1) * E;
+		routedmx->fec_buf = gf_realloc(routedmx->fec_buf, routedmx->fec_buf_size);
+		if (!routedmx->fec_buf) {
+			routedmx->fec_buf_size = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	nb_missing = 0;
+	for (j=0; j<k; j++) {
+		u32 start = block_offset + j*E;
+		u32 end = MIN(start+E, obj->total_length);
+		sources[j] = NULL;
+		if (!gf_route_obj_has_range(obj, start, end)) {
+			sources[j] = routedmx->fec_buf + nb_missing*E;
+			nb_missing++;
+			continue;
+		}
+		if (end-start < E) {
+			pad_src = routedmx->fec_buf + (routedmx->fec_buf_size - E);
+			memcpy(pad_src, obj->payload+start, end-start);
+			memset(pad_src + end-start, 0, E - (end-start));
+			symbols[nb_in] = pad_src;
+		} else {
+			symbols[nb_in] = obj->payload+start;
+		}
+		esis[nb_in] = j;
+		nb_in++;
+	}
+	for (i=0; (i<obj->fec_nb_repairs) && (nb_in<k); i++) {
+		if (obj->fec_repairs[i].sbn!=sbn) continue;
+		symbols[nb_in] = obj->fec_data + i*E;
+		esis[nb_in] = obj->fec_repairs[i].esi;
+		nb_in++;
+	}
+	e = gf_route_fec_rs_decode(symbols, esis, k, E, sources);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[%s] Object TSI %u TOI %u failed to decode FEC block %u: %s\n", s->log_name, obj->tsi, obj->toi, sbn, gf_error_to_string(e) ));
+		return GF_OK;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[%s] Object TSI %u TOI %u recovered %u source symbols of FEC block %u\n", s->log_name, obj->tsi, obj->toi, nb_missing, sbn));
+
+	//remove repair symbols of this block
+	for (i=0, j=0; i<obj->fec_nb_repairs; i++) {
+		if (obj->fec_repairs[i].sbn==sbn) continue;
+		if (i!=j) {
+			obj->fec_repairs[j] = obj->fec_repairs[i];
+			memcpy(obj->fec_data + j*E, obj->fec_data + i*E, E);
+		}
+		j++;
+	}
+	obj->fec_nb_repairs = j;
+
+	//and gather recovered symbols as regular source data
+	e = GF_OK;
+	for (j=0; j<k; j++) {
+		u32 start = block_offset + j*E;
+		u32 end = MIN(start+E, obj->total_length);
+		if (!sources[j]) continue;
+		e = gf_route_service_gather_object(routedmx, s, obj->tsi, obj->toi, start, sources[j], end-start, obj->total_length, GF_FALSE, GF_FALSE, obj->rlct, gather_obj, (s->protocol==GF_SERVICE_DVB_FLUTE) ? (s32) (start/E) : -1, 0);
+		if (e) break;
+	}
+	return e;
+}
+
+//try to recover all source blocks for which repair symbols are pending
+static GF_Err gf_route_service_fec_repair(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj, GF_LCTObject **gather_obj)
+{
+	u32 i=0;
+	while (i<obj->fec_nb_repairs) {
+		u32 nb_repairs = obj->fec_nb_repairs;
+		GF_Err e = gf_route_service_fec_repair_block(routedmx, s, obj, obj->fec_repairs[i].sbn, gather_obj);
+		if (e) return e;
+		//block recovered, its repair symbols are removed
+		if (nb_repairs != obj->fec_nb_repairs) continue;
+		i++;
+		//skip other repair symbols of this block
+		while ((i<obj->fec_nb_repairs) && (obj->fec_repairs[i].sbn == obj->fec_repairs[i-1].sbn)) i++;
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_route_service_gather_repair(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, u32 tsi, u32 toi, u32 total_len, u32 symbol_size, u32 max_sbl, u32 sbn, u32 esi, u8 *data, u32 size, GF_LCTObject **gather_obj)
+{
+	u32 i, k=0;
+	GF_LCTObject *obj = gf_route_service_find_object(s, tsi, toi);
+
+	if (!obj) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] TSI %u TOI %u repair symbol for unknown object, skipping\n", s->log_name, tsi, toi));
+		return GF_OK;
+	}
+	//done or progressive FLUTE object, nothing to repair
+	if ((obj->status>=GF_LCT_OBJ_DONE_ERR) || obj->ll_maps_count)
+		return GF_OK;
+	if (!obj->total_length || (obj->total_length != total_len)) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] TSI %u TOI %u repair symbol for object of unknown or different size, skipping\n", s->log_name, tsi, toi));
+		return GF_OK;
+	}
+	if ((size != symbol_size) || (esi>=255)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[%s] TSI %u TOI %u invalid repair symbol ESI %u size %u\n", s->log_name, tsi, toi, esi, size));
+		return GF_OK;
+	}
+	if (sbn >= gf_route_fec_source_block(total_len, symbol_size, max_sbl, sbn, NULL, &k)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[%s] TSI %u TOI %u invalid source block number %u\n", s->log_name, tsi, toi, sbn));
+		return GF_OK;
+	}
+	//source symbol sent as repair, ignore
+	if (esi<k) return GF_OK;
+
+	//FEC parameters changed, flush repair symbols
+	if ((obj->fec_symbol_size != symbol_size) || (obj->fec_max_sbl != max_sbl)) {
+		obj->fec_nb_repairs = 0;
+		if (obj->fec_symbol_size != symbol_size) {
+			obj->fec_symbol_size = symbol_size;
+			if (obj->fec_alloc_repairs)
+				obj->fec_data = gf_realloc(obj->fec_data, obj->fec_alloc_repairs * symbol_size);
+			if (!obj->fec_data) obj->fec_alloc_repairs = 0;
+		}
+		obj->fec_max_sbl = max_sbl;
+	}
+	for (i=0; i<obj->fec_nb_repairs; i++) {
+		if ((obj->fec_repairs[i].sbn==sbn) && (obj->fec_repairs[i].esi==esi))
+			return GF_OK;
+	}
+	if (obj->fec_nb_repairs == obj->fec_alloc_repairs) {
+		obj->fec_alloc_repairs = obj->fec_alloc_repairs ? 2*obj->fec_alloc_repairs : 16;
+		obj->fec_repairs = gf_realloc(obj->fec_repairs, sizeof(GF_LCTRepairInfo) * obj->fec_alloc_repairs);
+		obj->fec_data = gf_realloc(obj->fec_data, obj->fec_alloc_repairs * symbol_size);
+		if (!obj->fec_repairs || !obj->fec_data) {
+			obj->fec_nb_repairs = obj->fec_alloc_repairs = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	obj->fec_repairs[obj->fec_nb_repairs].sbn = sbn;
+	obj->fec_repairs[obj->fec_nb_repairs].esi = esi;
+	memcpy(obj->fec_data + obj->fec_nb_repairs * symbol_size, data, symbol_size);
+	obj->fec_nb_repairs++;
+
+	return gf_route_service_fec_repair_block(routedmx, s, obj, sbn, gather_obj);
+}
+
 static GF_Err gf_route_service_setup_dash(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, char *content, char *content_location)
 {
 	u32 len = (u32) strlen(content);
@@ -1977,6 +2413,7 @@ static GF_Err gf_route_service_setup_stsid(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 		//need a new socket for the session
 		if ((strcmp(s->dst_ip, dst_ip)) || (s->port != dst_port) ) {
 			rsess->sock = gf_sk_new_ex(GF_SOCK_TYPE_UDP, routedmx->netcap_id);
+			gf_sk_set_usr_data(rsess->sock, s);
 			if (gf_sk_has_nrt_netcap(rsess->sock))
 				routedmx->nrt_max_seg = MAX_SEG_IN_NRT;
 
@@ -2413,32 +2850,21 @@ static GF_Err gf_route_dmx_process_service_signaling(GF_ROUTEDmx *routedmx, GF_R
 
 #define GF_ROUTE_MAX_SIZE 0x40000000
 
-static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, u8 *data, u32 nb_read)
 {
 	GF_Err e;
-	u32 nb_read, v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
+	u32 v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
 	u32 /*a_G=0, a_U=0,*/ a_S=0, a_M=0/*, a_A=0, a_H=0, a_D=0*/;
 	u64 tol_size=0;
 	Bool in_order = GF_TRUE;
 	u32 start_offset;
+	Bool is_repair;
+	u64 fec_tl=0;
+	u32 fec_symbol_size=0, fec_max_sbl=0;
 	GF_ROUTELCTChannel *rlct=NULL;
 	GF_LCTObject *gather_object=NULL;
 
-	if (route_sess) {
-		e = gf_sk_receive_no_select(route_sess->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	} else {
-		e = gf_sk_receive_no_select(s->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	}
-
-	if (e != GF_OK) return e;
-	gf_assert(nb_read);
-
-	routedmx->nb_packets++;
-	routedmx->total_bytes_recv += nb_read;
-	routedmx->last_pck_time = gf_sys_clock_high_res();
-	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
-
-	e = gf_bs_reassign_buffer(routedmx->bs, routedmx->buffer, nb_read);
+	e = gf_bs_reassign_buffer(routedmx->bs, data, nb_read);
 	if (e != GF_OK) return e;
 
 	//parse LCT header
@@ -2483,8 +2909,10 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 		return GF_NON_COMPLIANT_BITSTREAM;
 	}
 
-	if (psi==0) {
-		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] FEC not implemented\n", s->log_name));
+	//PSI b00 is used for repair packets, the code point then gives the FEC encoding ID
+	is_repair = (psi==0) ? GF_TRUE : GF_FALSE;
+	if (is_repair && (cp!=GF_FEC_ENCODING_RS)) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] FEC encoding ID %d not supported\n", s->log_name, cp));
 		return GF_OK;
 	}
 
@@ -2525,14 +2953,14 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] No session with TSI %u defined, skipping packet (TOI %u)\n", s->log_name, tsi, toi));
 			return GF_OK;
 		}
-		for (i=0; rlct && i<rlct->nb_cps; i++) {
+		for (i=0; rlct && !is_repair && i<rlct->nb_cps; i++) {
 			if (rlct->CPs[i].codepoint==cp) {
 				in_order = rlct->CPs[i].order;
 				cp_found = GF_TRUE;
 				break;
 			}
 		}
-		if (!cp_found) {
+		if (!cp_found && !is_repair) {
 			if ((cp==0) || (cp==2) || (cp>=9) ) {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] Unsupported code point %d, skipping packet (TOI %u)\n", s->log_name, cp, toi));
 				return GF_OK;
@@ -2598,6 +3026,17 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 			}
 			break;
 
+		case GF_LCT_EXT_FTI:
+			if (hel!=3) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[%s] Wrong HEL %d for FTI LCT extension, expecting 3\n", s->log_name, hel));
+				break;
+			}
+			fec_tl = gf_bs_read_long_int(routedmx->bs, 48);
+			fec_symbol_size = gf_bs_read_u16(routedmx->bs);
+			fec_max_sbl = gf_bs_read_u8(routedmx->bs);
+			/*max_nb_encoding_symbols = */gf_bs_read_u8(routedmx->bs);
+			break;
+
 		default:
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] Unsupported header extension HEL %d HET %d, ignoring\n", s->log_name, hel, het));
 			break;
@@ -2615,6 +3054,18 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 		else hdr_len -= 1;
 	}
 
+	if (is_repair) {
+		u32 fec_pid = gf_bs_read_u32(routedmx->bs);
+		if (!fec_symbol_size || !fec_max_sbl || (fec_tl>=GF_ROUTE_MAX_SIZE)) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] Repair packet TSI %u TOI %u without valid FTI, skipping\n", s->log_name, tsi, toi));
+			return GF_OK;
+		}
+		pos = (u32) gf_bs_get_position(routedmx->bs);
+		if (pos>nb_read) return GF_NON_COMPLIANT_BITSTREAM;
+		e = gf_route_service_gather_repair(routedmx, s, tsi, toi, (u32) fec_tl, fec_symbol_size, fec_max_sbl, fec_pid>>8, fec_pid & 0xFF, data + pos, nb_read-pos, &gather_object);
+		goto process_object;
+	}
+
 	start_offset = gf_bs_read_u32(routedmx->bs);
 	if (start_offset>=GF_ROUTE_MAX_SIZE) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Invalid start offset %u\n", s->log_name, start_offset));
@@ -2626,8 +3077,12 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 	}
 	pos = (u32) gf_bs_get_position(routedmx->bs);
 
-	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, routedmx->buffer + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object, -1, 0);
+	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, data + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object, -1, 0);
+	//repair symbols pending for this object, source data may complete a block
+	if ((e==GF_OK) && gather_object && gather_object->fec_nb_repairs)
+		e = gf_route_service_fec_repair(routedmx, s, gather_object, &gather_object);
 
+process_object:
 	if (e==GF_EOS) {
 		if (!tsi) {
 			if (gather_object->status==GF_LCT_OBJ_DONE_ERR) {
@@ -2656,33 +3111,19 @@ static GF_Err dmx_process_service_route(GF_ROUTEDmx *routedmx, GF_ROUTEService *
 	return GF_OK;
 }
 
-static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, u8 *data, u32 nb_read)
 {
 	GF_Err e;
 	u32 fdt_symbol_length=0;
-	u32 nb_read, cp , v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cc, tsi, toi, pos;
+	u32 cp , v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cc, tsi, toi, pos;
 	u32 /*a_G=0, a_U=0,*/ a_S=0, a_M=0/*, a_A=0, a_H=0, a_D=0*/;
 	u64 transfert_length=0;
 	u32 start_offset=0;
 	GF_ROUTELCTChannel *rlct=NULL;
 	GF_LCTObject *gather_object=NULL;
-	u32 /*SBN,*/ESI; //Source Block Length  | Encoding Symbol  
-
-	if (route_sess) {
-		e = gf_sk_receive_no_select(route_sess->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	} else {
-		e = gf_sk_receive_no_select(s->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	}
+	u32 SBN=0, ESI; //Source Block Length  | Encoding Symbol  
 
-	if (e != GF_OK) return e;
-	gf_assert(nb_read);
-
-	routedmx->nb_packets++;
-	routedmx->total_bytes_recv += nb_read;
-	routedmx->last_pck_time = gf_sys_clock_high_res();
-	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
-
-	e = gf_bs_reassign_buffer(routedmx->bs, routedmx->buffer, nb_read);
+	e = gf_bs_reassign_buffer(routedmx->bs, data, nb_read);
 	if (e != GF_OK) return e;
 
 	//parse LCT header
@@ -2710,8 +3151,8 @@ static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEServi
 		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Wrong LCT header PSI %d, expecting b00 or b10\n", s->log_name, psi));
 		return GF_NON_COMPLIANT_BITSTREAM;
 	}
-	else if (cp>1) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Wrong LCT header CP %d but only Compact No-Code FEC and raptor FEC are allowed\n", s->log_name, cp));
+	else if ((cp>1) && (cp!=GF_FEC_ENCODING_RS)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[%s] Wrong LCT header CP %d but only Compact No-Code FEC, raptor FEC and Reed-Solomon FEC are allowed\n", s->log_name, cp));
 		return GF_NON_COMPLIANT_BITSTREAM;
 	}
 	else if (S && H) {
@@ -2755,6 +3196,8 @@ static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEServi
 			break;
 
 		case GF_LCT_EXT_FTI:
+			//Reed-Solomon FTI, only used by repair packets, FEC parameters are taken from FDT
+			if (cp==GF_FEC_ENCODING_RS) break;
 		{
 			transfert_length = gf_bs_read_int(routedmx->bs, 48);
 			/*u16 Fec_instance_ID = */gf_bs_read_int(routedmx->bs, 16);
@@ -2780,10 +3223,16 @@ static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEServi
 		else hdr_len -= 1;
 	}
 
-	//both no-code and raptor use 16 bits for each SBN and ESI
-	/*SBN =(u32) */gf_bs_read_u16(routedmx->bs);
-	ESI = (u32) gf_bs_read_u16(routedmx->bs);
+	//both no-code and raptor use 16 bits for each SBN and ESI, Reed-Solomon uses 24 bits SBN and 8 bits ESI
+	if (cp==GF_FEC_ENCODING_RS) {
+		SBN = gf_bs_read_int(routedmx->bs, 24);
+		ESI = gf_bs_read_u8(routedmx->bs);
+	} else {
+		/*SBN =(u32) */gf_bs_read_u16(routedmx->bs);
+		ESI = (u32) gf_bs_read_u16(routedmx->bs);
+	}
 	pos = (u32) gf_bs_get_position(routedmx->bs);
+	if (pos>nb_read) return GF_NON_COMPLIANT_BITSTREAM;
 
 	if (s->last_active_obj && (s->last_active_obj->tsi==tsi)) {
 		rlct = s->last_active_obj->rlct;
@@ -2804,10 +3253,29 @@ static GF_Err dmx_process_service_dvb_flute(GF_ROUTEDmx *routedmx, GF_ROUTEServi
 		}
 	}
 
-	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, routedmx->buffer + pos, nb_read-pos, (u32) transfert_length, B, GF_FALSE, rlct, &gather_object, ESI, fdt_symbol_length);
+	if (cp==GF_FEC_ENCODING_RS) {
+		u32 block_offset=0, k=0;
+		GF_LCTObject *obj = gf_route_service_find_object(s, tsi, toi);
+		if (!obj || !obj->fec_max_sbl || (SBN >= gf_route_fec_source_block(obj->total_length, obj->flute_symbol_size, obj->fec_max_sbl, SBN, &block_offset, &k))) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[%s] TSI %u TOI %u unknown or invalid FEC source block %u, skipping\n", s->log_name, tsi, toi, SBN));
+			return GF_OK;
+		}
+		if (ESI >= k) {
+			e = gf_route_service_gather_repair(routedmx, s, tsi, toi, obj->total_length, obj->flute_symbol_size, obj->fec_max_sbl, SBN, ESI, data + pos, nb_read-pos, &gather_object);
+			goto process_object;
+		}
+		//block offsets are multiple of symbol size
+		ESI += block_offset / obj->flute_symbol_size;
+	}
+
+	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, data + pos, nb_read-pos, (u32) transfert_length, B, GF_FALSE, rlct, &gather_object, ESI, fdt_symbol_length);
+	//repair symbols pending for this object, source data may complete a block
+	if ((e==GF_OK) && gather_object && gather_object->fec_nb_repairs)
+		e = gf_route_service_fec_repair(routedmx, s, gather_object, &gather_object);
 
 	start_offset += (nb_read ) * ESI; 
-	
+
+process_object:
 	if (e==GF_EOS) {
 		if (!tsi) {
 			if (gather_object->status==GF_LCT_OBJ_DONE_ERR) {
@@ -2920,11 +3388,44 @@ static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 	return GF_OK;
 }
 
+//fetch all pending datagrams on the socket and process them
+static GF_Err gf_route_dmx_process_socket(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+{
+	u32 i, nb_dgrams;
+	GF_Err e, res = GF_OK;
+
+	e = gf_sk_receive_batch(route_sess ? route_sess->sock : s->sock, routedmx->dgrams, GF_ROUTE_NB_DGRAMS, &nb_dgrams);
+	if (e) return e;
+
+	routedmx->last_pck_time = gf_sys_clock_high_res();
+	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
+
+	for (i=0; i<nb_dgrams; i++) {
+		GF_SockDatagram *dg = &routedmx->dgrams[i];
+		if (!dg->read) continue;
+		routedmx->nb_packets++;
+		routedmx->total_bytes_recv += dg->read;
+		//datagrams are already read, process all of them and report the last error
+		e = s->process_service(routedmx, s, route_sess, dg->buffer, dg->read);
+		if (e) res = e;
+	}
+	return res;
+}
+
+//number of objects per media stream of a service
+static u32 gf_route_service_nb_obj(GF_ROUTEService *s)
+{
+	u32 nb_obj = gf_list_count(s->objects);
+	if (s->nb_media_streams) nb_obj /= s->nb_media_streams;
+	return nb_obj;
+}
+
 GF_EXPORT
 GF_Err gf_route_dmx_process(GF_ROUTEDmx *routedmx)
 {
 	u32 i, j, count, nb_obj=0;
 	GF_Err e;
+	GF_Socket *sock;
 
 	//check all active sockets
 	e = gf_sk_group_select(routedmx->active_sockets, 10, GF_SK_SELECT_READ);
@@ -2947,44 +3448,44 @@ GF_Err gf_route_dmx_process(GF_ROUTEDmx *routedmx)
 		}
 		return e;
 	}
-	if (routedmx->atsc_sock) {
-		if (gf_sk_group_sock_is_set(routedmx->active_sockets, routedmx->atsc_sock, GF_SK_SELECT_READ)) {
+	//only visit ready sockets, service and route session sockets point to their service
+	i=0;
+	while ((sock = gf_sk_group_get_ready(routedmx->active_sockets, &i, GF_SK_SELECT_READ))) {
+		GF_ROUTESession *rsess = NULL;
+		GF_ROUTEService *s;
+		if (sock == routedmx->atsc_sock) {
 			e = gf_route_dmx_process_lls(routedmx);
 			if (e) return e;
+			continue;
+		}
+		s = gf_sk_get_usr_data(sock);
+		if (!s || (s->tune_mode==GF_ROUTE_TUNE_OFF)) continue;
+		//except for flute
+		if (s->service_id && routedmx->nrt_max_seg && (gf_route_service_nb_obj(s) > routedmx->nrt_max_seg))
+			continue;
+
+		if (sock != s->sock) {
+			if (s->tune_mode!=GF_ROUTE_TUNE_ON) continue;
+			j=0;
+			while ((rsess = (GF_ROUTESession *)gf_list_enum(s->route_sessions, &j) )) {
+				if (rsess->sock == sock) break;
+			}
+			if (!rsess) continue;
 		}
+		e = gf_route_dmx_process_socket(routedmx, s, rsess);
+		if (e) return e;
 	}
+	if (!routedmx->nrt_max_seg) return GF_OK;
 
 	count = gf_list_count(routedmx->services);
 	for (i=0; i<count; i++) {
-		u32 nb_obj_service;
-		GF_ROUTESession *rsess;
 		GF_ROUTEService *s = (GF_ROUTEService *)gf_list_get(routedmx->services, i);
 		if (s->tune_mode==GF_ROUTE_TUNE_OFF) continue;
-		nb_obj_service = gf_list_count(s->objects);
-		if (s->nb_media_streams) nb_obj_service /= s->nb_media_streams;
 		//except for flute
-		if (s->service_id) {
-			if (nb_obj<nb_obj_service) nb_obj = nb_obj_service;
-			if (routedmx->nrt_max_seg && (nb_obj_service > routedmx->nrt_max_seg))
-				continue;
-		}
-		if (gf_sk_group_sock_is_set(routedmx->active_sockets, s->sock, GF_SK_SELECT_READ)) {
-			e = s->process_service(routedmx, s, NULL);
-			if (e) return e;
-		}
-		if (s->tune_mode!=GF_ROUTE_TUNE_ON) continue;
-
-		if (!s->secondary_sockets) continue;
-
-		j=0;
-		while ((rsess = (GF_ROUTESession *)gf_list_enum(s->route_sessions, &j) )) {
-			if (gf_sk_group_sock_is_set(routedmx->active_sockets, rsess->sock, GF_SK_SELECT_READ)) {
-				e = s->process_service(routedmx, s, rsess);
-				if (e) return e;
-			}
-		}
+		if (s->service_id && (nb_obj < gf_route_service_nb_obj(s)))
+			nb_obj = gf_route_service_nb_obj(s);
 	}
-	if (routedmx->nrt_max_seg && (nb_obj>routedmx->nrt_max_seg))
+	if (nb_obj>routedmx->nrt_max_seg)
 		return GF_IP_NETWORK_EMPTY;
 	return GF_OK;
 }
@@ -3362,6 +3863,7 @@ GF_Err gf_routedmx_mark_active_quality(GF_ROUTEDmx *routedmx, u32 service_id, co
 		rlct->is_active = GF_TRUE;
 		if (!mcast_sess->nb_active && !(*sock)) {
 			*sock = gf_sk_new_ex(GF_SOCK_TYPE_UDP, routedmx->netcap_id);
+			gf_sk_set_usr_data(*sock, s);
 
 			gf_sk_set_usec_wait(*sock, 1);
 			const char *dst_add = mcast_sess->mcast_addr ? mcast_sess->mcast_addr : s->dst_ip;
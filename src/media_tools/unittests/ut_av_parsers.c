@@ -0,0 +1,96 @@
+#include <gpac/internal/media_dev.h>
+#include "tests.h"
+
+//byte-by-byte start code scan, as done before the zero-pair scanner
+static u32 ut_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+{
+    u32 i, v = 0xffffffff;
+    for (i=0; i<data_len; i++) {
+        v = (v<<8) | data[i];
+        if ((v & 0x00FFFFFF) == 0x00000001) {
+            *sc_size = ((v == 0x00000001) && (i>=3)) ? 4 : 3;
+            return i + 1 - *sc_size;
+        }
+    }
+    return data_len;
+}
+
+//byte-by-byte emulation prevention removal, as done before the zero-pair scanner
+static u32 ut_remove_emulation_bytes(const u8 *src, u8 *dst, u32 nal_size)
+{
+    u32 i = 0, emulation_bytes_count = 0;
+    u8 num_zero = 0;
+    while (i < nal_size) {
+        if ((num_zero == 2) && (src[i] == 0x03) && (i + 1 < nal_size) && (src[i + 1] < 0x04)) {
+            num_zero = 0;
+            emulation_bytes_count++;
+            i++;
+        }
+        if (dst) dst[i - emulation_bytes_count] = src[i];
+        if (!src[i]) num_zero++;
+        else num_zero = 0;
+        i++;
+    }
+    return nal_size - emulation_bytes_count;
+}
+
+//random payload where one byte out of zero_density is 0, with 0x000003xx patterns
+static void ut_fill(u8 *buf, u32 size, u32 zero_density)
+{
+    u32 i;
+    for (i=0; i<size; i++) {
+        u32 r = ut_rand();
+        buf[i] = (r % zero_density) ? (u8) (1 + (r>>8) % 255) : 0;
+        if (!buf[i] && (i>=2) && !buf[i-1] && !buf[i-2]) buf[i] = (r>>16) % 4;
+    }
+}
+
+static u32 ut_scan_start_codes(u32 (*next_sc)(const u8 *, u32, u32 *), const u8 *data, u32 size, u32 *sum)
+{
+    u32 pos = 0, nb_sc = 0;
+    while (pos < size) {
+        u32 sc_size = 0;
+        u32 next = next_sc(data + pos, size - pos, &sc_size);
+        if (next == size - pos) break;
+        nb_sc++;
+        *sum += pos + next + sc_size;
+        pos += next + sc_size;
+    }
+    return nb_sc;
+}
+
+static void ut_annexb_check(u32 size, u32 zero_density)
+{
+    u32 i, sc1, sc2, sum1=0, sum2=0;
+    u8 *buf = gf_malloc(size);
+    u8 *dst1 = gf_malloc(size);
+    u8 *dst2 = gf_malloc(size);
+    ut_fill(buf, size, zero_density);
+
+    sc1 = ut_scan_start_codes(gf_media_nalu_next_start_code, buf, size, &sum1);
+    sc2 = ut_scan_start_codes(ut_next_start_code, buf, size, &sum2);
+    assert_equal(sc1, sc2);
+    assert_equal(sum1, sum2);
+
+    i = gf_media_nalu_remove_emulation_bytes(buf, dst1, size);
+    assert_equal(i, ut_remove_emulation_bytes(buf, dst2, size));
+    assert_equal_mem(dst1, dst2, i);
+    //in-place removal
+    assert_equal(gf_media_nalu_remove_emulation_bytes(buf, buf, size), i);
+    assert_equal_mem(buf, dst2, i);
+
+    gf_free(buf);
+    gf_free(dst1);
+    gf_free(dst2);
+}
+
+unittest(nalu_annexb_scan)
+{
+    u32 i;
+    //short buffers, all alignments and densities
+    for (i=0; i<2000; i++) {
+        ut_annexb_check(1 + ut_rand() % 100, 1 + ut_rand() % 8);
+    }
+    ut_annexb_check(100000, 3);
+    ut_annexb_check(100000, 200);
+}
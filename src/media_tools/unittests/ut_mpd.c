@@ -0,0 +1,470 @@
+#include <gpac/mpd.h>
+#include <gpac/xml.h>
+#include "tests.h"
+
+#if !defined(GPAC_DISABLE_MPD)
+
+static const char *ut_mpd_xml =
+    "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" id=\"UTMPD\" type=\"dynamic\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\""
+    " availabilityStartTime=\"2020-01-01T00:00:00Z\" publishTime=\"2020-01-01T00:00:00Z\" minimumUpdatePeriod=\"PT2S\" timeShiftBufferDepth=\"PT30S\">"
+    "<Period id=\"P1\" start=\"PT0S\">"
+    "<AdaptationSet id=\"1\" segmentAlignment=\"true\" startWithSAP=\"1\">"
+    "<SegmentTemplate timescale=\"1000\" media=\"v_$Time$.m4s\" initialization=\"v_init.mp4\">"
+    "<SegmentTimeline><S t=\"0\" d=\"2000\"/></SegmentTimeline>"
+    "</SegmentTemplate>"
+    "<Representation id=\"v1\" bandwidth=\"100000\" mimeType=\"video/mp4\" codecs=\"avc1.42c01e\" width=\"320\" height=\"240\"/>"
+    "</AdaptationSet>"
+    "<AdaptationSet id=\"2\" startWithSAP=\"1\">"
+    "<Representation id=\"a1\" bandwidth=\"64000\" mimeType=\"audio/mp4\" codecs=\"mp4a.40.2\" audioSamplingRate=\"48000\">"
+    "<SegmentTemplate timescale=\"48000\" media=\"a_$Time$.m4s\" initialization=\"a_init.mp4\">"
+    "<SegmentTimeline><S t=\"0\" d=\"96000\"/></SegmentTimeline>"
+    "</SegmentTemplate>"
+    "</Representation>"
+    "</AdaptationSet>"
+    "</Period>"
+    "</MPD>";
+
+//patch selectors of the two timelines, in document order
+static const char *ut_mpd_sels[2] = {
+    "/MPD/Period[@id='P1']/AdaptationSet[@id='1']/SegmentTemplate/SegmentTimeline",
+    "/MPD/Period[@id='P1']/AdaptationSet[@id='2']/Representation[@id='a1']/SegmentTemplate/SegmentTimeline"
+};
+static const u32 ut_mpd_timescales[2] = {1000, 48000};
+
+static GF_MPD *ut_mpd_load(void)
+{
+    GF_MPD *mpd = gf_mpd_new();
+    GF_DOMParser *dom = gf_xml_dom_new();
+    assert_equal(gf_xml_dom_parse_string(dom, (char *) ut_mpd_xml), GF_OK);
+    assert_equal(gf_mpd_init_from_dom(gf_xml_dom_get_root(dom), mpd, NULL), GF_OK);
+    gf_xml_dom_del(dom);
+    return mpd;
+}
+
+static GF_MPD_AdaptationSet *ut_mpd_as(GF_MPD *mpd, u32 idx)
+{
+    GF_MPD_Period *period = gf_list_get(mpd->periods, 0);
+    return gf_list_get(period->adaptation_sets, idx);
+}
+
+//segment templates holding the two timelines
+static GF_MPD_SegmentTemplate *ut_mpd_template(GF_MPD *mpd, u32 idx)
+{
+    GF_MPD_AdaptationSet *as = ut_mpd_as(mpd, idx);
+    if (!idx) return as->segment_template;
+    return ((GF_MPD_Representation *) gf_list_get(as->representations, 0))->segment_template;
+}
+
+static char *ut_mpd_text(GF_MPD *mpd, u32 mode, u64 original_publish_time)
+{
+    u8 *data;
+    u32 size;
+    char *res;
+    FILE *f = gf_fileio_mem_writer(NULL, NULL, 0);
+    assert_not_null(f);
+    if (mode==2) assert_equal(gf_mpd_write_patch(mpd, f, original_publish_time, GF_FALSE), GF_OK);
+    else assert_equal(gf_mpd_write(mpd, f, mode ? GF_TRUE : GF_FALSE), GF_OK);
+    data = gf_fileio_mem_writer_data(f, &size);
+    res = gf_malloc(size+1);
+    memcpy(res, data, size);
+    res[size] = 0;
+    gf_fclose(f);
+    return res;
+}
+
+//timeline updates as done by the dasher: extend last run or add entry, purge first entry, split last run
+static void ut_tl_append(GF_MPD_SegmentTimeline *tl, u64 *next_time, u32 dur)
+{
+    GF_MPD_SegmentTimelineEntry *se = gf_list_last(tl->entries);
+    if (se && (se->duration==dur) && (se->start_time + (u64) (se->repeat_count+1) * se->duration == *next_time)) {
+        se->repeat_count++;
+    } else {
+        GF_SAFEALLOC(se, GF_MPD_SegmentTimelineEntry);
+        assert_not_null(se);
+        se->start_time = *next_time;
+        se->duration = dur;
+        gf_list_add(tl->entries, se);
+    }
+    *next_time += dur;
+}
+
+static void ut_tl_purge(GF_MPD_SegmentTemplate *st)
+{
+    GF_MPD_SegmentTimelineEntry *se = gf_list_get(st->segment_timeline->entries, 0);
+    if (se->repeat_count) {
+        se->repeat_count--;
+        se->start_time += se->duration;
+        return;
+    }
+    gf_list_rem(st->segment_timeline->entries, 0);
+    gf_free(se);
+    if (st->tsb_first_entry) st->tsb_first_entry--;
+}
+
+static void ut_tl_split(GF_MPD_SegmentTimeline *tl)
+{
+    GF_MPD_SegmentTimelineEntry *se = gf_list_last(tl->entries);
+    GF_MPD_SegmentTimelineEntry *next;
+    if (!se || !se->repeat_count) return;
+    se->repeat_count--;
+    GF_SAFEALLOC(next, GF_MPD_SegmentTimelineEntry);
+    assert_not_null(next);
+    next->start_time = se->start_time + (u64) (se->repeat_count+1) * se->duration;
+    next->duration = se->duration;
+    gf_list_add(tl->entries, next);
+}
+
+static void ut_tl_reset(GF_MPD_SegmentTimeline *tl)
+{
+    while (gf_list_count(tl->entries)) {
+        GF_MPD_SegmentTimelineEntry *se = gf_list_pop_back(tl->entries);
+        gf_free(se);
+    }
+}
+
+//rebuilds an MPD never written before with the same timelines
+static GF_MPD *ut_mpd_clone(GF_MPD *src)
+{
+    u32 i, j;
+    GF_MPD *mpd = ut_mpd_load();
+    for (i=0; i<2; i++) {
+        GF_MPD_SegmentTemplate *s_st = ut_mpd_template(src, i);
+        GF_MPD_SegmentTemplate *st = ut_mpd_template(mpd, i);
+        ut_tl_reset(st->segment_timeline);
+        for (j=0; j<gf_list_count(s_st->segment_timeline->entries); j++) {
+            GF_MPD_SegmentTimelineEntry *se;
+            GF_SAFEALLOC(se, GF_MPD_SegmentTimelineEntry);
+            assert_not_null(se);
+            *se = *(GF_MPD_SegmentTimelineEntry *) gf_list_get(s_st->segment_timeline->entries, j);
+            gf_list_add(st->segment_timeline->entries, se);
+        }
+        st->tsb_first_entry = s_st->tsb_first_entry;
+    }
+    mpd->publishTime = src->publishTime;
+    return mpd;
+}
+
+static char *ut_str_append(char *str, const char *src, u32 len)
+{
+    u32 size = str ? (u32) strlen(str) : 0;
+    str = gf_realloc(str, size + len + 1);
+    memcpy(str + size, src, len);
+    str[size + len] = 0;
+    return str;
+}
+
+static char *ut_str_strip_comments(char *str)
+{
+    char *start;
+    while ((start = strstr(str, "<!--"))) {
+        char *end = strstr(start, "-->");
+        assert_not_null(end);
+        if (!end) break;
+        end += 3;
+        if (end[0]=='\n') end++;
+        memmove(start, end, strlen(end)+1);
+    }
+    return str;
+}
+
+//value of first attribute name in str
+static void ut_str_attr(const char *str, const char *name, char *value, u32 max_len)
+{
+    const char *start = strstr(str, name);
+    const char *end;
+    value[0] = 0;
+    assert_not_null(start);
+    if (!start) return;
+    start += strlen(name);
+    end = strchr(start, '"');
+    assert_not_null(end);
+    if (!end || (end - start >= max_len)) return;
+    memcpy(value, start, end - start);
+    value[end - start] = 0;
+}
+
+//applies an MPD patch to the MPD text it was generated for
+static char *ut_mpd_apply_patch(const char *mpd, const char *patch, const char *old_publish_time)
+{
+    u32 i;
+    char *res = NULL;
+    char value[100];
+    const char *pos, *src;
+
+    ut_str_attr(patch, "<Patch xmlns=\"urn:mpeg:dash:schema:mpd-patch:2020\" mpdId=\"", value, 100);
+    assert_equal_str(value, "UTMPD");
+    ut_str_attr(patch, " originalPublishTime=\"", value, 100);
+    assert_equal_str(value, old_publish_time);
+
+    //publishTime replacement
+    pos = strstr(patch, "<replace sel=\"/MPD/@publishTime\">");
+    assert_not_null(pos);
+    if (!pos) return NULL;
+    pos += strlen("<replace sel=\"/MPD/@publishTime\">");
+    src = strstr(mpd, " publishTime=\"");
+    assert_not_null(src);
+    src += strlen(" publishTime=\"");
+    res = ut_str_append(res, mpd, (u32) (src - mpd));
+    res = ut_str_append(res, pos, (u32) (strstr(pos, "</replace>") - pos));
+    ut_str_attr(patch, " publishTime=\"", value, 100);
+    assert_true(!strncmp(pos, value, strlen(value)));
+    src = strchr(src, '"');
+
+    //timeline replacements, selectors and timelines are in document order
+    for (i=0; i<2; i++) {
+        const char *tl_start, *tl_end, *rep_end;
+        char sel[200];
+        pos = strstr(pos, "<replace sel=\"");
+        assert_not_null(pos);
+        if (!pos) break;
+        ut_str_attr(pos, "<replace sel=\"", sel, 200);
+        assert_equal_str(sel, ut_mpd_sels[i]);
+        pos = strchr(pos, '\n') + 1;
+        rep_end = strstr(pos, "</replace>");
+        while ((rep_end > pos) && (rep_end[-1]==' ')) rep_end--;
+
+        tl_start = strstr(src, "<SegmentTimeline>");
+        assert_not_null(tl_start);
+        if (!tl_start) break;
+        while ((tl_start > src) && (tl_start[-1]==' ')) tl_start--;
+        tl_end = strstr(tl_start, "</SegmentTimeline>\n") + strlen("</SegmentTimeline>\n");
+
+        res = ut_str_append(res, src, (u32) (tl_start - src));
+        res = ut_str_append(res, pos, (u32) (rep_end - pos));
+        src = tl_end;
+        pos = rep_end;
+    }
+    //no other replacement
+    assert_true(strstr(pos, "<replace")==NULL);
+    res = ut_str_append(res, src, (u32) strlen(src));
+    return res;
+}
+
+//MPD written at each update with serialization cache, compared to the same MPD written once, and to previous MPD patched
+unittest(mpd_write_timeline_cache)
+{
+    u32 i, k;
+    u64 next_time[2] = {0, 0};
+    char *text, *prev = NULL, *patched;
+    GF_MPD *mpd, *ref;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    mpd = ut_mpd_load();
+    mpd->publishTime = 1577836800000;
+    for (k=0; k<2; k++)
+        ut_tl_reset(ut_mpd_template(mpd, k)->segment_timeline);
+
+    for (i=0; i<400; i++) {
+        char *ref_text;
+        for (k=0; k<2; k++) {
+            u32 r, ts = ut_mpd_timescales[k];
+            GF_MPD_SegmentTemplate *st = ut_mpd_template(mpd, k);
+            GF_List *entries = st->segment_timeline->entries;
+
+            r = ut_rand() % 20;
+            //gap in timeline
+            if (!r) next_time[k] += ts;
+            //segment duration changes
+            if (r<4) ut_tl_append(st->segment_timeline, &next_time[k], ts + (ut_rand() % ts));
+            else ut_tl_append(st->segment_timeline, &next_time[k], 2*ts);
+            if (r==5) ut_tl_split(st->segment_timeline);
+            //purge timeshift buffer
+            if ((gf_list_count(entries)>4) && (ut_rand() % 3)) ut_tl_purge(st);
+            if (r==7) st->tsb_first_entry = (gf_list_count(entries)>4) ? ut_rand() % 3 : 0;
+        }
+        mpd->publishTime += 2000;
+
+        ref = ut_mpd_clone(mpd);
+        //compact writes use other cache parameters
+        if (i%50 == 49) {
+            text = ut_mpd_text(mpd, 1, 0);
+            ref_text = ut_mpd_text(ref, 1, 0);
+            assert_equal_str(text, ref_text);
+            gf_free(text);
+            gf_free(ref_text);
+        }
+        text = ut_mpd_text(mpd, 0, 0);
+        ref_text = ut_mpd_text(ref, 0, 0);
+        assert_equal_str(text, ref_text);
+        gf_free(ref_text);
+        gf_mpd_del(ref);
+
+        if (prev) {
+            char old_pt[100];
+            char *patch = ut_mpd_text(mpd, 2, mpd->publishTime - 2000);
+            ut_str_attr(prev, " publishTime=\"", old_pt, 100);
+            patched = ut_mpd_apply_patch(prev, patch, old_pt);
+            assert_not_null(patched);
+            if (patched) {
+                ut_str_strip_comments(patched);
+                ut_str_strip_comments(text);
+                assert_equal_str(patched, text);
+                gf_free(patched);
+            }
+            gf_free(patch);
+            gf_free(prev);
+        }
+        prev = text;
+    }
+    gf_free(prev);
+    gf_mpd_del(mpd);
+    gf_sys_close();
+}
+
+//HLS segment updates as done by the dasher: add parts to live edge segment, close it, purge first segment
+static void ut_hls_update(GF_MPD_Representation *rep, Bool ll, u32 *seg_num, u64 *next_time)
+{
+    GF_DASH_SegmentContext *sctx = gf_list_last(rep->state_seg_list);
+    u32 r = ut_rand() % 4;
+    if (ll && sctx && !sctx->llhls_done && r) {
+        sctx->frags = gf_realloc(sctx->frags, sizeof(GF_DASH_FragmentContext) * (sctx->nb_frags+1));
+        memset(&sctx->frags[sctx->nb_frags], 0, sizeof(GF_DASH_FragmentContext));
+        sctx->frags[sctx->nb_frags].duration = 500;
+        sctx->frags[sctx->nb_frags].size = 1000 + (ut_rand() % 1000);
+        sctx->frags[sctx->nb_frags].independent = (sctx->nb_frags==0) ? GF_TRUE : GF_FALSE;
+        sctx->nb_frags++;
+        sctx->dur += 500;
+        return;
+    }
+    if (sctx) sctx->llhls_done = GF_TRUE;
+
+    GF_SAFEALLOC(sctx, GF_DASH_SegmentContext);
+    assert_not_null(sctx);
+    sctx->seg_num = *seg_num;
+    sctx->time = *next_time;
+    sctx->filename = gf_malloc(50);
+    sprintf(sctx->filename, "%s_%u.m4s", rep->id, *seg_num);
+    if (ll) {
+        sctx->llhls_mode = 2;
+    } else {
+        sctx->dur = rep->timescale * 2 - (ut_rand() % 100);
+    }
+    (*seg_num)++;
+    *next_time += rep->timescale * 2;
+    gf_list_add(rep->state_seg_list, sctx);
+
+    if ((gf_list_count(rep->state_seg_list)>8) && (ut_rand() % 2)) {
+        sctx = gf_list_pop_front(rep->state_seg_list);
+        if (sctx->frags) gf_free(sctx->frags);
+        gf_free(sctx->filename);
+        gf_free(sctx);
+        if (rep->tsb_first_entry) rep->tsb_first_entry--;
+    }
+    if (!(ut_rand() % 10))
+        rep->tsb_first_entry = (gf_list_count(rep->state_seg_list)>4) ? ut_rand() % 3 : 0;
+}
+
+static GF_MPD_Representation *ut_hls_rep(GF_MPD *mpd, u32 idx)
+{
+    return gf_list_get(ut_mpd_as(mpd, idx)->representations, 0);
+}
+
+static void ut_hls_setup(GF_MPD *mpd)
+{
+    u32 k;
+    mpd->create_m3u8_files = GF_FALSE;
+    ut_mpd_as(mpd, 0)->use_hls_ll = GF_TRUE;
+    for (k=0; k<2; k++) {
+        GF_MPD_Representation *rep = ut_hls_rep(mpd, k);
+        rep->timescale = rep->timescale_mpd = ut_mpd_timescales[k];
+        rep->hls_max_seg_dur.num = 2;
+        rep->hls_max_seg_dur.den = 1;
+        rep->streamtype = k ? GF_STREAM_AUDIO : GF_STREAM_VISUAL;
+        if (!rep->state_seg_list) rep->state_seg_list = gf_list_new();
+    }
+}
+
+static GF_MPD *ut_hls_clone(GF_MPD *src)
+{
+    u32 j, k;
+    GF_MPD *mpd = ut_mpd_load();
+    ut_hls_setup(mpd);
+    mpd->publishTime = src->publishTime;
+    for (k=0; k<2; k++) {
+        GF_MPD_Representation *s_rep = ut_hls_rep(src, k);
+        GF_MPD_Representation *rep = ut_hls_rep(mpd, k);
+        for (j=0; j<gf_list_count(s_rep->state_seg_list); j++) {
+            GF_DASH_SegmentContext *sctx;
+            GF_DASH_SegmentContext *s_sctx = gf_list_get(s_rep->state_seg_list, j);
+            GF_SAFEALLOC(sctx, GF_DASH_SegmentContext);
+            assert_not_null(sctx);
+            *sctx = *s_sctx;
+            sctx->filename = gf_strdup(s_sctx->filename);
+            if (s_sctx->nb_frags) {
+                sctx->frags = gf_malloc(sizeof(GF_DASH_FragmentContext) * s_sctx->nb_frags);
+                memcpy(sctx->frags, s_sctx->frags, sizeof(GF_DASH_FragmentContext) * s_sctx->nb_frags);
+            }
+            gf_list_add(rep->state_seg_list, sctx);
+        }
+        rep->tsb_first_entry = s_rep->tsb_first_entry;
+        //kept across writes to avoid hold-back changes
+        rep->hls_ll_part_dur = s_rep->hls_ll_part_dur;
+    }
+    return mpd;
+}
+
+static char *ut_hls_text(GF_MPD *mpd, char **var_text)
+{
+    u8 *data;
+    u32 k, size;
+    char *res;
+    FILE *f = gf_fileio_mem_writer(NULL, NULL, 0);
+    assert_not_null(f);
+    assert_equal(gf_mpd_write_m3u8_master_playlist(mpd, f, "ut_live.m3u8", gf_list_get(mpd->periods, 0), GF_M3U8_WRITE_ALL), GF_OK);
+    data = gf_fileio_mem_writer_data(f, &size);
+    res = gf_malloc(size+1);
+    memcpy(res, data, size);
+    res[size] = 0;
+    gf_fclose(f);
+
+    for (k=0; k<2; k++) {
+        GF_MPD_Representation *rep = ut_hls_rep(mpd, k);
+        assert_not_null(rep->m3u8_var_file);
+        data = gf_fileio_mem_writer_data(rep->m3u8_var_file, &size);
+        var_text[k] = gf_malloc(size+1);
+        memcpy(var_text[k], data, size);
+        var_text[k][size] = 0;
+    }
+    return res;
+}
+
+//variant playlists written at each update with serialization cache, compared to the same playlists written once
+unittest(mpd_write_m3u8_cache)
+{
+    u32 i, k, nb_parts = 0;
+    u32 seg_num[2] = {1, 1};
+    u64 next_time[2] = {0, 0};
+    GF_MPD *mpd, *ref;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    mpd = ut_mpd_load();
+    mpd->publishTime = 1577836800000;
+    ut_hls_setup(mpd);
+
+    for (i=0; i<400; i++) {
+        char *text, *ref_text, *var[2], *ref_var[2];
+        for (k=0; k<2; k++)
+            ut_hls_update(ut_hls_rep(mpd, k), k ? GF_FALSE : GF_TRUE, &seg_num[k], &next_time[k]);
+        mpd->publishTime += 500;
+
+        ref = ut_hls_clone(mpd);
+        ref_text = ut_hls_text(ref, ref_var);
+        text = ut_hls_text(mpd, var);
+        assert_equal_str(text, ref_text);
+        if (strstr(var[0], "#EXT-X-PART:")) nb_parts++;
+        for (k=0; k<2; k++) {
+            assert_equal_str(var[k], ref_var[k]);
+            gf_free(var[k]);
+            gf_free(ref_var[k]);
+        }
+        gf_free(text);
+        gf_free(ref_text);
+        gf_mpd_del(ref);
+    }
+    assert_greater(seg_num[0], 20);
+    assert_greater(nb_parts, 0);
+    gf_mpd_del(mpd);
+    gf_sys_close();
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include <gpac/route.h>
+#include "tests.h"
+
+#if !defined(GPAC_DISABLE_ROUTE)
+
+//encodes a random source block, receives the k symbols given by esis and checks the recovered source symbols
+static void ut_rs_check(u32 k, u32 nb_repair, u32 symbol_size, const u32 *esis)
+{
+    u32 i, j, nb_lost = 0;
+    u8 *src[255], *repair[255], *recv[255], *rec[255];
+    Bool received[255];
+
+    for (i=0; i<k; i++) {
+        src[i] = gf_malloc(symbol_size);
+        for (j=0; j<symbol_size; j++) src[i][j] = (u8) ut_rand();
+    }
+    for (i=0; i<nb_repair; i++) repair[i] = gf_malloc(symbol_size);
+    assert_equal(gf_route_fec_rs_encode(src, k, symbol_size, repair, nb_repair), GF_OK);
+
+    memset(received, 0, sizeof(received));
+    for (i=0; i<k; i++) {
+        recv[i] = (esis[i]<k) ? src[esis[i]] : repair[esis[i]-k];
+        received[esis[i]] = GF_TRUE;
+    }
+    for (i=0; i<k; i++) {
+        rec[i] = NULL;
+        if (received[i]) continue;
+        rec[i] = gf_malloc(symbol_size);
+        memset(rec[i], 0xAA, symbol_size);
+        nb_lost++;
+    }
+    assert_equal(gf_route_fec_rs_decode(recv, esis, k, symbol_size, rec), GF_OK);
+    for (i=0; i<k; i++) {
+        if (!rec[i]) continue;
+        assert_equal_mem(rec[i], src[i], symbol_size);
+        gf_free(rec[i]);
+    }
+    assert_less_equal(nb_lost, nb_repair);
+
+    for (i=0; i<k; i++) gf_free(src[i]);
+    for (i=0; i<nb_repair; i++) gf_free(repair[i]);
+}
+
+//receives symbols [first, first+k[ of the n encoding symbols
+static void ut_rs_check_range(u32 k, u32 nb_repair, u32 symbol_size, u32 first)
+{
+    u32 i, esis[255];
+    for (i=0; i<k; i++) esis[i] = first + i;
+    ut_rs_check(k, nb_repair, symbol_size, esis);
+}
+
+//receives k symbols out of n picked at random, in random order
+static void ut_rs_check_random(u32 k, u32 nb_repair, u32 symbol_size)
+{
+    u32 i, n = k + nb_repair, esis[255];
+    for (i=0; i<n; i++) esis[i] = i;
+    for (i=0; i<n; i++) {
+        u32 t, j = i + ut_rand() % (n - i);
+        t = esis[i];
+        esis[i] = esis[j];
+        esis[j] = t;
+    }
+    ut_rs_check(k, nb_repair, symbol_size, esis);
+}
+
+unittest(route_fec_rs_erasures)
+{
+    u32 i;
+    u8 *src[2], *repair[2];
+
+    //no loss, first and last n-k symbols lost
+    ut_rs_check_range(10, 6, 64, 0);
+    ut_rs_check_range(10, 6, 64, 6);
+    ut_rs_check_range(10, 6, 37, 3);
+    //all source symbols lost
+    ut_rs_check_range(4, 4, 100, 4);
+    ut_rs_check_range(1, 1, 16, 1);
+    //every contiguous window of received symbols
+    for (i=0; i<=8; i++) {
+        ut_rs_check_range(8, 8, 16, i);
+    }
+    for (i=0; i<200; i++) {
+        ut_rs_check_random(1 + ut_rand() % 32, ut_rand() % 16, 1 + ut_rand() % 64);
+    }
+    //largest block
+    ut_rs_check_random(200, 55, 8);
+    ut_rs_check_range(128, 127, 8, 127);
+
+    src[0] = src[1] = repair[0] = repair[1] = NULL;
+    assert_equal(gf_route_fec_rs_encode(src, 200, 8, repair, 56), GF_BAD_PARAM);
+    assert_equal(gf_route_fec_rs_encode(src, 0, 8, repair, 1), GF_BAD_PARAM);
+}
+
+unittest(route_fec_source_block)
+{
+    u32 L, E, B, sbn, N, T, offset, k, A_large, A_small, I;
+
+    //RFC 5052 section 9.1, 100 symbols in blocks of at most 40: 34, 33, 33
+    assert_equal(gf_route_fec_source_block(1000, 10, 40, 0, &offset, &k), 3);
+    assert_equal(offset, 0);
+    assert_equal(k, 34);
+    assert_equal(gf_route_fec_source_block(1000, 10, 40, 1, &offset, &k), 3);
+    assert_equal(offset, 340);
+    assert_equal(k, 33);
+    assert_equal(gf_route_fec_source_block(1000, 10, 40, 2, &offset, &k), 3);
+    assert_equal(offset, 670);
+    assert_equal(k, 33);
+    //last symbol is partial
+    assert_equal(gf_route_fec_source_block(1001, 10, 101, 0, &offset, &k), 1);
+    assert_equal(k, 101);
+    assert_equal(gf_route_fec_source_block(0, 10, 40, 0, NULL, NULL), 0);
+    assert_equal(gf_route_fec_source_block(1000, 0, 40, 0, NULL, NULL), 0);
+    assert_equal(gf_route_fec_source_block(1000, 10, 0, 0, NULL, NULL), 0);
+
+    for (L=1; L<100000; L += 1 + L/4) {
+        for (E=1; E<=1500; E = E*3 + 1) {
+            for (B=1; B<=255; B = B*2 + 1) {
+                u32 next = 0;
+                Bool ok = GF_TRUE;
+                T = (L + E - 1) / E;
+                N = (T + B - 1) / B;
+                A_large = (T + N - 1) / N;
+                A_small = T / N;
+                I = T - A_small * N;
+                if (gf_route_fec_source_block(L, E, B, 0, NULL, NULL) != N) ok = GF_FALSE;
+                //the first I blocks have A_large symbols, the others A_small, blocks are contiguous and cover the object
+                for (sbn=0; sbn<N; sbn++) {
+                    gf_route_fec_source_block(L, E, B, sbn, &offset, &k);
+                    if (offset != next) ok = GF_FALSE;
+                    if (k != ((sbn<I) ? A_large : A_small)) ok = GF_FALSE;
+                    if (!k || (k > B)) ok = GF_FALSE;
+                    next += k * E;
+                }
+                if (next < L) ok = GF_FALSE;
+                if (next - L >= E) ok = GF_FALSE;
+                if (!ok) {
+                    assert_true(ok);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+#endif
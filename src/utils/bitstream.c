@@ -554,25 +554,83 @@ u8 gf_bs_read_bit(GF_BitStream *bs)
 #endif
 }
 
+/*load next byte in read mode, inlining the common case of memory streams without emulation prevention*/
+static GFINLINE void bs_load_current(GF_BitStream *bs)
+{
+	if ((bs->bsmode == GF_BITSTREAM_READ) && !bs->remove_emul_prevention_byte && (bs->position < bs->size)) {
+		bs->current = (u8) bs->original[bs->position++];
+	} else {
+		bs->current = BS_ReadByte(bs);
+	}
+	bs->nbBits = 0;
+}
+
+/*extract up to 8 bits from the current byte - the current byte is shifted left by the number of bits already read,
+so remaining bits are always the most significant ones of the low byte*/
+static GFINLINE u32 bs_get_bits(GF_BitStream *bs, u32 nBits)
+{
+	u32 ret = (bs->current & 0xFF) >> (8 - nBits);
+	bs->current <<= nBits;
+	bs->nbBits += nBits;
+	return ret;
+}
+
 GF_EXPORT
 u32 gf_bs_read_int(GF_BitStream *bs, u32 nBits)
 {
-	u32 ret;
+	u32 ret = 0;
 	bs->total_bits_read+= nBits;
 
-#ifndef NO_OPTS
-	if (nBits + bs->nbBits <= 8) {
-		bs->nbBits += nBits;
-		ret = (bs->current >> (8 - bs->nbBits) ) & bits_mask[nBits];
-		return ret;
+	//read by chunks of remaining bits in current byte rather than bit by bit
+	while (nBits) {
+		u32 nb_get;
+		if (bs->nbBits == 8) bs_load_current(bs);
+		nb_get = 8 - bs->nbBits;
+		if (nb_get > nBits) nb_get = nBits;
+		ret = (ret << nb_get) | bs_get_bits(bs, nb_get);
+		nBits -= nb_get;
 	}
+	return ret;
+}
+
+GF_EXPORT
+u32 gf_bs_read_leading_zeros(GF_BitStream *bs, u32 max_bits)
+{
+	u32 nb_zeros = 0;
+	while (nb_zeros < max_bits) {
+		u32 val, nb_lead, nb_left;
+		if (bs->nbBits == 8) bs_load_current(bs);
+		nb_left = 8 - bs->nbBits;
+		val = bs->current & 0xFF;
+		if (!val) {
+			//all remaining bits are 0
+			if (nb_left > max_bits - nb_zeros) nb_left = max_bits - nb_zeros;
+			bs_get_bits(bs, nb_left);
+			bs->total_bits_read += nb_left;
+			nb_zeros += nb_left;
+			continue;
+		}
+#if defined(__GNUC__) || defined(__clang__)
+		nb_lead = __builtin_clz(val) - 24;
+#else
+		nb_lead = 0;
+		while (!(val & 0x80)) {
+			val <<= 1;
+			nb_lead++;
+		}
 #endif
-	ret = 0;
-	while (nBits-- > 0) {
-		ret <<= 1;
-		ret |= gf_bs_read_bit(bs);
+		if (nb_zeros + nb_lead >= max_bits) {
+			nb_lead = max_bits - nb_zeros;
+			bs_get_bits(bs, nb_lead);
+			bs->total_bits_read += nb_lead;
+			return max_bits;
+		}
+		//consume zeros and the terminating 1 bit
+		bs_get_bits(bs, nb_lead + 1);
+		bs->total_bits_read += nb_lead + 1;
+		return nb_zeros + nb_lead;
 	}
-	return ret;
+	return nb_zeros;
 }
 
 GF_EXPORT
@@ -744,10 +802,12 @@ u64 gf_bs_read_long_int(GF_BitStream *bs, u32 nBits)
 		}
 		ret = gf_bs_read_long_int(bs, 64);
 	} else {
-		while (nBits-- > 0) {
-			ret <<= 1;
-			ret |= gf_bs_read_bit(bs);
+		if (nBits > 32) {
+			ret = gf_bs_read_int(bs, nBits - 32);
+			nBits = 32;
 		}
+		ret <<= nBits;
+		ret |= gf_bs_read_int(bs, nBits);
 	}
 	return ret;
 }
@@ -171,6 +171,16 @@ struct __DownloadedCacheEntryStruct
     GF_Blob cache_blob;
     GF_Blob *external_blob;
     Bool persistent;
+
+	/*set if entry cannot be evicted from the cache by the download manager*/
+	Bool pinned;
+	/*set if entry was moved from disk to memory storage by the download manager memory tier*/
+	Bool mem_tier;
+	/*last access time of the entry, in download manager clock*/
+	u64 last_access;
+	/*set if entry storage is accounted in download manager cache size, and accounted size*/
+	Bool accounted;
+	u32 accounted_size;
 };
 
 Bool gf_cache_entry_persistent(const DownloadedCacheEntry entry)
@@ -182,6 +192,71 @@ void gf_cache_entry_set_persistent(const DownloadedCacheEntry entry)
 	if (entry) entry->persistent = GF_TRUE;
 }
 
+void gf_cache_entry_set_pinned(const DownloadedCacheEntry entry)
+{
+	if (entry) entry->pinned = GF_TRUE;
+}
+
+void gf_cache_entry_set_last_access(const DownloadedCacheEntry entry, u64 last_access)
+{
+	if (entry) entry->last_access = last_access;
+}
+
+u64 gf_cache_entry_get_last_access(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->last_access : 0;
+}
+
+Bool gf_cache_is_memory_stored(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->memory_stored : GF_FALSE;
+}
+
+u32 gf_cache_get_storage_size(const DownloadedCacheEntry entry)
+{
+	if (!entry) return 0;
+	if (entry->memory_stored) {
+		//external blobs are owned by the caller
+		if (entry->external_blob) return 0;
+		return entry->mem_allocated;
+	}
+	return MAX(entry->cacheSize, entry->written_in_cache);
+}
+
+u32 gf_cache_entry_set_accounted(const DownloadedCacheEntry entry, Bool accounted)
+{
+	u32 size;
+	if (!entry) return 0;
+	if (accounted) {
+		entry->accounted = GF_TRUE;
+		entry->accounted_size = gf_cache_get_storage_size(entry);
+		return entry->accounted_size;
+	}
+	size = entry->accounted ? entry->accounted_size : 0;
+	entry->accounted = GF_FALSE;
+	entry->accounted_size = 0;
+	return size;
+}
+
+s64 gf_cache_entry_update_accounted_size(const DownloadedCacheEntry entry)
+{
+	u32 size;
+	s64 diff;
+	if (!entry || !entry->accounted) return 0;
+	size = gf_cache_get_storage_size(entry);
+	diff = (s64) size - (s64) entry->accounted_size;
+	entry->accounted_size = size;
+	return diff;
+}
+
+void gf_dm_cache_entry_resized(GF_DownloadManager *dm, const DownloadedCacheEntry entry);
+
+//notifies download manager of storage size changes
+static void gf_cache_entry_resized(const DownloadedCacheEntry entry)
+{
+	if (entry->dm) gf_dm_cache_entry_resized(entry->dm, entry);
+}
+
 Bool delete_cache_files(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info) {
 	const char * startPattern;
 	int sz;
@@ -198,6 +273,7 @@ Bool delete_cache_files(void *cbck, char *item_name, char *item_path, GF_FileEnu
 }
 
 static const char * cache_file_prefix = "gpac_cache_";
+static const char * cache_file_info_suffix = ".txt";
 
 Bool gather_cache_size(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info)
 {
@@ -219,6 +295,129 @@ GF_Err gf_cache_delete_all_cached_files(const char * directory) {
 	return gf_enum_directory( directory, GF_FALSE, delete_cache_files, (void*)cache_file_prefix, NULL);
 }
 
+typedef struct
+{
+	//cache file name without info suffix, identifies the resource
+	char *name;
+	char *files[2];
+	u64 size;
+	u64 last_modified;
+} CachedResource;
+
+Bool gather_cached_resources(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info)
+{
+	u32 len, sfx_len;
+	CachedResource *res;
+	GF_List *resources = (GF_List *)cbck;
+	if (strncmp(cache_file_prefix, item_name, strlen(cache_file_prefix)))
+		return GF_FALSE;
+
+	GF_SAFEALLOC(res, CachedResource);
+	if (!res) return GF_TRUE;
+	res->name = gf_strdup(item_name);
+	res->files[0] = gf_strdup(item_path);
+	res->size = file_info->size;
+	res->last_modified = file_info->last_modified;
+	//data file and its properties file are the same resource
+	len = (u32) strlen(item_name);
+	sfx_len = (u32) strlen(cache_file_info_suffix);
+	if ((len>sfx_len) && !strcmp(item_name + len - sfx_len, cache_file_info_suffix))
+		res->name[len - sfx_len] = 0;
+	gf_list_add(resources, res);
+	return GF_FALSE;
+}
+
+static int cached_resource_name_cmp(const void *_a, const void *_b)
+{
+	CachedResource *a = *(CachedResource **)_a;
+	CachedResource *b = *(CachedResource **)_b;
+	return strcmp(a->name, b->name);
+}
+
+static int cached_resource_time_cmp(const void *_a, const void *_b)
+{
+	CachedResource *a = *(CachedResource **)_a;
+	CachedResource *b = *(CachedResource **)_b;
+	if (a->last_modified < b->last_modified) return -1;
+	if (a->last_modified > b->last_modified) return 1;
+	return 0;
+}
+
+static void cached_resource_del(CachedResource *res)
+{
+	if (res->files[0]) gf_free(res->files[0]);
+	if (res->files[1]) gf_free(res->files[1]);
+	gf_free(res->name);
+	gf_free(res);
+}
+
+GF_Err gf_cache_trim_cached_files(const char * directory, u64 max_size)
+{
+	u32 i, count, nb_res;
+	u64 total_size = 0;
+	CachedResource **res_array;
+	GF_List *files = gf_list_new();
+	if (!files) return GF_OUT_OF_MEM;
+
+	gf_enum_directory(directory, GF_FALSE, gather_cached_resources, files, NULL);
+	count = gf_list_count(files);
+	if (!count) {
+		gf_list_del(files);
+		return GF_OK;
+	}
+	res_array = gf_malloc(sizeof(CachedResource *) * count);
+	if (!res_array) {
+		while (gf_list_count(files)) cached_resource_del(gf_list_pop_back(files));
+		gf_list_del(files);
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<count; i++)
+		res_array[i] = gf_list_get(files, i);
+	gf_list_del(files);
+
+	//merge data and properties files of each resource
+	qsort(res_array, count, sizeof(CachedResource *), cached_resource_name_cmp);
+	nb_res = 0;
+	for (i=0; i<count; i++) {
+		CachedResource *res = res_array[i];
+		total_size += res->size;
+		if (nb_res && !strcmp(res_array[nb_res-1]->name, res->name) && !res_array[nb_res-1]->files[1]) {
+			CachedResource *prev = res_array[nb_res-1];
+			prev->files[1] = res->files[0];
+			res->files[0] = NULL;
+			prev->size += res->size;
+			if (res->last_modified > prev->last_modified)
+				prev->last_modified = res->last_modified;
+			cached_resource_del(res);
+			continue;
+		}
+		res_array[nb_res++] = res;
+	}
+	if (total_size > max_size) {
+		u32 nb_del = 0;
+		u64 del_size = 0;
+		//least recently modified resources first
+		qsort(res_array, nb_res, sizeof(CachedResource *), cached_resource_time_cmp);
+		for (i=0; i<nb_res; i++) {
+			u32 j;
+			if (total_size <= max_size) break;
+			for (j=0; j<2; j++) {
+				if (res_array[i]->files[j] && (gf_file_delete(res_array[i]->files[j]) != GF_OK))
+					GF_LOG(GF_LOG_ERROR, GF_LOG_CACHE, ("[CACHE] : failed to cleanup file %s\n", res_array[i]->files[j]));
+			}
+			total_size -= res_array[i]->size;
+			del_size += res_array[i]->size;
+			nb_del++;
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_CACHE, ("[CACHE] Trimmed cache %s: deleted %d resources ("LLU" bytes), "LLU" bytes left\n", directory, nb_del, del_size, total_size));
+	}
+
+	for (i=0; i<nb_res; i++)
+		cached_resource_del(res_array[i]);
+	gf_free(res_array);
+	return GF_OK;
+}
+
 void gf_cache_entry_set_delete_files_when_deleted(const DownloadedCacheEntry entry) {
 	if (entry && !entry->persistent)
 		entry->deletableFilesOnDelete = GF_TRUE;
@@ -388,14 +587,50 @@ GF_Err gf_cache_get_http_headers(const DownloadedCacheEntry entry, const char **
 #define _CACHE_HASH_SIZE 20
 #define _CACHE_MAX_EXTENSION_SIZE 6
 static const char * default_cache_file_suffix = ".dat";
-static const char * cache_file_info_suffix = ".txt";
+
+//sets cache file name and properties of an entry stored on disk, cache_filename must be large enough
+static GF_Err gf_cache_entry_setup_file(DownloadedCacheEntry entry, const char *cache_directory)
+{
+	char tmp[_CACHE_TMP_SIZE];
+	char ext[_CACHE_MAX_EXTENSION_SIZE];
+
+	strcpy ( entry->cache_filename, cache_directory );
+	strcat( entry->cache_filename, cache_file_prefix );
+	strcat ( entry->cache_filename, entry->hash );
+	strncpy ( tmp, entry->url, _CACHE_TMP_SIZE-1 );
+	tmp[_CACHE_TMP_SIZE-1] = 0;
+
+	{
+		char * parser;
+		parser = strrchr ( tmp, '?' );
+		if ( parser )
+			parser[0] = '\0';
+		parser = strrchr ( tmp, '#' );
+		if ( parser )
+			parser[0] = '\0';
+		parser = strrchr ( tmp, '.' );
+		if ( parser && ( strlen ( parser ) < _CACHE_MAX_EXTENSION_SIZE ) )
+			strncpy(ext, parser, _CACHE_MAX_EXTENSION_SIZE);
+		else
+			strncpy(ext, default_cache_file_suffix, _CACHE_MAX_EXTENSION_SIZE);
+		assert (strlen(ext));
+		strcat( entry->cache_filename, ext);
+	}
+	tmp[0] = '\0';
+	strcpy( tmp, cache_file_prefix);
+	strcat( tmp, entry->hash );
+	strcat( tmp , ext);
+	strcat ( tmp, cache_file_info_suffix );
+	entry->properties = gf_cfg_force_new ( cache_directory, tmp );
+	if ( !entry->properties ) return GF_OUT_OF_MEM;
+	return GF_OK;
+}
 
 DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char * cache_directory, const char * url , u64 start_range, u64 end_range, Bool mem_storage, GF_Mutex *mx)
 {
 	char tmp[_CACHE_TMP_SIZE];
 	u8 hash[_CACHE_HASH_SIZE];
 	int sz;
-	char ext[_CACHE_MAX_EXTENSION_SIZE];
 	DownloadedCacheEntry entry = NULL;
 	if ( !dm || !url || !cache_directory) {
 		GF_LOG(GF_LOG_WARNING, GF_LOG_CACHE,
@@ -500,35 +735,7 @@ DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char
 	}
 
 
-	tmp[0] = '\0';
-	strcpy ( entry->cache_filename, cache_directory );
-	strcat( entry->cache_filename, cache_file_prefix );
-	strcat ( entry->cache_filename, entry->hash );
-	strcpy ( tmp, url );
-
-	{
-		char * parser;
-		parser = strrchr ( tmp, '?' );
-		if ( parser )
-			parser[0] = '\0';
-		parser = strrchr ( tmp, '#' );
-		if ( parser )
-			parser[0] = '\0';
-		parser = strrchr ( tmp, '.' );
-		if ( parser && ( strlen ( parser ) < _CACHE_MAX_EXTENSION_SIZE ) )
-			strncpy(ext, parser, _CACHE_MAX_EXTENSION_SIZE);
-		else
-			strncpy(ext, default_cache_file_suffix, _CACHE_MAX_EXTENSION_SIZE);
-		assert (strlen(ext));
-		strcat( entry->cache_filename, ext);
-	}
-	tmp[0] = '\0';
-	strcpy( tmp, cache_file_prefix);
-	strcat( tmp, entry->hash );
-	strcat( tmp , ext);
-	strcat ( tmp, cache_file_info_suffix );
-	entry->properties = gf_cfg_force_new ( cache_directory, tmp );
-	if ( !entry->properties )
+	if (gf_cache_entry_setup_file(entry, cache_directory) != GF_OK)
 	{
 		GF_Err err;
 		/* out of memory ? */
@@ -631,6 +838,13 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 			GF_LOG(GF_LOG_ERROR, GF_LOG_CACHE, ("[CACHE] Failed to fully write file on cache, e=%d\n", e));
 		}
 	}
+	//memory tier entries are revalidated like disk entries
+	else if (entry->mem_tier && success) {
+		entry->cacheSize = entry->written_in_cache;
+		gf_cache_set_last_modified_on_disk(entry, gf_cache_get_last_modified_on_server(entry));
+		gf_cache_set_etag_on_disk(entry, gf_cache_get_etag_on_server(entry));
+		gf_cache_entry_resized(entry);
+	}
 	entry->write_session = NULL;
 #ifdef ENABLE_WRITE_MX
 	gf_mx_v(entry->write_mutex);
@@ -638,6 +852,70 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 	return e;
 }
 
+Bool gf_cache_entry_set_memory_storage(const DownloadedCacheEntry entry, GF_Mutex *mx)
+{
+	char *burl;
+	if (!entry || entry->memory_stored) return GF_FALSE;
+	if (entry->write_session || entry->writeFilePtr || entry->continue_file || entry->persistent) return GF_FALSE;
+
+	//resource is refreshed, remove any previous version on disk
+	if (entry->properties) {
+		char *propfile = gf_strdup(gf_cfg_get_filename(entry->properties));
+		gf_cfg_discard_changes(entry->properties);
+		gf_cfg_del(entry->properties);
+		entry->properties = NULL;
+		if (propfile) {
+			if (gf_file_exists(propfile)) gf_file_delete(propfile);
+			gf_free(propfile);
+		}
+	}
+	if (entry->cache_filename && gf_file_exists(entry->cache_filename))
+		gf_file_delete(entry->cache_filename);
+	entry->file_exists = GF_FALSE;
+
+	entry->cache_filename = gf_realloc(entry->cache_filename, strlen("gmem://") + 8 + strlen("@") + 16 + 1);
+	if (!entry->cache_filename) return GF_FALSE;
+	entry->cache_filename[0] = 0;
+	entry->memory_stored = GF_TRUE;
+	entry->mem_tier = GF_TRUE;
+	entry->cacheSize = 0;
+	entry->cache_blob.mx = mx;
+	entry->cache_blob.data = entry->mem_storage;
+	entry->cache_blob.size = entry->contentLength;
+	burl = gf_blob_register(&entry->cache_blob);
+	if (burl) {
+		strcpy(entry->cache_filename, burl);
+		gf_free(burl);
+	}
+	gf_cache_entry_resized(entry);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Moving %s to memory storage\n", entry->url));
+	return GF_TRUE;
+}
+
+Bool gf_cache_entry_set_disk_storage(const DownloadedCacheEntry entry, const char *cache_directory)
+{
+	if (!entry || !entry->mem_tier || !cache_directory) return GF_FALSE;
+	if (entry->write_session || entry->external_blob) return GF_FALSE;
+
+	entry->cache_filename = gf_realloc(entry->cache_filename, strlen(cache_directory) + strlen(cache_file_prefix) + strlen(entry->hash) + _CACHE_MAX_EXTENSION_SIZE + 1);
+	if (!entry->cache_filename) return GF_FALSE;
+	if (gf_cache_entry_setup_file(entry, cache_directory) != GF_OK) return GF_FALSE;
+
+	gf_blob_unregister(&entry->cache_blob);
+	if (entry->mem_storage && entry->mem_allocated) gf_free(entry->mem_storage);
+	entry->mem_storage = NULL;
+	entry->mem_allocated = 0;
+	entry->cache_blob.data = NULL;
+	entry->cache_blob.size = 0;
+	entry->written_in_cache = 0;
+	entry->cacheSize = 0;
+	entry->memory_stored = GF_FALSE;
+	entry->mem_tier = GF_FALSE;
+	gf_cache_entry_resized(entry);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Moving %s to disk storage\n", entry->url));
+	return GF_TRUE;
+}
+
 GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_DownloadSession * sess)
 {
 	CHECK_ENTRY;
@@ -677,6 +955,7 @@ GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_Dow
 			GF_LOG(GF_LOG_ERROR, GF_LOG_CACHE, ("[CACHE] Failed to create memory storage for file %s\n", entry->url));
 			return GF_OUT_OF_MEM;
 		}
+		gf_cache_entry_resized(entry);
 		return GF_OK;
 	}
 
@@ -694,6 +973,7 @@ GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_Dow
 	entry->file_exists = GF_TRUE;
 	if (entry->continue_file )
 		gf_fseek(entry->writeFilePtr, 0, SEEK_END);
+	gf_cache_entry_resized(entry);
 	return GF_OK;
 }
 
@@ -729,14 +1009,17 @@ GF_Err gf_cache_write_to_cache( const DownloadedCacheEntry entry, const GF_Downl
 		memset(entry->mem_storage + entry->written_in_cache, 0, 2);
 		entry->cache_blob.size = entry->written_in_cache;
 		gf_mx_v(entry->cache_blob.mx);
+		gf_cache_entry_resized(entry);
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Storing %d bytes to memory\n", size));
 		return GF_OK;
 	}
 
 	read = (u32) gf_fwrite(data, size, entry->writeFilePtr);
-	if (read > 0)
+	if (read > 0) {
 		entry->written_in_cache+= read;
+		gf_cache_entry_resized(entry);
+	}
 	if (read != size) {
 		/* Something bad happened */
 		GF_LOG(GF_LOG_WARNING, GF_LOG_CACHE,
@@ -865,6 +1148,7 @@ Bool gf_cache_check_if_cache_file_is_corrupted(const DownloadedCacheEntry entry)
 
 		entry->cacheSize = ( u32 ) gf_fsize(the_cache);
 		gf_fclose ( the_cache );
+		gf_cache_entry_resized(entry);
 		if (keyValue) {
 			entry->contentLength = (u32) strtoul( keyValue, &endPtr, 10);
 			if (*endPtr!='\0' || entry->contentLength != entry->cacheSize) {
@@ -955,6 +1239,14 @@ Bool gf_cache_is_in_progress(const DownloadedCacheEntry entry)
 	return GF_FALSE;
 }
 
+Bool gf_cache_entry_is_pinned(const DownloadedCacheEntry entry)
+{
+	if (!entry) return GF_TRUE;
+	if (entry->pinned || entry->persistent || entry->external_blob) return GF_TRUE;
+	if (entry->write_session || gf_list_count(entry->sessions)) return GF_TRUE;
+	return gf_cache_is_in_progress(entry);
+}
+
 Bool gf_cache_set_mime(const DownloadedCacheEntry entry, const char *mime)
 {
 	if (!entry || !entry->memory_stored) return GF_FALSE;
@@ -1042,6 +1334,7 @@ Bool gf_cache_set_content(const DownloadedCacheEntry entry, GF_Blob *blob, Bool
 			gf_blob_unregister(entry->external_blob);
 			entry->external_blob = NULL;
 		}
+        gf_cache_entry_resized(entry);
         return GF_TRUE;
     }
     if (blob->mx)
@@ -1102,6 +1395,7 @@ Bool gf_cache_set_content(const DownloadedCacheEntry entry, GF_Blob *blob, Bool
     if (blob->mx)
         gf_mx_v(blob->mx);
 
+    gf_cache_entry_resized(entry);
     return GF_TRUE;
 }
 
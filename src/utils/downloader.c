@@ -301,6 +301,8 @@ void dm_sess_sk_del(GF_DownloadSession *sess)
 	}
 }
 
+#define GF_DM_CACHE_INDEX_SIZE	256
+
 struct __gf_download_manager
 {
 	GF_Mutex *cache_mx;
@@ -318,6 +320,15 @@ struct __gf_download_manager
 	GF_List *skip_proxy_servers;
 	GF_List *credentials;
 	GF_List *cache_entries;
+	//cache entries indexed by URL hash
+	GF_List *cache_index[GF_DM_CACHE_INDEX_SIZE];
+	//max size of resources stored in memory rather than on disk, 0 if disabled
+	u32 cache_mem_size;
+	//access clock for LRU eviction
+	u64 cache_clock;
+	//storage size of cache entries, updated as entries are added, removed or resized
+	u64 cache_size;
+	u32 cache_hits, cache_misses, cache_evictions;
 	/* FIXME : should be placed in DownloadedCacheEntry maybe... */
 	GF_List *partial_downloads;
 #ifdef GPAC_HAS_SSL
@@ -1065,6 +1076,26 @@ void gf_cache_set_end_range(DownloadedCacheEntry entry, u64 range_end);
 /*returns 1 if cache is currently open for write*/
 Bool gf_cache_is_in_progress(const DownloadedCacheEntry entry);
 
+/*returns 1 if entry cannot be evicted (in use, in progress, persistent or pinned)*/
+Bool gf_cache_entry_is_pinned(const DownloadedCacheEntry entry);
+/*marks entry as not evictable*/
+void gf_cache_entry_set_pinned(const DownloadedCacheEntry entry);
+/*sets/gets last access time of entry for LRU eviction*/
+void gf_cache_entry_set_last_access(const DownloadedCacheEntry entry, u64 last_access);
+u64 gf_cache_entry_get_last_access(const DownloadedCacheEntry entry);
+/*returns 1 if entry is stored in memory*/
+Bool gf_cache_is_memory_stored(const DownloadedCacheEntry entry);
+/*returns size in bytes used by the entry storage*/
+u32 gf_cache_get_storage_size(const DownloadedCacheEntry entry);
+/*moves an entry not yet written to memory storage, returns 1 if the entry is now in memory*/
+Bool gf_cache_entry_set_memory_storage(const DownloadedCacheEntry entry, GF_Mutex *mx);
+/*moves an entry not yet written from memory storage back to disk storage, returns 1 if the entry is now on disk*/
+Bool gf_cache_entry_set_disk_storage(const DownloadedCacheEntry entry, const char *cache_directory);
+/*sets whether entry storage is accounted in the cache size, returns the storage size added or removed*/
+u32 gf_cache_entry_set_accounted(const DownloadedCacheEntry entry, Bool accounted);
+/*returns storage size change since last call if entry is accounted*/
+s64 gf_cache_entry_update_accounted_size(const DownloadedCacheEntry entry);
+
 #include <gpac/crypt.h>
 
 static GF_Err gf_user_credentials_save_digest( GF_DownloadManager * dm, GF_UserCredentials * creds, const char * password, Bool store_info);
@@ -1656,6 +1687,7 @@ static GF_Err gf_ssl_write(GF_DownloadSession *sess, const u8 *buffer, u32 size,
 			if (sess->flags & GF_NETIO_SESSION_NO_BLOCK) {
 				int err = SSL_get_error(sess->ssl, len);
 				if ((err==SSL_ERROR_WANT_READ) || (err==SSL_ERROR_WANT_WRITE)) {
+					gf_sk_set_would_block(sess->sock, (err==SSL_ERROR_WANT_READ) ? GF_SK_SELECT_READ : GF_SK_SELECT_WRITE);
 					return GF_IP_NETWORK_EMPTY;
 				}
 				if (err==SSL_ERROR_SSL) {
@@ -1677,6 +1709,19 @@ static GF_Err gf_ssl_write(GF_DownloadSession *sess, const u8 *buffer, u32 size,
 #endif /* GPAC_HAS_SSL */
 
 
+static GF_Err dm_sess_push_async(GF_DownloadSession *par_sess, const u8 *buffer, u32 size)
+{
+	if (par_sess->async_buf_alloc < par_sess->async_buf_size + size) {
+		par_sess->async_buf_alloc = par_sess->async_buf_size + size;
+		par_sess->async_buf = gf_realloc(par_sess->async_buf, par_sess->async_buf_alloc);
+		if (!par_sess->async_buf) return GF_OUT_OF_MEM;
+	}
+	if (buffer)
+		memcpy(par_sess->async_buf+par_sess->async_buf_size, buffer, size);
+	par_sess->async_buf_size += size;
+	return GF_OK;
+}
+
 static GF_Err dm_sess_write(GF_DownloadSession *session, const u8 *buffer, u32 size)
 {
 	GF_Err e;
@@ -1719,13 +1764,7 @@ static GF_Err dm_sess_write(GF_DownloadSession *session, const u8 *buffer, u32 s
 			}
 		}
 	} else {
-		if (par_sess->async_buf_alloc < par_sess->async_buf_size + remain) {
-			par_sess->async_buf_alloc = par_sess->async_buf_size + remain;
-			par_sess->async_buf = gf_realloc(par_sess->async_buf, par_sess->async_buf_alloc);
-			if (!par_sess->async_buf) return GF_OUT_OF_MEM;
-		}
-		memcpy(par_sess->async_buf+par_sess->async_buf_size, buffer + written, remain);
-		par_sess->async_buf_size += remain;
+		return dm_sess_push_async(par_sess, buffer + written, remain);
 	}
 	return GF_OK;
 }
@@ -1747,27 +1786,71 @@ static Bool gf_dm_can_handle_url(GF_DownloadManager *dm, const char *url)
 	return GF_FALSE;
 }
 
-/*!
- * Finds an existing entry in the cache for a given URL
-\param sess The session configured with the URL
-\return NULL if none found, the DownloadedCacheEntry otherwise
- */
-DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess)
+static u32 gf_dm_cache_hash_str(const char *str)
+{
+	u32 hash = 5381;
+	while (*str) {
+		hash = ((hash << 5) + hash) + (u8) *str;
+		str++;
+	}
+	return hash % GF_DM_CACHE_INDEX_SIZE;
+}
+
+//groute entries are matched on the resource path only and are indexed on this path
+static u32 gf_dm_cache_url_hash(const char *url)
+{
+	if (!strncmp(url, "http://groute/", 14)) {
+		char *sep = strchr(url+14, '/');
+		if (sep) return gf_dm_cache_hash_str(sep);
+	}
+	return gf_dm_cache_hash_str(url);
+}
+
+//adds entry to cache - the cache mutex SHALL be grabbed before calling this
+static void gf_dm_cache_add(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	u32 idx = gf_dm_cache_url_hash(gf_cache_get_url(entry));
+	gf_list_add(dm->cache_entries, entry);
+	if (!dm->cache_index[idx])
+		dm->cache_index[idx] = gf_list_new();
+	gf_list_add(dm->cache_index[idx], entry);
+	gf_cache_entry_set_last_access(entry, ++dm->cache_clock);
+	dm->cache_size += gf_cache_entry_set_accounted(entry, GF_TRUE);
+}
+
+//removes entry from cache without destroying it - the cache mutex SHALL be grabbed before calling this
+static void gf_dm_cache_remove(GF_DownloadManager *dm, DownloadedCacheEntry entry)
+{
+	u32 idx = gf_dm_cache_url_hash(gf_cache_get_url(entry));
+	gf_list_del_item(dm->cache_entries, entry);
+	if (dm->cache_index[idx])
+		gf_list_del_item(dm->cache_index[idx], entry);
+	dm->cache_size -= gf_cache_entry_set_accounted(entry, GF_FALSE);
+}
+
+//called by cache entries when their storage size changes
+void gf_dm_cache_entry_resized(GF_DownloadManager *dm, const DownloadedCacheEntry entry)
+{
+	gf_mx_p(dm->cache_mx);
+	dm->cache_size += gf_cache_entry_update_accounted_size(entry);
+	gf_mx_v(dm->cache_mx);
+}
+
+static DownloadedCacheEntry gf_dm_cache_find_in_index(GF_DownloadSession *sess, u32 idx)
 {
 	u32 i, count;
-	gf_assert( sess && sess->dm && sess->dm->cache_entries );
-	gf_mx_p( sess->dm->cache_mx );
-	count = gf_list_count(sess->dm->cache_entries);
+	GF_List *bucket = sess->dm->cache_index[idx];
+	count = gf_list_count(bucket);
 	for (i = 0 ; i < count; i++) {
 		const char * url;
-		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(sess->dm->cache_entries, i);
+		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(bucket, i);
 		gf_assert(e);
 		url = gf_cache_get_url(e);
 		gf_assert( url );
 
 		if (!strncmp(url, "http://groute/", 14)) {
 			char *sep_1 = strchr(url+14, '/');
-			char *sep_2 = strchr(sess->orig_url+14, '/');
+			char *sep_2 = (strlen(sess->orig_url)>14) ? strchr(sess->orig_url+14, '/') : NULL;
 			if (!sep_1 || !sep_2 || strcmp(sep_1, sep_2))
 				continue;
 		} else if (strcmp(url, sess->orig_url)) continue;
@@ -1777,13 +1860,116 @@ DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess)
 			if (sess->range_end != gf_cache_get_end_range(e)) continue;
 		}
 		/*OK that's ours*/
-		gf_mx_v( sess->dm->cache_mx );
 		return e;
 	}
-	gf_mx_v( sess->dm->cache_mx );
 	return NULL;
 }
 
+/*!
+ * Finds an existing entry in the cache for a given URL
+\param sess The session configured with the URL
+\return NULL if none found, the DownloadedCacheEntry otherwise
+ */
+DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess)
+{
+	u32 idx;
+	DownloadedCacheEntry e;
+	gf_assert( sess && sess->dm && sess->dm->cache_entries );
+	gf_mx_p( sess->dm->cache_mx );
+	idx = gf_dm_cache_url_hash(sess->orig_url);
+	e = gf_dm_cache_find_in_index(sess, idx);
+	//groute entries may match a non-groute URL with the same resource path
+	if (!e && (strlen(sess->orig_url)>14) && strncmp(sess->orig_url, "http://groute/", 14)) {
+		char *sep = strchr(sess->orig_url+14, '/');
+		if (sep) {
+			u32 g_idx = gf_dm_cache_hash_str(sep);
+			if (g_idx != idx)
+				e = gf_dm_cache_find_in_index(sess, g_idx);
+		}
+	}
+	if (e)
+		gf_cache_entry_set_last_access(e, ++sess->dm->cache_clock);
+	gf_mx_v( sess->dm->cache_mx );
+	return e;
+}
+
+static int gf_dm_cache_cmp_ptr(const void *a, const void *b)
+{
+	uintptr_t pa = (uintptr_t) *(void **)a;
+	uintptr_t pb = (uintptr_t) *(void **)b;
+	return (pa<pb) ? -1 : ((pa>pb) ? 1 : 0);
+}
+
+static int gf_dm_cache_cmp_access(const void *a, const void *b)
+{
+	u64 la = gf_cache_entry_get_last_access(*(DownloadedCacheEntry *)a);
+	u64 lb = gf_cache_entry_get_last_access(*(DownloadedCacheEntry *)b);
+	return (la<lb) ? -1 : ((la>lb) ? 1 : 0);
+}
+
+//evicts least recently used entries until cache size is below max cache size - the cache mutex SHALL be grabbed before calling this
+static void gf_dm_cache_evict(GF_DownloadManager *dm)
+{
+	u32 i, count, nb_sess, nb_cands=0;
+	void **in_use;
+	DownloadedCacheEntry *cands;
+	if (!dm->max_cache_size || (dm->cache_size <= dm->max_cache_size)) return;
+
+	//sessions may still point to an entry they are no longer attached to, only compare pointers
+	nb_sess = gf_list_count(dm->sessions);
+	in_use = nb_sess ? gf_malloc(sizeof(void *) * nb_sess) : NULL;
+	for (i=0; i<nb_sess; i++) {
+		GF_DownloadSession *a_sess = (GF_DownloadSession*)gf_list_get(dm->sessions, i);
+		in_use[i] = a_sess->cache_entry;
+	}
+	if (nb_sess) qsort(in_use, nb_sess, sizeof(void *), gf_dm_cache_cmp_ptr);
+
+	count = gf_list_count(dm->cache_entries);
+	cands = count ? gf_malloc(sizeof(DownloadedCacheEntry) * count) : NULL;
+	for (i=0; i<count; i++) {
+		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(dm->cache_entries, i);
+		if (gf_cache_entry_is_pinned(e)) continue;
+		if (nb_sess && bsearch(&e, in_use, nb_sess, sizeof(void *), gf_dm_cache_cmp_ptr)) continue;
+		cands[nb_cands++] = e;
+	}
+	if (nb_cands) qsort(cands, nb_cands, sizeof(DownloadedCacheEntry), gf_dm_cache_cmp_access);
+
+	for (i=0; (i<nb_cands) && (dm->cache_size > dm->max_cache_size); i++) {
+		DownloadedCacheEntry lru = cands[i];
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Evicting %s (%d bytes) from cache\n", gf_cache_get_url(lru), gf_cache_get_storage_size(lru)));
+		gf_dm_cache_remove(dm, lru);
+		gf_cache_entry_set_delete_files_when_deleted(lru);
+		gf_cache_delete_entry(lru);
+		dm->cache_evictions++;
+	}
+	if (in_use) gf_free(in_use);
+	if (cands) gf_free(cands);
+}
+
+GF_EXPORT
+GF_Err gf_dm_get_cache_stats(GF_DownloadManager *dm, GF_DMCacheStats *stats)
+{
+	u32 i, count;
+	if (!dm || !stats) return GF_BAD_PARAM;
+	memset(stats, 0, sizeof(GF_DMCacheStats));
+	gf_mx_p(dm->cache_mx);
+	stats->hits = dm->cache_hits;
+	stats->misses = dm->cache_misses;
+	stats->evictions = dm->cache_evictions;
+	stats->size = dm->cache_size;
+	count = gf_list_count(dm->cache_entries);
+	stats->nb_entries = count;
+	for (i=0; i<count; i++) {
+		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(dm->cache_entries, i);
+		if (gf_cache_is_memory_stored(e)) {
+			stats->nb_mem_entries++;
+			stats->mem_size += gf_cache_get_storage_size(e);
+		}
+	}
+	gf_mx_v(dm->cache_mx);
+	return GF_OK;
+}
+
 /**
  * Creates a new cache entry
  */
@@ -1819,17 +2005,11 @@ static void gf_dm_remove_cache_entry_from_session(GF_DownloadSession * sess) {
 
 		        && (0 == gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)))
 		{
-			u32 i, count;
 			gf_mx_p( sess->dm->cache_mx );
-			count = gf_list_count( sess->dm->cache_entries );
-			for (i = 0; i < count; i++) {
-				DownloadedCacheEntry ex = (DownloadedCacheEntry)gf_list_get(sess->dm->cache_entries, i);
-				if (ex == sess->cache_entry) {
-					gf_list_rem(sess->dm->cache_entries, i);
-					gf_cache_delete_entry( sess->cache_entry );
-					sess->cache_entry = NULL;
-					break;
-				}
+			if (gf_list_find(sess->dm->cache_entries, sess->cache_entry)>=0) {
+				gf_dm_cache_remove(sess->dm, sess->cache_entry);
+				gf_cache_delete_entry( sess->cache_entry );
+				sess->cache_entry = NULL;
 			}
 			gf_mx_v( sess->dm->cache_mx );
 		}
@@ -1888,7 +2068,7 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 				if (!gf_cache_entry_persistent(sess->cache_entry) && !gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)) {
 					gf_mx_p( sess->dm->cache_mx );
 					/* No session attached anymore... we can delete it */
-					gf_list_del_item(sess->dm->cache_entries, sess->cache_entry);
+					gf_dm_cache_remove(sess->dm, sess->cache_entry);
 					gf_mx_v( sess->dm->cache_mx );
 					gf_cache_delete_entry(sess->cache_entry);
 				}
@@ -1900,7 +2080,7 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 				return;
 			}
 			gf_mx_p( sess->dm->cache_mx );
-			gf_list_add(sess->dm->cache_entries, entry);
+			gf_dm_cache_add(sess->dm, entry);
 			gf_mx_v( sess->dm->cache_mx );
 			sess->is_range_continuation = GF_FALSE;
 		}
@@ -1922,6 +2102,9 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 				gf_cache_close_write_cache(sess->cache_entry, sess, GF_FALSE);
 		}
 		gf_cache_add_session_to_cache_entry(sess->cache_entry, sess);
+		gf_mx_p( sess->dm->cache_mx );
+		gf_dm_cache_evict(sess->dm);
+		gf_mx_v( sess->dm->cache_mx );
 		if (sess->needs_range)
 			gf_cache_set_range(sess->cache_entry, 0, sess->range_start, sess->range_end);
 		GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[CACHE] Cache setup to %p %s\n", sess, gf_cache_get_cache_filename(sess->cache_entry)));
@@ -1950,7 +2133,7 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 void gf_dm_delete_cached_file_entry(const GF_DownloadManager * dm,  const char * url)
 {
 	GF_Err e;
-	u32 count, i;
+	u32 count, i, idx;
 	char * realURL;
 	GF_URL_Info info;
 	if (!url || !dm)
@@ -1966,10 +2149,11 @@ void gf_dm_delete_cached_file_entry(const GF_DownloadManager * dm,  const char *
 	realURL = gf_strdup(info.canonicalRepresentation);
 	gf_dm_url_info_del(&info);
 	gf_assert( realURL );
-	count = gf_list_count(dm->cache_entries);
+	idx = gf_dm_cache_url_hash(realURL);
+	count = gf_list_count(dm->cache_index[idx]);
 	for (i = 0 ; i < count; i++) {
 		const char * e_url;
-		DownloadedCacheEntry cache_ent = (DownloadedCacheEntry)gf_list_get(dm->cache_entries, i);
+		DownloadedCacheEntry cache_ent = (DownloadedCacheEntry)gf_list_get(dm->cache_index[idx], i);
 		gf_assert(cache_ent);
 		e_url = gf_cache_get_url(cache_ent);
 		gf_assert( e_url );
@@ -1978,7 +2162,7 @@ void gf_dm_delete_cached_file_entry(const GF_DownloadManager * dm,  const char *
 			gf_cache_entry_set_delete_files_when_deleted(cache_ent);
 			if (0 == gf_cache_get_sessions_count_for_cache_entry( cache_ent )) {
 				/* No session attached anymore... we can delete it */
-				gf_list_rem(dm->cache_entries, i);
+				gf_dm_cache_remove((GF_DownloadManager *) dm, cache_ent);
 				gf_cache_delete_entry(cache_ent);
 			}
 			/* If deleted or not, we don't search further */
@@ -3152,6 +3336,9 @@ static GF_Err gf_dm_read_data(GF_DownloadSession *sess, char *data, u32 data_siz
 				GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[SSL] Cannot read, error %s\n", msg));
 				e = GF_IO_ERR;
 			} else {
+				//TLS reads directly from the socket handle, notify drained socket
+				if (err==SSL_ERROR_WANT_READ)
+					gf_sk_set_would_block(sess->sock, GF_SK_SELECT_READ);
 				e = gf_sk_probe(sess->sock);
 			}
 		} else if (!size)
@@ -3608,6 +3795,7 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 #endif
 					SET_LAST_ERR(GF_SERVICE_ERROR)
 				} else if ((ret==SSL_ERROR_WANT_READ) || (ret==SSL_ERROR_WANT_WRITE)) {
+					gf_sk_set_would_block(sess->sock, (ret==SSL_ERROR_WANT_READ) ? GF_SK_SELECT_READ : GF_SK_SELECT_WRITE);
 					sess->status = GF_NETIO_SETUP;
 					sess->connect_pending = 2;
 					return;
@@ -3968,11 +4156,12 @@ typedef struct
 
 static void gf_dm_clean_cache(GF_DownloadManager *dm)
 {
-	u64 out_size = gf_cache_get_size(dm->cache_directory);
-	if (out_size >= dm->max_cache_size) {
-		GF_LOG(dm->max_cache_size ? GF_LOG_WARNING : GF_LOG_INFO, GF_LOG_HTTP, ("[Cache] Cache size %d exceeds max allowed %d, deleting entire cache\n", out_size, dm->max_cache_size));
+	if (!dm->max_cache_size) {
 		gf_cache_delete_all_cached_files(dm->cache_directory);
+		return;
 	}
+	//remove least recently modified resources until we are below max size
+	gf_cache_trim_cached_files(dm->cache_directory, dm->max_cache_size);
 }
 
 GF_EXPORT
@@ -4064,6 +4253,7 @@ retry_cache:
 		}
 	}
 	dm->allow_broken_certificate = gf_opts_get_bool("core", "broken-cert");
+	dm->cache_mem_size = gf_opts_get_int("core", "cache-mem");
 
 	gf_mx_v( dm->cache_mx );
 
@@ -4088,6 +4278,7 @@ void gf_dm_set_auth_callback(GF_DownloadManager *dm, gf_dm_get_usr_pass get_user
 GF_EXPORT
 void gf_dm_del(GF_DownloadManager *dm)
 {
+	u32 i;
 	if (!dm)
 		return;
 	gf_assert( dm->sessions);
@@ -4129,6 +4320,12 @@ void gf_dm_del(GF_DownloadManager *dm)
 	gf_list_del( dm->credentials);
 	dm->credentials = NULL;
 	gf_assert( dm->cache_entries );
+	if (dm->cache_hits || dm->cache_misses) {
+		GF_DMCacheStats stats;
+		gf_dm_get_cache_stats(dm, &stats);
+		GF_LOG(GF_LOG_INFO, GF_LOG_CACHE, ("[Cache] %u hits %u misses %u evictions - %u entries "LLU" bytes - %u in memory "LLU" bytes\n",
+			stats.hits, stats.misses, stats.evictions, stats.nb_entries, stats.size, stats.nb_mem_entries, stats.mem_size));
+	}
 	{
 		/* Deletes DownloadedCacheEntry and associated files if required */
 		Bool delete_my_files = gf_dm_needs_to_delete_cache(dm);
@@ -4141,8 +4338,11 @@ void gf_dm_del(GF_DownloadManager *dm)
 		}
 		gf_list_del( dm->cache_entries );
 		dm->cache_entries = NULL;
+		for (i=0; i<GF_DM_CACHE_INDEX_SIZE; i++) {
+			if (dm->cache_index[i]) gf_list_del(dm->cache_index[i]);
+			dm->cache_index[i] = NULL;
+		}
 	}
-
 	gf_list_del( dm->partial_downloads );
 	dm->partial_downloads = NULL;
 	/* TODO: Not ready for now, we should find a locking strategy between several GPAC instances...
@@ -5445,6 +5645,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		sess->reply_time = (u32) (gf_sys_clock_high_res() - sess->request_start_time);
 		sess->rsp_hdr_size = 0;
 		sess->total_size = sess->bytes_done = gf_cache_get_content_length(sess->cache_entry);
+		safe_int_inc(&sess->dm->cache_hits);
 
 		memset(&par, 0, sizeof(GF_NETIO_Parameter));
 		par.msg_type = GF_NETIO_DATA_TRANSFERED;
@@ -6085,6 +6286,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	{
 		sess->status = GF_NETIO_PARSE_REPLY;
 		gf_assert(sess->cache_entry);
+		safe_int_inc(&sess->dm->cache_hits);
 		sess->total_size = gf_cache_get_cache_filesize(sess->cache_entry);
 
 		gf_dm_sess_notify_state(sess, GF_NETIO_PARSE_REPLY, GF_OK);
@@ -6325,6 +6527,21 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	} else {
 		sess->total_size = ContentLength;
 		if (sess->use_cache_file && sess->http_read_type == GET ) {
+			//small resources go to the memory tier
+			if (sess->dm->cache_mem_size && ContentLength && (ContentLength <= sess->dm->cache_mem_size)
+				&& !(sess->flags & GF_NETIO_SESSION_KEEP_CACHE) && !sess->needs_range
+				&& (gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)==1)
+			) {
+				gf_cache_entry_set_memory_storage(sess->cache_entry, sess->dm->cache_mx);
+			}
+			//resource grew above the memory tier limit, move it back to disk
+			else if (gf_cache_is_memory_stored(sess->cache_entry) && (!ContentLength || (ContentLength > sess->dm->cache_mem_size))
+				&& !(sess->flags & GF_NETIO_SESSION_KEEP_CACHE) && !sess->needs_range
+				&& (gf_cache_get_sessions_count_for_cache_entry(sess->cache_entry)==1)
+			) {
+				gf_cache_entry_set_disk_storage(sess->cache_entry, sess->dm->cache_directory);
+			}
+			safe_int_inc(&sess->dm->cache_misses);
 			e = gf_cache_open_write_cache(sess->cache_entry, sess);
 			if (e) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ( "[CACHE] Failed to open cache, error=%d\n", e));
@@ -6920,16 +7137,17 @@ GF_Err gf_dm_set_localcache_provider(GF_DownloadManager *dm, Bool (*local_cache_
 GF_EXPORT
 DownloadedCacheEntry gf_dm_add_cache_entry(GF_DownloadManager *dm, const char *szURL, GF_Blob *blob, u64 start_range, u64 end_range, const char *mime, Bool clone_memory, u32 download_time_ms)
 {
-	u32 i, count;
+	u32 i, count, idx;
 	DownloadedCacheEntry the_entry = NULL;
 
 	gf_mx_p(dm->cache_mx );
 	if (blob)
 		GF_LOG(GF_LOG_INFO, GF_LOG_CACHE, ("[HTTP] Pushing %s to cache "LLU" bytes (done %s)\n", szURL, blob->size, (blob->flags & GF_BLOB_IN_TRANSFER) ? "no" : "yes"));
-	count = gf_list_count(dm->cache_entries);
+	idx = gf_dm_cache_url_hash(szURL);
+	count = gf_list_count(dm->cache_index[idx]);
 	for (i = 0 ; i < count; i++) {
 		const char * url;
-		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(dm->cache_entries, i);
+		DownloadedCacheEntry e = (DownloadedCacheEntry)gf_list_get(dm->cache_index[idx], i);
 		gf_assert(e);
 		url = gf_cache_get_url(e);
 		gf_assert( url );
@@ -6949,7 +7167,9 @@ DownloadedCacheEntry gf_dm_add_cache_entry(GF_DownloadManager *dm, const char *s
 			gf_mx_v(dm->cache_mx );
 			return NULL;
 		}
-		gf_list_add(dm->cache_entries, the_entry);
+		//entry is owned by the local cache provider
+		gf_cache_entry_set_pinned(the_entry);
+		gf_dm_cache_add(dm, the_entry);
 	}
 
 	gf_cache_set_mime(the_entry, mime);
@@ -7140,6 +7360,144 @@ GF_Err gf_dm_sess_send(GF_DownloadSession *sess, u8 *data, u32 size)
 	return e;
 }
 
+static Bool dm_sess_can_send_direct(GF_DownloadSession *sess)
+{
+	if (!sess->sock || !(sess->flags & GF_NETIO_SESSION_NO_BLOCK)) return GF_FALSE;
+#ifdef GPAC_HAS_SSL
+	if (sess->ssl) return GF_FALSE;
+#endif
+#ifdef GPAC_HAS_HTTP2
+	if (sess->h2_sess) return GF_FALSE;
+#endif
+	//pending data shall be sent first
+	if (sess->async_buf_size) return GF_FALSE;
+	return GF_TRUE;
+}
+
+//queue what is left of a set of buffers after a partial write
+static GF_Err dm_sess_push_async_remain(GF_DownloadSession *sess, const u8 **buffers, const u32 *sizes, u32 nb_buffers, u32 written)
+{
+	u32 i;
+	for (i=0; i<nb_buffers; i++) {
+		GF_Err e;
+		if (written >= sizes[i]) {
+			written -= sizes[i];
+			continue;
+		}
+		e = dm_sess_push_async(sess, buffers[i] + written, sizes[i] - written);
+		if (e) return e;
+		written = 0;
+	}
+	return GF_OK;
+}
+
+GF_Err gf_dm_sess_sendv(GF_DownloadSession *sess, const u8 **buffers, const u32 *sizes, u32 nb_buffers)
+{
+	u32 i, written=0;
+	GF_Err e;
+
+	if (!dm_sess_can_send_direct(sess) || (nb_buffers>8)) {
+		for (i=0; i<nb_buffers; i++) {
+			e = gf_dm_sess_send(sess, (u8 *) buffers[i], sizes[i]);
+			if (e) return e;
+		}
+		return GF_OK;
+	}
+	e = gf_sk_sendv(sess->sock, buffers, sizes, nb_buffers, GF_FALSE, &written);
+	if (e==GF_NOT_SUPPORTED) {
+		for (i=0; i<nb_buffers; i++) {
+			e = gf_dm_sess_send(sess, (u8 *) buffers[i], sizes[i]);
+			if (e) return e;
+		}
+		return GF_OK;
+	}
+	if (e==GF_IP_NETWORK_EMPTY)
+		return dm_sess_push_async_remain(sess, buffers, sizes, nb_buffers, written);
+
+	if (e==GF_IP_CONNECTION_CLOSED) {
+		sess_connection_closed(sess);
+		sess->status = GF_NETIO_STATE_ERROR;
+	}
+	return e;
+}
+
+GF_Err gf_dm_sess_send_file(GF_DownloadSession *sess, s32 fd, u64 offset, u32 size, const u8 *hdr, u32 hdr_size, const u8 *trailer, u32 trailer_size, u32 *sent, u32 *sent_zc)
+{
+#ifdef GPAC_CONFIG_LINUX
+	GF_Err e = GF_OK;
+	u32 written=0, done=0;
+	Bool framed = (hdr_size || trailer_size) ? GF_TRUE : GF_FALSE;
+	*sent = *sent_zc = 0;
+
+	if (!dm_sess_can_send_direct(sess) || (fd<0))
+		return GF_NOT_SUPPORTED;
+
+	if (hdr_size) {
+		e = gf_sk_sendv(sess->sock, &hdr, &hdr_size, 1, GF_TRUE, &written);
+		if (e==GF_NOT_SUPPORTED) return e;
+		if (e && (e!=GF_IP_NETWORK_EMPTY)) goto exit;
+		//header not sent, queue header and load data - no zero-copy possible
+		if (written<hdr_size) {
+			e = dm_sess_push_async(sess, hdr+written, hdr_size-written);
+			goto queue_file;
+		}
+	}
+
+	e = gf_sk_send_file(sess->sock, fd, offset, size, &done);
+	*sent_zc = done;
+	if (e==GF_NOT_SUPPORTED) {
+		//nothing sent yet, let caller use regular send
+		if (!hdr_size) return e;
+	}
+	else if (e && (e!=GF_IP_NETWORK_EMPTY)) goto exit;
+	else if (!framed) {
+		*sent = done;
+		return (done || !e) ? GF_OK : GF_IP_NETWORK_EMPTY;
+	}
+
+queue_file:
+	if (e && (e!=GF_IP_NETWORK_EMPTY) && (e!=GF_NOT_SUPPORTED)) goto exit;
+	e = GF_OK;
+	//chunk framing must be completed, copy remaining file data to pending buffer
+	if (done<size) {
+		s32 nb_read;
+		u32 remain = size - done;
+		u32 pos = sess->async_buf_size;
+		e = dm_sess_push_async(sess, NULL, remain);
+		if (e) goto exit;
+		nb_read = (s32) pread(fd, sess->async_buf + pos, remain, (off_t) (offset+done));
+		if (nb_read != (s32) remain) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_HTTP, ("[HTTP] Failed to read file data\n"));
+			sess->async_buf_size = pos;
+			e = GF_IO_ERR;
+			goto exit;
+		}
+	}
+	if (trailer_size) {
+		written = 0;
+		if (sess->async_buf_size) {
+			e = dm_sess_push_async(sess, trailer, trailer_size);
+		} else {
+			e = gf_sk_sendv(sess->sock, &trailer, &trailer_size, 1, GF_FALSE, &written);
+			if (e==GF_IP_NETWORK_EMPTY)
+				e = dm_sess_push_async(sess, trailer+written, trailer_size-written);
+		}
+	}
+
+exit:
+	if (e==GF_IP_CONNECTION_CLOSED) {
+		sess_connection_closed(sess);
+		sess->status = GF_NETIO_STATE_ERROR;
+		return e;
+	}
+	if (!e) *sent = size;
+	return e;
+#else
+	*sent = *sent_zc = 0;
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
 void gf_dm_sess_flush_h2(GF_DownloadSession *sess)
 {
 #ifdef GPAC_HAS_HTTP2
@@ -25,6 +25,7 @@
 
 #include <gpac/tools.h>
 #include <gpac/thread.h>
+#include <gpac/internal/log_dev.h>
 
 
 //ugly patch, we have a concurrence issue with gf_4cc_to_str, for now fixed by rolling buffers
@@ -750,6 +751,11 @@ Bool gpac_log_utc_time = GF_FALSE;
 Bool gpac_log_dual = GF_FALSE;
 Bool last_log_is_lf = GF_TRUE;
 static u64 gpac_last_log_time=0;
+//clock and UTC at which the message being written by the async logger was emitted, 0 if sync
+static u64 log_async_clock=0;
+static u64 log_async_utc=0;
+//set while the async logger writes a batch of messages, flush is done once at the end of the batch
+static Bool log_async_batch=GF_FALSE;
 
 static void do_log_time(FILE *logs, const char *fmt)
 {
@@ -757,12 +763,12 @@ static void do_log_time(FILE *logs, const char *fmt)
 
 	if (last_log_is_lf) {
 		if (gpac_log_time_start) {
-			u64 now = gf_sys_clock_high_res();
+			u64 now = log_async_clock ? log_async_clock : gf_sys_clock_high_res();
 			gf_fprintf(logs, "At "LLD" (diff %d) - ", now, (u32) (now - gpac_last_log_time) );
 			gpac_last_log_time = now;
 		}
 		if (gpac_log_utc_time) {
-			u64 utc_clock = gf_net_get_utc() ;
+			u64 utc_clock = log_async_utc ? log_async_utc : gf_net_get_utc() ;
 			time_t secs = utc_clock/1000;
 			struct tm t;
 			t = *gf_gmtime(&secs);
@@ -793,7 +799,8 @@ void default_log_callback(void *cbck, GF_LOG_Level level, GF_LOG_Tool tool, cons
 		}
 		vfprintf(logs, fmt, vlist);
 	}
-	gf_fflush(logs);
+	if (!log_async_batch)
+		gf_fflush(logs);
 }
 
 void default_log_callback_color(void *cbck, GF_LOG_Level level, GF_LOG_Tool tool, const char *fmt, va_list vlist)
@@ -830,7 +837,8 @@ void default_log_callback_color(void *cbck, GF_LOG_Level level, GF_LOG_Tool tool
 
 	vfprintf(stderr, fmt, vlist);
 	gf_sys_set_console_code(stderr, GF_CONSOLE_RESET);
-	gf_fflush(stderr);
+	if (!log_async_batch)
+		gf_fflush(stderr);
 }
 
 
@@ -848,6 +856,319 @@ Bool gf_log_use_color()
 	return (log_cbk == default_log_callback_color) ? GF_TRUE : GF_FALSE;
 }
 
+#if !defined(GPAC_DISABLE_THREADS) && !defined(GPAC_CONFIG_EMSCRIPTEN)
+#define GPAC_LOG_ASYNC
+#endif
+
+#ifdef GPAC_LOG_ASYNC
+
+#if defined(WIN32) && !defined(__GNUC__)
+#define LOG_TLS	__declspec(thread)
+//volatile accesses have acquire/release semantics with msvc
+#define log_load_acquire(_v)	(_v)
+#define log_store_release(_v, _val)	(_v) = (_val)
+#else
+#define LOG_TLS	__thread
+#define log_load_acquire(_v)	__atomic_load_n(&(_v), __ATOMIC_ACQUIRE)
+#define log_store_release(_v, _val)	__atomic_store_n(&(_v), (_val), __ATOMIC_RELEASE)
+#endif
+
+//number of messages in each thread queue, must be a power of 2
+#define LOG_RING_SIZE	512
+//max message size stored in the queue, larger messages are allocated
+#define LOG_SLOT_TEXT	232
+#define LOG_MAX_RINGS	256
+//max wait time in ms when a queue is full before dropping the message
+#define LOG_FULL_MAX_WAIT	10
+
+typedef struct
+{
+	u32 seq;
+	u32 level, tool;
+	u64 clock, utc;
+	char *large_text;
+	char text[LOG_SLOT_TEXT];
+} GF_LogSlot;
+
+//single producer single consumer queue, head is only written by the owning thread, tail by the logger thread
+typedef struct
+{
+	volatile u32 head;
+	volatile u32 tail;
+	//set when the owning thread is gone, the queue can be reused once empty
+	volatile Bool released;
+	GF_LogSlot slots[LOG_RING_SIZE];
+} GF_LogRing;
+
+static GF_Thread *log_async_th = NULL;
+static volatile Bool log_async_on = GF_FALSE;
+static volatile Bool log_async_run = GF_FALSE;
+static u32 log_async_gen = 0;
+static u32 log_async_seq = 0;
+static u32 log_async_drops = 0;
+static u32 log_async_drops_reported = 0;
+//number of threads currently queuing a message
+static volatile u32 log_async_pushing = 0;
+static GF_LogRing *log_rings[LOG_MAX_RINGS];
+static volatile u32 log_nb_rings = 0;
+
+static LOG_TLS GF_LogRing *log_ring = NULL;
+static LOG_TLS u32 log_ring_gen = 0;
+static LOG_TLS Bool log_is_logger = GF_FALSE;
+
+static GF_LogRing *log_async_get_ring()
+{
+	u32 i;
+	if (log_ring && (log_ring_gen==log_async_gen)) return log_ring;
+	log_ring = NULL;
+
+	gf_mx_p(logs_mx);
+	for (i=0; i<log_nb_rings; i++) {
+		GF_LogRing *r = log_rings[i];
+		if (r->released && (r->head == log_load_acquire(r->tail))) {
+			r->released = GF_FALSE;
+			log_ring = r;
+			break;
+		}
+	}
+	if (!log_ring && (log_nb_rings<LOG_MAX_RINGS)) {
+		//not using gf_malloc, we may be called by the memory tracker
+		log_ring = calloc(1, sizeof(GF_LogRing));
+		if (log_ring) {
+			log_rings[log_nb_rings] = log_ring;
+			log_store_release(log_nb_rings, log_nb_rings+1);
+		}
+	}
+	gf_mx_v(logs_mx);
+	log_ring_gen = log_async_gen;
+	return log_ring;
+}
+
+//wait for all pending messages to be written
+static void log_async_flush()
+{
+	u32 i, nb_rings = log_load_acquire(log_nb_rings);
+	for (i=0; i<nb_rings; i++) {
+		GF_LogRing *r = log_rings[i];
+		while (log_async_run && (r->head != log_load_acquire(r->tail)))
+			gf_sleep(1);
+	}
+}
+
+static Bool log_async_push(const char *fmt, va_list vl)
+{
+	GF_LogRing *r;
+	GF_LogSlot *slot;
+	u32 head;
+	s32 len;
+	va_list vl_c;
+
+	//logs from the logger thread (callbacks) are written directly
+	if (log_is_logger) return GF_FALSE;
+	//app messages and fatal errors are written synchronously once pending messages are written
+	if ((call_tool==GF_LOG_APP) || (log_exit_on_error && (call_lev==GF_LOG_ERROR) && (call_tool != GF_LOG_MEMORY))) {
+		log_async_flush();
+		return GF_FALSE;
+	}
+	r = log_async_get_ring();
+	if (!r) return GF_FALSE;
+
+	head = r->head;
+	if (head - log_load_acquire(r->tail) >= LOG_RING_SIZE) {
+		u32 nb_tries = 0;
+		//queue full, give the logger thread a chance to catch up before dropping
+		while (head - log_load_acquire(r->tail) >= LOG_RING_SIZE) {
+			if (nb_tries == LOG_FULL_MAX_WAIT) {
+				safe_int_inc(&log_async_drops);
+				return GF_TRUE;
+			}
+			nb_tries++;
+			gf_sleep(1);
+		}
+	}
+	slot = &r->slots[head & (LOG_RING_SIZE-1)];
+	va_copy(vl_c, vl);
+	len = vsnprintf(slot->text, LOG_SLOT_TEXT, fmt, vl_c);
+	va_end(vl_c);
+	slot->large_text = NULL;
+	if (len<0) {
+		slot->text[LOG_SLOT_TEXT-1] = 0;
+	} else if (len >= LOG_SLOT_TEXT) {
+		slot->large_text = malloc(len+1);
+		if (slot->large_text) vsnprintf(slot->large_text, len+1, fmt, vl);
+	}
+	slot->level = call_lev;
+	slot->tool = call_tool;
+	slot->clock = gpac_log_time_start ? gf_sys_clock_high_res() : 0;
+	slot->utc = gpac_log_utc_time ? gf_net_get_utc() : 0;
+	slot->seq = safe_int_inc(&log_async_seq);
+	log_store_release(r->head, head+1);
+	return GF_TRUE;
+}
+
+static void log_async_cbk(GF_LOG_Level level, GF_LOG_Tool tool, const char *fmt, ...)
+{
+	va_list vl;
+	va_start(vl, fmt);
+	log_cbk(user_log_cbk, level, tool, fmt, vl);
+	va_end(vl);
+}
+
+static void log_async_write(GF_LogSlot *slot)
+{
+	char *text = slot->large_text ? slot->large_text : slot->text;
+	log_async_clock = slot->clock;
+	log_async_utc = slot->utc;
+	//callbacks may check the format for a trailing LF, use the message as format if no format specifier in it
+	if (!strchr(text, '%')) {
+		log_async_cbk(slot->level, slot->tool, text);
+	} else {
+		u32 len = (u32) strlen(text);
+		if (len && (text[len-1]=='\n')) {
+			text[len-1] = 0;
+			log_async_cbk(slot->level, slot->tool, "%s\n", text);
+		} else {
+			log_async_cbk(slot->level, slot->tool, "%s", text);
+		}
+	}
+	log_async_clock = log_async_utc = 0;
+	if (slot->large_text) free(slot->large_text);
+	slot->large_text = NULL;
+}
+
+static u32 log_async_drain()
+{
+	u32 nb_written = 0;
+	gf_mx_p(logs_mx);
+	log_async_batch = GF_TRUE;
+	while (1) {
+		u32 i, nb_rings = log_load_acquire(log_nb_rings);
+		GF_LogRing *r = NULL;
+		GF_LogSlot *slot = NULL;
+		//write oldest message first
+		for (i=0; i<nb_rings; i++) {
+			GF_LogRing *a_r = log_rings[i];
+			GF_LogSlot *a_slot;
+			if (log_load_acquire(a_r->head) == a_r->tail) continue;
+			a_slot = &a_r->slots[a_r->tail & (LOG_RING_SIZE-1)];
+			if (!slot || ((s32) (a_slot->seq - slot->seq) < 0)) {
+				r = a_r;
+				slot = a_slot;
+			}
+		}
+		if (!r) break;
+		log_async_write(slot);
+		log_store_release(r->tail, r->tail+1);
+		nb_written++;
+	}
+	if (log_async_drops != log_async_drops_reported) {
+		u32 nb_drops = log_async_drops - log_async_drops_reported;
+		log_async_drops_reported += nb_drops;
+		log_async_cbk(GF_LOG_WARNING, GF_LOG_CORE, "[core] %u log messages dropped, async log queue full\n", nb_drops);
+	}
+	log_async_batch = GF_FALSE;
+	if (nb_written) {
+		if (gpac_log_file) gf_fflush(gpac_log_file);
+		gf_fflush(stderr);
+	}
+	gf_mx_v(logs_mx);
+	return nb_written;
+}
+
+static u32 log_async_proc(void *par)
+{
+	log_is_logger = GF_TRUE;
+	while (log_async_run) {
+		if (!log_async_drain())
+			gf_sleep(1);
+	}
+	log_async_drain();
+	return 0;
+}
+
+//called when a thread created by gf_th_run exits
+void gf_log_thread_done(void)
+{
+	if (log_ring) {
+		//queues are freed under the log mutex when async logs are disabled
+		gf_mx_p(logs_mx);
+		if (log_ring_gen==log_async_gen)
+			log_ring->released = GF_TRUE;
+		gf_mx_v(logs_mx);
+	}
+	log_ring = NULL;
+}
+
+GF_EXPORT
+GF_Err gf_log_set_async(Bool enable)
+{
+	u32 i;
+	if (enable) {
+		if (log_async_th) return GF_OK;
+		log_async_th = gf_th_new("Logger");
+		if (!log_async_th) return GF_OUT_OF_MEM;
+		log_async_gen++;
+		log_async_drops = log_async_drops_reported = 0;
+		log_async_run = GF_TRUE;
+		if (gf_th_run(log_async_th, log_async_proc, NULL) != GF_OK) {
+			log_async_run = GF_FALSE;
+			gf_th_del(log_async_th);
+			log_async_th = NULL;
+			return GF_IO_ERR;
+		}
+		log_async_on = GF_TRUE;
+		return GF_OK;
+	}
+	if (!log_async_th) return GF_OK;
+	//new messages are now written synchronously
+	log_async_on = GF_FALSE;
+	//wait for threads still queuing a message, they may wait for the logger thread to free a slot
+	while (safe_int_add(&log_async_pushing, 0))
+		gf_sleep(1);
+	//the logger thread writes pending messages before exiting
+	log_async_run = GF_FALSE;
+	gf_th_stop(log_async_th);
+	gf_th_del(log_async_th);
+	log_async_th = NULL;
+
+	gf_mx_p(logs_mx);
+	//force threads to get a new queue
+	log_async_gen++;
+	for (i=0; i<log_nb_rings; i++) {
+		free(log_rings[i]);
+		log_rings[i] = NULL;
+	}
+	log_nb_rings = 0;
+	gf_mx_v(logs_mx);
+	return GF_OK;
+}
+
+GF_EXPORT
+u32 gf_log_get_async_drops()
+{
+	return log_async_drops;
+}
+
+#else
+
+void gf_log_thread_done(void)
+{
+}
+
+GF_EXPORT
+GF_Err gf_log_set_async(Bool enable)
+{
+	return enable ? GF_NOT_SUPPORTED : GF_OK;
+}
+
+GF_EXPORT
+u32 gf_log_get_async_drops()
+{
+	return 0;
+}
+
+#endif //GPAC_LOG_ASYNC
+
 GF_EXPORT
 void gf_log(const char *fmt, ...)
 {
@@ -860,7 +1181,26 @@ void gf_log(const char *fmt, ...)
 #endif
 	va_list vl;
 	va_start(vl, fmt);
+#ifdef GPAC_LOG_ASYNC
+	if (log_async_on) {
+		Bool queued = GF_FALSE;
+		safe_int_inc(&log_async_pushing);
+		//check again, async logs may have been disabled before we were counted
+		if (log_async_on)
+			queued = log_async_push(fmt, vl);
+		safe_int_dec(&log_async_pushing);
+		if (queued) {
+			va_end(vl);
+			return;
+		}
+	}
+#endif
 	gf_mx_p(logs_mx);
+#ifdef GPAC_LOG_ASYNC
+	//async logs are being disabled, write queued messages first to keep messages in order
+	if (log_nb_rings && !log_async_on && !log_is_logger)
+		log_async_drain();
+#endif
 	log_cbk(user_log_cbk, call_lev, call_tool, fmt, vl);
 	gf_mx_v(logs_mx);
 	va_end(vl);
@@ -974,6 +1314,18 @@ Bool gf_log_tool_level_on(GF_LOG_Tool log_tool, GF_LOG_Level log_level)
 	return GF_FALSE;
 }
 
+GF_EXPORT
+GF_Err gf_log_set_async(Bool enable)
+{
+	return enable ? GF_NOT_SUPPORTED : GF_OK;
+}
+
+GF_EXPORT
+u32 gf_log_get_async_drops()
+{
+	return 0;
+}
+
 GF_EXPORT
 void gf_log_push_extra(const GF_LogExtra *log){}
 
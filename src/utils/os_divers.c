@@ -900,6 +900,7 @@ Bool gf_sys_is_cov_mode()
 const char *gpac_log_file_name=NULL;
 #ifndef GPAC_DISABLE_LOG
 extern Bool gpac_log_dual;
+static Bool gpac_log_async = GF_FALSE;
 #ifdef GPAC_CONFIG_EMSCRIPTEN
 extern Bool gpac_log_console;
 #endif
@@ -943,6 +944,9 @@ char gf_prog_lf = '\r';
 
 #ifndef GPAC_DISABLE_NETWORK
 extern Bool gpac_use_poll;
+#ifdef GPAC_HAS_EPOLL
+extern Bool gpac_use_epoll;
+#endif
 #endif
 
 GF_EXPORT
@@ -957,6 +961,9 @@ GF_Err gf_sys_set_args(s32 argc, const char **argv)
 
 #ifndef GPAC_DISABLE_NETWORK
 		gpac_use_poll = GF_TRUE;
+#ifdef GPAC_HAS_EPOLL
+		gpac_use_epoll = GF_TRUE;
+#endif
 #endif
 		for (i=1; i<argc; i++) {
 			Bool consumed;
@@ -1012,6 +1019,10 @@ GF_Err gf_sys_set_args(s32 argc, const char **argv)
 			} else if (!strcmp(arg, "-log-utc") || !strcmp(arg, "-lu")) {
 #ifndef GPAC_DISABLE_LOG
 				gpac_log_utc_time = GF_TRUE;
+#endif
+			} else if (!strcmp(arg, "-log-async") || !strcmp(arg, "-la")) {
+#ifndef GPAC_DISABLE_LOG
+				gpac_log_async = bool_value;
 #endif
 			} else if (!strcmp(arg, "-quiet")) {
 				gpac_quiet = 2;
@@ -1028,6 +1039,10 @@ GF_Err gf_sys_set_args(s32 argc, const char **argv)
 			} else if (!stricmp(arg, "-no-poll")) {
 #ifndef GPAC_DISABLE_NETWORK
 				gpac_use_poll = bool_value;
+#endif
+			} else if (!stricmp(arg, "-no-epoll")) {
+#if !defined(GPAC_DISABLE_NETWORK) && defined(GPAC_HAS_EPOLL)
+				gpac_use_epoll = !bool_value;
 #endif
 			}
 #if !defined(GPAC_DISABLE_NETCAP)
@@ -1063,6 +1078,9 @@ GF_Err gf_sys_set_args(s32 argc, const char **argv)
 
 #ifndef GPAC_DISABLE_LOG
 		gf_log_reset_file();
+		//start async logs if already initialized, otherwise done in gf_sys_init
+		if (gpac_log_async && logs_mx)
+			gf_log_set_async(GF_TRUE);
 #endif
 		if (gf_opts_get_bool("core", "rmt"))
 			gf_sys_enable_remotery(GF_TRUE, GF_FALSE);
@@ -1598,6 +1616,10 @@ GF_Err gf_sys_init(GF_MemTrackerType mem_tracker_type, const char *profile)
 #ifndef GPAC_CONFIG_EMSCRIPTEN
 		//avoid log mutex on emscriptem - let the FS IO deal with it
 		logs_mx = gf_mx_new("Logs");
+#ifndef GPAC_DISABLE_LOG
+		if (gpac_log_async)
+			gf_log_set_async(GF_TRUE);
+#endif
 #endif
 		gf_rand_init(GF_FALSE);
 
@@ -1662,6 +1684,9 @@ void gf_sys_close()
 		gf_uninit_global_config(gpac_discard_config);
 
 #ifndef GPAC_DISABLE_LOG
+		//write pending logs
+		gf_log_set_async(GF_FALSE);
+		gpac_log_async = GF_FALSE;
 		if (gpac_log_file) {
 			gf_fclose(gpac_log_file);
 			gpac_log_file = NULL;
@@ -1471,6 +1471,124 @@ GF_FileIO *gf_fileio_from_mem(const char *URL, const u8 *data, u32 size)
 }
 
 
+typedef struct
+{
+	u8 *data;
+	u32 size, alloc;
+	gfio_mem_realloc_proc realloc_proc;
+	void *udta;
+} GF_FileIOMemWriter;
+
+static GF_Err gfio_memw_realloc(GF_FileIOMemWriter *mw, u32 size)
+{
+	u8 *data;
+	if (size <= mw->alloc) return GF_OK;
+	//grow at least twice the current size to keep reallocation count low
+	if (size < 2*mw->alloc) size = 2*mw->alloc;
+	if (size < 1024) size = 1024;
+	if (mw->realloc_proc)
+		data = mw->realloc_proc(mw->udta, mw->data, size);
+	else
+		data = gf_realloc(mw->data, size);
+	if (!data) return GF_OUT_OF_MEM;
+	mw->data = data;
+	mw->alloc = size;
+	return GF_OK;
+}
+
+static GF_FileIO *gfio_memw_open(GF_FileIO *fileio_ref, const char *url, const char *mode, GF_Err *out_error)
+{
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(fileio_ref);
+	*out_error = GF_OK;
+	if (!strcmp(mode, "close")) {
+		if (!mw->realloc_proc && mw->data) gf_free(mw->data);
+		gf_free(mw);
+		gf_fileio_del(fileio_ref);
+		return NULL;
+	}
+	*out_error = GF_BAD_PARAM;
+	return NULL;
+}
+static GF_Err gfio_memw_seek(GF_FileIO *fileio, u64 offset, s32 whence)
+{
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(fileio);
+	if (whence==SEEK_CUR) offset += mw->size;
+	else if (whence==SEEK_END) offset = mw->size;
+	//seeking truncates the data
+	if (offset > mw->size) return GF_BAD_PARAM;
+	mw->size = (u32) offset;
+	return GF_OK;
+}
+static u32 gfio_memw_write(GF_FileIO *fileio, u8 *buffer, u32 bytes)
+{
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(fileio);
+	if (!buffer || !bytes) return 0;
+	if (gfio_memw_realloc(mw, mw->size + bytes)) return 0;
+	memcpy(mw->data + mw->size, buffer, bytes);
+	mw->size += bytes;
+	return bytes;
+}
+static s64 gfio_memw_tell(GF_FileIO *fileio)
+{
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(fileio);
+	return (s64) mw->size;
+}
+static Bool gfio_memw_eof(GF_FileIO *fileio)
+{
+	return GF_TRUE;
+}
+static int gfio_memw_printf(GF_FileIO *fileio, const char *format, va_list args)
+{
+	va_list args_copy;
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(fileio);
+	u32 avail = mw->alloc - mw->size;
+
+	//print directly in the buffer, and only reallocate if too small
+	va_copy(args_copy, args);
+	s32 len = vsnprintf(mw->data ? (char *) mw->data + mw->size : NULL, avail, format, args_copy);
+	va_end(args_copy);
+	if (len<0) return len;
+	if ((u32) len >= avail) {
+		if (gfio_memw_realloc(mw, mw->size + len + 1)) return -1;
+		vsnprintf((char *) mw->data + mw->size, len+1, format, args);
+	}
+	mw->size += len;
+	return len;
+}
+
+GF_EXPORT
+FILE *gf_fileio_mem_writer(gfio_mem_realloc_proc realloc_proc, void *udta, u32 size_hint)
+{
+	GF_FileIOMemWriter *mw;
+	GF_SAFEALLOC(mw, GF_FileIOMemWriter);
+	if (!mw) return NULL;
+	mw->realloc_proc = realloc_proc;
+	mw->udta = udta;
+	GF_FileIO *res = gf_fileio_new(NULL, mw, gfio_memw_open, gfio_memw_seek, NULL, gfio_memw_write, gfio_memw_tell, gfio_memw_eof, gfio_memw_printf);
+	if (!res) {
+		gf_free(mw);
+		return NULL;
+	}
+	if (size_hint && gfio_memw_realloc(mw, size_hint)) {
+		gf_fclose((FILE *) res);
+		return NULL;
+	}
+	return (FILE *) res;
+}
+
+GF_EXPORT
+u8 *gf_fileio_mem_writer_data(FILE *fp, u32 *size)
+{
+	GF_FileIO *gfio = (GF_FileIO *) fp;
+	if (!gf_fileio_check(fp) || (gfio->open != gfio_memw_open)) {
+		if (size) *size = 0;
+		return NULL;
+	}
+	GF_FileIOMemWriter *mw = gf_fileio_get_udta(gfio);
+	if (size) *size = mw->size;
+	return mw->data;
+}
+
 #ifdef GPAC_CONFIG_EMSCRIPTEN
 static u32 mainloop_th_id = 0;
 void gf_set_mainloop_thread(u32 thread_id)
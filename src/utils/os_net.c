@@ -23,6 +23,11 @@
  *
  */
 
+//for recvmmsg
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <gpac/network.h>
 
 #ifndef GPAC_DISABLE_NETWORK
@@ -155,6 +160,18 @@ typedef s32 SOCKET;
 
 #endif
 
+#ifdef GPAC_HAS_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#include <sys/uio.h>
+
+#ifdef GPAC_CONFIG_LINUX
+#include <sys/sendfile.h>
+#define GPAC_HAS_SENDFILE
+#define GPAC_HAS_RECVMMSG
+#endif
+
 #endif /*WIN32||_WIN32_WCE*/
 
 #ifdef GPAC_BUILD_FOR_WINXP
@@ -426,6 +443,15 @@ struct __tag_socket
 #ifdef GPAC_HAS_POLL
 	u32 poll_idx;
 #endif
+#ifdef GPAC_HAS_EPOLL
+	//epoll group this socket is registered in
+	GF_SockGroup *ep_group;
+	//readiness reported by edge-triggered epoll, kept until the socket would block
+	u32 ep_ready;
+	//1-based index in the group pending array, 0 if not ready
+	u32 ep_pending_idx;
+#endif
+	void *usr_data;
 
 #ifndef GPAC_DISABLE_NETCAP
 	NetCapInfo *cap_info;
@@ -2107,6 +2133,10 @@ GF_EXPORT
 void gf_sk_del(GF_Socket *sock)
 {
 	gf_assert( sock );
+#ifdef GPAC_HAS_EPOLL
+	//group still references the socket
+	if (sock->ep_group) gf_sk_group_unregister(sock->ep_group, sock);
+#endif
 	gf_sk_free(sock);
 #ifdef WIN32
 	wsa_init --;
@@ -2678,8 +2708,104 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *ifce_ip_or_name, u16 port, const
 #endif
 }
 
+#include <gpac/list.h>
+struct __tag_sock_group
+{
+	GF_List *sockets;
+	fd_set rgroup, wgroup;
+
+#ifdef GPAC_HAS_POLL
+	u32 last_mask;
+	u32 nb_fds, alloc_fds;
+	GF_POLLFD *fds;
+#endif
+
+#ifdef GPAC_HAS_EPOLL
+	int epfd;
+	//number of registered sockets with pending read / write readiness
+	u32 nb_ep_read, nb_ep_write;
+	u32 alloc_ep_events;
+	struct epoll_event *ep_events;
+	//sockets with pending read or write readiness
+	GF_Socket **ep_pending;
+	u32 nb_ep_pending, alloc_ep_pending;
+#endif
+	//sockets found ready by the last select, enumerated by gf_sk_group_get_ready
+	GF_Socket **ready;
+	u32 nb_ready, alloc_ready;
+
+#ifndef GPAC_DISABLE_NETCAP
+	u32 nb_nfs;
+	u32 nb_socks;
+#endif
+};
+
 Bool gpac_use_poll=GF_TRUE;
 
+#define SK_EP_READ	1
+#define SK_EP_WRITE	2
+
+#ifdef GPAC_HAS_EPOLL
+Bool gpac_use_epoll=GF_TRUE;
+
+static void sk_ep_set_ready(GF_Socket *sock, u32 flags)
+{
+	GF_SockGroup *sg = sock->ep_group;
+	u32 new_flags = flags & ~sock->ep_ready;
+	if (!new_flags) return;
+	if (!sock->ep_ready) {
+		if (sg->nb_ep_pending == sg->alloc_ep_pending) {
+			u32 new_alloc = sg->alloc_ep_pending ? 2*sg->alloc_ep_pending : 64;
+			GF_Socket **pending = gf_realloc(sg->ep_pending, sizeof(GF_Socket *) * new_alloc);
+			if (!pending) return;
+			sg->ep_pending = pending;
+			sg->alloc_ep_pending = new_alloc;
+		}
+		sg->ep_pending[sg->nb_ep_pending] = sock;
+		sg->nb_ep_pending++;
+		sock->ep_pending_idx = sg->nb_ep_pending;
+	}
+	sock->ep_ready |= new_flags;
+	if (new_flags & SK_EP_READ) sock->ep_group->nb_ep_read++;
+	if (new_flags & SK_EP_WRITE) sock->ep_group->nb_ep_write++;
+}
+
+//edge-triggered mode: readiness is only cleared once an operation on the socket would block
+static void sk_ep_clear_ready(GF_Socket *sock, u32 flags)
+{
+	u32 old_flags;
+	if (!sock->ep_group) return;
+	old_flags = flags & sock->ep_ready;
+	if (!old_flags) return;
+	sock->ep_ready &= ~old_flags;
+	if (old_flags & SK_EP_READ) sock->ep_group->nb_ep_read--;
+	if (old_flags & SK_EP_WRITE) sock->ep_group->nb_ep_write--;
+	if (!sock->ep_ready && sock->ep_pending_idx) {
+		GF_SockGroup *sg = sock->ep_group;
+		//swap with last pending socket
+		GF_Socket *last = sg->ep_pending[sg->nb_ep_pending-1];
+		sg->ep_pending[sock->ep_pending_idx-1] = last;
+		last->ep_pending_idx = sock->ep_pending_idx;
+		sg->nb_ep_pending--;
+		sock->ep_pending_idx = 0;
+	}
+}
+#define sk_would_block(_sock, _flags)	sk_ep_clear_ready(_sock, _flags)
+#else
+#define sk_would_block(_sock, _flags)
+#endif
+
+GF_EXPORT
+void gf_sk_set_would_block(GF_Socket *sock, GF_SockSelectMode mode)
+{
+#ifdef GPAC_HAS_EPOLL
+	if (!sock) return;
+	if (mode==GF_SK_SELECT_READ) sk_ep_clear_ready(sock, SK_EP_READ);
+	else if (mode==GF_SK_SELECT_WRITE) sk_ep_clear_ready(sock, SK_EP_WRITE);
+	else sk_ep_clear_ready(sock, SK_EP_READ|SK_EP_WRITE);
+#endif
+}
+
 static GF_Err poll_select(GF_Socket *sock, GF_SockSelectMode mode, u32 usec, Bool force_select)
 {
 #ifndef __SYMBIAN32__
@@ -2805,6 +2931,7 @@ GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written
 		if (res == SOCKET_ERROR) {
 			switch (res = LASTSOCKERROR) {
 			case EAGAIN:
+				sk_would_block(sock, SK_EP_WRITE);
 				return GF_IP_NETWORK_EMPTY;
 #ifndef __SYMBIAN32__
 			case ENOTCONN:
@@ -2839,6 +2966,140 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 
 }
 
+static GF_Err sk_send_error(GF_Socket *sock, s32 err)
+{
+	switch (err) {
+	case EAGAIN:
+		sk_would_block(sock, SK_EP_WRITE);
+		return GF_IP_NETWORK_EMPTY;
+	case ENOTCONN:
+	case ECONNRESET:
+	case EPIPE:
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(err)));
+		return GF_IP_CONNECTION_CLOSED;
+	case ENOBUFS:
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(err)));
+		return GF_BUFFER_TOO_SMALL;
+	default:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(err)));
+		return GF_IP_NETWORK_FAILURE;
+	}
+}
+
+GF_EXPORT
+GF_Err gf_sk_sendv(GF_Socket *sock, const u8 **buffers, const u32 *sizes, u32 nb_buffers, Bool more, u32 *written)
+{
+#if defined(WIN32) || defined(_WIN32_WCE) || defined(__SYMBIAN32__)
+	u32 i;
+	GF_Err e = GF_OK;
+	if (written) *written = 0;
+	for (i=0; i<nb_buffers; i++) {
+		u32 done=0;
+		e = gf_sk_send_ex(sock, buffers[i], sizes[i], &done);
+		if (written) *written += done;
+		if (e) break;
+	}
+	return e;
+#else
+	struct iovec iov[8];
+	struct msghdr msg;
+	u32 i, total=0, count=0;
+	s32 res;
+	int sflags = 0;
+
+	if (written) *written = 0;
+	if (nb_buffers>8) return GF_BAD_PARAM;
+	if (!sock || !sock->socket)
+		return GF_BAD_PARAM;
+#ifndef GPAC_DISABLE_NETCAP
+	if (sock->cap_info) return GF_NOT_SUPPORTED;
+#endif
+	if (sock->flags & GF_SOCK_HAS_PEER) return GF_NOT_SUPPORTED;
+
+	for (i=0; i<nb_buffers; i++) {
+		iov[i].iov_base = (void *) buffers[i];
+		iov[i].iov_len = sizes[i];
+		total += sizes[i];
+	}
+	memset(&msg, 0, sizeof(struct msghdr));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = nb_buffers;
+
+	if (! (sock->flags & GF_SOCK_NON_BLOCKING)) {
+		//check write
+		GF_Err e = poll_select(sock, GF_SK_SELECT_WRITE, sock->usec_wait, GF_FALSE);
+		if (e) return e;
+	}
+#ifdef MSG_NOSIGNAL
+	sflags |= MSG_NOSIGNAL;
+#endif
+#ifdef MSG_MORE
+	if (more) sflags |= MSG_MORE;
+#endif
+
+	while (count < total) {
+		res = (s32) sendmsg(sock->socket, &msg, sflags);
+		if (res == SOCKET_ERROR)
+			return sk_send_error(sock, LASTSOCKERROR);
+
+		count += res;
+		if (written) *written += res;
+		//skip sent vectors
+		while (res && msg.msg_iovlen) {
+			if ((u32) res < msg.msg_iov[0].iov_len) {
+				msg.msg_iov[0].iov_base = (u8 *) msg.msg_iov[0].iov_base + res;
+				msg.msg_iov[0].iov_len -= res;
+				break;
+			}
+			res -= (s32) msg.msg_iov[0].iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+	}
+	return GF_OK;
+#endif
+}
+
+GF_EXPORT
+GF_Err gf_sk_send_file(GF_Socket *sock, s32 fd, u64 offset, u32 length, u32 *written)
+{
+#ifdef GPAC_HAS_SENDFILE
+	u32 count=0;
+	off_t pos = (off_t) offset;
+
+	if (written) *written = 0;
+	if (!sock || !sock->socket || (fd<0))
+		return GF_BAD_PARAM;
+#ifndef GPAC_DISABLE_NETCAP
+	if (sock->cap_info) return GF_NOT_SUPPORTED;
+#endif
+	if (!(sock->flags & GF_SOCK_IS_TCP)) return GF_NOT_SUPPORTED;
+
+	if (! (sock->flags & GF_SOCK_NON_BLOCKING)) {
+		//check write
+		GF_Err e = poll_select(sock, GF_SK_SELECT_WRITE, sock->usec_wait, GF_FALSE);
+		if (e) return e;
+	}
+	while (count < length) {
+		ssize_t res = sendfile(sock->socket, fd, &pos, length - count);
+		if (res < 0) {
+			s32 err = LASTSOCKERROR;
+			//file cannot be mapped, caller must use regular send
+			if (!count && ((err==EINVAL) || (err==ENOSYS))) return GF_NOT_SUPPORTED;
+			return sk_send_error(sock, err);
+		}
+		//end of file reached
+		if (!res) break;
+		count += (u32) res;
+		if (written) *written += (u32) res;
+	}
+	return GF_OK;
+#else
+	if (written) *written = 0;
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
 GF_Err gf_sk_select(GF_Socket *sock, GF_SockSelectMode mode)
 {
 	//the socket must be bound or connected
@@ -3527,24 +3788,7 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 
 }
 
-#include <gpac/list.h>
-struct __tag_sock_group
-{
-	GF_List *sockets;
-	fd_set rgroup, wgroup;
-
-#ifdef GPAC_HAS_POLL
-	u32 last_mask;
-	u32 nb_fds, alloc_fds;
-	GF_POLLFD *fds;
-#endif
-
-#ifndef GPAC_DISABLE_NETCAP
-	u32 nb_nfs;
-	u32 nb_socks;
-#endif
-};
-
+GF_EXPORT
 GF_SockGroup *gf_sk_group_new()
 {
 	GF_SockGroup *tmp;
@@ -3555,12 +3799,38 @@ GF_SockGroup *gf_sk_group_new()
 
 #ifdef GPAC_HAS_POLL
 	tmp->last_mask = POLLIN;
+#endif
+#ifdef GPAC_HAS_EPOLL
+	tmp->epfd = -1;
+	if (gpac_use_epoll) {
+		tmp->epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (tmp->epfd<0) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot create epoll instance: %s, using poll\n", gf_errno_str(LASTSOCKERROR) ));
+		}
+	}
 #endif
 	return tmp;
 }
 
+GF_EXPORT
 void gf_sk_group_del(GF_SockGroup *sg)
 {
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epfd>=0) {
+		u32 i=0;
+		GF_Socket *sk;
+		while ((sk = gf_list_enum(sg->sockets, &i))) {
+			if (sk->ep_group != sg) continue;
+			sk->ep_group = NULL;
+			sk->ep_ready = 0;
+			sk->ep_pending_idx = 0;
+		}
+		close(sg->epfd);
+	}
+	if (sg->ep_events) gf_free(sg->ep_events);
+	if (sg->ep_pending) gf_free(sg->ep_pending);
+#endif
+	if (sg->ready) gf_free(sg->ready);
 	gf_list_del(sg->sockets);
 #ifdef GPAC_HAS_POLL
 	if (sg->fds) gf_free(sg->fds);
@@ -3568,6 +3838,47 @@ void gf_sk_group_del(GF_SockGroup *sg)
 	gf_free(sg);
 }
 
+#ifdef GPAC_HAS_POLL
+static void sk_group_add_pollfd(GF_SockGroup *sg, GF_Socket *sk)
+{
+	if (sg->nb_fds + 1 > sg->alloc_fds) {
+		sg->fds = gf_realloc(sg->fds, (sg->nb_fds+1) * sizeof(GF_POLLFD));
+		sg->alloc_fds = sg->nb_fds+1;
+	}
+	sg->fds[sg->nb_fds].fd = sk->socket;
+	sg->fds[sg->nb_fds].events = sg->last_mask;
+	sg->fds[sg->nb_fds].revents = 0;
+	sk->poll_idx = sg->nb_fds+1;
+	gf_assert(sg->fds[sg->nb_fds].fd != 0);
+	sg->nb_fds++;
+}
+#endif
+
+#ifdef GPAC_HAS_EPOLL
+//move group back to poll/select, all sockets but the one being registered are moved to the pollfd array
+static void sk_group_disable_epoll(GF_SockGroup *sg, GF_Socket *new_sk)
+{
+	u32 i=0;
+	GF_Socket *sk;
+	while ((sk = gf_list_enum(sg->sockets, &i))) {
+		if (sk->ep_group == sg) {
+			sk_ep_clear_ready(sk, SK_EP_READ|SK_EP_WRITE);
+			sk->ep_group = NULL;
+		}
+#ifdef GPAC_HAS_POLL
+		if ((sk==new_sk) || !gpac_use_poll) continue;
+#ifndef GPAC_DISABLE_NETCAP
+		if (sk->cap_info) continue;
+#endif
+		sk_group_add_pollfd(sg, sk);
+#endif
+	}
+	close(sg->epfd);
+	sg->epfd = -1;
+}
+#endif
+
+GF_EXPORT
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (!sg || !sk) return;
@@ -3585,28 +3896,60 @@ void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 	}
 #endif
 
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epfd>=0) {
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(struct epoll_event));
+		//edge-triggered, readiness is kept in the socket until an operation would block
+		ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		ev.data.ptr = sk;
+		if (epoll_ctl(sg->epfd, EPOLL_CTL_ADD, sk->socket, &ev) == 0) {
+			if (sk->ep_group && (sk->ep_group != sg)) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] socket registered in several groups, readiness tracked only for the first one\n"));
+			} else {
+				sk->ep_group = sg;
+				sk->ep_ready = 0;
+			}
+			return;
+		}
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot add socket to epoll group: %s\n", gf_errno_str(LASTSOCKERROR) ));
+		//mixing epoll and poll is not possible, move the whole group to poll (or select)
+		sk_group_disable_epoll(sg, sk);
+	}
+#endif
+
 #ifdef GPAC_HAS_POLL
 	if (!sg->fds && !gpac_use_poll)
 		return;
 
-	if (sg->nb_fds + 1 > sg->alloc_fds) {
-		sg->fds = gf_realloc(sg->fds, (sg->nb_fds+1) * sizeof(GF_POLLFD));
-		sg->alloc_fds = sg->nb_fds+1;
-	}
-	sg->fds[sg->nb_fds].fd = sk->socket;
-	sg->fds[sg->nb_fds].events = sg->last_mask;
-	sg->fds[sg->nb_fds].revents = 0;
-	sk->poll_idx = sg->nb_fds+1;
-	gf_assert(sg->fds[sg->nb_fds].fd != 0);
-	sg->nb_fds++;
+	sk_group_add_pollfd(sg, sk);
 #endif
 }
 
+GF_EXPORT
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 {
+	u32 i;
 	if (!sg || !sk) return;
 	s32 pidx = gf_list_del_item(sg->sockets, sk);
 
+	//socket may be unregistered while enumerating ready sockets
+	for (i=0; i<sg->nb_ready; i++) {
+		if (sg->ready[i]==sk) sg->ready[i] = NULL;
+	}
+
+#ifdef GPAC_HAS_EPOLL
+	if ((sg->epfd>=0) && (pidx>=0)) {
+		struct epoll_event ev;
+		//socket may already be closed
+		epoll_ctl(sg->epfd, EPOLL_CTL_DEL, sk->socket, &ev);
+		if (sk->ep_group == sg) {
+			sk_ep_clear_ready(sk, SK_EP_READ|SK_EP_WRITE);
+			sk->ep_group = NULL;
+		}
+	}
+#endif
+
 #ifndef GPAC_DISABLE_NETCAP
 	if (sk->cap_info && sk->cap_info->nf->read_socks) {
 		if (sg->nb_nfs && (pidx>=0))
@@ -3654,6 +3997,20 @@ void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 #endif
 }
 
+static void sk_group_add_ready(GF_SockGroup *sg, GF_Socket *sock)
+{
+	if (sg->nb_ready == sg->alloc_ready) {
+		u32 new_alloc = sg->alloc_ready ? 2*sg->alloc_ready : 64;
+		GF_Socket **ready = gf_realloc(sg->ready, sizeof(GF_Socket *) * new_alloc);
+		if (!ready) return;
+		sg->ready = ready;
+		sg->alloc_ready = new_alloc;
+	}
+	sg->ready[sg->nb_ready] = sock;
+	sg->nb_ready++;
+}
+
+GF_EXPORT
 GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mode)
 {
 	s32 ready;
@@ -3661,6 +4018,7 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 	struct timeval timeout;
 	GF_Socket *sock;
 
+	sg->nb_ready = 0;
 	if (!sg->sockets)
 		return GF_IP_NETWORK_EMPTY;
 
@@ -3704,6 +4062,65 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 	}
 #endif
 
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epfd>=0) {
+		s32 res;
+		Bool pending = GF_FALSE;
+		if ((mode != GF_SK_SELECT_WRITE) && sg->nb_ep_read) pending = GF_TRUE;
+		if ((mode != GF_SK_SELECT_READ) && sg->nb_ep_write) pending = GF_TRUE;
+
+		if (!sg->ep_events) {
+			sg->alloc_ep_events = 64;
+			sg->ep_events = gf_malloc(sizeof(struct epoll_event) * sg->alloc_ep_events);
+			if (!sg->ep_events) {
+				sg->alloc_ep_events = 0;
+				return GF_OUT_OF_MEM;
+			}
+		}
+		//sockets not yet drained are still ready, only collect new events
+		res = epoll_wait(sg->epfd, sg->ep_events, sg->alloc_ep_events, pending ? 0 : usec_wait/1000);
+		if (res<0) {
+			switch (LASTSOCKERROR) {
+			case EAGAIN:
+			case EINTR:
+				//sockets not yet drained are still reported
+				if (!pending) return GF_IP_NETWORK_EMPTY;
+				res = 0;
+				break;
+			default:
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot epoll: %s\n", gf_errno_str(LASTSOCKERROR) ));
+				return GF_IP_NETWORK_FAILURE;
+			}
+		}
+		for (i=0; i<(u32) res; i++) {
+			u32 flags = 0;
+			u32 evts = sg->ep_events[i].events;
+			sock = sg->ep_events[i].data.ptr;
+			if (sock->ep_group != sg) continue;
+			//disconnected or error, consider ready to read/write
+			if (evts & (EPOLLHUP|EPOLLERR)) flags = SK_EP_READ | SK_EP_WRITE;
+			if (evts & (EPOLLIN|EPOLLRDHUP)) flags |= SK_EP_READ;
+			if (evts & EPOLLOUT) flags |= SK_EP_WRITE;
+			sk_ep_set_ready(sock, flags);
+		}
+		//more events pending than we could fetch, grow for next call
+		if (((u32) res == sg->alloc_ep_events) && (sg->alloc_ep_events < gf_list_count(sg->sockets))) {
+			struct epoll_event *evts = gf_realloc(sg->ep_events, sizeof(struct epoll_event) * 2 * sg->alloc_ep_events);
+			if (evts) {
+				sg->ep_events = evts;
+				sg->alloc_ep_events *= 2;
+			}
+		}
+		//only sockets with pending readiness are reported
+		for (i=0; i<sg->nb_ep_pending; i++) {
+			sock = sg->ep_pending[i];
+			if ((mode != GF_SK_SELECT_WRITE) && (sock->ep_ready & SK_EP_READ)) sk_group_add_ready(sg, sock);
+			else if ((mode != GF_SK_SELECT_READ) && (sock->ep_ready & SK_EP_WRITE)) sk_group_add_ready(sg, sock);
+		}
+		return sg->nb_ready ? GF_OK : GF_IP_NETWORK_EMPTY;
+	}
+#endif
+
 #ifdef GPAC_HAS_POLL
 	if (sg->fds) {
 		u32 mask = 0;
@@ -3730,6 +4147,11 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 
 		if (!res)
 			return GF_IP_NETWORK_EMPTY;
+		for (i=0; i<sg->nb_fds; i++) {
+			if (!sg->fds[i].revents) continue;
+			sock = gf_list_get(sg->sockets, i);
+			if (sock) sk_group_add_ready(sg, sock);
+		}
 		return GF_OK;
 	}
 #endif
@@ -3786,9 +4208,15 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
 		return GF_IP_NETWORK_EMPTY;
 	}
+	i=0;
+	while ((sock = gf_list_enum(sg->sockets, &i))) {
+		if ((rgroup && FD_ISSET(sock->socket, rgroup)) || (wgroup && FD_ISSET(sock->socket, wgroup)))
+			sk_group_add_ready(sg, sock);
+	}
 	return GF_OK;
 }
 
+GF_EXPORT
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode mode)
 {
 	if (!sg || !sk) return GF_FALSE;
@@ -3806,6 +4234,16 @@ Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode
 	}
 #endif
 
+#ifdef GPAC_HAS_EPOLL
+	if ((sg->epfd>=0) && (sk->ep_group==sg)) {
+		if ((mode!=GF_SK_SELECT_WRITE) && (sk->ep_ready & SK_EP_READ))
+			return GF_TRUE;
+		if ((mode!=GF_SK_SELECT_READ) && (sk->ep_ready & SK_EP_WRITE))
+			return GF_TRUE;
+		return GF_FALSE;
+	}
+#endif
+
 #ifdef GPAC_HAS_POLL
 	if (sg->fds && sk->poll_idx) {
 		GF_POLLFD *pfd = &sg->fds[sk->poll_idx-1];
@@ -3833,6 +4271,43 @@ Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode
 	return GF_FALSE;
 }
 
+GF_EXPORT
+GF_Socket *gf_sk_group_get_ready(GF_SockGroup *sg, u32 *idx, GF_SockSelectMode mode)
+{
+	if (!sg || !idx) return NULL;
+#ifndef GPAC_DISABLE_NETCAP
+	//capture replay, readiness is only known per socket
+	if (sg->nb_nfs) {
+		GF_Socket *sk;
+		while ((sk = gf_list_enum(sg->sockets, idx))) {
+			if (gf_sk_group_sock_is_set(sg, sk, mode)) return sk;
+		}
+		return NULL;
+	}
+#endif
+	while (*idx < sg->nb_ready) {
+		GF_Socket *sk = sg->ready[*idx];
+		(*idx)++;
+		//unregistered since last select
+		if (!sk) continue;
+		//drained since last select, or not ready for this mode
+		if (gf_sk_group_sock_is_set(sg, sk, mode)) return sk;
+	}
+	return NULL;
+}
+
+GF_EXPORT
+void gf_sk_set_usr_data(GF_Socket *sock, void *udta)
+{
+	if (sock) sock->usr_data = udta;
+}
+
+GF_EXPORT
+void *gf_sk_get_usr_data(GF_Socket *sock)
+{
+	return sock ? sock->usr_data : NULL;
+}
+
 //fetch nb bytes on a socket and fill the buffer from startFrom
 //length is the allocated size of the receiving buffer
 //BytesRead is the number of bytes read from the network
@@ -3887,7 +4362,10 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 	if (do_select && !(sock->flags & GF_SOCK_NON_BLOCKING)) {
 		//check read
 		GF_Err e = poll_select(sock, GF_SK_SELECT_READ, sock->usec_wait, GF_FALSE);
-		if (e) return e;
+		if (e) {
+			if (e==GF_IP_NETWORK_EMPTY) sk_would_block(sock, SK_EP_READ);
+			return e;
+		}
 	}
 	if (!buffer) return GF_OK;
 
@@ -3903,6 +4381,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 		res = LASTSOCKERROR;
 		switch (res) {
 		case EAGAIN:
+			sk_would_block(sock, SK_EP_READ);
 			return GF_IP_NETWORK_EMPTY;
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -3942,6 +4421,10 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 
 	if (!res) return GF_IP_NETWORK_EMPTY;
 
+	//stream socket drained
+	if ((sock->flags & GF_SOCK_IS_TCP) && ((u32) res < length))
+		sk_would_block(sock, SK_EP_READ);
+
 	if (BytesRead)
 		*BytesRead = res;
 	return GF_OK;
@@ -3959,6 +4442,85 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *Byt
 	return gf_sk_receive_internal(sock, buffer, length, BytesRead, GF_FALSE);
 }
 
+//max number of datagrams fetched in one system call
+#define GF_SK_MAX_BATCH	64
+
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *slots, u32 nb_slots, u32 *nb_read)
+{
+	u32 i;
+	GF_Err e;
+
+	if (nb_read) *nb_read = 0;
+	if (!sock || !slots || !nb_slots || !nb_read) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_RECVMMSG
+	if (sock->socket && !(sock->flags & GF_SOCK_IS_TCP)
+#ifndef GPAC_DISABLE_NETCAP
+		&& !sock->cap_info
+#endif
+	) {
+		struct mmsghdr msgs[GF_SK_MAX_BATCH];
+		struct iovec iovs[GF_SK_MAX_BATCH];
+		s32 res;
+
+		if (nb_slots > GF_SK_MAX_BATCH) nb_slots = GF_SK_MAX_BATCH;
+		memset(msgs, 0, sizeof(struct mmsghdr) * nb_slots);
+		for (i=0; i<nb_slots; i++) {
+			iovs[i].iov_base = slots[i].buffer;
+			iovs[i].iov_len = slots[i].size;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			//datagrams are received in order, the address of the last sender is kept as for recvfrom
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+			}
+			slots[i].read = 0;
+		}
+		res = recvmmsg(sock->socket, msgs, nb_slots, MSG_DONTWAIT, NULL);
+		if (res == SOCKET_ERROR) {
+			res = LASTSOCKERROR;
+			if ((res==EAGAIN) || (res==EWOULDBLOCK)) {
+				sk_would_block(sock, SK_EP_READ);
+				return GF_IP_NETWORK_EMPTY;
+			}
+			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading: %s\n", gf_errno_str(res) ));
+			return GF_IP_NETWORK_FAILURE;
+		}
+		if (!res) return GF_IP_NETWORK_EMPTY;
+
+		for (i=0; i<(u32) res; i++) {
+			slots[i].read = msgs[i].msg_len;
+		}
+		if (sock->flags & GF_SOCK_HAS_PEER)
+			sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+		//socket drained
+		if ((u32) res < nb_slots)
+			sk_would_block(sock, SK_EP_READ);
+		*nb_read = (u32) res;
+		return GF_OK;
+	}
+#endif
+
+	for (i=0; i<nb_slots; i++) {
+		slots[i].read = 0;
+		e = gf_sk_receive_internal(sock, slots[i].buffer, slots[i].size, &slots[i].read, GF_FALSE);
+		if (e) {
+			if (!i) return e;
+			break;
+		}
+		(*nb_read)++;
+		//blocking socket, don't risk a blocking read
+		if (!(sock->flags & GF_SOCK_NON_BLOCKING)) break;
+#ifndef GPAC_DISABLE_NETCAP
+		//netcap replays one packet per select
+		if (sock->cap_info) break;
+#endif
+	}
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -4004,6 +4566,7 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 	if (sk == INVALID_SOCKET) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
+			sk_would_block(sock, SK_EP_READ);
 			return GF_IP_NETWORK_EMPTY;
 		default:
 			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] accept error: %s\n", gf_errno_str(LASTSOCKERROR)));
@@ -28,6 +28,7 @@
 #endif
 
 #include <gpac/thread.h>
+#include <gpac/internal/log_dev.h>
 
 #ifndef GPAC_DISABLE_THREADS
 
@@ -242,6 +243,8 @@ exit:
 	}
 #ifndef GPAC_DISABLE_LOG
 	GF_LOG(GF_LOG_INFO, GF_LOG_MUTEX, ("[Thread %s] At %d Exiting thread proc, return code %d\n", t->log_name, gf_sys_clock(), ret));
+	//release async log queue of this thread
+	gf_log_thread_done();
 #endif
 	t->status = GF_THREAD_STATUS_DEAD;
 	t->Run = NULL;
@@ -0,0 +1,74 @@
+#include <gpac/bitstream.h>
+#include "tests.h"
+
+u8 gf_bs_read_bit(GF_BitStream *bs);
+
+static u32 read_ue(GF_BitStream *bs)
+{
+    u32 nb_lead = gf_bs_read_leading_zeros(bs, 32);
+    return (1<<nb_lead) - 1 + gf_bs_read_int(bs, nb_lead);
+}
+
+static const u8 bs_data[] = {0xA5, 0x3C, 0x00, 0xFF, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0x01, 0x80, 0x7F, 0x55};
+
+unittest(gf_bs_read_int)
+{
+    u32 i, nb_bits, pos=0;
+    GF_BitStream *bs = gf_bs_new(bs_data, sizeof(bs_data), GF_BITSTREAM_READ);
+    GF_BitStream *ref = gf_bs_new(bs_data, sizeof(bs_data), GF_BITSTREAM_READ);
+
+    //read fields of varying sizes crossing byte boundaries and compare against bit by bit reading
+    for (nb_bits=1; pos + nb_bits <= 8*sizeof(bs_data); nb_bits = (nb_bits % 17) + 1) {
+        u32 val = gf_bs_read_int(bs, nb_bits);
+        u32 ref_val = 0;
+        for (i=0; i<nb_bits; i++)
+            ref_val = (ref_val<<1) | gf_bs_read_bit(ref);
+        assert_equal(val, ref_val);
+        pos += nb_bits;
+        assert_equal(gf_bs_get_bit_offset(bs), gf_bs_get_bit_offset(ref));
+    }
+    gf_bs_del(bs);
+    gf_bs_del(ref);
+
+    bs = gf_bs_new(bs_data, sizeof(bs_data), GF_BITSTREAM_READ);
+    assert_equal(gf_bs_read_int(bs, 4), 0xA);
+    assert_equal(gf_bs_read_int(bs, 32), 0x53C00FF1);
+    assert_equal(gf_bs_read_long_int(bs, 44), 0x23456789ABCULL);
+    gf_bs_align(bs);
+    assert_equal(gf_bs_read_u8(bs), 0xDE);
+    gf_bs_del(bs);
+}
+
+unittest(gf_bs_read_int_emulation_prevention)
+{
+    //00 00 03 01 -> 00 00 01
+    const u8 data[] = {0x80, 0x00, 0x00, 0x03, 0x01, 0xFF};
+    GF_BitStream *bs = gf_bs_new(data, sizeof(data), GF_BITSTREAM_READ);
+    gf_bs_enable_emulation_byte_removal(bs, GF_TRUE);
+    assert_equal(gf_bs_read_int(bs, 4), 0x8);
+    assert_equal(gf_bs_read_int(bs, 24), 0x000000);
+    assert_equal(gf_bs_read_int(bs, 12), 0x1FF);
+    assert_equal(gf_bs_get_emulation_byte_removed(bs), 1);
+    gf_bs_del(bs);
+}
+
+unittest(gf_bs_read_leading_zeros)
+{
+    //1 | 010 | 011 | 00100 | 0000 0000 1 0000 0000 (255) | 00101 (4)
+    const u8 data[] = {0xA6, 0x40, 0x08, 0x01, 0x40};
+    const u8 zeros[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    GF_BitStream *bs = gf_bs_new(data, sizeof(data), GF_BITSTREAM_READ);
+    assert_equal(read_ue(bs), 0);
+    assert_equal(read_ue(bs), 1);
+    assert_equal(read_ue(bs), 2);
+    assert_equal(read_ue(bs), 3);
+    assert_equal(read_ue(bs), 255);
+    assert_equal(read_ue(bs), 4);
+    gf_bs_del(bs);
+
+    bs = gf_bs_new(zeros, sizeof(zeros), GF_BITSTREAM_READ);
+    assert_equal(gf_bs_read_int(bs, 3), 0);
+    assert_equal(gf_bs_read_leading_zeros(bs, 33), 33);
+    assert_equal(gf_bs_get_bit_offset(bs), 36);
+    gf_bs_del(bs);
+}
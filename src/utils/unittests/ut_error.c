@@ -0,0 +1,133 @@
+#include <gpac/thread.h>
+#include "tests.h"
+
+#define UT_LOG_THREADS	4
+#define UT_LOG_MSGS		2000
+
+static u32 ut_log_count[UT_LOG_THREADS];
+static u32 ut_log_last[UT_LOG_THREADS];
+static u32 ut_log_sent[UT_LOG_THREADS];
+static Bool ut_log_order_ok;
+static volatile Bool ut_log_stop;
+
+//callbacks are called under the log mutex, in sync and async modes
+static void ut_log_cbk(void *udta, GF_LOG_Level level, GF_LOG_Tool tool, const char *fmt, va_list vl)
+{
+    u32 th, idx;
+    char msg[100];
+    vsnprintf(msg, sizeof(msg), fmt, vl);
+    if (sscanf(msg, "ut_log %u %u", &th, &idx) != 2) return;
+    if (th >= UT_LOG_THREADS) return;
+    //messages of a thread are written in order
+    if (ut_log_count[th] && (idx <= ut_log_last[th])) ut_log_order_ok = GF_FALSE;
+    ut_log_last[th] = idx;
+    ut_log_count[th]++;
+}
+
+static u32 ut_log_proc(void *par)
+{
+    u32 i, th = (u32) (uintptr_t) par;
+    for (i=0; i<UT_LOG_MSGS; i++) {
+        GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("ut_log %u %u\n", th, i));
+    }
+    return 0;
+}
+
+//logs until stopped
+static u32 ut_log_loop_proc(void *par)
+{
+    u32 i = 0, th = (u32) (uintptr_t) par;
+    while (!ut_log_stop) {
+        GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("ut_log %u %u\n", th, i));
+        i++;
+    }
+    ut_log_sent[th] = i;
+    return 0;
+}
+
+static void ut_log_reset(void)
+{
+    memset(ut_log_count, 0, sizeof(ut_log_count));
+    memset(ut_log_last, 0, sizeof(ut_log_last));
+    memset(ut_log_sent, 0, sizeof(ut_log_sent));
+    ut_log_order_ok = GF_TRUE;
+    ut_log_stop = GF_FALSE;
+}
+
+unittest(log_async_threads)
+{
+    u32 i, nb_recv = 0;
+    GF_Thread *th[UT_LOG_THREADS];
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    gf_log_set_tool_level(GF_LOG_CORE, GF_LOG_INFO);
+    gf_log_set_callback(NULL, ut_log_cbk);
+    ut_log_reset();
+
+    assert_equal(gf_log_set_async(GF_TRUE), GF_OK);
+    for (i=0; i<UT_LOG_THREADS; i++) {
+        th[i] = gf_th_new("ut_log");
+        assert_not_null(th[i]);
+        assert_equal(gf_th_run(th[i], ut_log_proc, (void *) (uintptr_t) i), GF_OK);
+    }
+    for (i=0; i<UT_LOG_THREADS; i++) {
+        gf_th_stop(th[i]);
+        gf_th_del(th[i]);
+    }
+    //pending messages are written when disabling
+    assert_equal(gf_log_set_async(GF_FALSE), GF_OK);
+
+    for (i=0; i<UT_LOG_THREADS; i++)
+        nb_recv += ut_log_count[i];
+    assert_equal(nb_recv + gf_log_get_async_drops(), UT_LOG_THREADS * UT_LOG_MSGS);
+    assert_true(ut_log_order_ok);
+
+    gf_log_set_callback(NULL, NULL);
+    gf_log_set_tool_level(GF_LOG_CORE, GF_LOG_WARNING);
+    gf_sys_close();
+}
+
+//disabling async logs while threads are logging must not lose queues in use
+unittest(log_async_disable_while_logging)
+{
+    u32 i, nb_recv = 0, nb_sent = 0, nb_drops;
+    GF_Thread *th[UT_LOG_THREADS];
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    gf_log_set_tool_level(GF_LOG_CORE, GF_LOG_INFO);
+    gf_log_set_callback(NULL, ut_log_cbk);
+    ut_log_reset();
+
+    assert_equal(gf_log_set_async(GF_TRUE), GF_OK);
+    for (i=0; i<UT_LOG_THREADS; i++) {
+        th[i] = gf_th_new("ut_log");
+        assert_not_null(th[i]);
+        assert_equal(gf_th_run(th[i], ut_log_loop_proc, (void *) (uintptr_t) i), GF_OK);
+    }
+    gf_sleep(20);
+    assert_equal(gf_log_set_async(GF_FALSE), GF_OK);
+    nb_drops = gf_log_get_async_drops();
+    //threads keep logging synchronously
+    gf_sleep(10);
+    assert_equal(gf_log_set_async(GF_TRUE), GF_OK);
+    gf_sleep(10);
+    assert_equal(gf_log_set_async(GF_FALSE), GF_OK);
+    nb_drops += gf_log_get_async_drops();
+    ut_log_stop = GF_TRUE;
+    for (i=0; i<UT_LOG_THREADS; i++) {
+        gf_th_stop(th[i]);
+        gf_th_del(th[i]);
+    }
+
+    for (i=0; i<UT_LOG_THREADS; i++) {
+        nb_recv += ut_log_count[i];
+        nb_sent += ut_log_sent[i];
+    }
+    assert_greater(nb_sent, 0);
+    assert_equal(nb_recv + nb_drops, nb_sent);
+    assert_true(ut_log_order_ok);
+
+    gf_log_set_callback(NULL, NULL);
+    gf_log_set_tool_level(GF_LOG_CORE, GF_LOG_WARNING);
+    gf_sys_close();
+}
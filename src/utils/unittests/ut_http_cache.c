@@ -0,0 +1,229 @@
+#include <gpac/download.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+#include "tests.h"
+
+#ifndef GPAC_DISABLE_NETWORK
+
+#define UT_HC_DIR	"ut_http_cache"
+
+static GF_Socket *ut_hc_listen;
+static u16 ut_hc_port;
+static volatile Bool ut_hc_stop;
+//size of resource "grow", other resources are named by their size
+static volatile u32 ut_hc_grow_size;
+
+static void ut_hc_reply(GF_Socket *sk, const char *req)
+{
+    char name[100], etag[120], hdr[400];
+    const char *inm;
+    u32 size, sent;
+    u8 *data;
+    if (sscanf(req, "GET /%99s ", name) != 1) return;
+    if (!strcmp(name, "grow")) size = ut_hc_grow_size;
+    else size = atoi(name);
+    snprintf(etag, sizeof(etag), "\"%s-%u\"", name, size);
+
+    inm = strstr(req, "If-None-Match: ");
+    if (inm && !strncmp(inm+15, etag, strlen(etag))) {
+        snprintf(hdr, sizeof(hdr), "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nConnection: close\r\n\r\n", etag);
+        gf_sk_send(sk, (u8 *) hdr, (u32) strlen(hdr));
+        return;
+    }
+    snprintf(hdr, sizeof(hdr), "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %u\r\nETag: %s\r\nConnection: close\r\n\r\n", size, etag);
+    gf_sk_send(sk, (u8 *) hdr, (u32) strlen(hdr));
+    data = gf_malloc(size+1);
+    memset(data, 'a', size);
+    sent = 0;
+    while (sent < size) {
+        u32 len = MIN(size - sent, 1000);
+        if (gf_sk_send(sk, data + sent, len) != GF_OK) break;
+        sent += len;
+    }
+    gf_free(data);
+}
+
+//serves one GET per connection
+static u32 ut_hc_server(void *par)
+{
+    while (!ut_hc_stop) {
+        char req[2000];
+        u32 len = 0, nb_tries = 0;
+        GF_Socket *sk = NULL;
+        if (gf_sk_accept(ut_hc_listen, &sk) != GF_OK) {
+            gf_sleep(1);
+            continue;
+        }
+        while ((len < sizeof(req) - 1) && (nb_tries < 2000)) {
+            u32 read = 0;
+            GF_Err e = gf_sk_receive(sk, (u8 *) req + len, sizeof(req) - 1 - len, &read);
+            if (e == GF_IP_NETWORK_EMPTY) {
+                nb_tries++;
+                gf_sleep(1);
+                continue;
+            }
+            if (e) break;
+            len += read;
+            req[len] = 0;
+            if (strstr(req, "\r\n\r\n")) {
+                ut_hc_reply(sk, req);
+                break;
+            }
+        }
+        gf_sk_del(sk);
+    }
+    return 0;
+}
+
+//fetches a resource, returns GF_TRUE if fetched
+static Bool ut_hc_get(GF_DownloadManager *dm, const char *name)
+{
+    GF_Err e;
+    u32 nb_loops = 0;
+    char url[200];
+    GF_NetIOStatus status = GF_NETIO_SETUP;
+    GF_DownloadSession *sess;
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/%s", ut_hc_port, name);
+    sess = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED, NULL, NULL, &e);
+    assert_not_null(sess);
+    if (!sess) return GF_FALSE;
+    //connection is closed by the server once the resource is sent
+    while (nb_loops < 10000) {
+        e = gf_dm_sess_process(sess);
+        gf_dm_sess_get_stats(sess, NULL, NULL, NULL, NULL, NULL, &status);
+        if ((status >= GF_NETIO_DATA_TRANSFERED) || (e && (e != GF_IP_NETWORK_EMPTY))) break;
+        nb_loops++;
+    }
+    e = gf_dm_sess_last_error(sess);
+    gf_dm_sess_del(sess);
+    return (!e && ((status == GF_NETIO_DATA_TRANSFERED) || (status == GF_NETIO_DISCONNECTED))) ? GF_TRUE : GF_FALSE;
+}
+
+static GF_DownloadManager *ut_hc_dm(const char *cache_size, const char *cache_mem)
+{
+    GF_DownloadManager *dm;
+    gf_opts_set_key("core", "cache", UT_HC_DIR);
+    gf_opts_set_key("core", "cache-size", cache_size);
+    gf_opts_set_key("core", "cache-mem", cache_mem);
+    dm = gf_dm_new(NULL);
+    assert_not_null(dm);
+    return dm;
+}
+
+static void ut_hc_check(GF_DownloadManager *dm, u32 hits, u32 misses, u32 evictions, u32 nb_entries, u64 size)
+{
+    GF_DMCacheStats stats;
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.hits, hits);
+    assert_equal(stats.misses, misses);
+    assert_equal(stats.evictions, evictions);
+    assert_equal(stats.nb_entries, nb_entries);
+    assert_equal(stats.size, size);
+}
+
+unittest(http_cache_lru_and_memory_tier)
+{
+    u32 i;
+    GF_Thread *th;
+    GF_DownloadManager *dm;
+    GF_DMCacheStats stats;
+
+    gf_sys_init(GF_MemTrackerNone, NULL);
+    ut_hc_stop = GF_FALSE;
+    ut_hc_listen = gf_sk_new(GF_SOCK_TYPE_TCP);
+    assert_not_null(ut_hc_listen);
+    //pick a free port
+    for (i=0; i<100; i++) {
+        ut_hc_port = 20000 + ut_rand() % 30000;
+        if (gf_sk_bind(ut_hc_listen, "127.0.0.1", ut_hc_port, NULL, 0, 0) == GF_OK) break;
+    }
+    assert_true(i<100);
+    assert_equal(gf_sk_listen(ut_hc_listen, 0), GF_OK);
+    gf_sk_set_block_mode(ut_hc_listen, GF_TRUE);
+    th = gf_th_new("ut_http_cache");
+    gf_th_run(th, ut_hc_server, NULL);
+
+    //3 disk entries fill the cache
+    dm = ut_hc_dm("10000", "2000");
+    assert_true(ut_hc_get(dm, "3000"));
+    assert_true(ut_hc_get(dm, "3001"));
+    assert_true(ut_hc_get(dm, "3002"));
+    ut_hc_check(dm, 0, 3, 0, 3, 9003);
+    //revalidated, 3000 is now most recently used
+    assert_true(ut_hc_get(dm, "3000"));
+    ut_hc_check(dm, 1, 3, 0, 3, 9003);
+    //going above the limit does not evict until the next request
+    assert_true(ut_hc_get(dm, "3003"));
+    ut_hc_check(dm, 1, 4, 0, 4, 12006);
+
+    //small resource goes to memory, least recently used 3001 is evicted
+    assert_true(ut_hc_get(dm, "100"));
+    ut_hc_check(dm, 1, 5, 1, 4, 9105);
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.nb_mem_entries, 1);
+    assert_equal(stats.mem_size, 100);
+
+    //evicted entry is fetched again, cache is above limit
+    assert_true(ut_hc_get(dm, "3001"));
+    ut_hc_check(dm, 1, 6, 1, 5, 12106);
+    //3002 is the least recently used but in use, 3000 is evicted
+    assert_true(ut_hc_get(dm, "3002"));
+    ut_hc_check(dm, 2, 6, 2, 4, 9106);
+    assert_true(ut_hc_get(dm, "3000"));
+    ut_hc_check(dm, 2, 7, 2, 5, 12106);
+    //eviction stops once below the limit, 3003 only
+    assert_true(ut_hc_get(dm, "3001"));
+    ut_hc_check(dm, 3, 7, 3, 4, 9103);
+    assert_true(ut_hc_get(dm, "3003"));
+    ut_hc_check(dm, 3, 8, 3, 5, 12106);
+    //memory entry 100 then 3000 are evicted
+    assert_true(ut_hc_get(dm, "3002"));
+    ut_hc_check(dm, 4, 8, 5, 3, 9006);
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.nb_mem_entries, 0);
+    assert_equal(stats.mem_size, 0);
+    gf_dm_del(dm);
+
+    //promotion and demotion of a resource changing size, without size limit
+    dm = ut_hc_dm("0", "2000");
+    ut_hc_grow_size = 500;
+    assert_true(ut_hc_get(dm, "grow"));
+    ut_hc_check(dm, 0, 1, 0, 1, 500);
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.nb_mem_entries, 1);
+    assert_equal(stats.mem_size, 500);
+    //unchanged
+    assert_true(ut_hc_get(dm, "grow"));
+    ut_hc_check(dm, 1, 1, 0, 1, 500);
+    //too large for memory
+    ut_hc_grow_size = 5000;
+    assert_true(ut_hc_get(dm, "grow"));
+    ut_hc_check(dm, 1, 2, 0, 1, 5000);
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.nb_mem_entries, 0);
+    assert_equal(stats.mem_size, 0);
+    assert_true(ut_hc_get(dm, "grow"));
+    ut_hc_check(dm, 2, 2, 0, 1, 5000);
+    //small again
+    ut_hc_grow_size = 200;
+    assert_true(ut_hc_get(dm, "grow"));
+    ut_hc_check(dm, 2, 3, 0, 1, 200);
+    assert_equal(gf_dm_get_cache_stats(dm, &stats), GF_OK);
+    assert_equal(stats.nb_mem_entries, 1);
+    assert_equal(stats.mem_size, 200);
+    gf_dm_del(dm);
+
+    ut_hc_stop = GF_TRUE;
+    gf_th_stop(th);
+    gf_th_del(th);
+    gf_sk_del(ut_hc_listen);
+    ut_hc_listen = NULL;
+    gf_opts_set_key("core", "cache", NULL);
+    gf_opts_set_key("core", "cache-size", NULL);
+    gf_opts_set_key("core", "cache-mem", NULL);
+    gf_dir_cleanup(UT_HC_DIR);
+    gf_rmdir(UT_HC_DIR);
+    gf_sys_close();
+}
+
+#endif
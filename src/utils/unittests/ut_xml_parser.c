@@ -1,3 +1,4 @@
+#include <gpac/xml.h>
 #include "tests.h"
 
 char *xml_translate_xml_string(char *str);
@@ -7,3 +8,39 @@ unittest(xml_translate_xml_string)
     assert_equal_str(str, "&");
     gf_free(str);
 }
+
+unittest(gf_xml_dom_enable_arena)
+{
+    GF_XMLNode *root, *n1, *n2, *txt;
+    GF_XMLAttribute *att;
+    char doc[] = "<root v=\"1\"><item id=\"a\">text</item><item id=\"b\"/></root>";
+    GF_DOMParser *dom = gf_xml_dom_new();
+    gf_xml_dom_enable_arena(dom);
+    assert_equal(gf_xml_dom_parse_string(dom, doc), GF_OK);
+
+    root = gf_xml_dom_get_root(dom);
+    assert_true(root->in_arena);
+    assert_equal_str(root->name, "root");
+    att = gf_list_get(root->attributes, 0);
+    assert_equal_str(att->name, "v");
+    assert_equal_str(att->value, "1");
+
+    n1 = gf_list_get(root->content, 0);
+    n2 = gf_list_get(root->content, 1);
+    assert_equal_str(n1->name, "item");
+    //element and attribute names are interned
+    assert_true(n1->name == n2->name);
+    assert_true(((GF_XMLAttribute *)gf_list_get(n1->attributes, 0))->name == ((GF_XMLAttribute *)gf_list_get(n2->attributes, 0))->name);
+    assert_equal_str(((GF_XMLAttribute *)gf_list_get(n2->attributes, 0))->value, "b");
+    txt = gf_list_get(n1->content, 0);
+    assert_equal(txt->type, GF_XML_TEXT_TYPE);
+    assert_equal_str(txt->name, "text");
+
+    //detached root is a regular copy surviving the parser
+    root = gf_xml_dom_detach_root(dom);
+    gf_xml_dom_del(dom);
+    assert_false(root->in_arena);
+    n2 = gf_list_get(root->content, 1);
+    assert_equal_str(((GF_XMLAttribute *)gf_list_get(n2->attributes, 0))->value, "b");
+    gf_xml_dom_node_del(root);
+}
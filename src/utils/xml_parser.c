@@ -1647,6 +1647,31 @@ u32 gf_xml_sax_get_node_end_pos(GF_SAXParser *parser)
 	return parser->elt_end_pos;
 }
 
+//arena blocks for DOM nodes, attributes and strings, released in one shot
+typedef struct _xml_arena_block
+{
+	struct _xml_arena_block *next;
+	u32 size, used;
+} XMLArenaBlock;
+
+//interned names
+typedef struct _xml_arena_name
+{
+	struct _xml_arena_name *next;
+	char *name;
+} XMLArenaName;
+
+#define XML_ARENA_BLOCK_MIN		16384
+#define XML_ARENA_BLOCK_MAX		(1<<20)
+#define XML_ARENA_NAME_HASH		256
+
+typedef struct
+{
+	XMLArenaBlock *blocks;
+	u32 next_block_size;
+	XMLArenaName *names[XML_ARENA_NAME_HASH];
+} XMLArena;
+
 struct _tag_dom_parser
 {
 	GF_SAXParser *parser;
@@ -1659,8 +1684,80 @@ struct _tag_dom_parser
 	Bool keep_valid;
 	void (*OnProgress)(void *cbck, u64 done, u64 tot);
 	void *cbk;
+	Bool use_arena;
+	XMLArena *arena;
 };
 
+static void *xml_arena_alloc(XMLArena *arena, u32 size)
+{
+	u8 *ptr;
+	XMLArenaBlock *blk = arena->blocks;
+	//keep 8-bytes alignment for nodes and attributes
+	size = (size + 7) & ~7;
+	if (!blk || (blk->used + size > blk->size)) {
+		u32 blk_size = MAX(arena->next_block_size, size);
+		blk = gf_malloc(sizeof(XMLArenaBlock) + blk_size);
+		if (!blk) return NULL;
+		blk->size = blk_size;
+		blk->used = 0;
+		blk->next = arena->blocks;
+		arena->blocks = blk;
+		if (arena->next_block_size < XML_ARENA_BLOCK_MAX)
+			arena->next_block_size *= 2;
+	}
+	ptr = ((u8 *) (blk+1)) + blk->used;
+	blk->used += size;
+	return ptr;
+}
+
+static char *xml_arena_strdup(XMLArena *arena, const char *str, u32 len)
+{
+	char *res = xml_arena_alloc(arena, len+1);
+	if (!res) return NULL;
+	memcpy(res, str, len+1);
+	return res;
+}
+
+static char *xml_arena_intern(XMLArena *arena, const char *name)
+{
+	XMLArenaName *n;
+	u32 len=0, hash = 5381;
+	while (name[len]) {
+		hash = ((hash << 5) + hash) + (u8) name[len];
+		len++;
+	}
+	hash %= XML_ARENA_NAME_HASH;
+	n = arena->names[hash];
+	while (n) {
+		if (!strcmp(n->name, name)) return n->name;
+		n = n->next;
+	}
+	n = xml_arena_alloc(arena, sizeof(XMLArenaName));
+	if (!n) return NULL;
+	n->name = xml_arena_strdup(arena, name, len);
+	if (!n->name) return NULL;
+	n->next = arena->names[hash];
+	arena->names[hash] = n;
+	return n->name;
+}
+
+static void *xml_arena_new(XMLArena *arena, u32 size)
+{
+	void *ptr = xml_arena_alloc(arena, size);
+	if (ptr) memset(ptr, 0, size);
+	return ptr;
+}
+
+static void xml_arena_del(XMLArena *arena)
+{
+	while (arena->blocks) {
+		XMLArenaBlock *blk = arena->blocks;
+		arena->blocks = blk->next;
+		gf_free(blk);
+	}
+	gf_free(arena);
+}
+
 
 GF_EXPORT
 void gf_xml_dom_node_reset(GF_XMLNode *node, Bool reset_attribs, Bool reset_children)
@@ -1670,6 +1767,7 @@ void gf_xml_dom_node_reset(GF_XMLNode *node, Bool reset_attribs, Bool reset_chil
 		while (gf_list_count(node->attributes)) {
 			GF_XMLAttribute *att = (GF_XMLAttribute *)gf_list_last(node->attributes);
 			gf_list_rem_last(node->attributes);
+			if (node->in_arena) continue;
 			if (att->name) gf_free(att->name);
 			if (att->value) gf_free(att->value);
 			gf_free(att);
@@ -1692,6 +1790,8 @@ void gf_xml_dom_node_del(GF_XMLNode *node)
 	gf_xml_dom_node_reset(node, GF_TRUE, GF_TRUE);
 	if (node->attributes) gf_list_del(node->attributes);
 	if (node->content) gf_list_del(node->content);
+	//strings and node memory belong to the parser arena
+	if (node->in_arena) return;
 	if (node->ns) gf_free(node->ns);
 	if (node->name) gf_free(node->name);
 	gf_free(node);
@@ -1710,15 +1810,26 @@ static void on_dom_node_start(void *cbk, const char *name, const char *ns, const
 		return;
 	}
 
-	GF_SAFEALLOC(node, GF_XMLNode);
+	if (par->arena) {
+		node = xml_arena_new(par->arena, sizeof(GF_XMLNode));
+		if (node) {
+			node->in_arena = GF_TRUE;
+			node->name = xml_arena_intern(par->arena, name);
+			if (ns) node->ns = xml_arena_intern(par->arena, ns);
+		}
+	} else {
+		GF_SAFEALLOC(node, GF_XMLNode);
+		if (node) {
+			node->name = gf_strdup(name);
+			if (ns) node->ns = gf_strdup(ns);
+		}
+	}
 	if (!node) {
 		par->parser->sax_state = SAX_STATE_ALLOC_ERROR;
 		return;
 	}
 	node->attributes = gf_list_new_prealloc(nb_attributes);
 	//don't allocate content yet
-	node->name = gf_strdup(name);
-	if (ns) node->ns = gf_strdup(ns);
 	gf_list_add(par->stack, node);
 	if (!par->root) {
 		par->root = node;
@@ -1741,14 +1852,24 @@ static void on_dom_node_start(void *cbk, const char *name, const char *ns, const
 		}
 		if (dup) continue;
 
-		GF_SAFEALLOC(att, GF_XMLAttribute);
+		if (par->arena) {
+			att = xml_arena_alloc(par->arena, sizeof(GF_XMLAttribute));
+			if (att) {
+				att->name = xml_arena_intern(par->arena, in_att->name);
+				att->value = xml_arena_strdup(par->arena, in_att->value, (u32) strlen(in_att->value));
+			}
+		} else {
+			GF_SAFEALLOC(att, GF_XMLAttribute);
+			if (att) {
+				att->name = gf_strdup(in_att->name);
+				att->value = gf_strdup(in_att->value);
+			}
+		}
 		if (! att) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_PARSER, ("[SAX] Failed to allocate attribute\n"));
 			par->parser->sax_state = SAX_STATE_ALLOC_ERROR;
 			return;
 		}
-		att->name = gf_strdup(in_att->name);
-		att->value = gf_strdup(in_att->value);
 		gf_list_add(node->attributes, att);
 	}
 }
@@ -1790,14 +1911,22 @@ static void on_dom_text_content(void *cbk, const char *content, Bool is_cdata)
 	if (!last->content)
 		last->content = gf_list_new();
 
-	GF_SAFEALLOC(node, GF_XMLNode);
+	if (par->arena) {
+		node = xml_arena_new(par->arena, sizeof(GF_XMLNode));
+		if (node) {
+			node->in_arena = GF_TRUE;
+			node->name = xml_arena_strdup(par->arena, content, (u32) strlen(content));
+		}
+	} else {
+		GF_SAFEALLOC(node, GF_XMLNode);
+		if (node) node->name = gf_strdup(content);
+	}
 	if (!node) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_PARSER, ("[SAX] Failed to allocate XML node"));
 		par->parser->sax_state = SAX_STATE_ALLOC_ERROR;
 		return;
 	}
 	node->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
-	node->name = gf_strdup(content);
 	gf_list_add(last->content, node);
 }
 
@@ -1841,6 +1970,24 @@ static void gf_xml_dom_reset(GF_DOMParser *dom, Bool full_reset)
 		}
 		dom->root = NULL;
 	}
+	if (full_reset && dom->arena) {
+		xml_arena_del(dom->arena);
+		dom->arena = NULL;
+	}
+}
+
+static GF_Err gf_xml_dom_setup(GF_DOMParser *dom)
+{
+	gf_xml_dom_reset(dom, GF_TRUE);
+	dom->stack = gf_list_new();
+	if (dom->use_arena) {
+		GF_SAFEALLOC(dom->arena, XMLArena);
+		if (!dom->arena) return GF_OUT_OF_MEM;
+		dom->arena->next_block_size = XML_ARENA_BLOCK_MIN;
+	}
+	dom->parser = gf_xml_sax_new(on_dom_node_start, on_dom_node_end, on_dom_text_content, dom);
+	if (!dom->stack || !dom->parser) return GF_OUT_OF_MEM;
+	return GF_OK;
 }
 
 GF_EXPORT
@@ -1863,6 +2010,12 @@ GF_XMLNode *gf_xml_dom_detach_root(GF_DOMParser *parser)
 	root = parser->root;
 	gf_list_del_item(parser->root_nodes, root);
 	parser->root = gf_list_get(parser->root_nodes, 0);
+	//arena memory is released with the parser, return a copy
+	if (root && root->in_arena) {
+		GF_XMLNode *clone = gf_xml_dom_node_clone(root);
+		gf_xml_dom_node_del(root);
+		root = clone;
+	}
 	return root;
 }
 
@@ -1875,10 +2028,8 @@ static void dom_on_progress(void *cbck, u64 done, u64 tot)
 GF_EXPORT
 GF_Err gf_xml_dom_parse(GF_DOMParser *dom, const char *file, gf_xml_sax_progress OnProgress, void *cbk)
 {
-	GF_Err e;
-	gf_xml_dom_reset(dom, GF_TRUE);
-	dom->stack = gf_list_new();
-	dom->parser = gf_xml_sax_new(on_dom_node_start, on_dom_node_end, on_dom_text_content, dom);
+	GF_Err e = gf_xml_dom_setup(dom);
+	if (e) return e;
 	dom->OnProgress = OnProgress;
 	dom->cbk = cbk;
 	e = gf_xml_sax_parse_file(dom->parser, file, OnProgress ? dom_on_progress : NULL);
@@ -1889,10 +2040,8 @@ GF_Err gf_xml_dom_parse(GF_DOMParser *dom, const char *file, gf_xml_sax_progress
 GF_EXPORT
 GF_Err gf_xml_dom_parse_string(GF_DOMParser *dom, char *string)
 {
-	GF_Err e;
-	gf_xml_dom_reset(dom, GF_TRUE);
-	dom->stack = gf_list_new();
-	dom->parser = gf_xml_sax_new(on_dom_node_start, on_dom_node_end, on_dom_text_content, dom);
+	GF_Err e = gf_xml_dom_setup(dom);
+	if (e) return e;
 	e = gf_xml_sax_init(dom->parser, (unsigned char *) string);
 	gf_xml_dom_reset(dom, GF_FALSE);
 	return e<0 ? e : GF_OK;
@@ -1906,6 +2055,14 @@ GF_Err gf_xml_dom_enable_passthrough(GF_DOMParser *dom)
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_xml_dom_enable_arena(GF_DOMParser *dom)
+{
+	if (!dom) return GF_BAD_PARAM;
+	dom->use_arena = GF_TRUE;
+	return GF_OK;
+}
+
 #if 0 //unused
 GF_XMLNode *gf_xml_dom_create_root(GF_DOMParser *parser, const char* name) {
 	GF_XMLNode * root;